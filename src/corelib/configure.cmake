@@ -174,6 +174,26 @@ std::filesystem::copy(
 "# FIXME: qmake: CONFIG += c++17
 )
 
+# epoll
+qt_config_compile_test(epoll
+    LABEL "epoll"
+    CODE
+"#include <sys/epoll.h>
+
+int main(void)
+{
+    /* BEGIN TEST: */
+struct epoll_event ev = {};
+ev.events = EPOLLIN;
+ev.data.fd = 0;
+int fd = epoll_create1(EPOLL_CLOEXEC);
+epoll_ctl(fd, EPOLL_CTL_ADD, 0, &ev);
+epoll_wait(fd, &ev, 1, 0);
+    /* END TEST: */
+    return 0;
+}
+")
+
 # eventfd
 qt_config_compile_test(eventfd
     LABEL "eventfd"
@@ -333,6 +353,29 @@ shm_unlink(\"test\");
 }
 ")
 
+# io_uring
+qt_config_compile_test(io_uring
+    LABEL "io_uring"
+    CODE
+"#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+int main(void)
+{
+    /* BEGIN TEST: */
+struct io_uring_params params = {};
+int fd = syscall(__NR_io_uring_setup, 8, &params);
+if (!(params.features & IORING_FEAT_SINGLE_MMAP))
+    return 1;
+struct io_uring_sqe sqe = {};
+sqe.opcode = IORING_OP_READV;
+syscall(__NR_io_uring_enter, fd, 1, 1, IORING_ENTER_GETEVENTS, 0, 0);
+    /* END TEST: */
+    return 0;
+}
+")
+
 # linkat
 qt_config_compile_test(linkat
     LABEL "linkat()"
@@ -523,6 +566,10 @@ qt_feature("cxx17_filesystem" PUBLIC
     LABEL "C++17 <filesystem>"
     CONDITION TEST_cxx17_filesystem
 )
+qt_feature("epoll" PRIVATE
+    LABEL "epoll"
+    CONDITION NOT WASM AND TEST_epoll
+)
 qt_feature("eventfd" PUBLIC
     LABEL "eventfd"
     CONDITION NOT WASM AND TEST_eventfd
@@ -589,6 +636,10 @@ qt_feature("linkat" PRIVATE
     AUTODETECT LINUX AND NOT ANDROID
     CONDITION TEST_linkat
 )
+qt_feature("io_uring" PRIVATE
+    LABEL "io_uring"
+    CONDITION LINUX AND QT_FEATURE_future AND TEST_io_uring
+)
 qt_feature("std-atomic64" PUBLIC
     LABEL "64 bit atomic operations"
     CONDITION WrapAtomic_FOUND
@@ -916,10 +967,22 @@ qt_feature("cborstreamwriter" PUBLIC
     LABEL "CBOR stream writing"
     PURPOSE "Provides support for writing the CBOR binary format."
 )
+qt_feature("jsonstreamreader" PUBLIC
+    SECTION "Utilities"
+    LABEL "JSON stream reading"
+    PURPOSE "Provides support for reading JSON text incrementally, without building a QJsonDocument."
+)
+qt_feature("jsonstreamwriter" PUBLIC
+    SECTION "Utilities"
+    LABEL "JSON stream writing"
+    PURPOSE "Provides support for writing JSON text incrementally, without building a QJsonDocument."
+)
 qt_configure_add_summary_section(NAME "Qt Core")
 qt_configure_add_summary_entry(ARGS "backtrace")
 qt_configure_add_summary_entry(ARGS "doubleconversion")
 qt_configure_add_summary_entry(ARGS "system-doubleconversion")
+qt_configure_add_summary_entry(ARGS "epoll")
+qt_configure_add_summary_entry(ARGS "io_uring")
 qt_configure_add_summary_entry(ARGS "glib")
 qt_configure_add_summary_entry(ARGS "icu")
 qt_configure_add_summary_entry(ARGS "system-libb2")
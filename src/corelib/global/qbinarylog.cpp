@@ -0,0 +1,664 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qbinarylog_p.h"
+
+#include <QtCore/qdatetime.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qthread.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+using namespace QBinaryLog;
+
+static constexpr quint64 alignedSize(quint64 size) noexcept
+{
+    return (size + 7) & ~quint64(7);
+}
+
+static qint64 currentTimestamp() noexcept
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+static quint64 hashString(const char *string) noexcept
+{
+    // FNV-1a; the content identifies a format string, not its address,
+    // as the same address can hold different strings over time
+    quint64 hash = Q_UINT64_C(14695981039346656037);
+    for (; *string; ++string) {
+        hash ^= uchar(*string);
+        hash *= Q_UINT64_C(1099511628211);
+    }
+    return hash ? hash : 1;
+}
+
+static bool isDigit(char c) noexcept
+{
+    return c >= '0' && c <= '9';
+}
+
+/*!
+    \internal
+
+    Parses the conversion specification starting with the \c{%} at \a spec
+    the way QString::vasprintf() does, and stores the arguments it consumes
+    in \a conversion. Returns a pointer past the specification, or \nullptr
+    if the binary log cannot record it.
+*/
+const char *QBinaryLog::parseConversion(const char *spec, Conversion *conversion) noexcept
+{
+    Q_ASSERT(*spec == '%');
+    *conversion = {};
+
+    const char *c = spec + 1;
+    if (*c == '%')
+        return c + 1;
+
+    while (*c == '#' || *c == '0' || *c == '-' || *c == ' ' || *c == '+' || *c == '\'')
+        ++c;
+
+    if (*c == '*') {
+        conversion->widthArgument = true;
+        ++c;
+    } else {
+        while (isDigit(*c))
+            ++c;
+    }
+
+    if (*c == '.') {
+        conversion->precision = true;
+        ++c;
+        if (*c == '*') {
+            conversion->precisionArgument = true;
+            ++c;
+        } else {
+            while (isDigit(*c))
+                ++c;
+        }
+    }
+
+    enum { NoLength, LongLength, LongLongLength, LongDoubleLength, IntMaxLength, SizeLength }
+            length = NoLength;
+    switch (*c) {
+    case 'h':
+        ++c;
+        if (*c == 'h')
+            ++c;
+        break;
+    case 'l':
+        ++c;
+        length = LongLength;
+        if (*c == 'l') {
+            ++c;
+            length = LongLongLength;
+        }
+        break;
+    case 'L':
+        ++c;
+        length = LongDoubleLength;
+        break;
+    case 'j':
+        ++c;
+        length = IntMaxLength;
+        break;
+    case 'z':
+    case 'Z':
+    case 't':
+        ++c;
+        length = SizeLength;
+        break;
+    }
+
+    switch (*c) {
+    case 'd':
+    case 'i':
+    case 'o':
+    case 'u':
+    case 'x':
+    case 'X':
+        switch (length) {
+        case NoLength:
+            conversion->argument = IntArgument;
+            break;
+        case LongLength:
+            conversion->argument = LongArgument;
+            break;
+        case LongLongLength:
+            conversion->argument = Int64Argument;
+            break;
+        case SizeLength:
+            conversion->argument = SizeArgument;
+            break;
+        case IntMaxLength:
+            // QString::vasprintf() reads a long for %jd, but nothing for %ju
+            if (*c != 'd' && *c != 'i')
+                return nullptr;
+            conversion->argument = LongArgument;
+            break;
+        case LongDoubleLength:
+            return nullptr;
+        }
+        break;
+    case 'e':
+    case 'E':
+    case 'f':
+    case 'F':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+        if (length == LongDoubleLength)
+            return nullptr;
+        conversion->argument = DoubleArgument;
+        break;
+    case 'c':
+        conversion->argument = IntArgument;
+        break;
+    case 's':
+        // a precision allows strings that are not null-terminated
+        if (length == LongLength || conversion->precision)
+            return nullptr;
+        conversion->argument = StringArgument;
+        break;
+    case 'p':
+        conversion->argument = PointerArgument;
+        break;
+    default:
+        return nullptr;
+    }
+    return c + 1;
+}
+
+static quint8 parseSignature(const char *format, char *signature, quint8 unsupported) noexcept
+{
+    quint8 count = 0;
+    const auto add = [&](ArgumentType argument) {
+        if (count == MaxArguments)
+            return false;
+        signature[count++] = argument;
+        return true;
+    };
+
+    for (const char *c = format; *c; ) {
+        if (*c != '%') {
+            ++c;
+            continue;
+        }
+
+        Conversion conversion;
+        c = parseConversion(c, &conversion);
+        if (!c)
+            return unsupported;
+        if (conversion.widthArgument && !add(IntArgument))
+            return unsupported;
+        if (conversion.precisionArgument && !add(IntArgument))
+            return unsupported;
+        if (conversion.argument != NoArgument && !add(conversion.argument))
+            return unsupported;
+    }
+    return count;
+}
+
+/*!
+    \internal
+    \class QBinaryLogWriter
+
+    Records log messages in a memory-mapped file instead of formatting them.
+    The default message handler uses it if the \c QT_LOGGING_BINARY_FILE
+    environment variable is set; \c QT_LOGGING_BINARY_FILE_SIZE sets the
+    size of the file in bytes. Messages that no longer fit are dropped.
+*/
+
+QBinaryLogWriter *QBinaryLogWriter::instance()
+{
+    // never destroyed: other threads may still log while the process exits
+    static QBinaryLogWriter *writer = []() -> QBinaryLogWriter * {
+        const QString fileName = qEnvironmentVariable("QT_LOGGING_BINARY_FILE");
+        if (fileName.isEmpty())
+            return nullptr;
+        auto writer = new QBinaryLogWriter;
+        if (!writer->open(fileName, qgetenv("QT_LOGGING_BINARY_FILE_SIZE").toLongLong())) {
+            delete writer;
+            return nullptr;
+        }
+        return writer;
+    }();
+    return writer;
+}
+
+bool QBinaryLogWriter::open(const QString &fileName, qint64 capacity)
+{
+    Q_ASSERT(!header);
+
+    if (capacity <= 0)
+        capacity = 64 * 1024 * 1024;
+    capacity = qMax(capacity, qint64(4096)) & ~qint64(7);
+
+    // the file is sparse until records are written
+    file.setFileName(fileName);
+    if (!file.open(QIODevice::ReadWrite | QIODevice::Truncate)
+            || !file.resize(capacity) || file.size() != capacity) {
+        file.close();
+        return false;
+    }
+
+    uchar *map = file.map(0, capacity);
+    if (!map) {
+        file.close();
+        return false;
+    }
+
+    header = reinterpret_cast<FileHeader *>(map);
+    header->version = Version;
+    header->capacity = quint64(capacity);
+    header->startTime = QDateTime::currentMSecsSinceEpoch();
+    header->startTimestamp = currentTimestamp();
+    header->used.storeRelaxed(sizeof(FileHeader));
+    header->dropped.storeRelaxed(0);
+    header->magic = Magic;
+    return true;
+}
+
+uchar *QBinaryLogWriter::reserve(quint32 size)
+{
+    Q_ASSERT(size % 8 == 0);
+    const quint64 offset = header->used.fetchAndAddRelaxed(size);
+    if (offset + size > header->capacity) {
+        header->dropped.fetchAndAddRelaxed(1);
+        return nullptr;
+    }
+
+    uchar *record = reinterpret_cast<uchar *>(header) + offset;
+    reinterpret_cast<RecordHeader *>(record)->size = size;
+    return record;
+}
+
+const QBinaryLogWriter::StringSlot *QBinaryLogWriter::intern(const char *string)
+{
+    const quint64 hash = hashString(string);
+    for (quint64 i = 0; i < StringSlotCount; ++i) {
+        StringSlot &slot = strings[(hash + i) % StringSlotCount];
+        quint64 current = slot.hash.loadAcquire();
+        if (!current && slot.hash.testAndSetOrdered(0, hash, current)) {
+            // never freed, like the writer
+            slot.string = qstrdup(string);
+            slot.argumentCount = parseSignature(string, slot.signature, UnsupportedFormat);
+
+            const quint32 id = nextStringId.fetchAndAddRelaxed(1);
+            const size_t length = strlen(string);
+            if (uchar *record = reserve(quint32(alignedSize(sizeof(String) + length)))) {
+                auto s = reinterpret_cast<String *>(record);
+                s->id = id;
+                s->length = quint32(length);
+                memcpy(record + sizeof(String), string, length);
+                s->header.kind.storeRelease(StringRecord);
+            }
+            slot.id.storeRelease(id);
+            return &slot;
+        }
+        if (current != hash)
+            continue;
+
+        // another thread may still be adding it
+        while (!slot.id.loadAcquire())
+            std::this_thread::yield();
+        // a different string with the same hash is in the next free slot
+        if (strcmp(slot.string, string) == 0)
+            return &slot;
+    }
+    return nullptr;
+}
+
+Message *QBinaryLogWriter::beginMessage(QtMsgType type, const QMessageLogContext &context,
+                                        quint32 format, quint64 size)
+{
+    const qint64 timestamp = currentTimestamp();
+
+    quint32 category = DefaultCategory;
+    if (context.category && strcmp(context.category, "default") != 0) {
+        if (const StringSlot *slot = intern(context.category))
+            category = slot->id.loadRelaxed();
+    }
+
+    if (size > MaxRecordSize) {
+        header->dropped.fetchAndAddRelaxed(1);
+        return nullptr;
+    }
+
+    auto record = reinterpret_cast<Message *>(reserve(quint32(size)));
+    if (!record)
+        return nullptr;
+    record->header.type = quint16(type);
+    record->category = category;
+    record->format = format;
+    record->timestamp = timestamp;
+    record->threadId = quint64(quintptr(QThread::currentThreadId()));
+    return record;
+}
+
+/*!
+    \internal
+
+    Records a message with the printf-style \a format and the arguments in
+    \a ap. Returns \c false without consuming \a ap if the format cannot be
+    recorded; the caller has to format the message itself then.
+*/
+bool QBinaryLogWriter::write(QtMsgType type, const QMessageLogContext &context,
+                             const char *format, va_list ap)
+{
+    const StringSlot *slot = intern(format);
+    if (!slot || slot->argumentCount == UnsupportedFormat)
+        return false;
+
+    quint64 values[MaxArguments];
+    const char *stringArguments[MaxArguments];
+    quint64 size = sizeof(Message) + slot->argumentCount * sizeof(quint64);
+    for (int i = 0; i < slot->argumentCount; ++i) {
+        switch (slot->signature[i]) {
+        case IntArgument:
+            values[i] = quint64(va_arg(ap, int));
+            break;
+        case LongArgument:
+            values[i] = quint64(va_arg(ap, long));
+            break;
+        case Int64Argument:
+            values[i] = quint64(va_arg(ap, qint64));
+            break;
+        case SizeArgument:
+            values[i] = quint64(va_arg(ap, qsizetype));
+            break;
+        case DoubleArgument: {
+            const double d = va_arg(ap, double);
+            memcpy(&values[i], &d, sizeof(d));
+            break;
+        }
+        case PointerArgument:
+            values[i] = quintptr(va_arg(ap, void *));
+            break;
+        case StringArgument:
+            stringArguments[i] = va_arg(ap, const char *);
+            values[i] = stringArguments[i]
+                    ? qMin(quint64(strlen(stringArguments[i])), quint64(MaxRecordSize)) : quint64(NullString);
+            if (stringArguments[i])
+                size += alignedSize(values[i]);
+            break;
+        }
+    }
+
+    Message *record = beginMessage(type, context, slot->id.loadRelaxed(), size);
+    if (!record)
+        return true;
+
+    uchar *out = reinterpret_cast<uchar *>(record + 1);
+    for (int i = 0; i < slot->argumentCount; ++i) {
+        memcpy(out, &values[i], sizeof(quint64));
+        out += sizeof(quint64);
+        if (slot->signature[i] == StringArgument && stringArguments[i]) {
+            memcpy(out, stringArguments[i], values[i]);
+            out += alignedSize(values[i]);
+        }
+    }
+    record->header.kind.storeRelease(MessageRecord);
+    return true;
+}
+
+/*!
+    \internal
+
+    Records the formatted \a message.
+*/
+void QBinaryLogWriter::write(QtMsgType type, const QMessageLogContext &context,
+                             const QString &message)
+{
+    const QByteArray text = message.toUtf8();
+    const quint64 length = quint64(text.size());
+    Message *record = beginMessage(type, context, TextFormat,
+                                   sizeof(Message) + sizeof(length) + alignedSize(length));
+    if (!record)
+        return;
+
+    uchar *out = reinterpret_cast<uchar *>(record + 1);
+    memcpy(out, &length, sizeof(length));
+    memcpy(out + sizeof(length), text.constData(), length);
+    record->header.kind.storeRelease(MessageRecord);
+}
+
+/*!
+    \internal
+    \class QBinaryLogReader
+
+    Decodes a log file written by QBinaryLogWriter, formatting the messages
+    the way QString::vasprintf() would have. It reads files written on the
+    same kind of platform only.
+*/
+
+static QString formatMessage(const char *format, const uchar *payload, const uchar *end)
+{
+    const auto take = [&](quint64 *value) {
+        if (end - payload < qsizetype(sizeof(quint64)))
+            return false;
+        memcpy(value, payload, sizeof(quint64));
+        payload += sizeof(quint64);
+        return true;
+    };
+    const auto replaceStar = [](QByteArray &spec, qsizetype from, quint64 value) {
+        const qsizetype star = spec.indexOf('*', from);
+        // like QString::vasprintf(), treat a negative value as unspecified
+        const QByteArray number = int(value) < 0 ? QByteArray() : QByteArray::number(int(value));
+        spec.replace(star, 1, number);
+        return star + number.size();
+    };
+
+    QString result;
+    const char *c = format;
+    while (*c) {
+        const char *text = c;
+        while (*c && *c != '%')
+            ++c;
+        result += QString::fromUtf8(text, c - text);
+        if (!*c)
+            break;
+
+        Conversion conversion;
+        const char *next = parseConversion(c, &conversion);
+        if (!next)
+            return result;
+        QByteArray spec(c, next - c);
+        c = next;
+
+        quint64 value;
+        qsizetype from = 0;
+        if (conversion.widthArgument) {
+            if (!take(&value))
+                return result;
+            from = replaceStar(spec, from, value);
+        }
+        if (conversion.precisionArgument) {
+            if (!take(&value))
+                return result;
+            replaceStar(spec, from, value);
+        }
+        if (conversion.argument == NoArgument) {
+            result += QLatin1Char('%');
+            continue;
+        }
+        if (!take(&value))
+            return result;
+
+        switch (conversion.argument) {
+        case NoArgument:
+            break;
+        case IntArgument:
+            result += QString::asprintf(spec.constData(), int(value));
+            break;
+        case LongArgument:
+            result += QString::asprintf(spec.constData(), long(value));
+            break;
+        case Int64Argument:
+            result += QString::asprintf(spec.constData(), qint64(value));
+            break;
+        case SizeArgument:
+            result += QString::asprintf(spec.constData(), qsizetype(value));
+            break;
+        case DoubleArgument: {
+            double d;
+            memcpy(&d, &value, sizeof(d));
+            result += QString::asprintf(spec.constData(), d);
+            break;
+        }
+        case PointerArgument:
+            result += QString::asprintf(spec.constData(), reinterpret_cast<void *>(quintptr(value)));
+            break;
+        case StringArgument:
+            if (value == NullString) {
+                result += QString::asprintf(spec.constData(), static_cast<const char *>(nullptr));
+            } else {
+                if (quint64(end - payload) < value)
+                    return result;
+                const QByteArray string(reinterpret_cast<const char *>(payload), qsizetype(value));
+                payload += qMin(alignedSize(value), quint64(end - payload));
+                result += QString::asprintf(spec.constData(), string.constData());
+            }
+            break;
+        }
+    }
+    return result;
+}
+
+bool QBinaryLogReader::open(const QString &fileName)
+{
+    error.clear();
+    messages.clear();
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        error = file.errorString();
+        return false;
+    }
+
+    const qint64 size = file.size();
+    const uchar *data = size >= qint64(sizeof(FileHeader)) ? file.map(0, size) : nullptr;
+    const auto fileHeader = reinterpret_cast<const FileHeader *>(data);
+    if (!data || fileHeader->magic != Magic) {
+        error = QStringLiteral("Not a binary log file");
+        return false;
+    }
+    if (fileHeader->version != Version) {
+        error = QStringLiteral("Unsupported binary log version %1").arg(fileHeader->version);
+        return false;
+    }
+
+    start = fileHeader->startTime;
+    dropped = fileHeader->dropped.loadRelaxed();
+    const quint64 end = qMin(qMin(fileHeader->used.loadRelaxed(), fileHeader->capacity),
+                             quint64(size));
+
+    // strings are added by the first message using them, which need not be
+    // the first one in the file, so collect them before decoding
+    QHash<quint32, QByteArray> strings;
+    QList<const Message *> records;
+    for (quint64 offset = sizeof(FileHeader); offset + sizeof(RecordHeader) <= end; ) {
+        const auto record = reinterpret_cast<const RecordHeader *>(data + offset);
+        // the writer was interrupted before storing the size
+        if (record->size < sizeof(RecordHeader) || record->size % 8 || offset + record->size > end)
+            break;
+
+        switch (record->kind.loadRelaxed()) {
+        case StringRecord: {
+            const auto s = reinterpret_cast<const String *>(record);
+            if (record->size >= sizeof(String) && sizeof(String) + s->length <= record->size)
+                strings.insert(s->id, QByteArray(reinterpret_cast<const char *>(s + 1), s->length));
+            break;
+        }
+        case MessageRecord:
+            if (record->size >= sizeof(Message))
+                records.append(reinterpret_cast<const Message *>(record));
+            break;
+        default:
+            // not completed by the writer
+            break;
+        }
+        offset += record->size;
+    }
+
+    messages.reserve(records.size());
+    for (const Message *record : qAsConst(records)) {
+        const auto payload = reinterpret_cast<const uchar *>(record + 1);
+        const auto payloadEnd = reinterpret_cast<const uchar *>(record) + record->header.size;
+
+        Entry entry;
+        entry.type = QtMsgType(record->header.type);
+        entry.timestamp = record->timestamp - fileHeader->startTimestamp;
+        entry.threadId = record->threadId;
+        entry.category = record->category == DefaultCategory
+                ? QByteArray("default") : strings.value(record->category, "<unknown>");
+
+        if (record->format == TextFormat) {
+            quint64 length = 0;
+            if (payloadEnd - payload >= qsizetype(sizeof(length)))
+                memcpy(&length, payload, sizeof(length));
+            length = qMin(length, quint64(payloadEnd - payload) - sizeof(length));
+            entry.message = QString::fromUtf8(reinterpret_cast<const char *>(payload) + sizeof(length),
+                                              qsizetype(length));
+        } else if (strings.contains(record->format)) {
+            entry.message = formatMessage(strings.value(record->format).constData(), payload, payloadEnd);
+        } else {
+            entry.message = QStringLiteral("<unknown format %1>").arg(record->format);
+        }
+        messages.append(std::move(entry));
+    }
+
+    // records are in the order their space was reserved in, not necessarily
+    // the order their timestamps were taken in
+    std::stable_sort(messages.begin(), messages.end(), [](const Entry &lhs, const Entry &rhs) {
+        return lhs.timestamp < rhs.timestamp;
+    });
+    return true;
+}
+
+QT_END_NAMESPACE
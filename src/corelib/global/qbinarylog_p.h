@@ -0,0 +1,229 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QBINARYLOG_P_H
+#define QBINARYLOG_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists for the convenience
+// of a number of Qt sources files.  This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qbasicatomic.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qstring.h>
+
+#include <stdarg.h>
+
+QT_BEGIN_NAMESPACE
+
+class QMessageLogContext;
+
+/*
+    The binary log is a memory-mapped file that starts with a FileHeader,
+    followed by 8-byte aligned records. Writers reserve the space for a
+    record by atomically advancing FileHeader::used, fill it in, and
+    publish it by storing its kind last.
+
+    Format strings and category names are written once as StringRecords
+    and referred to by id afterwards. A MessageRecord either references
+    the printf-style format string of the message, followed by one 8-byte
+    slot per argument (strings are stored inline as a 32-bit length and
+    the bytes, padded to 8 bytes), or has a format id of 0 and carries the
+    already formatted UTF-8 message text.
+*/
+namespace QBinaryLog {
+
+enum : quint32 {
+    Magic = 0x474c4251,     // "QBLG"
+    Version = 1,
+
+    TextFormat = 0,
+    DefaultCategory = 0,
+    NullString = 0xffffffff,
+
+    MaxArguments = 16,
+    MaxRecordSize = 16 * 1024 * 1024
+};
+
+enum RecordKind : quint16 {
+    IncompleteRecord = 0,
+    StringRecord = 1,
+    MessageRecord = 2
+};
+
+struct FileHeader
+{
+    quint32 magic;
+    quint32 version;
+    quint64 capacity;                       // size of the file, including this header
+    qint64 startTime;                       // msecs since the epoch
+    qint64 startTimestamp;                  // steady clock in nsecs, same base as the records
+    QBasicAtomicInteger<quint64> used;      // offset of the next record, can exceed capacity
+    QBasicAtomicInteger<quint64> dropped;   // records that did not fit
+    quint64 reserved[2];
+};
+
+struct RecordHeader
+{
+    quint32 size;                           // including this header, multiple of 8
+    QBasicAtomicInteger<quint16> kind;      // stored last
+    quint16 type;                           // QtMsgType of a MessageRecord
+};
+
+struct String
+{
+    RecordHeader header;
+    quint32 id;
+    quint32 length;
+    // followed by length bytes of UTF-8 data
+};
+
+struct Message
+{
+    RecordHeader header;
+    quint32 category;
+    quint32 format;
+    qint64 timestamp;
+    quint64 threadId;
+    // followed by the arguments, or the message text if format is TextFormat
+};
+
+static_assert(sizeof(FileHeader) == 64);
+static_assert(sizeof(String) == 16);
+static_assert(sizeof(Message) == 32);
+
+// the va_arg() type QString::vasprintf() reads for a conversion
+enum ArgumentType : char {
+    NoArgument = 0,
+    IntArgument = 'i',
+    LongArgument = 'l',
+    Int64Argument = 'q',
+    SizeArgument = 'z',
+    DoubleArgument = 'd',
+    PointerArgument = 'p',
+    StringArgument = 's'
+};
+
+struct Conversion
+{
+    ArgumentType argument;
+    bool widthArgument;
+    bool precision;
+    bool precisionArgument;
+};
+
+Q_CORE_EXPORT const char *parseConversion(const char *spec, Conversion *conversion) noexcept;
+
+} // namespace QBinaryLog
+
+class Q_AUTOTEST_EXPORT QBinaryLogWriter
+{
+public:
+    QBinaryLogWriter() = default;
+
+    static QBinaryLogWriter *instance();
+
+    bool open(const QString &fileName, qint64 capacity);
+
+    bool write(QtMsgType type, const QMessageLogContext &context, const char *format, va_list ap);
+    void write(QtMsgType type, const QMessageLogContext &context, const QString &message);
+
+private:
+    Q_DISABLE_COPY_MOVE(QBinaryLogWriter)
+
+    struct StringSlot
+    {
+        QBasicAtomicInteger<quint64> hash;
+        QBasicAtomicInteger<quint32> id;
+        const char *string;         // a copy, compared on hash collisions
+        quint8 argumentCount;
+        char signature[QBinaryLog::MaxArguments];
+    };
+    enum { StringSlotCount = 4096, UnsupportedFormat = 0xff };
+
+    const StringSlot *intern(const char *string);
+    uchar *reserve(quint32 size);
+    QBinaryLog::Message *beginMessage(QtMsgType type, const QMessageLogContext &context,
+                                      quint32 format, quint64 size);
+
+    QFile file;
+    QBinaryLog::FileHeader *header = nullptr;
+    QBasicAtomicInteger<quint32> nextStringId = Q_BASIC_ATOMIC_INITIALIZER(1);
+    StringSlot strings[StringSlotCount] = {};
+};
+
+class Q_CORE_EXPORT QBinaryLogReader
+{
+public:
+    struct Entry
+    {
+        QtMsgType type;
+        qint64 timestamp;           // nsecs since the log was created
+        quint64 threadId;
+        QByteArray category;
+        QString message;
+    };
+
+    bool open(const QString &fileName);
+
+    QString errorString() const { return error; }
+    qint64 startTime() const noexcept { return start; }
+    quint64 droppedCount() const noexcept { return dropped; }
+    QList<Entry> entries() const { return messages; }
+
+private:
+    QString error;
+    qint64 start = 0;
+    quint64 dropped = 0;
+    QList<Entry> messages;
+};
+
+QT_END_NAMESPACE
+
+#endif // QBINARYLOG_P_H
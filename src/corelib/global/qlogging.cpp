@@ -57,6 +57,11 @@
 #include "qdatetime.h"
 #include "qcoreapplication.h"
 #include "qthread.h"
+#include "qmath.h"
+#if QT_CONFIG(thread)
+#include "qsemaphore.h"
+#endif
+#include "private/qbinarylog_p.h"
 #include "private/qloggingregistry_p.h"
 #include "private/qcoreapplication_p.h"
 #include "private/qsimd_p.h"
@@ -175,6 +180,10 @@ Q_NORETURN
 static void qt_message_fatal(QtMsgType, const QMessageLogContext &context, const QString &message);
 static void qt_message_print(QtMsgType, const QMessageLogContext &context, const QString &message);
 static void qt_message_print(const QString &message);
+#ifndef QT_BOOTSTRAPPED
+static bool qt_binary_message_print(QtMsgType, const QMessageLogContext &context,
+                                    const char *msg, va_list ap);
+#endif
 
 static int checked_var_value(const char *varname)
 {
@@ -190,30 +199,55 @@ static int checked_var_value(const char *varname)
     return ok ? value : 1;
 }
 
+static QAtomicInt &fatalCriticals()
+{
+    static QAtomicInt value = checked_var_value("QT_FATAL_CRITICALS");
+    return value;
+}
+
+static QAtomicInt &fatalWarnings()
+{
+    static QAtomicInt value = checked_var_value("QT_FATAL_WARNINGS");
+    return value;
+}
+
 static bool isFatal(QtMsgType msgType)
 {
     if (msgType == QtFatalMsg)
         return true;
 
     if (msgType == QtCriticalMsg) {
-        static QAtomicInt fatalCriticals = checked_var_value("QT_FATAL_CRITICALS");
-
         // it's fatal if the current value is exactly 1,
         // otherwise decrement if it's non-zero
-        return fatalCriticals.loadRelaxed() && fatalCriticals.fetchAndAddRelaxed(-1) == 1;
+        return fatalCriticals().loadRelaxed() && fatalCriticals().fetchAndAddRelaxed(-1) == 1;
     }
 
     if (msgType == QtWarningMsg || msgType == QtCriticalMsg) {
-        static QAtomicInt fatalWarnings = checked_var_value("QT_FATAL_WARNINGS");
-
         // it's fatal if the current value is exactly 1,
         // otherwise decrement if it's non-zero
-        return fatalWarnings.loadRelaxed() && fatalWarnings.fetchAndAddRelaxed(-1) == 1;
+        return fatalWarnings().loadRelaxed() && fatalWarnings().fetchAndAddRelaxed(-1) == 1;
     }
 
     return false;
 }
 
+#ifndef QT_BOOTSTRAPPED
+// like isFatal(), but without counting the message
+static bool mayBeFatal(QtMsgType msgType)
+{
+    switch (msgType) {
+    case QtFatalMsg:
+        return true;
+    case QtCriticalMsg:
+        return fatalCriticals().loadRelaxed() || fatalWarnings().loadRelaxed();
+    case QtWarningMsg:
+        return fatalWarnings().loadRelaxed();
+    default:
+        return false;
+    }
+}
+#endif
+
 static bool isDefaultCategory(const char *category)
 {
     return !category || strcmp(category, "default") == 0;
@@ -371,6 +405,10 @@ static inline void convert_to_wchar_t_elided(wchar_t *d, size_t space, const cha
 Q_NEVER_INLINE
 static QString qt_message(QtMsgType msgType, const QMessageLogContext &context, const char *msg, va_list ap)
 {
+#ifndef QT_BOOTSTRAPPED
+    if (qt_binary_message_print(msgType, context, msg, ap))
+        return QString();
+#endif
     QString buf = QString::vasprintf(msg, ap);
     qt_message_print(msgType, context, buf);
     return buf;
@@ -1739,6 +1777,287 @@ static bool wasm_default_message_handler(QtMsgType type,
 
 // --------------------------------------------------------------------------
 
+#if !defined(QT_BOOTSTRAPPED) && QT_CONFIG(thread) && defined(Q_COMPILER_THREAD_LOCAL)
+#define QLOGGING_HAVE_ASYNC_OUTPUT
+
+namespace {
+
+struct QAsyncMessage
+{
+    quint32 serial;
+    QByteArray text;
+};
+
+/*
+    Ring buffer of formatted messages of one thread. Only the thread that
+    owns it pushes, and only the thread holding the writer's drain mutex
+    pops, so neither side needs a lock.
+*/
+class QAsyncMessageBuffer
+{
+public:
+    explicit QAsyncMessageBuffer(quint32 capacity)
+        : messages(capacity), mask(capacity - 1)
+    {
+        Q_ASSERT(capacity && (capacity & mask) == 0);
+    }
+
+    bool push(quint32 serial, QByteArray &text)
+    {
+        const quint32 h = head.loadRelaxed();
+        if (h - tail.loadAcquire() > mask)
+            return false;
+        QAsyncMessage &message = messages[h & mask];
+        message.serial = serial;
+        message.text.swap(text);
+        head.storeRelease(h + 1);
+        return true;
+    }
+
+    bool pop(std::vector<QAsyncMessage> *out)
+    {
+        const quint32 t = tail.loadRelaxed();
+        if (t == head.loadAcquire())
+            return false;
+        out->push_back(std::move(messages[t & mask]));
+        messages[t & mask].text = QByteArray();
+        tail.storeRelease(t + 1);
+        return true;
+    }
+
+    QAtomicInt orphaned;
+
+private:
+    std::vector<QAsyncMessage> messages;
+    const quint32 mask;
+    alignas(64) QAtomicInteger<quint32> head;
+    alignas(64) QAtomicInteger<quint32> tail;
+};
+
+/*
+    Writes the messages for stderr from a background thread, so that the
+    threads that log don't wait for the output. Messages are numbered when
+    they are logged and written in that order, except that a message that
+    only reaches its buffer after the writer has written later messages of
+    other threads is written after them. Messages of one thread are always
+    written in order.
+
+    Enabled by QT_LOGGING_ASYNC=1. QT_LOGGING_ASYNC_BUFFER_SIZE sets the
+    number of messages each thread can have pending (default 1024), and
+    QT_LOGGING_ASYNC_OVERFLOW=drop makes a thread drop messages instead of
+    waiting when it has too many pending.
+*/
+class QAsyncMessageWriter : public QThread
+{
+public:
+    QAsyncMessageWriter();
+    ~QAsyncMessageWriter();
+
+    bool write(QByteArray &message);
+    void flush();
+
+protected:
+    void run() override;
+
+private:
+    QAsyncMessageBuffer *threadBuffer();
+    void wake();
+    void drain();
+    void releaseWaiters();
+
+    QBasicMutex buffersMutex;
+    std::vector<std::shared_ptr<QAsyncMessageBuffer>> buffers;
+    QBasicMutex drainMutex;
+    QSemaphore wakeUp;
+    QAtomicInt wakeUpPending;
+    // threads waiting for room in their buffer
+    QSemaphore roomAvailable;
+    QAtomicInt roomWaiters;
+    QAtomicInt stopping;
+    QAtomicInteger<quint32> nextSerial;
+    QAtomicInt dropped;
+    quint32 capacity = 1024;
+    bool dropOnOverflow = false;
+};
+
+// trivially destructible, so that they can still be used while a thread exits
+static thread_local QAsyncMessageBuffer *currentAsyncMessageBuffer = nullptr;
+static thread_local bool asyncMessageBufferReleased = false;
+
+struct QAsyncMessageBufferReleaser
+{
+    ~QAsyncMessageBufferReleaser()
+    {
+        if (buffer)
+            buffer->orphaned.storeRelease(1);
+        currentAsyncMessageBuffer = nullptr;
+        asyncMessageBufferReleased = true;
+    }
+    std::shared_ptr<QAsyncMessageBuffer> buffer;
+};
+
+static thread_local QAsyncMessageBufferReleaser asyncMessageBufferReleaser;
+
+QAsyncMessageWriter::QAsyncMessageWriter()
+{
+    bool ok = false;
+    const int size = qEnvironmentVariableIntValue("QT_LOGGING_ASYNC_BUFFER_SIZE", &ok);
+    if (ok && size > 0)
+        capacity = qNextPowerOfTwo(quint32(qMin(size, 1 << 20) - 1));
+    dropOnOverflow = qgetenv("QT_LOGGING_ASYNC_OVERFLOW") == "drop";
+
+    setObjectName(QStringLiteral("Qt async logging"));
+    start(LowPriority);
+}
+
+QAsyncMessageWriter::~QAsyncMessageWriter()
+{
+    stopping.storeRelease(1);
+    wakeUp.release();
+    wait();
+    flush();
+}
+
+// returns nullptr once the thread-local data of the thread is destroyed
+QAsyncMessageBuffer *QAsyncMessageWriter::threadBuffer()
+{
+    if (currentAsyncMessageBuffer || asyncMessageBufferReleased)
+        return currentAsyncMessageBuffer;
+
+    auto buffer = std::make_shared<QAsyncMessageBuffer>(capacity);
+    {
+        const auto locker = qt_scoped_lock(buffersMutex);
+        buffers.push_back(buffer);
+    }
+    currentAsyncMessageBuffer = buffer.get();
+    asyncMessageBufferReleaser.buffer = std::move(buffer);
+    return currentAsyncMessageBuffer;
+}
+
+// returns false if the message has to be written synchronously
+bool QAsyncMessageWriter::write(QByteArray &message)
+{
+    QAsyncMessageBuffer *buffer = threadBuffer();
+    if (!buffer)
+        return false;
+    // numbered so that the messages of different threads can be written
+    // in the order they were logged
+    const quint32 serial = nextSerial.fetchAndAddRelaxed(1);
+    while (!buffer->push(serial, message)) {
+        if (dropOnOverflow) {
+            dropped.ref();
+            return true;
+        }
+        // wait for the writer to make room, or make room ourselves if
+        // the writer is gone already
+        if (stopping.loadAcquire()) {
+            flush();
+        } else {
+            roomWaiters.ref();
+            wake();
+            // the timeout rechecks whether the writer is stopping
+            roomAvailable.tryAcquire(1, 100);
+            roomWaiters.deref();
+        }
+    }
+    wake();
+    return true;
+}
+
+void QAsyncMessageWriter::flush()
+{
+    {
+        const auto locker = qt_scoped_lock(drainMutex);
+        drain();
+    }
+    releaseWaiters();
+}
+
+void QAsyncMessageWriter::releaseWaiters()
+{
+    // a waiter that timed out leaves its permit behind, which only makes
+    // another one check its buffer again
+    if (const int waiters = roomWaiters.loadAcquire())
+        roomAvailable.release(waiters);
+}
+
+void QAsyncMessageWriter::wake()
+{
+    if (wakeUpPending.testAndSetOrdered(0, 1))
+        wakeUp.release();
+}
+
+// must be called with drainMutex locked
+void QAsyncMessageWriter::drain()
+{
+    std::vector<QAsyncMessage> messages;
+    {
+        const auto locker = qt_scoped_lock(buffersMutex);
+        for (auto it = buffers.begin(); it != buffers.end();) {
+            QAsyncMessageBuffer *buffer = it->get();
+            const bool orphaned = buffer->orphaned.loadAcquire();
+            while (buffer->pop(&messages)) {
+            }
+            if (orphaned)
+                it = buffers.erase(it);
+            else
+                ++it;
+        }
+    }
+    // the serial numbers wrap around, but never by more than half of their
+    // range among the messages of one drain
+    std::stable_sort(messages.begin(), messages.end(),
+                     [](const QAsyncMessage &lhs, const QAsyncMessage &rhs) {
+                         return qint32(lhs.serial - rhs.serial) < 0;
+                     });
+
+    QByteArray output;
+    for (const QAsyncMessage &message : messages)
+        output += message.text;
+    if (const int count = dropped.fetchAndStoreRelaxed(0)) {
+        output += "QT_LOGGING_ASYNC: " + QByteArray::number(count)
+                  + " message(s) dropped because the buffer was full\n";
+    }
+    if (output.isEmpty())
+        return;
+    fwrite(output.constData(), 1, size_t(output.size()), stderr);
+    fflush(stderr);
+}
+
+void QAsyncMessageWriter::run()
+{
+    while (!stopping.loadAcquire()) {
+        // the timeout lets buffers of finished threads be released
+        wakeUp.tryAcquire(1, 1000);
+        wakeUpPending.fetchAndStoreOrdered(0);
+        flush();
+    }
+}
+
+} // unnamed namespace
+
+Q_GLOBAL_STATIC(QAsyncMessageWriter, qt_async_message_writer)
+
+static thread_local bool creatingAsyncMessageWriter = false;
+
+static QAsyncMessageWriter *asyncMessageWriter()
+{
+    static const bool enabled = qEnvironmentVariableIntValue("QT_LOGGING_ASYNC");
+    if (!enabled)
+        return nullptr;
+    if (qt_async_message_writer.exists())
+        return qt_async_message_writer();
+    // messages logged while the writer thread is being started, for
+    // instance by QThread::start(), are written synchronously
+    if (creatingAsyncMessageWriter)
+        return nullptr;
+    creatingAsyncMessageWriter = true;
+    QAsyncMessageWriter *writer = qt_async_message_writer();
+    creatingAsyncMessageWriter = false;
+    return writer;
+}
+#endif // !QT_BOOTSTRAPPED && thread && Q_COMPILER_THREAD_LOCAL
+
 static void stderr_message_handler(QtMsgType type, const QMessageLogContext &context, const QString &message)
 {
     QString formattedMessage = qFormatLogMessage(type, context, message);
@@ -1748,6 +2067,18 @@ static void stderr_message_handler(QtMsgType type, const QMessageLogContext &con
     if (formattedMessage.isNull())
         return;
 
+#ifdef QLOGGING_HAVE_ASYNC_OUTPUT
+    // qt_message_fatal() flushes the output before terminating
+    if (QAsyncMessageWriter *writer = asyncMessageWriter()) {
+        QByteArray output = formattedMessage.toLocal8Bit();
+        output += '\n';
+        if (writer->write(output))
+            return;
+        // keep the order of the messages of a thread that is exiting
+        writer->flush();
+    }
+#endif
+
 #ifdef Q_OS_WASM
     // Prevent thread cross-talk, which causes Emscripten to log
     // non-valid UTF-8. FIXME: remove once we upgrade to emsdk > 2.0.30
@@ -1767,6 +2098,15 @@ static void qDefaultMessageHandler(QtMsgType type, const QMessageLogContext &con
 {
     bool handledStderr = false;
 
+#ifndef QT_BOOTSTRAPPED
+    // Fatal messages still show up on the console
+    if (QBinaryLogWriter *writer = QBinaryLogWriter::instance()) {
+        writer->write(type, context, message);
+        if (type != QtFatalMsg)
+            return;
+    }
+#endif
+
     // A message sink logs the message to a structured or unstructured destination,
     // optionally formatting the message if the latter, and returns true if the sink
     // handled stderr output as well, which will shortcut our default stderr output.
@@ -1843,6 +2183,43 @@ static void qt_message_print(QtMsgType msgType, const QMessageLogContext &contex
     }
 }
 
+#ifndef QT_BOOTSTRAPPED
+/*!
+    \internal
+
+    Records the message in the binary log without formatting it, if the
+    default message handler would write it there. Returns \c false if the
+    message needs to be formatted and printed instead; \a ap has not been
+    used then.
+*/
+static bool qt_binary_message_print(QtMsgType msgType, const QMessageLogContext &context,
+                                    const char *msg, va_list ap)
+{
+    // the message text is needed in case it is fatal, including warnings
+    // and criticals made fatal by QT_FATAL_WARNINGS and QT_FATAL_CRITICALS
+    if (mayBeFatal(msgType) || messageHandler.loadAcquire())
+        return false;
+
+    QBinaryLogWriter *writer = nullptr;
+    if (!grabMessageHandler())
+        return false;
+    {
+        const auto ungrab = qScopeGuard([]{ ungrabMessageHandler(); });
+        writer = QBinaryLogWriter::instance();
+    }
+    if (!writer)
+        return false;
+
+    if (isDefaultCategory(context.category)) {
+        if (QLoggingCategory *defaultCategory = QLoggingCategory::defaultCategory()) {
+            if (!defaultCategory->isEnabled(msgType))
+                return true;
+        }
+    }
+    return writer->write(msgType, context, msg, ap);
+}
+#endif
+
 static void qt_message_print(const QString &message)
 {
 #if defined(Q_OS_WIN) && !defined(QT_BOOTSTRAPPED)
@@ -1857,6 +2234,11 @@ static void qt_message_print(const QString &message)
 
 static void qt_message_fatal(QtMsgType, const QMessageLogContext &context, const QString &message)
 {
+#ifdef QLOGGING_HAVE_ASYNC_OUTPUT
+    if (QAsyncMessageWriter *writer = asyncMessageWriter())
+        writer->flush();
+#endif
+
 #if defined(Q_CC_MSVC) && defined(QT_DEBUG) && defined(_DEBUG) && defined(_CRT_ERROR)
     wchar_t contextFileL[256];
     // we probably should let the compiler do this for us, by declaring QMessageLogContext::file to
@@ -1981,6 +2363,25 @@ void qErrnoWarning(int code, const char *msg, ...)
     output under X11 or to the debugger under Windows. If it is a
     fatal message, the application aborts immediately.
 
+    When the message is written to \c stderr, setting the \c QT_LOGGING_ASYNC
+    environment variable to \c 1 makes the default message handler write
+    it from a background thread, so that threads that log do not wait for
+    the output. Each thread can have up to \c QT_LOGGING_ASYNC_BUFFER_SIZE
+    messages pending (1024 by default); a thread that has more waits for
+    the background thread, unless \c QT_LOGGING_ASYNC_OVERFLOW is set to
+    \c drop, in which case the message is dropped and the number of dropped
+    messages is reported. Pending messages are written before a fatal
+    message terminates the application.
+
+    If the \c QT_LOGGING_BINARY_FILE environment variable is set to a file
+    name, the default message handler records the messages in that file
+    instead, in a binary format that the \c qlogdecode tool turns back
+    into text. Messages logged with a printf-style format string are
+    recorded without being formatted. The file is memory-mapped and has a
+    fixed size of \c QT_LOGGING_BINARY_FILE_SIZE bytes (64 MB by default);
+    messages that do not fit are dropped. Fatal messages are also written
+    to \c stderr.
+
     Only one message handler can be defined, since this is usually
     done on an application-wide basis to control debug output.
 
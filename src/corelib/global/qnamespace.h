@@ -1304,6 +1304,7 @@ namespace Qt {
         DirectConnection,
         QueuedConnection,
         BlockingQueuedConnection,
+        BatchedQueuedConnection,
         UniqueConnection =  0x80,
         SingleShotConnection = 0x100,
     };
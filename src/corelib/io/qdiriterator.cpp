@@ -87,6 +87,18 @@
     enables iterating through all subdirectories of the assigned path,
     following all symbolic links. Symbolic link loops (e.g., "link" => "." or
     "link" => "..") are automatically detected and ignored.
+
+    \value ParallelTraversal When combined with Subdirectories, this flag
+    makes the iterator scan directories concurrently on the global
+    QThreadPool, and return entries as soon as they are discovered. The
+    metadata of the returned entries is read by the scanning threads, so
+    the QFileInfo returned by fileInfo() does not need to access the file
+    system again. Entries are not returned in any particular order; in
+    particular, the contents of a directory are not necessarily returned
+    right after the directory itself. This flag has no effect when
+    iterating over a path handled by a QAbstractFileEngine, such as a
+    resource path, or when Qt was built without thread support. This value
+    was introduced in Qt 6.3.
 */
 
 #include "qdiriterator.h"
@@ -96,6 +108,11 @@
 #include <QtCore/qset.h>
 #include <QtCore/qstack.h>
 #include <QtCore/qvariant.h>
+#if QT_CONFIG(thread)
+#include <QtCore/qmutex.h>
+#include <QtCore/qthreadpool.h>
+#include <QtCore/qwaitcondition.h>
+#endif
 #if QT_CONFIG(regularexpression)
 #include <QtCore/qregularexpression.h>
 #endif
@@ -107,10 +124,15 @@
 #include <QtCore/private/qfileinfo_p.h>
 #include <QtCore/private/qduplicatetracker_p.h>
 
+#include <atomic>
 #include <memory>
 
 QT_BEGIN_NAMESPACE
 
+#if QT_CONFIG(thread) && !defined(QT_NO_FILESYSTEMITERATOR)
+#  define QT_DIRITERATOR_PARALLEL
+#endif
+
 template <class Iterator>
 class QDirIteratorPrivateIteratorStack : public QStack<Iterator *>
 {
@@ -126,14 +148,50 @@ class QDirIteratorPrivate
 public:
     QDirIteratorPrivate(const QFileSystemEntry &entry, const QStringList &nameFilters,
                         QDir::Filters _filters, QDirIterator::IteratorFlags flags, bool resolveEngine = true);
+    ~QDirIteratorPrivate();
 
     void advance();
 
     bool entryMatches(const QString & fileName, const QFileInfo &fileInfo);
     void pushDirectory(const QFileInfo &fileInfo);
     void checkAndPushDirectory(const QFileInfo &);
+    bool shouldDescendInto(const QFileInfo &fileInfo) const;
     bool matchesFilters(const QString &fileName, const QFileInfo &fi) const;
 
+#ifdef QT_DIRITERATOR_PARALLEL
+    // State shared between the iterating thread and the threads scanning
+    // directories in ParallelTraversal mode. Everything but cancelled is
+    // guarded by mutex.
+    struct ParallelScan
+    {
+        enum {
+            BatchSize = 256,            // entries published at once
+            MaxPendingEntries = 65536   // before scanning threads wait for next()
+        };
+
+        QMutex mutex;
+        QWaitCondition stateChanged;
+        QWaitCondition entriesTaken;
+        QList<QFileInfo> directories;   // waiting to be scanned
+        QList<QFileInfo> entries;       // found, but not taken by next() yet
+        int activeScans = 0;
+        int workers = 0;
+        int maxWorkers = 1;
+        std::atomic<bool> cancelled = false;
+    };
+
+    void startParallelScan(const QFileInfo &root);
+    void queueDirectory(const QFileInfo &fileInfo);
+    void runScanWorker();
+    void scanDirectory(const QFileInfo &dirInfo, bool mayBlock);
+    void publishEntries(QList<QFileInfo> &batch, bool mayBlock);
+    bool fetchParallelEntries();
+
+    std::unique_ptr<ParallelScan> parallel;
+    QList<QFileInfo> parallelEntries;   // taken from parallel->entries
+    qsizetype nextParallelEntry = 0;
+#endif
+
     std::unique_ptr<QAbstractFileEngine> engine;
 
     QFileSystemEntry dirEntry;
@@ -180,11 +238,187 @@ QDirIteratorPrivate::QDirIteratorPrivate(const QFileSystemEntry &entry, const QS
         engine.reset(QFileSystemEngine::resolveEntryAndCreateLegacyEngine(dirEntry, metaData));
     QFileInfo fileInfo(new QFileInfoPrivate(dirEntry, metaData));
 
+#ifdef QT_DIRITERATOR_PARALLEL
+    if (!engine && (iteratorFlags & QDirIterator::ParallelTraversal)
+        && (iteratorFlags & QDirIterator::Subdirectories)) {
+        startParallelScan(fileInfo);
+        return;
+    }
+#endif
+
     // Populate fields for hasNext() and next()
     pushDirectory(fileInfo);
     advance();
 }
 
+/*!
+    \internal
+*/
+QDirIteratorPrivate::~QDirIteratorPrivate()
+{
+#ifdef QT_DIRITERATOR_PARALLEL
+    if (parallel) {
+        // the scanning threads use this object, so wait for them to notice
+        QMutexLocker locker(&parallel->mutex);
+        parallel->cancelled = true;
+        parallel->entriesTaken.wakeAll();
+        while (parallel->workers)
+            parallel->stateChanged.wait(&parallel->mutex);
+    }
+#endif
+}
+
+#ifdef QT_DIRITERATOR_PARALLEL
+/*!
+    \internal
+
+    Sets up a ParallelTraversal scan of \a root. Directories are scanned by
+    up to QThreadPool::maxThreadCount() tasks on the global thread pool;
+    fetchParallelEntries() scans directories itself instead of waiting when
+    no task could be started, so the iteration makes progress even if the
+    pool is busy or the iterating thread belongs to it.
+*/
+void QDirIteratorPrivate::startParallelScan(const QFileInfo &root)
+{
+    parallel = std::make_unique<ParallelScan>();
+    parallel->maxWorkers = qMax(1, QThreadPool::globalInstance()->maxThreadCount());
+    if (iteratorFlags & QDirIterator::FollowSymlinks) {
+        // Stop link loops back to the root
+        [[maybe_unused]] const bool seen = visitedLinks.hasSeen(root.canonicalFilePath());
+    }
+
+    QMutexLocker locker(&parallel->mutex);
+    queueDirectory(root);
+}
+
+/*!
+    \internal
+
+    Adds \a fileInfo to the directories to scan, starting another worker if
+    possible. Must be called with parallel->mutex locked.
+*/
+void QDirIteratorPrivate::queueDirectory(const QFileInfo &fileInfo)
+{
+    parallel->directories.append(fileInfo);
+    if (parallel->workers < parallel->maxWorkers
+        && QThreadPool::globalInstance()->tryStart([this] { runScanWorker(); })) {
+        ++parallel->workers;
+    }
+    parallel->stateChanged.wakeAll();
+}
+
+/*!
+    \internal
+*/
+void QDirIteratorPrivate::runScanWorker()
+{
+    QMutexLocker locker(&parallel->mutex);
+    while (!parallel->cancelled && !parallel->directories.isEmpty()) {
+        const QFileInfo dirInfo = parallel->directories.takeLast();
+        ++parallel->activeScans;
+        locker.unlock();
+        scanDirectory(dirInfo, true);
+        locker.relock();
+        --parallel->activeScans;
+    }
+    --parallel->workers;
+    parallel->stateChanged.wakeAll();
+}
+
+/*!
+    \internal
+
+    Lists the directory \a dirInfo, queueing its subdirectories and
+    publishing the entries that match the filters. If \a mayBlock is \c true,
+    waits for the iterating thread when too many entries are pending.
+*/
+void QDirIteratorPrivate::scanDirectory(const QFileInfo &dirInfo, bool mayBlock)
+{
+    QFileSystemIterator it(dirInfo.d_ptr->fileEntry, filters, nameFilters, iteratorFlags);
+    QFileSystemEntry entry;
+    QFileSystemMetaData metaData;
+    QList<QFileInfo> batch;
+
+    while (!parallel->cancelled && it.advance(entry, metaData)) {
+        QFileInfo info(new QFileInfoPrivate(entry, metaData));
+        metaData = QFileSystemMetaData();
+
+        if (shouldDescendInto(info)) {
+            const bool seen = (iteratorFlags & QDirIterator::FollowSymlinks)
+                    && [&] {
+                           const QString canonical = info.canonicalFilePath();
+                           QMutexLocker locker(&parallel->mutex);
+                           return visitedLinks.hasSeen(canonical);
+                       }();
+            if (!seen) {
+                QMutexLocker locker(&parallel->mutex);
+                queueDirectory(info);
+            }
+        }
+
+        if (matchesFilters(entry.fileName(), info)) {
+            info.stat();
+            batch.append(std::move(info));
+            if (batch.size() >= ParallelScan::BatchSize)
+                publishEntries(batch, mayBlock);
+        }
+    }
+    publishEntries(batch, mayBlock);
+}
+
+/*!
+    \internal
+*/
+void QDirIteratorPrivate::publishEntries(QList<QFileInfo> &batch, bool mayBlock)
+{
+    if (batch.isEmpty())
+        return;
+
+    QMutexLocker locker(&parallel->mutex);
+    while (mayBlock && !parallel->cancelled
+           && parallel->entries.size() >= ParallelScan::MaxPendingEntries) {
+        parallel->entriesTaken.wait(&parallel->mutex);
+    }
+    parallel->entries.append(batch);
+    batch.clear();
+    parallel->stateChanged.wakeAll();
+}
+
+/*!
+    \internal
+
+    Refills parallelEntries, waiting for or helping with the scan as needed.
+    Returns \c false once all directories have been scanned and all entries
+    have been returned.
+*/
+bool QDirIteratorPrivate::fetchParallelEntries()
+{
+    parallelEntries.clear();
+    nextParallelEntry = 0;
+
+    QMutexLocker locker(&parallel->mutex);
+    while (true) {
+        if (!parallel->entries.isEmpty()) {
+            parallelEntries.swap(parallel->entries);
+            parallel->entriesTaken.wakeAll();
+            return true;
+        }
+        if (!parallel->directories.isEmpty()) {
+            const QFileInfo dirInfo = parallel->directories.takeLast();
+            ++parallel->activeScans;
+            locker.unlock();
+            scanDirectory(dirInfo, false);
+            locker.relock();
+            --parallel->activeScans;
+            continue;
+        }
+        if (!parallel->activeScans)
+            return false;
+        parallel->stateChanged.wait(&parallel->mutex);
+    }
+}
+#endif // QT_DIRITERATOR_PARALLEL
+
 /*!
     \internal
 */
@@ -286,29 +520,38 @@ void QDirIteratorPrivate::advance()
     \internal
  */
 void QDirIteratorPrivate::checkAndPushDirectory(const QFileInfo &fileInfo)
+{
+    if (shouldDescendInto(fileInfo))
+        pushDirectory(fileInfo);
+}
+
+/*!
+    \internal
+ */
+bool QDirIteratorPrivate::shouldDescendInto(const QFileInfo &fileInfo) const
 {
     // If we're doing flat iteration, we're done.
     if (!(iteratorFlags & QDirIterator::Subdirectories))
-        return;
+        return false;
 
     // Never follow non-directory entries
     if (!fileInfo.isDir())
-        return;
+        return false;
 
     // Follow symlinks only when asked
     if (!(iteratorFlags & QDirIterator::FollowSymlinks) && fileInfo.isSymLink())
-        return;
+        return false;
 
     // Never follow . and ..
     QString fileName = fileInfo.fileName();
     if (QLatin1String(".") == fileName || QLatin1String("..") == fileName)
-        return;
+        return false;
 
     // No hidden directories unless requested
     if (!(filters & QDir::AllDirs) && !(filters & QDir::Hidden) && fileInfo.isHidden())
-        return;
+        return false;
 
-    pushDirectory(fileInfo);
+    return true;
 }
 
 /*!
@@ -497,6 +740,15 @@ QDirIterator::~QDirIterator()
 */
 QString QDirIterator::next()
 {
+#ifdef QT_DIRITERATOR_PARALLEL
+    if (d->parallel) {
+        if (hasNext())
+            d->currentFileInfo = std::move(d->parallelEntries[d->nextParallelEntry++]);
+        else
+            d->currentFileInfo = QFileInfo();
+        return filePath();
+    }
+#endif
     d->advance();
     return filePath();
 }
@@ -509,6 +761,10 @@ QString QDirIterator::next()
 */
 bool QDirIterator::hasNext() const
 {
+#ifdef QT_DIRITERATOR_PARALLEL
+    if (d->parallel)
+        return d->nextParallelEntry < d->parallelEntries.size() || d->fetchParallelEntries();
+#endif
     if (d->engine)
         return !d->fileEngineIterators.isEmpty();
     else
@@ -0,0 +1,471 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qfileasyncio_p.h"
+
+#include <QtCore/qmutex.h>
+#include <QtCore/qpromise.h>
+#include <QtCore/qrunnable.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qthreadpool.h>
+#include <QtCore/qvarlengtharray.h>
+
+#include <private/qcore_unix_p.h>
+
+#include <errno.h>
+#include <limits>
+#include <memory>
+
+#if QT_CONFIG(io_uring)
+#  include <linux/io_uring.h>
+#  include <sys/eventfd.h>
+#  include <sys/mman.h>
+#  include <sys/syscall.h>
+#  include <sys/uio.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+// Linux never transfers more than this in a single read() or write()
+constexpr qint64 MaxTransferSize = 0x7ffff000;
+
+struct Request
+{
+    enum Type { Read, Write };
+
+    // takes ownership of fd, which is -1 if it could not be duplicated
+    Request(Type type, int fd, qint64 offset, const QByteArray &buffer)
+        : type(type), fd(fd), offset(offset), buffer(buffer)
+    {
+        if (type == Read)
+            readPromise.start();
+        else
+            writePromise.start();
+    }
+
+    ~Request()
+    {
+        if (fd != -1)
+            qt_safe_close(fd);
+    }
+
+    // result is the number of bytes transferred, or -errno on failure
+    void finish(qint64 result)
+    {
+        if (type == Read) {
+            if (result < 0)
+                buffer = QByteArray();
+            else
+                buffer.truncate(result);
+            readPromise.addResult(std::move(buffer));
+            readPromise.finish();
+        } else {
+            writePromise.addResult(result < 0 ? qint64(-1) : result);
+            writePromise.finish();
+        }
+    }
+
+    // Accounts for one transfer of the rest of the buffer, whose result is
+    // the number of bytes transferred or -errno. Finishes the request unless
+    // the transfer was short and the rest still has to be transferred.
+    bool advance(qint64 result)
+    {
+        if (result > 0) {
+            done += result;
+            if (done < buffer.size())
+                return false;
+        }
+        finish(result < 0 && done == 0 ? result : done);  // error or end of file
+        return true;
+    }
+
+    // don't detach the caller's data when writing
+    char *data() { return type == Read ? buffer.data() : const_cast<char *>(buffer.constData()); }
+
+    // the synchronous fallback, also used to complete a transfer that
+    // io_uring could not finish
+    void run()
+    {
+        for (;;) {
+            ssize_t ret;
+            const size_t size = size_t(buffer.size() - done);
+            if (type == Read)
+                EINTR_LOOP(ret, ::pread(fd, data() + done, size, QT_OFF_T(offset + done)));
+            else
+                EINTR_LOOP(ret, ::pwrite(fd, data() + done, size, QT_OFF_T(offset + done)));
+            if (advance(ret < 0 ? -errno : ret))
+                return;
+        }
+    }
+
+    Type type;
+    int fd;
+    qint64 offset;
+    qint64 done = 0;
+    QByteArray buffer;
+    QPromise<QByteArray> readPromise;
+    QPromise<qint64> writePromise;
+#if QT_CONFIG(io_uring)
+    iovec iov;
+#endif
+};
+
+class RequestRunnable : public QRunnable
+{
+public:
+    explicit RequestRunnable(std::unique_ptr<Request> request)
+        : request(std::move(request))
+    {}
+
+    void run() override { request->run(); }
+
+private:
+    std::unique_ptr<Request> request;
+};
+
+#if QT_CONFIG(io_uring)
+/*
+    A single ring shared by the whole process. Submitters fill in submission
+    queue entries under a mutex and wake the completion thread, which hands
+    everything queued since it last woke up to the kernel with one
+    io_uring_enter() call and then fulfills the promises of the completed
+    requests.
+*/
+class IoUring : public QThread
+{
+public:
+    IoUring();
+    ~IoUring();
+
+    bool isValid() const { return ringFd != -1; }
+    bool submit(Request *request);
+
+protected:
+    void run() override;
+
+private:
+    void reapCompletions();
+    void failUnsubmitted();
+
+    static quint32 loadAcquire(const quint32 *p) { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+    static void storeRelease(quint32 *p, quint32 v) { __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+
+    int ringFd = -1;
+    int wakeFd = -1;
+
+    void *sqRing = MAP_FAILED;
+    void *cqRing = MAP_FAILED;
+    size_t sqRingSize = 0;
+    size_t cqRingSize = 0;
+    io_uring_sqe *sqes = static_cast<io_uring_sqe *>(MAP_FAILED);
+    size_t sqesSize = 0;
+
+    quint32 *sqHead = nullptr;
+    quint32 *sqTail = nullptr;
+    quint32 *sqArray = nullptr;
+    quint32 sqMask = 0;
+    quint32 *cqHead = nullptr;
+    quint32 *cqTail = nullptr;
+    io_uring_cqe *cqes = nullptr;
+    quint32 cqMask = 0;
+    quint32 entries = 0;
+
+    QMutex mutex;
+    quint32 inFlight = 0;       // submitted but not yet completed
+    quint32 unsubmitted = 0;    // queued but not yet handed to the kernel
+    bool quitting = false;
+    bool broken = false;        // io_uring_enter() failed, don't use the ring
+};
+
+IoUring::IoUring()
+{
+    if (qEnvironmentVariableIsSet("QT_NO_IO_URING"))
+        return;
+
+    io_uring_params params = {};
+    int fd = int(syscall(__NR_io_uring_setup, 256, &params));
+    if (fd < 0)
+        return;     // not supported by the kernel, or blocked by a seccomp filter
+
+    sqRingSize = params.sq_off.array + params.sq_entries * sizeof(quint32);
+    cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+        sqRingSize = cqRingSize = qMax(sqRingSize, cqRingSize);
+    sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+
+    sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                  fd, IORING_OFF_SQ_RING);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        cqRing = sqRing;
+    } else if (sqRing != MAP_FAILED) {
+        cqRing = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      fd, IORING_OFF_CQ_RING);
+    }
+    if (cqRing != MAP_FAILED) {
+        sqes = static_cast<io_uring_sqe *>(mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE,
+                                                MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+    }
+    wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (sqes == MAP_FAILED || wakeFd == -1) {
+        qt_safe_close(fd);
+        return;
+    }
+
+    char *sq = static_cast<char *>(sqRing);
+    sqHead = reinterpret_cast<quint32 *>(sq + params.sq_off.head);
+    sqTail = reinterpret_cast<quint32 *>(sq + params.sq_off.tail);
+    sqMask = *reinterpret_cast<quint32 *>(sq + params.sq_off.ring_mask);
+    sqArray = reinterpret_cast<quint32 *>(sq + params.sq_off.array);
+    char *cq = static_cast<char *>(cqRing);
+    cqHead = reinterpret_cast<quint32 *>(cq + params.cq_off.head);
+    cqTail = reinterpret_cast<quint32 *>(cq + params.cq_off.tail);
+    cqMask = *reinterpret_cast<quint32 *>(cq + params.cq_off.ring_mask);
+    cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+    entries = params.sq_entries;
+
+    ringFd = fd;
+    setObjectName(QStringLiteral("Qt io_uring completion thread"));
+    start();
+}
+
+IoUring::~IoUring()
+{
+    if (isRunning()) {
+        {
+            QMutexLocker locker(&mutex);
+            quitting = true;
+        }
+        eventfd_write(wakeFd, 1);
+        wait();
+    }
+
+    if (sqes != MAP_FAILED)
+        munmap(sqes, sqesSize);
+    if (cqRing != MAP_FAILED && cqRing != sqRing)
+        munmap(cqRing, cqRingSize);
+    if (sqRing != MAP_FAILED)
+        munmap(sqRing, sqRingSize);
+    if (wakeFd != -1)
+        qt_safe_close(wakeFd);
+    if (ringFd != -1)
+        qt_safe_close(ringFd);
+}
+
+bool IoUring::submit(Request *request)
+{
+    QMutexLocker locker(&mutex);
+
+    // Limiting the number of requests in flight to the size of the
+    // submission queue guarantees that neither queue can overflow.
+    if (quitting || broken || inFlight == entries)
+        return false;
+
+    // what is left of the transfer, in case an earlier one was short
+    request->iov.iov_base = request->data() + request->done;
+    request->iov.iov_len = size_t(request->buffer.size() - request->done);
+
+    const quint32 tail = *sqTail;
+    const quint32 index = tail & sqMask;
+    io_uring_sqe *sqe = &sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = request->type == Request::Read ? IORING_OP_READV : IORING_OP_WRITEV;
+    sqe->fd = request->fd;
+    sqe->off = quint64(request->offset + request->done);
+    sqe->addr = quint64(quintptr(&request->iov));
+    sqe->len = 1;
+    sqe->user_data = quint64(quintptr(request));
+    sqArray[index] = index;
+    storeRelease(sqTail, tail + 1);
+
+    ++inFlight;
+    const bool wake = unsubmitted++ == 0;
+    locker.unlock();
+
+    // the completion thread picks up everything queued until it runs
+    if (wake)
+        eventfd_write(wakeFd, 1);
+    return true;
+}
+
+void IoUring::run()
+{
+    for (;;) {
+        pollfd pfds[2] = {
+            qt_make_pollfd(ringFd, POLLIN),
+            qt_make_pollfd(wakeFd, POLLIN)
+        };
+        if (qt_safe_poll(pfds, 2, nullptr) < 0)
+            continue;
+
+        if (pfds[1].revents & POLLIN) {
+            eventfd_t value;
+            eventfd_read(wakeFd, &value);
+        }
+
+        QMutexLocker locker(&mutex);
+        if (quitting && inFlight == 0)
+            return;
+        quint32 toSubmit = unsubmitted;
+        locker.unlock();
+
+        while (toSubmit) {
+            const int ret = int(syscall(__NR_io_uring_enter, ringFd, toSubmit, 0, 0, nullptr, 0));
+            if (ret < 0) {
+                if (errno == EINTR)
+                    continue;
+                // EAGAIN and EBUSY mean that completions have to be reaped
+                // first, which will wake us up again
+                if (errno != EAGAIN && errno != EBUSY) {
+                    qErrnoWarning("QFileAsyncIo: io_uring_enter failed");
+                    failUnsubmitted();
+                }
+                break;
+            }
+            locker.relock();
+            unsubmitted -= quint32(ret);
+            toSubmit = unsubmitted;
+            locker.unlock();
+        }
+
+        reapCompletions();
+    }
+}
+
+/*
+    Takes the requests that the kernel did not accept back out of the
+    submission queue and runs them synchronously instead, so that their
+    futures still finish. Later requests don't use the ring anymore.
+*/
+void IoUring::failUnsubmitted()
+{
+    QVarLengthArray<Request *, 16> requests;
+    {
+        QMutexLocker locker(&mutex);
+        broken = true;
+        // only this thread enters the ring, so the kernel is not looking
+        // at the queue right now
+        const quint32 head = loadAcquire(sqHead);
+        const quint32 tail = *sqTail;
+        for (quint32 i = head; i != tail; ++i) {
+            const io_uring_sqe &sqe = sqes[sqArray[i & sqMask]];
+            requests.append(reinterpret_cast<Request *>(quintptr(sqe.user_data)));
+        }
+        storeRelease(sqTail, head);
+        inFlight -= tail - head;
+        unsubmitted = 0;
+    }
+
+    for (Request *request : qAsConst(requests))
+        QThreadPool::globalInstance()->start(new RequestRunnable(std::unique_ptr<Request>(request)));
+}
+
+void IoUring::reapCompletions()
+{
+    const quint32 head = *cqHead;
+    const quint32 tail = loadAcquire(cqTail);
+    if (head == tail)
+        return;
+
+    // A read or write may transfer less than requested (e.g. when
+    // interrupted by a signal), without having reached the end of the file.
+    QVarLengthArray<Request *, 16> unfinished;
+    for (quint32 i = head; i != tail; ++i) {
+        const io_uring_cqe &cqe = cqes[i & cqMask];
+        std::unique_ptr<Request> request(reinterpret_cast<Request *>(quintptr(cqe.user_data)));
+        if (!request->advance(cqe.res))
+            unfinished.append(request.release());
+    }
+    storeRelease(cqHead, tail);
+
+    {
+        QMutexLocker locker(&mutex);
+        inFlight -= tail - head;
+    }
+
+    // transfer the rest like the fallback does
+    for (Request *request : qAsConst(unfinished)) {
+        if (!submit(request))
+            QThreadPool::globalInstance()->start(new RequestRunnable(std::unique_ptr<Request>(request)));
+    }
+}
+#endif // QT_CONFIG(io_uring)
+
+} // unnamed namespace
+
+#if QT_CONFIG(io_uring)
+Q_GLOBAL_STATIC(IoUring, ioUring)
+#endif
+
+static void submit(std::unique_ptr<Request> request)
+{
+    if (request->fd == -1) {
+        request->finish(-EBADF);
+        return;
+    }
+
+#if QT_CONFIG(io_uring)
+    if (IoUring *ring = ioUring(); ring && ring->isValid() && ring->submit(request.get())) {
+        request.release();  // owned by the ring until it completes
+        return;
+    }
+#endif
+    QThreadPool::globalInstance()->start(new RequestRunnable(std::move(request)));
+}
+
+QFuture<QByteArray> QFileAsyncIo::read(int fd, qint64 offset, qint64 maxSize)
+{
+    const qint64 size = qBound<qint64>(0, maxSize, MaxTransferSize);
+    auto request = std::make_unique<Request>(Request::Read, qt_safe_dup(fd), offset,
+                                             QByteArray(qsizetype(size), Qt::Uninitialized));
+    QFuture<QByteArray> future = request->readPromise.future();
+    submit(std::move(request));
+    return future;
+}
+
+QFuture<qint64> QFileAsyncIo::write(int fd, qint64 offset, const QByteArray &data)
+{
+    auto request = std::make_unique<Request>(Request::Write, qt_safe_dup(fd), offset, data);
+    QFuture<qint64> future = request->writePromise.future();
+    submit(std::move(request));
+    return future;
+}
+
+QT_END_NAMESPACE
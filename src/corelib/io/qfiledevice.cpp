@@ -42,6 +42,13 @@
 #include "qfiledevice_p.h"
 #include "qfsfileengine_p.h"
 
+#if QT_CONFIG(future)
+#  include "qfuture.h"
+#  ifdef Q_OS_UNIX
+#    include "qfileasyncio_p.h"
+#  endif
+#endif
+
 #ifdef QT_NO_QOBJECT
 #define tr(X) QString::fromLatin1(X)
 #endif
@@ -735,6 +742,98 @@ bool QFileDevice::unmap(uchar *address)
     return false;
 }
 
+#if QT_CONFIG(future)
+/*!
+    \since 6.3
+
+    Reads at most \a maxSize bytes starting at \a offset in the file without
+    blocking the calling thread, and returns a future that is fulfilled with
+    the data once it has been read. The result is empty if \a offset is at or
+    past the end of the file, and a null QByteArray if an error occurred.
+
+    The current position of the file is neither used nor changed. Pending
+    buffered writes are flushed before the read is started.
+
+    On Linux, the read is submitted through io_uring if the kernel supports
+    it; many concurrent requests are then handed to the kernel together.
+    Otherwise it runs on QThreadPool::globalInstance(). If the file has no
+    native handle, for instance because it is a Qt resource, the data is read
+    synchronously and the returned future has already finished.
+
+    Closing the file does not cancel the read; it still completes on the
+    file that was open when readAsync() was called.
+
+    \sa writeAsync(), read(), handle()
+*/
+QFuture<QByteArray> QFileDevice::readAsync(qint64 offset, qint64 maxSize)
+{
+    if (!isOpen() || !(openMode() & ReadOnly) || offset < 0 || maxSize < 0) {
+        qWarning("QFileDevice::readAsync: device not open for reading or invalid arguments");
+        return QtFuture::makeReadyFuture(QByteArray());
+    }
+
+    if (openMode() & WriteOnly)
+        flush();
+
+#ifdef Q_OS_UNIX
+    const int fd = handle();
+    if (fd != -1)
+        return QFileAsyncIo::read(fd, offset, maxSize);
+#endif
+
+    QByteArray data;
+    const qint64 oldPos = pos();
+    if (seek(offset))
+        data = read(maxSize);
+    seek(oldPos);
+    return QtFuture::makeReadyFuture(std::move(data));
+}
+
+/*!
+    \since 6.3
+
+    Writes \a data at \a offset in the file without blocking the calling
+    thread, and returns a future that is fulfilled with the number of bytes
+    that were written, or -1 if an error occurred.
+
+    The current position of the file is neither used nor changed, and the
+    write does not go through the file's write buffer. Pending buffered
+    writes are flushed before the write is started. Data that was already
+    buffered for reading is not updated.
+
+    Requests are submitted the same way as for readAsync(). Closing the file
+    does not cancel the write; it still completes on the file that was open
+    when writeAsync() was called.
+
+    \sa readAsync(), write(), handle()
+*/
+QFuture<qint64> QFileDevice::writeAsync(qint64 offset, const QByteArray &data)
+{
+    if (!isOpen() || !(openMode() & WriteOnly) || offset < 0) {
+        qWarning("QFileDevice::writeAsync: device not open for writing or invalid arguments");
+        return QtFuture::makeReadyFuture(qint64(-1));
+    }
+
+    flush();
+
+#ifdef Q_OS_UNIX
+    const int fd = handle();
+    if (fd != -1)
+        return QFileAsyncIo::write(fd, offset, data);
+#endif
+
+    qint64 written = -1;
+    const qint64 oldPos = pos();
+    if (seek(offset)) {
+        written = write(data);
+        if (!flush())
+            written = -1;
+    }
+    seek(oldPos);
+    return QtFuture::makeReadyFuture(written);
+}
+#endif // QT_CONFIG(future)
+
 /*!
     \enum QFileDevice::FileTime
     \since 5.10
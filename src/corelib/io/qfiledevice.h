@@ -47,6 +47,9 @@ QT_BEGIN_NAMESPACE
 
 class QDateTime;
 class QFileDevicePrivate;
+#if QT_CONFIG(future)
+template <typename T> class QFuture;
+#endif
 
 class Q_CORE_EXPORT QFileDevice : public QIODevice
 {
@@ -127,6 +130,11 @@ public:
     uchar *map(qint64 offset, qint64 size, MemoryMapFlags flags = NoOptions);
     bool unmap(uchar *address);
 
+#if QT_CONFIG(future)
+    QFuture<QByteArray> readAsync(qint64 offset, qint64 maxSize);
+    QFuture<qint64> writeAsync(qint64 offset, const QByteArray &data);
+#endif
+
     QDateTime fileTime(QFileDevice::FileTime time) const;
     bool setFileTime(const QDateTime &newDate, QFileDevice::FileTime fileTime);
 
@@ -42,6 +42,7 @@
 #include "qresource_p.h"
 #include "qresource_iterator_p.h"
 #include "qset.h"
+#include "qcache.h"
 #include <private/qlocking_p.h>
 #include "qdebug.h"
 #include "qlocale.h"
@@ -145,10 +146,17 @@ private:
     inline int findOffset(int node) const { return node * (14 + (version >= 0x02 ? 8 : 0)); } //sizeof each tree element
     uint hash(int node) const;
     QString name(int node) const;
+    bool nameEquals(int node, QStringView str) const;
     short flags(int node) const;
+    int findLocalizedNode(int parent, int node, const QLocale &locale) const;
+    int findNodeInIndex(QStringView path, const QLocale &locale) const;
 public:
     mutable QAtomicInt ref;
 
+    // decompressed payloads, keyed by data(); guarded by resourceMutex()
+    static constexpr qsizetype DecompressedCacheCost = 8 * 1024 * 1024;
+    mutable QCache<const uchar *, QByteArray> decompressedCache{DecompressedCacheCost};
+
     inline QResourceRoot(): tree(nullptr), names(nullptr), payloads(nullptr), version(0) {}
     inline QResourceRoot(int version, const uchar *t, const uchar *n, const uchar *d) { setSource(version, t, n, d); }
     virtual ~QResourceRoot() { }
@@ -194,8 +202,6 @@ static QString cleanPath(const QString &_path)
     return path;
 }
 
-Q_DECLARE_TYPEINFO(QResourceRoot, Q_RELOCATABLE_TYPE);
-
 typedef QList<QResourceRoot*> ResourceList;
 struct QResourceGlobalData
 {
@@ -705,8 +711,10 @@ const uchar *QResource::data() const
     compressed. If the resource is a directory or an error occurs while
     decompressing, a null QByteArray is returned.
 
-    \note If the data was compressed, this function will decompress every time
-    it is called. The result is not cached between calls.
+    \note Since Qt 6.3, the decompressed data of recently used resources is
+    cached, so calling this function repeatedly for the same resource, or
+    opening it repeatedly with QFile, shares the same buffer instead of
+    decompressing again.
 
     \sa uncompressedSize(), size(), compressionAlgorithm(), isFile()
 */
@@ -724,13 +732,25 @@ QByteArray QResource::uncompressedData() const
     if (d->compressionAlgo == NoCompression)
         return QByteArray::fromRawData(reinterpret_cast<const char *>(d->data), n);
 
+    QResourceRoot *root = d->related.constFirst();
+    {
+        const auto locker = qt_scoped_lock(resourceMutex());
+        if (const QByteArray *cached = root->decompressedCache.object(d->data))
+            return *cached;
+    }
+
     // decompress
     QByteArray result(n, Qt::Uninitialized);
     n = d->decompress(result.data(), n);
-    if (n < 0)
+    if (n < 0) {
         result.clear();
-    else
+    } else {
         result.truncate(n);
+        if (n <= QResourceRoot::DecompressedCacheCost) {
+            const auto locker = qt_scoped_lock(resourceMutex());
+            root->decompressedCache.insert(d->data, new QByteArray(result), qMax(n, qint64(1)));
+        }
+    }
     return result;
 }
 
@@ -802,6 +822,126 @@ inline QString QResourceRoot::name(int node) const
     return ret;
 }
 
+inline bool QResourceRoot::nameEquals(int node, QStringView str) const
+{
+    if (!node) // root
+        return str.isEmpty();
+    qint32 name_offset = qFromBigEndian<qint32>(tree + findOffset(node));
+    const quint16 name_length = qFromBigEndian<qint16>(names + name_offset);
+    if (name_length != str.size())
+        return false;
+    name_offset += 2;
+    name_offset += 4; // jump past hash
+
+    const uchar *name = names + name_offset;
+    for (qsizetype i = 0; i < str.size(); ++i) {
+        if (qFromBigEndian<quint16>(name + 2 * i) != str.at(i).unicode())
+            return false;
+    }
+    return true;
+}
+
+/*
+    Format version 4 stores a perfect hash of the full path of every node
+    after the tree. Its offset in the tree is stored in the otherwise unused
+    name offset of the root node; zero means that rcc did not write one.
+
+    The index starts with the number of buckets and slots, followed by one
+    seed per bucket, one node per slot (0 for an empty slot) and the parent
+    of each node. The node for a path is found in the slot selected by
+    qt_resource_index_slot() using the seed of the path's bucket. As the
+    index only holds paths that exist, the parents are then used to verify
+    that the node really is the one we are looking for.
+
+    Must match RCCResourceLibrary::writeDataIndex() in rcc.cpp.
+*/
+static inline uint qt_resource_index_slot(uint hash, uint seed, uint slotCount)
+{
+    uint h = hash ^ (seed * 0x9e3779b9U);
+    h ^= h >> 16;
+    h *= 0x85ebca6bU;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35U;
+    h ^= h >> 16;
+    return h % slotCount;
+}
+
+int QResourceRoot::findNodeInIndex(QStringView path, const QLocale &locale) const
+{
+    const qint32 index_offset = qFromBigEndian<qint32>(tree);
+    const uchar *index = tree + index_offset;
+    const quint32 bucket_count = qFromBigEndian<quint32>(index);
+    const quint32 slot_count = qFromBigEndian<quint32>(index + 4);
+    const uchar *seeds = index + 8;
+    const uchar *slot_nodes = seeds + 4 * bucket_count;
+    const uchar *parents = slot_nodes + 4 * slot_count;
+
+    while (path.startsWith(QLatin1Char('/')))
+        path = path.mid(1);
+    if (path.isEmpty() || !bucket_count || !slot_count)
+        return -1;
+
+    const uint h = qt_hash(path);
+    const quint32 seed = qFromBigEndian<quint32>(seeds + 4 * (h % bucket_count));
+    const qint32 node = qFromBigEndian<qint32>(slot_nodes + 4 * qt_resource_index_slot(h, seed, slot_count));
+    if (!node)
+        return -1;
+
+    // walk up the tree to verify that this is the node for the whole path
+    qint32 parent = node;
+    QStringView remaining = path;
+    while (true) {
+        const qsizetype slash = remaining.lastIndexOf(QLatin1Char('/'));
+        if (!nameEquals(parent, remaining.mid(slash + 1)))
+            return -1;
+        parent = qFromBigEndian<qint32>(parents + 4 * parent);
+        if (slash < 0)
+            break;
+        if (!parent)
+            return -1;
+        remaining = remaining.left(slash);
+    }
+    if (parent)
+        return -1;
+
+    if (flags(node) & Directory)
+        return node;
+    return findLocalizedNode(qFromBigEndian<qint32>(parents + 4 * node), node, locale);
+}
+
+/*
+    Picks the best match for \a locale among the siblings that have the same
+    name as \a node, using the same rules as the tree walk in findNode().
+*/
+int QResourceRoot::findLocalizedNode(int parent, int node, const QLocale &locale) const
+{
+    int offset = findOffset(parent) + 4 + 2; // jump past name and flags
+    const qint32 child_count = qFromBigEndian<qint32>(tree + offset);
+    const qint32 child = qFromBigEndian<qint32>(tree + offset + 4);
+
+    const uint h = hash(node);
+    int sub_node = node;
+    while (sub_node > child && hash(sub_node - 1) == h) // backup for collisions
+        --sub_node;
+
+    QString nodeName = name(node);
+    int result = -1;
+    for (; sub_node < child + child_count && hash(sub_node) == h; ++sub_node) {
+        if (sub_node != node && !nameEquals(sub_node, nodeName))
+            continue;
+        offset = findOffset(sub_node) + 4 + 2; // jump past name and flags
+        const qint16 territory = qFromBigEndian<qint16>(tree + offset);
+        const qint16 language = qFromBigEndian<qint16>(tree + offset + 2);
+        if (territory == locale.territory() && language == locale.language())
+            return sub_node;
+        if ((territory == QLocale::AnyTerritory && language == locale.language())
+            || (territory == QLocale::AnyTerritory && language == QLocale::C && result == -1)) {
+            result = sub_node;
+        }
+    }
+    return result;
+}
+
 int QResourceRoot::findNode(const QString &_path, const QLocale &locale) const
 {
     QString path = _path;
@@ -827,6 +967,9 @@ int QResourceRoot::findNode(const QString &_path, const QLocale &locale) const
     if (path == QLatin1String("/"))
         return 0;
 
+    if (version >= 0x04 && qFromBigEndian<qint32>(tree) != 0)
+        return findNodeInIndex(path, locale);
+
     // the root node is always first
     qint32 child_count = qFromBigEndian<qint32>(tree + 6);
     qint32 child       = qFromBigEndian<qint32>(tree + 10);
@@ -1020,7 +1163,7 @@ Q_CORE_EXPORT bool qRegisterResourceData(int version, const unsigned char *tree,
         return false;
     const auto locker = qt_scoped_lock(resourceMutex());
     ResourceList *list = resourceList();
-    if (version >= 0x01 && version <= 0x3) {
+    if (version >= 0x01 && version <= 0x4) {
         bool found = false;
         QResourceRoot res(version, tree, name, data);
         for (int i = 0; i < list->size(); ++i) {
@@ -1046,7 +1189,7 @@ Q_CORE_EXPORT bool qUnregisterResourceData(int version, const unsigned char *tre
         return false;
 
     const auto locker = qt_scoped_lock(resourceMutex());
-    if (version >= 0x01 && version <= 0x3) {
+    if (version >= 0x01 && version <= 0x4) {
         QResourceRoot res(version, tree, name, data);
         ResourceList *list = resourceList();
         for (int i = 0; i < list->size();) {
@@ -1126,7 +1269,7 @@ public:
         if (file_flags & ~acceptableFlags)
             return false;
 
-        if (version >= 0x01 && version <= 0x03) {
+        if (version >= 0x01 && version <= 0x04) {
             buffer = b;
             setSource(version, b + tree_offset, b + name_offset, b + data_offset);
             return true;
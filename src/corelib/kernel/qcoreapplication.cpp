@@ -134,6 +134,7 @@
 #endif
 
 #include <algorithm>
+#include <memory>
 
 QT_BEGIN_NAMESPACE
 
@@ -357,6 +358,8 @@ bool QCoreApplicationPrivate::is_app_closing = false;
 Q_CORE_EXPORT uint qGlobalPostedEventsCount()
 {
     QThreadData *currentThreadData = QThreadData::current();
+    const auto locker = qt_scoped_lock(currentThreadData->postEventList.mutex);
+    currentThreadData->acceptIncomingPostedEvents();
     return currentThreadData->postEventList.size() - currentThreadData->postEventList.startOffset;
 }
 
@@ -505,6 +508,7 @@ void QCoreApplicationPrivate::cleanupThreadData()
 
         // need to clear the state of the mainData, just in case a new QCoreApplication comes along.
         const auto locker = qt_scoped_lock(thisThreadData->postEventList.mutex);
+        thisThreadData->acceptIncomingPostedEvents();
         for (int i = 0; i < thisThreadData->postEventList.size(); ++i) {
             const QPostEvent &pe = thisThreadData->postEventList.at(i);
             if (pe.event) {
@@ -1496,6 +1500,7 @@ QCoreApplicationPrivate::QPostEventListLocker QCoreApplicationPrivate::lockThrea
     if (!object) {
         locker.threadData = QThreadData::current();
         locker.locker = qt_unique_lock(locker.threadData->postEventList.mutex);
+        locker.threadData->acceptIncomingPostedEvents();
         return locker;
     }
 
@@ -1518,6 +1523,7 @@ QCoreApplicationPrivate::QPostEventListLocker QCoreApplicationPrivate::lockThrea
     }
 
     Q_ASSERT(locker.threadData);
+    locker.threadData->acceptIncomingPostedEvents();
     return locker;
 }
 
@@ -1542,6 +1548,12 @@ QCoreApplicationPrivate::QPostEventListLocker QCoreApplicationPrivate::lockThrea
     details. Events with equal \a priority will be processed in the
     order posted.
 
+    Events of type QEvent::MetaCall, which are used for queued signal-slot
+    connections and QMetaObject::invokeMethod(), are never compressed and
+    are posted without locking the receiving thread's event queue. They are
+    moved into the queue, in the order they were posted, when the receiving
+    thread next processes or inspects its posted events.
+
     \threadsafe
 
     \sa sendEvent(), notify(), sendPostedEvents(), Qt::EventPriority
@@ -1556,6 +1568,46 @@ void QCoreApplication::postEvent(QObject *receiver, QEvent *event, int priority)
         return;
     }
 
+    if (event->type() == QEvent::MetaCall) {
+        QScopedPointer<QEvent> eventDeleter(event);
+        std::unique_ptr<QPostEventList::IncomingEvent> incoming(
+                    new QPostEventList::IncomingEvent{ QPostEvent(receiver, event, priority),
+                                                       nullptr });
+        eventDeleter.take();
+
+        // Register with the thread before publishing, so that a concurrent
+        // QObject::moveToThread() waits for us and then hands the event over
+        // to the new thread. If the receiver moved before we registered,
+        // follow it instead.
+        QThreadData *data = receiver->d_func()->threadData.loadAcquire();
+        int phase = 0;
+        while (data) {
+            phase = data->postEventList.beginIncomingPost();
+            QThreadData *current = receiver->d_func()->threadData.loadAcquire();
+            if (Q_LIKELY(current == data))
+                break;
+            data->postEventList.endIncomingPost(phase);
+            data = current;
+        }
+        if (!data) {
+            // posting during destruction? just delete the event to prevent a leak
+            delete event;
+            return;
+        }
+
+        Q_TRACE(QCoreApplication_postEvent_event_posted, receiver, event, event->type());
+        event->m_posted = true;
+        // the receiver's thread may deliver the event and delete the receiver
+        // as soon as it is published, so only data can be used from here on
+        const bool wasEmpty = data->postEventList.addIncomingEvent(incoming.release());
+        data->postEventList.endIncomingPost(phase);
+        if (wasEmpty) {
+            if (QAbstractEventDispatcher *dispatcher = data->eventDispatcher.loadAcquire())
+                dispatcher->wakeUp();
+        }
+        return;
+    }
+
     auto locker = QCoreApplicationPrivate::lockThreadPostEventList(receiver);
     if (!locker.threadData) {
         // posting during destruction? just delete the event to prevent a leak
@@ -1710,6 +1762,7 @@ void QCoreApplicationPrivate::sendPostedEvents(QObject *receiver, int event_type
     ++data->postEventList.recursion;
 
     auto locker = qt_unique_lock(data->postEventList.mutex);
+    data->acceptIncomingPostedEvents();
 
     // by default, we assume that the event dispatcher can go to sleep after
     // processing all events. if any new events are posted while we send
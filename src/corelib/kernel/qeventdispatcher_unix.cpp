@@ -55,6 +55,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <limits>
+
 #ifndef QT_NO_EVENTFD
 #  include <sys/eventfd.h>
 #endif
@@ -226,14 +228,155 @@ QEventDispatcherUNIXPrivate::QEventDispatcherUNIXPrivate()
 {
     if (Q_UNLIKELY(threadPipe.init() == false))
         qFatal("QEventDispatcherUNIXPrivate(): Cannot continue without a thread pipe");
+#if QT_CONFIG(epoll)
+    if (!qEnvironmentVariableIsSet("QT_NO_EPOLL"))
+        initEpoll();
+#endif
 }
 
 QEventDispatcherUNIXPrivate::~QEventDispatcherUNIXPrivate()
 {
+#if QT_CONFIG(epoll)
+    closeEpoll();
+#endif
     // cleanup timers
     qDeleteAll(timerList);
 }
 
+#if QT_CONFIG(epoll)
+// the kernel uses the same bit values for both interfaces, which lets us
+// hand epoll results to the poll()-based bookkeeping unchanged
+static_assert(EPOLLIN == POLLIN && EPOLLOUT == POLLOUT && EPOLLPRI == POLLPRI
+              && EPOLLERR == POLLERR && EPOLLHUP == POLLHUP);
+
+bool QEventDispatcherUNIXPrivate::initEpoll()
+{
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd == -1)
+        return false;
+
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.fd = threadPipe.fds[0];
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, ev.data.fd, &ev) == -1) {
+        closeEpoll();
+        return false;
+    }
+    return true;
+}
+
+void QEventDispatcherUNIXPrivate::closeEpoll()
+{
+    if (epollFd == -1)
+        return;
+    qt_safe_close(epollFd);
+    epollFd = -1;
+    epollEvents.clear();
+    invalidSocketFds.clear();
+}
+
+void QEventDispatcherUNIXPrivate::updateEpollInterest(int fd, short oldEvents, short newEvents)
+{
+    if (epollFd == -1 || oldEvents == newEvents)
+        return;
+
+    epoll_event ev = {};
+    ev.events = uint(newEvents);
+    ev.data.fd = fd;
+
+    int op = EPOLL_CTL_MOD;
+    if (!oldEvents)
+        op = EPOLL_CTL_ADD;
+    else if (!newEvents)
+        op = EPOLL_CTL_DEL;
+
+    int ret = epoll_ctl(epollFd, op, fd, &ev);
+    if (ret == -1) {
+        // The kernel drops a descriptor from the interest set when its last
+        // reference is closed, so the set may be out of sync with our
+        // bookkeeping if the fd was closed (and possibly reused) while a
+        // notifier was still registered for it.
+        if (op == EPOLL_CTL_ADD && errno == EEXIST)
+            ret = epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &ev);
+        else if (op == EPOLL_CTL_MOD && errno == ENOENT)
+            ret = epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+        else if (op == EPOLL_CTL_DEL && (errno == ENOENT || errno == EBADF))
+            ret = 0;
+    }
+
+    if (ret == -1 && errno == EBADF) {
+        // The descriptor was closed while a notifier was registered for it.
+        // The kernel has already dropped it from the interest set, so
+        // nothing would ever report it; do what poll() does with POLLNVAL.
+        if (!invalidSocketFds.contains(fd))
+            invalidSocketFds.append(fd);
+        return;
+    }
+
+    if (ret == -1) {
+        // epoll can't watch everything poll() can (e.g. regular files
+        // fail with EPERM), and poll() reports invalid descriptors, so
+        // fall back to rebuilding the pollfd array on every iteration.
+        closeEpoll();
+    }
+}
+
+int QEventDispatcherUNIXPrivate::waitForEpollEvents(const timespec *tm)
+{
+    Q_ASSERT(epollFd != -1);
+
+    int nevents = 0;
+    timespec zero = { 0, 0 };
+    if (!invalidSocketFds.isEmpty()) {
+        // may disable notifiers, which modifies the list
+        const QList<int> fds = std::exchange(invalidSocketFds, {});
+        for (int fd : fds)
+            markPendingSocketNotifiers(fd, POLLNVAL);
+        tm = &zero;
+    }
+
+    // epoll_wait only has millisecond resolution; round up so that
+    // timers never get activated before they are due
+    const auto toMsecs = [](const timespec &ts) {
+        const qint64 msecs = qint64(ts.tv_sec) * 1000 + (ts.tv_nsec + 999999) / 1000000;
+        return int(qMin(msecs, qint64(std::numeric_limits<int>::max())));
+    };
+
+    const timespec start = tm ? qt_gettime() : timespec();
+    int timeout = tm ? toMsecs(*tm) : -1;
+
+    epollEvents.resize(socketNotifiers.size() + 1);
+    int n;
+    forever {
+        n = epoll_wait(epollFd, epollEvents.data(), int(epollEvents.size()), timeout);
+        if (n != -1 || errno != EINTR)
+            break;
+        if (tm) {
+            // interrupted by a signal, wait for the rest of the timeout
+            const timespec remaining = *tm + start - qt_gettime();
+            if (remaining.tv_sec < 0)
+                return nevents;
+            timeout = toMsecs(remaining);
+        }
+    }
+    if (n == -1) {
+        perror("epoll_wait");
+        return nevents;
+    }
+
+    for (int i = 0; i < n; ++i) {
+        const epoll_event &ev = epollEvents.at(i);
+        if (ev.data.fd == threadPipe.fds[0]) {
+            pollfd pfd = qt_make_pollfd(ev.data.fd, POLLIN);
+            pfd.revents = short(ev.events);
+            nevents += threadPipe.check(pfd);
+        } else
+            markPendingSocketNotifiers(ev.data.fd, short(ev.events));
+    }
+    return nevents;
+}
+#endif // QT_CONFIG(epoll)
+
 void QEventDispatcherUNIXPrivate::setSocketNotifierPending(QSocketNotifier *notifier)
 {
     Q_ASSERT(notifier);
@@ -255,38 +398,46 @@ void QEventDispatcherUNIXPrivate::markPendingSocketNotifiers()
         if (pfd.fd < 0 || pfd.revents == 0)
             continue;
 
-        auto it = socketNotifiers.find(pfd.fd);
-        Q_ASSERT(it != socketNotifiers.end());
+        Q_ASSERT(socketNotifiers.contains(pfd.fd));
+        markPendingSocketNotifiers(pfd.fd, pfd.revents);
+    }
+
+    pollfds.clear();
+}
 
-        const QSocketNotifierSetUNIX &sn_set = it.value();
+void QEventDispatcherUNIXPrivate::markPendingSocketNotifiers(int fd, short revents)
+{
+    auto it = socketNotifiers.find(fd);
+    if (it == socketNotifiers.end())
+        return;
 
-        static const struct {
-            QSocketNotifier::Type type;
-            short flags;
-        } notifiers[] = {
-            { QSocketNotifier::Read,      POLLIN  | POLLHUP | POLLERR },
-            { QSocketNotifier::Write,     POLLOUT | POLLHUP | POLLERR },
-            { QSocketNotifier::Exception, POLLPRI | POLLHUP | POLLERR }
-        };
+    // a copy, disabling a notifier below may remove the set
+    const QSocketNotifierSetUNIX sn_set = it.value();
 
-        for (const auto &n : notifiers) {
-            QSocketNotifier *notifier = sn_set.notifiers[n.type];
+    static const struct {
+        QSocketNotifier::Type type;
+        short flags;
+    } notifiers[] = {
+        { QSocketNotifier::Read,      POLLIN  | POLLHUP | POLLERR },
+        { QSocketNotifier::Write,     POLLOUT | POLLHUP | POLLERR },
+        { QSocketNotifier::Exception, POLLPRI | POLLHUP | POLLERR }
+    };
 
-            if (!notifier)
-                continue;
+    for (const auto &n : notifiers) {
+        QSocketNotifier *notifier = sn_set.notifiers[n.type];
 
-            if (pfd.revents & POLLNVAL) {
-                qWarning("QSocketNotifier: Invalid socket %d with type %s, disabling...",
-                         it.key(), socketType(n.type));
-                notifier->setEnabled(false);
-            }
+        if (!notifier)
+            continue;
 
-            if (pfd.revents & n.flags)
-                setSocketNotifierPending(notifier);
+        if (revents & POLLNVAL) {
+            qWarning("QSocketNotifier: Invalid socket %d with type %s, disabling...",
+                     fd, socketType(n.type));
+            notifier->setEnabled(false);
         }
-    }
 
-    pollfds.clear();
+        if (revents & n.flags)
+            setSocketNotifierPending(notifier);
+    }
 }
 
 int QEventDispatcherUNIXPrivate::activateSocketNotifiers()
@@ -411,7 +562,13 @@ void QEventDispatcherUNIX::registerSocketNotifier(QSocketNotifier *notifier)
         qWarning("%s: Multiple socket notifiers for same socket %d and type %s",
                  Q_FUNC_INFO, sockfd, socketType(type));
 
+#if QT_CONFIG(epoll)
+    const short oldEvents = sn_set.events();
+    sn_set.notifiers[type] = notifier;
+    d->updateEpollInterest(sockfd, oldEvents, sn_set.events());
+#else
     sn_set.notifiers[type] = notifier;
+#endif
 }
 
 void QEventDispatcherUNIX::unregisterSocketNotifier(QSocketNotifier *notifier)
@@ -450,7 +607,13 @@ void QEventDispatcherUNIX::unregisterSocketNotifier(QSocketNotifier *notifier)
         return;
     }
 
+#if QT_CONFIG(epoll)
+    const short oldEvents = sn_set.events();
+    sn_set.notifiers[type] = nullptr;
+    d->updateEpollInterest(sockfd, oldEvents, sn_set.events());
+#else
     sn_set.notifiers[type] = nullptr;
+#endif
 
     if (sn_set.isEmpty())
         d->socketNotifiers.erase(i);
@@ -487,29 +650,39 @@ bool QEventDispatcherUNIX::processEvents(QEventLoop::ProcessEventsFlags flags)
     if (!canWait || (include_timers && d->timerList.timerWait(wait_tm)))
         tm = &wait_tm;
 
-    d->pollfds.clear();
-    d->pollfds.reserve(1 + (include_notifiers ? d->socketNotifiers.size() : 0));
-
-    if (include_notifiers)
-        for (auto it = d->socketNotifiers.cbegin(); it != d->socketNotifiers.cend(); ++it)
-            d->pollfds.append(qt_make_pollfd(it.key(), it.value().events()));
-
-    // This must be last, as it's popped off the end below
-    d->pollfds.append(d->threadPipe.prepare());
-
     int nevents = 0;
 
-    switch (qt_safe_poll(d->pollfds.data(), d->pollfds.size(), tm)) {
-    case -1:
-        perror("qt_safe_poll");
-        break;
-    case 0:
-        break;
-    default:
-        nevents += d->threadPipe.check(d->pollfds.takeLast());
+#if QT_CONFIG(epoll)
+    if (include_notifiers && d->epollFd != -1) {
+        // the interest set is kept up to date by (un)registerSocketNotifier,
+        // so only the descriptors that are actually ready are visited here
+        nevents += d->waitForEpollEvents(tm);
+        nevents += d->activateSocketNotifiers();
+    } else
+#endif
+    {
+        d->pollfds.clear();
+        d->pollfds.reserve(1 + (include_notifiers ? d->socketNotifiers.size() : 0));
+
         if (include_notifiers)
-            nevents += d->activateSocketNotifiers();
-        break;
+            for (auto it = d->socketNotifiers.cbegin(); it != d->socketNotifiers.cend(); ++it)
+                d->pollfds.append(qt_make_pollfd(it.key(), it.value().events()));
+
+        // This must be last, as it's popped off the end below
+        d->pollfds.append(d->threadPipe.prepare());
+
+        switch (qt_safe_poll(d->pollfds.data(), d->pollfds.size(), tm)) {
+        case -1:
+            perror("qt_safe_poll");
+            break;
+        case 0:
+            break;
+        default:
+            nevents += d->threadPipe.check(d->pollfds.takeLast());
+            if (include_notifiers)
+                nevents += d->activateSocketNotifiers();
+            break;
+        }
     }
 
     if (include_timers)
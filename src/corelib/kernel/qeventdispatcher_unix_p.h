@@ -58,6 +58,10 @@
 #include "QtCore/qvarlengtharray.h"
 #include "private/qtimerinfo_unix_p.h"
 
+#if QT_CONFIG(epoll)
+#  include <sys/epoll.h>
+#endif
+
 QT_BEGIN_NAMESPACE
 
 class QEventDispatcherUNIXPrivate;
@@ -135,12 +139,30 @@ public:
     int activateTimers();
 
     void markPendingSocketNotifiers();
+    void markPendingSocketNotifiers(int fd, short revents);
     int activateSocketNotifiers();
     void setSocketNotifierPending(QSocketNotifier *notifier);
 
+#if QT_CONFIG(epoll)
+    bool initEpoll();
+    void closeEpoll();
+    void updateEpollInterest(int fd, short oldEvents, short newEvents);
+    int waitForEpollEvents(const timespec *tm);
+#endif
+
     QThreadPipe threadPipe;
     QList<pollfd> pollfds;
 
+#if QT_CONFIG(epoll)
+    // persistent interest set holding the thread pipe and all socket notifiers;
+    // -1 if epoll is unavailable or was disabled, in which case poll() is used
+    int epollFd = -1;
+    QVarLengthArray<epoll_event, 64> epollEvents;
+    // descriptors epoll_ctl() rejected with EBADF; reported as POLLNVAL
+    // on the next iteration, like poll() would
+    QList<int> invalidSocketFds;
+#endif
+
     QHash<int, QSocketNotifierSetUNIX> socketNotifiers;
     QList<QSocketNotifier *> pendingNotifiers;
 
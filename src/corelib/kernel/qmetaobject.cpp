@@ -1522,6 +1522,8 @@ bool QMetaObject::invokeMethodImpl(QObject *object, QtPrivate::QSlotObjectBase *
 
     if (type == Qt::AutoConnection)
         type = receiverInSameThread ? Qt::DirectConnection : Qt::QueuedConnection;
+    else if (type == Qt::BatchedQueuedConnection)
+        type = Qt::QueuedConnection;
 
     void *argv[] = { ret };
 
@@ -2359,6 +2361,9 @@ bool QMetaMethod::invoke(QObject *object,
                          ? Qt::DirectConnection
                          : Qt::QueuedConnection;
     }
+    // a single invocation has nothing to be batched with
+    if (connectionType == Qt::BatchedQueuedConnection)
+        connectionType = Qt::QueuedConnection;
 
 #if !QT_CONFIG(thread)
     if (connectionType == Qt::BlockingQueuedConnection) {
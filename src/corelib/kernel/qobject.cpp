@@ -224,7 +224,7 @@ QObjectPrivate::~QObjectPrivate()
         }
     }
 
-    if (postedEvents)
+    if (postedEvents || thisThreadData->postEventList.hasIncomingEvents())
         QCoreApplication::removePostedEvents(q_ptr, 0);
 
     thisThreadData->deref();
@@ -637,6 +637,164 @@ void QMetaCallEvent::placeMetaCall(QObject *object)
     }
 }
 
+/*!
+    \internal
+
+    Creates an empty batch of calls for the connection \a c, whose signal
+    arguments have the types \a argumentTypes (a zero terminated list of
+    meta type ids). Must be called with signalSlotLock(\a receiver) locked.
+ */
+QBatchedMetaCallEvent::QBatchedMetaCallEvent(QObjectPrivate::Connection *c, const QObject *receiver,
+                                             const QObject *sender, int signalId,
+                                             const int *argumentTypes)
+    : QAbstractMetaCallEvent(sender, signalId),
+      connection_(c),
+      receiver_(receiver),
+      slotObj_(c->isSlotObject ? c->slotObj : nullptr),
+      callFunction_(c->isSlotObject ? nullptr : c->callFunction),
+      method_offset_(c->isSlotObject ? 0 : c->method_offset),
+      method_relative_(c->isSlotObject ? ushort(-1) : c->method_relative)
+{
+    connection_->ref();
+    if (slotObj_)
+        slotObj_->ref();
+
+    // all arguments of one emission are stored next to each other, and the
+    // emissions follow each other in the same chunk of memory
+    for (const int *t = argumentTypes; *t; ++t) {
+        const QMetaType type(*t);
+        const qsizetype align = qMax<qsizetype>(type.alignOf(), 1);
+        alignment_ = qMax(alignment_, size_t(align));
+        stride_ = (stride_ + align - 1) & ~(align - 1);
+        types_.append(type);
+        offsets_.append(stride_);
+        stride_ += type.sizeOf();
+    }
+    stride_ = (stride_ + qsizetype(alignment_) - 1) & ~(qsizetype(alignment_) - 1);
+}
+
+/*!
+    \internal
+ */
+QBatchedMetaCallEvent::~QBatchedMetaCallEvent()
+{
+    detach();
+
+    qsizetype first = 0;
+    for (const Chunk &chunk : qAsConst(chunks_)) {
+        for (qsizetype i = qMax(delivered_ - first, qsizetype(0)); i < chunk.size; ++i)
+            destroyArguments(chunk.data + i * stride_);
+        first += chunk.size;
+        ::operator delete(chunk.data, std::align_val_t(alignment_));
+    }
+    if (slotObj_)
+        slotObj_->destroyIfLastRef();
+    connection_->deref();
+}
+
+/*!
+    \internal
+
+    Copies the signal arguments \a argv to the end of the batch.
+ */
+void QBatchedMetaCallEvent::append(void **argv)
+{
+    if (stride_) {
+        if (chunks_.isEmpty() || chunks_.last().size == chunks_.last().capacity) {
+            const qsizetype capacity = chunks_.isEmpty() ? 16 : chunks_.last().capacity * 2;
+            void *data = ::operator new(size_t(capacity * stride_), std::align_val_t(alignment_));
+            chunks_.append({ static_cast<char *>(data), capacity, 0 });
+        }
+        Chunk &chunk = chunks_.last();
+        char *call = chunk.data + chunk.size * stride_;
+        for (qsizetype n = 0; n < types_.size(); ++n)
+            types_[n].construct(call + offsets_[n], argv[n + 1]);
+        ++chunk.size;
+    }
+    ++count_;
+}
+
+/*!
+    \internal
+
+    Stops the batch from accepting further emissions, waiting for the ones
+    that are still copying their arguments.
+ */
+void QBatchedMetaCallEvent::detach()
+{
+    if (detached_)
+        return;
+    detached_ = true;
+
+    {
+        QBasicMutexLocker locker(signalSlotLock(receiver_));
+        if (connection_->pendingBatch == this)
+            connection_->pendingBatch = nullptr;
+    }
+    QBasicMutexLocker locker(&mutex);
+}
+
+/*!
+    \internal
+ */
+void QBatchedMetaCallEvent::destroyArguments(char *call)
+{
+    for (qsizetype n = 0; n < types_.size(); ++n)
+        types_[n].destruct(call + offsets_[n]);
+}
+
+/*!
+    \internal
+ */
+void QBatchedMetaCallEvent::placeMetaCall(QObject *object)
+{
+    detach();
+
+    QVarLengthArray<void *, 8> args(types_.size() + 1);
+    args[0] = nullptr;
+    const auto invoke = [&] {
+        if (slotObj_) {
+            slotObj_->call(object, args.data());
+        } else if (callFunction_ && method_offset_ <= object->metaObject()->methodOffset()) {
+            callFunction_(object, QMetaObject::InvokeMetaMethod, method_relative_, args.data());
+        } else {
+            QMetaObject::metacall(object, QMetaObject::InvokeMetaMethod,
+                                  method_offset_ + method_relative_, args.data());
+        }
+    };
+
+    // a slot may delete the receiver, which would discard the remaining
+    // calls if they had been posted separately
+    QPointer<QObject> guard;
+    if (count_ > 1)
+        guard = object;
+
+    if (!stride_) {
+        while (delivered_ < count_) {
+            if (delivered_ && !guard)
+                return;
+            ++delivered_;
+            invoke();
+        }
+        return;
+    }
+
+    qsizetype first = 0;
+    for (const Chunk &chunk : qAsConst(chunks_)) {
+        for (qsizetype i = delivered_ - first; i < chunk.size; ++i) {
+            if (delivered_ && !guard)
+                return;
+            char *call = chunk.data + i * stride_;
+            for (qsizetype n = 0; n < types_.size(); ++n)
+                args[n + 1] = call + offsets_[n];
+            invoke();
+            destroyArguments(call);
+            ++delivered_;
+        }
+        first += chunk.size;
+    }
+}
+
 /*!
     \class QSignalBlocker
     \brief Exception-safe wrapper around QObject::blockSignals().
@@ -1642,6 +1800,12 @@ void QObject::moveToThread(QThread *targetThread)
     // move the object
     d_func()->setThreadData_helper(currentData, targetData);
 
+    // events posted without locking that have not been accepted yet are
+    // handed over to targetData now that the object's threadData changed,
+    // once the posters that might still have seen currentData are done
+    currentData->postEventList.waitForIncomingPosts();
+    currentData->acceptIncomingPostedEvents();
+
     locker.unlock();
 
     // now currentData can commit suicide if it wants to
@@ -2856,7 +3020,7 @@ QMetaObject::Connection QObject::connect(const QObject *sender, const char *sign
     }
 
     int *types = nullptr;
-    if ((type == Qt::QueuedConnection)
+    if ((type == Qt::QueuedConnection || type == Qt::BatchedQueuedConnection)
             && !(types = queuedConnectionTypes(signalTypes.constData(), signalTypes.size()))) {
         return QMetaObject::Connection(nullptr);
     }
@@ -2939,7 +3103,8 @@ QMetaObject::Connection QObject::connect(const QObject *sender, const QMetaMetho
     }
 
     int *types = nullptr;
-    if ((type == Qt::QueuedConnection) && !(types = queuedConnectionTypes(signal)))
+    if ((type == Qt::QueuedConnection || type == Qt::BatchedQueuedConnection)
+            && !(types = queuedConnectionTypes(signal)))
         return QMetaObject::Connection(nullptr);
 
 #ifndef QT_NO_DEBUG
@@ -3406,7 +3571,7 @@ QObjectPrivate::Connection *QMetaObjectPrivate::connect(const QObject *sender,
     type &= ~Qt::SingleShotConnection;
 
     Q_ASSERT(type >= 0);
-    Q_ASSERT(type <= 3);
+    Q_ASSERT(type <= Qt::BatchedQueuedConnection);
 
     std::unique_ptr<QObjectPrivate::Connection> c{new QObjectPrivate::Connection};
     c->sender = s;
@@ -3724,7 +3889,7 @@ private:
 
     \a signal must be in the signal index range (see QObjectPrivate::signalIndex()).
 */
-static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connection *c, void **argv)
+static const int *queuedArgumentTypes(QObject *sender, int signal, QObjectPrivate::Connection *c)
 {
     const int *argumentTypes = c->argumentTypes.loadRelaxed();
     if (!argumentTypes) {
@@ -3738,6 +3903,17 @@ static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connect
             argumentTypes = c->argumentTypes.loadRelaxed();
         }
     }
+    return argumentTypes;
+}
+
+/*!
+    \internal
+
+    \a signal must be in the signal index range (see QObjectPrivate::signalIndex()).
+*/
+static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connection *c, void **argv)
+{
+    const int *argumentTypes = queuedArgumentTypes(sender, signal, c);
     if (argumentTypes == &DIRECT_CONNECTION_ONLY) // cannot activate
         return;
     int nargs = 1; // include return type
@@ -3788,6 +3964,55 @@ static void queued_activate(QObject *sender, int signal, QObjectPrivate::Connect
     QCoreApplication::postEvent(receiver, ev);
 }
 
+/*!
+    \internal
+
+    Like queued_activate(), but adds the emission to the batch that is already
+    waiting in the receiver's event queue, if there is one.
+*/
+static void batched_activate(QObject *sender, int signal, QObjectPrivate::Connection *c, void **argv)
+{
+    if (c->isSingleShot) {
+        // nothing to batch
+        queued_activate(sender, signal, c, argv);
+        return;
+    }
+
+    const int *argumentTypes = queuedArgumentTypes(sender, signal, c);
+    if (argumentTypes == &DIRECT_CONNECTION_ONLY) // cannot activate
+        return;
+
+    QBasicMutexLocker locker(signalSlotLock(c->receiver.loadRelaxed()));
+    QObject *receiver = c->receiver.loadRelaxed();
+    if (!receiver) {
+        // the connection has been disconnected before we got the lock
+        return;
+    }
+
+    if (QBatchedMetaCallEvent *batch = c->pendingBatch) {
+        // the receiver cannot start delivering the batch before we are done
+        QBasicMutexLocker batchLocker(&batch->mutex);
+        locker.unlock();
+        batch->append(argv);
+        return;
+    }
+
+    auto batch = new QBatchedMetaCallEvent(c, receiver, sender, signal, argumentTypes);
+    locker.unlock();
+    batch->append(argv);
+
+    locker.relock();
+    if (!c->receiver.loadRelaxed()) {
+        // the connection has been disconnected while we were unlocked
+        locker.unlock();
+        delete batch;
+        return;
+    }
+
+    c->pendingBatch = batch;
+    QCoreApplication::postEvent(receiver, batch);
+}
+
 template <bool callbacks_enabled>
 void doActivate(QObject *sender, int signal_index, void **argv)
 {
@@ -3871,6 +4096,9 @@ void doActivate(QObject *sender, int signal_index, void **argv)
                 || (c->connectionType == Qt::QueuedConnection)) {
                 queued_activate(sender, signal_index, c, argv);
                 continue;
+            } else if (c->connectionType == Qt::BatchedQueuedConnection) {
+                batched_activate(sender, signal_index, c, argv);
+                continue;
 #if QT_CONFIG(thread)
             } else if (c->connectionType == Qt::BlockingQueuedConnection) {
                 if (receiverInSameThread) {
@@ -5012,7 +5240,7 @@ QMetaObject::Connection QObjectPrivate::connectImpl(const QObject *sender, int s
     type &= ~Qt::SingleShotConnection;
 
     Q_ASSERT(type >= 0);
-    Q_ASSERT(type <= 3);
+    Q_ASSERT(type <= Qt::BatchedQueuedConnection);
 
     std::unique_ptr<QObjectPrivate::Connection> c{new QObjectPrivate::Connection};
     c->sender = s;
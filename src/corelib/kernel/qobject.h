@@ -233,7 +233,8 @@ public:
                           "Return type of the slot is not compatible with the return type of the signal.");
 
         const int *types = nullptr;
-        if (type == Qt::QueuedConnection || type == Qt::BlockingQueuedConnection)
+        if (type == Qt::QueuedConnection || type == Qt::BlockingQueuedConnection
+            || type == Qt::BatchedQueuedConnection)
             types = QtPrivate::ConnectionTypes<typename SignalType::Arguments>::types();
 
         return connectImpl(sender, reinterpret_cast<void **>(&signal),
@@ -273,7 +274,8 @@ public:
                           "Return type of the slot is not compatible with the return type of the signal.");
 
         const int *types = nullptr;
-        if (type == Qt::QueuedConnection || type == Qt::BlockingQueuedConnection)
+        if (type == Qt::QueuedConnection || type == Qt::BlockingQueuedConnection
+            || type == Qt::BatchedQueuedConnection)
             types = QtPrivate::ConnectionTypes<typename SignalType::Arguments>::types();
 
         return connectImpl(sender, reinterpret_cast<void **>(&signal), context, nullptr,
@@ -312,7 +314,8 @@ public:
                           "No Q_OBJECT in the class with the signal");
 
         const int *types = nullptr;
-        if (type == Qt::QueuedConnection || type == Qt::BlockingQueuedConnection)
+        if (type == Qt::QueuedConnection || type == Qt::BlockingQueuedConnection
+            || type == Qt::BatchedQueuedConnection)
             types = QtPrivate::ConnectionTypes<typename SignalType::Arguments>::types();
 
         return connectImpl(sender, reinterpret_cast<void **>(&signal), context, nullptr,
@@ -55,11 +55,13 @@
 #include <QtCore/private/qglobal_p.h>
 #include "QtCore/qcoreevent.h"
 #include "QtCore/qlist.h"
+#include "QtCore/qmutex.h"
 #include "QtCore/qobject.h"
 #include "QtCore/qpointer.h"
 #include "QtCore/qreadwritelock.h"
 #include "QtCore/qsharedpointer.h"
 #include "QtCore/qvariant.h"
+#include "QtCore/qvarlengtharray.h"
 #include "QtCore/qproperty.h"
 #include "QtCore/private/qproperty_p.h"
 
@@ -68,6 +70,7 @@ QT_BEGIN_NAMESPACE
 class QVariant;
 class QThreadData;
 class QObjectConnectionListVector;
+class QBatchedMetaCallEvent;
 namespace QtSharedPointer { struct ExternalRefCountData; }
 
 /* for Qt Test */
@@ -169,10 +172,12 @@ public:
         ushort method_offset;
         ushort method_relative;
         signed int signal_index : 27; // In signal range (see QObjectPrivate::signalIndex())
-        ushort connectionType : 2; // 0 == auto, 1 == direct, 2 == queued, 3 == blocking
+        ushort connectionType : 3; // 0 == auto, 1 == direct, 2 == queued, 3 == blocking, 4 == batched
         ushort isSlotObject : 1;
         ushort ownArgumentTypes : 1;
         ushort isSingleShot : 1;
+        // the batch still accepting emissions, guarded by signalSlotLock(receiver)
+        QBatchedMetaCallEvent *pendingBatch = nullptr;
         Connection() : ref_(2), ownArgumentTypes(true) {
             //ref_ is 2 for the use in the internal lists, and for the use in QMetaObject::Connection
         }
@@ -611,6 +616,53 @@ private:
     alignas(void *) char prealloc_[3 * sizeof(void *) + 3 * sizeof(QMetaType)];
 };
 
+// Qt::BatchedQueuedConnection - collects the arguments of all emissions that
+// happen before the receiver gets to process the event, and delivers them
+// in one go
+class QBatchedMetaCallEvent : public QAbstractMetaCallEvent
+{
+public:
+    QBatchedMetaCallEvent(QObjectPrivate::Connection *c, const QObject *receiver,
+                          const QObject *sender, int signalId, const int *argumentTypes);
+    ~QBatchedMetaCallEvent() override;
+
+    // must be called with mutex locked
+    void append(void **argv);
+    qsizetype count() const { return count_; }
+
+    void placeMetaCall(QObject *object) override;
+
+    // guards the argument buffer while the batch is pending
+    QBasicMutex mutex;
+
+private:
+    Q_DISABLE_COPY_MOVE(QBatchedMetaCallEvent)
+
+    struct Chunk {
+        char *data;
+        qsizetype capacity;
+        qsizetype size;
+    };
+
+    void detach();
+    void destroyArguments(char *call);
+
+    QObjectPrivate::Connection *connection_;
+    const QObject *receiver_; // only used for locking
+    QtPrivate::QSlotObjectBase *slotObj_;
+    QObjectPrivate::StaticMetaCallFunction callFunction_;
+    ushort method_offset_;
+    ushort method_relative_;
+    bool detached_ = false;
+    qsizetype count_ = 0;
+    qsizetype delivered_ = 0;
+    qsizetype stride_ = 0;
+    size_t alignment_ = alignof(std::max_align_t);
+    QVarLengthArray<QMetaType, 4> types_;
+    QVarLengthArray<qsizetype, 4> offsets_;
+    QVarLengthArray<Chunk, 8> chunks_;
+};
+
 class QBoolBlocker
 {
     Q_DISABLE_COPY_MOVE(QBoolBlocker)
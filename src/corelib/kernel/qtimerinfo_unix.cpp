@@ -46,6 +46,10 @@
 #include "private/qobject_p.h"
 #include "private/qabstracteventdispatcher_p.h"
 
+#include <qvarlengtharray.h>
+
+#include <algorithm>
+
 #ifdef QTIMERINFO_DEBUG
 #  include <QDebug>
 #  include <QThread>
@@ -84,6 +88,7 @@ QTimerInfoList::QTimerInfoList()
 #endif
 
     firstTimerInfo = nullptr;
+    nextSequence = 0;
 }
 
 timespec QTimerInfoList::updateCurrentTime()
@@ -170,18 +175,129 @@ void QTimerInfoList::repairTimersIfNeeded()
 
 #endif
 
+/*
+  Timers are ordered by timeout; timers with the same timeout fire in the
+  order they were (re)inserted, like they did when the list was sorted.
+*/
+static inline bool timerLessThan(const QTimerInfo *t1, const QTimerInfo *t2)
+{
+    if (t1->timeout < t2->timeout)
+        return true;
+    if (t2->timeout < t1->timeout)
+        return false;
+    return t1->sequence < t2->sequence;
+}
+
+void QTimerInfoList::siftUp(qsizetype index)
+{
+    QTimerInfo **heap = data();
+    QTimerInfo *t = heap[index];
+    while (index > 0) {
+        const qsizetype parent = (index - 1) / 2;
+        if (!timerLessThan(t, heap[parent]))
+            break;
+        heap[index] = heap[parent];
+        heap[index]->heapIndex = index;
+        index = parent;
+    }
+    heap[index] = t;
+    t->heapIndex = index;
+}
+
+void QTimerInfoList::siftDown(qsizetype index)
+{
+    QTimerInfo **heap = data();
+    const qsizetype count = size();
+    QTimerInfo *t = heap[index];
+    for (;;) {
+        qsizetype child = 2 * index + 1;
+        if (child >= count)
+            break;
+        if (child + 1 < count && timerLessThan(heap[child + 1], heap[child]))
+            ++child;
+        if (!timerLessThan(heap[child], t))
+            break;
+        heap[index] = heap[child];
+        heap[index]->heapIndex = index;
+        index = child;
+    }
+    heap[index] = t;
+    t->heapIndex = index;
+}
+
 /*
   insert timer info into list
 */
 void QTimerInfoList::timerInsert(QTimerInfo *ti)
 {
-    int index = size();
-    while (index--) {
-        const QTimerInfo * const t = at(index);
-        if (!(ti->timeout < t->timeout))
-            break;
+    ti->sequence = nextSequence++;
+    ti->heapIndex = size();
+    append(ti);
+    siftUp(ti->heapIndex);
+}
+
+/*
+  remove timer info from list, without deleting it
+*/
+void QTimerInfoList::timerRemove(QTimerInfo *ti)
+{
+    const qsizetype index = ti->heapIndex;
+    Q_ASSERT(at(index) == ti);
+    QTimerInfo *last = takeLast();
+    if (last == ti)
+        return;
+    data()[index] = last;
+    last->heapIndex = index;
+    siftDown(index);
+    siftUp(last->heapIndex);
+}
+
+/*
+  Returns the earliest timer that is not currently being activated, or null.
+  Only timers being activated are descended into, since any other timer is
+  earlier than everything below it in the heap.
+*/
+QTimerInfo *QTimerInfoList::firstInactiveTimer() const
+{
+    QTimerInfo *first = nullptr;
+    QVarLengthArray<qsizetype, 32> pending;
+    if (!isEmpty())
+        pending.append(0);
+    while (!pending.isEmpty()) {
+        const qsizetype index = pending.last();
+        pending.removeLast();
+        QTimerInfo *t = at(index);
+        if (first && !timerLessThan(t, first))
+            continue;
+        if (!t->activateRef) {
+            first = t;
+            continue;
+        }
+        for (qsizetype child = 2 * index + 1; child <= 2 * index + 2 && child < size(); ++child)
+            pending.append(child);
     }
-    insert(index+1, ti);
+    return first;
+}
+
+/*
+  Returns the number of timers whose timeout is not after \a currentTime.
+*/
+int QTimerInfoList::countExpiredTimers(timespec currentTime) const
+{
+    int expired = 0;
+    QVarLengthArray<qsizetype, 32> pending;
+    if (!isEmpty())
+        pending.append(0);
+    while (!pending.isEmpty()) {
+        const qsizetype index = pending.last();
+        pending.removeLast();
+        if (currentTime < at(index)->timeout)
+            continue;
+        ++expired;
+        for (qsizetype child = 2 * index + 1; child <= 2 * index + 2 && child < size(); ++child)
+            pending.append(child);
+    }
+    return expired;
 }
 
 inline timespec &operator+=(timespec &t1, int ms)
@@ -385,14 +501,7 @@ bool QTimerInfoList::timerWait(timespec &tm)
     repairTimersIfNeeded();
 
     // Find first waiting timer not already active
-    QTimerInfo *t = nullptr;
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (!(*it)->activateRef) {
-            t = *it;
-            break;
-        }
-    }
-
+    QTimerInfo *t = firstInactiveTimer();
     if (!t)
       return false;
 
@@ -419,16 +528,13 @@ int QTimerInfoList::timerRemainingTime(int timerId)
     repairTimersIfNeeded();
     timespec tm = {0, 0};
 
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            if (currentTime < t->timeout) {
-                // time to wait
-                tm = roundToMillisecond(t->timeout - currentTime);
-                return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
-            } else {
-                return 0;
-            }
+    if (const QTimerInfo *t = timersById.value(timerId)) {
+        if (currentTime < t->timeout) {
+            // time to wait
+            tm = roundToMillisecond(t->timeout - currentTime);
+            return tm.tv_sec*1000 + tm.tv_nsec/1000/1000;
+        } else {
+            return 0;
         }
     }
 
@@ -490,6 +596,8 @@ void QTimerInfoList::registerTimer(int timerId, qint64 interval, Qt::TimerType t
     }
 
     timerInsert(t);
+    timersById.insert(timerId, t);
+    timersByObject.insert(object, t);
 
 #ifdef QTIMERINFO_DEBUG
     t->expected = expected;
@@ -504,56 +612,54 @@ void QTimerInfoList::registerTimer(int timerId, qint64 interval, Qt::TimerType t
 bool QTimerInfoList::unregisterTimer(int timerId)
 {
     // set timer inactive
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->id == timerId) {
-            // found it
-            removeAt(i);
-            if (t == firstTimerInfo)
-                firstTimerInfo = nullptr;
-            if (t->activateRef)
-                *(t->activateRef) = nullptr;
-            delete t;
-            return true;
-        }
+    QTimerInfo *t = timersById.take(timerId);
+    if (!t) {
+        // id not found
+        return false;
     }
-    // id not found
-    return false;
+
+    timersByObject.remove(t->obj, t);
+    timerRemove(t);
+    if (t == firstTimerInfo)
+        firstTimerInfo = nullptr;
+    if (t->activateRef)
+        *(t->activateRef) = nullptr;
+    delete t;
+    return true;
 }
 
 bool QTimerInfoList::unregisterTimers(QObject *object)
 {
     if (isEmpty())
         return false;
-    for (int i = 0; i < count(); ++i) {
-        QTimerInfo *t = at(i);
-        if (t->obj == object) {
-            // object found
-            removeAt(i);
-            if (t == firstTimerInfo)
-                firstTimerInfo = nullptr;
-            if (t->activateRef)
-                *(t->activateRef) = nullptr;
-            delete t;
-            // move back one so that we don't skip the new current item
-            --i;
-        }
+    const QList<QTimerInfo *> timers = timersByObject.values(object);
+    timersByObject.remove(object);
+    for (QTimerInfo *t : timers) {
+        timersById.remove(t->id);
+        timerRemove(t);
+        if (t == firstTimerInfo)
+            firstTimerInfo = nullptr;
+        if (t->activateRef)
+            *(t->activateRef) = nullptr;
+        delete t;
     }
     return true;
 }
 
 QList<QAbstractEventDispatcher::TimerInfo> QTimerInfoList::registeredTimers(QObject *object) const
 {
+    // report the timers in the order in which they will fire
+    QList<QTimerInfo *> timers = timersByObject.values(object);
+    std::sort(timers.begin(), timers.end(), timerLessThan);
+
     QList<QAbstractEventDispatcher::TimerInfo> list;
-    for (int i = 0; i < count(); ++i) {
-        const QTimerInfo * const t = at(i);
-        if (t->obj == object) {
-            list << QAbstractEventDispatcher::TimerInfo(t->id,
-                                                        (t->timerType == Qt::VeryCoarseTimer
-                                                         ? t->interval * 1000
-                                                         : t->interval),
-                                                        t->timerType);
-        }
+    list.reserve(timers.size());
+    for (const QTimerInfo * const t : qAsConst(timers)) {
+        list << QAbstractEventDispatcher::TimerInfo(t->id,
+                                                    (t->timerType == Qt::VeryCoarseTimer
+                                                     ? t->interval * 1000
+                                                     : t->interval),
+                                                    t->timerType);
     }
     return list;
 }
@@ -575,11 +681,7 @@ int QTimerInfoList::activateTimers()
 
 
     // Find out how many timer have expired
-    for (QTimerInfoList::const_iterator it = constBegin(); it != constEnd(); ++it) {
-        if (currentTime < (*it)->timeout)
-            break;
-        maxCount++;
-    }
+    maxCount = countExpiredTimers(currentTime);
 
     //fire the timers.
     while (maxCount--) {
@@ -600,9 +702,6 @@ int QTimerInfoList::activateTimers()
             firstTimerInfo = currentTimerInfo;
         }
 
-        // remove from list
-        removeFirst();
-
 #ifdef QTIMERINFO_DEBUG
         float diff;
         if (currentTime < currentTimerInfo->expected) {
@@ -626,8 +725,10 @@ int QTimerInfoList::activateTimers()
         // determine next timeout time
         calculateNextTimeout(currentTimerInfo, currentTime);
 
-        // reinsert timer
-        timerInsert(currentTimerInfo);
+        // reinsert timer; it is still at the top of the heap, so moving
+        // it down to its new position is all that is needed
+        currentTimerInfo->sequence = nextSequence++;
+        siftDown(0);
         if (currentTimerInfo->interval > 0)
             n_act++;
 
@@ -1,4 +1,5 @@
 qt_commandline_option(doubleconversion TYPE enum VALUES no qt system)
+qt_commandline_option(epoll TYPE boolean)
 qt_commandline_option(eventfd TYPE boolean)
 qt_commandline_option(glib TYPE boolean)
 qt_commandline_option(icu TYPE boolean)
@@ -44,6 +44,7 @@
 #include <qstringlist.h>
 #include <qvariant.h>
 #include <qdebug.h>
+#include <qmutex.h>
 #include <qcbormap.h>
 #include <qcborarray.h>
 #include "qcborvalue_p.h"
@@ -97,6 +98,14 @@ public:
     char *rawData = nullptr;
     uint rawDataSize = 0;
 
+    // the validated text of a document parsed with ParseOnDemand. It is
+    // only replaced by non-const functions: const ones may be called from
+    // several threads at once, and only ever add 'value' next to it.
+    QByteArray json;
+    QCborValue::Type jsonType = QCborValue::Invalid;
+    QBasicMutex materializeMutex;
+    QAtomicInt materialized;    // 'value' holds the parsed 'json'
+
     void clearRawData()
     {
         if (rawData) {
@@ -104,6 +113,54 @@ public:
             rawData = nullptr;
             rawDataSize = 0;
         }
+        json = QByteArray();
+        materialized.storeRelaxed(0);
+    }
+
+    void assign(const QJsonDocumentPrivate &other)
+    {
+        if (other.isOnDemand()) {
+            value = QCborValue();
+            json = other.json;
+            jsonType = other.jsonType;
+        } else {
+            value = other.value;
+            json = QByteArray();
+        }
+        materialized.storeRelaxed(0);
+    }
+
+    bool isOnDemand() const { return !json.isNull() && !materialized.loadAcquire(); }
+    QCborValue::Type type() const { return isOnDemand() ? jsonType : value.type(); }
+
+    // Called from const functions, possibly in several threads at once.
+    void materialize()
+    {
+        if (!isOnDemand())
+            return;
+        const QMutexLocker locker(&materializeMutex);
+        if (materialized.loadRelaxed())
+            return;
+        QJsonPrivate::Parser parser(json.constData(), json.length());
+        value = parser.parse(nullptr);
+        materialized.storeRelease(1);
+    }
+
+    template <typename String>
+    QCborValue memberValue(String key) const
+    {
+        if (!isOnDemand())
+            return value.toMap().value(key);
+        QJsonPrivate::Parser parser(json.constData(), json.length());
+        return parser.memberValue(key);
+    }
+
+    QCborValue elementValue(qsizetype i) const
+    {
+        if (!isOnDemand())
+            return value.toArray().at(i);
+        QJsonPrivate::Parser parser(json.constData(), json.length());
+        return parser.elementValue(i);
     }
 };
 
@@ -157,7 +214,7 @@ QJsonDocument::QJsonDocument(const QJsonDocument &other)
     if (other.d) {
         if (!d)
             d = std::make_unique<QJsonDocumentPrivate>();
-        d->value = other.d->value;
+        d->assign(*other.d);
     } else {
         d.reset();
     }
@@ -185,7 +242,7 @@ QJsonDocument &QJsonDocument::operator =(const QJsonDocument &other)
                 d = std::make_unique<QJsonDocumentPrivate>();
             else
                 d->clearRawData();
-            d->value = other.d->value;
+            d->assign(*other.d);
         } else {
             d.reset();
         }
@@ -259,6 +316,7 @@ QVariant QJsonDocument::toVariant() const
     if (!d)
         return QVariant();
 
+    d->materialize();
     QCborContainerPrivate *container = QJsonPrivate::Value::container(d->value);
     if (d->value.isArray())
         return QJsonArray(container).toVariantList();
@@ -292,6 +350,7 @@ QByteArray QJsonDocument::toJson(JsonFormat format) const
     if (!d)
         return json;
 
+    d->materialize();
     const QCborContainerPrivate *container = QJsonPrivate::Value::container(d->value);
     if (d->value.isArray())
         QJsonPrivate::Writer::arrayToJson(container, json, 0, (format == Compact));
@@ -313,9 +372,64 @@ QByteArray QJsonDocument::toJson(JsonFormat format) const
  \sa toJson(), QJsonParseError, isNull()
  */
 QJsonDocument QJsonDocument::fromJson(const QByteArray &json, QJsonParseError *error)
+{
+    return fromJson(json, error, ParseEagerly);
+}
+
+/*!
+    \enum QJsonDocument::ParseMode
+    \since 6.3
+
+    This value defines when fromJson() builds the values of a document.
+
+    \value ParseEagerly The whole document is converted to its in-memory
+    representation while parsing. This is the default.
+
+    \value ParseOnDemand The document is only validated while parsing. Looking
+    up a single member or element of the top-level object or array through
+    operator[]() parses just that value; the whole document is converted the
+    first time it is needed as a whole, for instance by object(), array(),
+    toVariant() or toJson().
+*/
+
+/*!
+    \overload
+    \since 6.3
+
+    Parses \a json as a UTF-8 encoded JSON document using the parse \a mode,
+    and creates a QJsonDocument from it.
+
+    Errors are reported the same way in both modes: if \a json is not a valid
+    JSON document, the returned document is null and the optional \a error
+    variable contains further details.
+
+    ParseOnDemand is useful for large documents of which only a few members
+    are read. Since every lookup through operator[]() scans the document text
+    again, retrieve the object() or array() instead when accessing many
+    values. An on-demand document converts itself once, the first time one
+    of them is called; like for any other document, const functions can be
+    called from several threads at once.
+
+    \sa ParseMode, operator[]()
+ */
+QJsonDocument QJsonDocument::fromJson(const QByteArray &json, QJsonParseError *error,
+                                      ParseMode mode)
 {
     QJsonPrivate::Parser parser(json.constData(), json.length());
     QJsonDocument result;
+    if (mode == ParseOnDemand) {
+        const QCborValue::Type type = parser.validate(error);
+        if (type == QCborValue::Array || type == QCborValue::Map) {
+            result.d = std::make_unique<QJsonDocumentPrivate>();
+            result.d->json = json;
+            // don't hold on to data from QByteArray::fromRawData()
+            if (!result.d->json.data_ptr().isMutable())
+                result.d->json.detach();
+            result.d->jsonType = type;
+        }
+        return result;
+    }
+
     const QCborValue val = parser.parse(error);
     if (val.isArray() || val.isMap()) {
         result.d = std::make_unique<QJsonDocumentPrivate>();
@@ -345,7 +459,7 @@ bool QJsonDocument::isArray() const
     if (!d)
         return false;
 
-    return d->value.isArray();
+    return d->type() == QCborValue::Array;
 }
 
 /*!
@@ -358,7 +472,7 @@ bool QJsonDocument::isObject() const
     if (!d)
         return false;
 
-    return d->value.isMap();
+    return d->type() == QCborValue::Map;
 }
 
 /*!
@@ -372,6 +486,7 @@ bool QJsonDocument::isObject() const
 QJsonObject QJsonDocument::object() const
 {
     if (isObject()) {
+        d->materialize();
         if (auto container = QJsonPrivate::Value::container(d->value))
             return QJsonObject(container);
     }
@@ -389,6 +504,7 @@ QJsonObject QJsonDocument::object() const
 QJsonArray QJsonDocument::array() const
 {
     if (isArray()) {
+        d->materialize();
         if (auto container = QJsonPrivate::Value::container(d->value))
             return QJsonArray(container);
     }
@@ -453,7 +569,7 @@ const QJsonValue QJsonDocument::operator[](QStringView key) const
     if (!isObject())
         return QJsonValue(QJsonValue::Undefined);
 
-    return QJsonPrivate::Value::fromTrustedCbor(d->value.toMap().value(key));
+    return QJsonPrivate::Value::fromTrustedCbor(d->memberValue(key));
 }
 
 /*!
@@ -465,7 +581,7 @@ const QJsonValue QJsonDocument::operator[](QLatin1String key) const
     if (!isObject())
         return QJsonValue(QJsonValue::Undefined);
 
-    return QJsonPrivate::Value::fromTrustedCbor(d->value.toMap().value(key));
+    return QJsonPrivate::Value::fromTrustedCbor(d->memberValue(key));
 }
 
 /*!
@@ -485,7 +601,7 @@ const QJsonValue QJsonDocument::operator[](qsizetype i) const
     if (!isArray())
         return QJsonValue(QJsonValue::Undefined);
 
-    return QJsonPrivate::Value::fromTrustedCbor(d->value.toArray().at(i));
+    return QJsonPrivate::Value::fromTrustedCbor(d->elementValue(i));
 }
 
 /*!
@@ -493,8 +609,11 @@ const QJsonValue QJsonDocument::operator[](qsizetype i) const
  */
 bool QJsonDocument::operator==(const QJsonDocument &other) const
 {
-    if (d && other.d)
+    if (d && other.d) {
+        d->materialize();
+        other.d->materialize();
         return d->value == other.d->value;
+    }
     return !d == !other.d;
 }
 
@@ -526,6 +645,7 @@ QDebug operator<<(QDebug dbg, const QJsonDocument &o)
         dbg << "QJsonDocument()";
         return dbg;
     }
+    o.d->materialize();
     QByteArray json;
     const QCborContainerPrivate *container = QJsonPrivate::Value::container(o.d->value);
     if (o.d->value.isArray())
@@ -114,7 +114,13 @@ public:
         Compact
     };
 
+    enum ParseMode {
+        ParseEagerly,
+        ParseOnDemand
+    };
+
     static QJsonDocument fromJson(const QByteArray &json, QJsonParseError *error = nullptr);
+    static QJsonDocument fromJson(const QByteArray &json, QJsonParseError *error, ParseMode mode);
 
 #if !defined(QT_JSON_READONLY) || defined(Q_CLANG_QDOC)
     QByteArray toJson(JsonFormat format = Indented) const;
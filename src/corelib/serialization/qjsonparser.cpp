@@ -47,6 +47,7 @@
 #include "private/qstringconverter_p.h"
 #include "private/qcborvalue_p.h"
 #include "private/qnumeric_p.h"
+#include "private/qsimd_p.h"
 
 //#define PARSER_DEBUG
 #ifdef PARSER_DEBUG
@@ -272,6 +273,162 @@ enum {
     Quote = 0x22
 };
 
+/*
+    The tokenizer spends most of its time looking for the next "interesting"
+    byte: the end of a run of whitespace, the end of a run of plain ASCII
+    characters inside a string, or the next structural character when
+    skipping a value. The scanners below test 16 (or 32, with AVX2) bytes at
+    a time and fall back to a byte-wise loop for the tail.
+*/
+namespace {
+struct NonSpace
+{
+    static bool matches(uchar c)
+    { return c != Space && c != Tab && c != LineFeed && c != Return; }
+#ifdef __SSE2__
+    static __m128i matches(__m128i data)
+    {
+        const __m128i space = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(data, _mm_set1_epi8(Space)),
+                                                        _mm_cmpeq_epi8(data, _mm_set1_epi8(Tab))),
+                                           _mm_or_si128(_mm_cmpeq_epi8(data, _mm_set1_epi8(LineFeed)),
+                                                        _mm_cmpeq_epi8(data, _mm_set1_epi8(Return))));
+        return _mm_xor_si128(space, _mm_set1_epi8(char(0xff)));
+    }
+#endif
+#ifdef __AVX2__
+    static __m256i matches(__m256i data)
+    {
+        const __m256i space = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(data, _mm256_set1_epi8(Space)),
+                                                              _mm256_cmpeq_epi8(data, _mm256_set1_epi8(Tab))),
+                                              _mm256_or_si256(_mm256_cmpeq_epi8(data, _mm256_set1_epi8(LineFeed)),
+                                                              _mm256_cmpeq_epi8(data, _mm256_set1_epi8(Return))));
+        return _mm256_xor_si256(space, _mm256_set1_epi8(char(0xff)));
+    }
+#endif
+#if defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64)
+    static uint8x16_t matches(uint8x16_t data)
+    {
+        const uint8x16_t space = vorrq_u8(vorrq_u8(vceqq_u8(data, vdupq_n_u8(Space)),
+                                                   vceqq_u8(data, vdupq_n_u8(Tab))),
+                                          vorrq_u8(vceqq_u8(data, vdupq_n_u8(LineFeed)),
+                                                   vceqq_u8(data, vdupq_n_u8(Return))));
+        return vmvnq_u8(space);
+    }
+#endif
+};
+
+// a quotation mark, a backslash or, if NonAscii is set, the lead byte of a
+// multi-byte UTF-8 sequence
+template <bool NonAscii>
+struct StringSpecial
+{
+    static bool matches(uchar c)
+    { return c == Quote || c == '\\' || (NonAscii && c >= 0x80); }
+#ifdef __SSE2__
+    static __m128i matches(__m128i data)
+    {
+        __m128i result = _mm_or_si128(_mm_cmpeq_epi8(data, _mm_set1_epi8(Quote)),
+                                      _mm_cmpeq_epi8(data, _mm_set1_epi8('\\')));
+        if (NonAscii)
+            result = _mm_or_si128(result, _mm_cmplt_epi8(data, _mm_setzero_si128()));
+        return result;
+    }
+#endif
+#ifdef __AVX2__
+    static __m256i matches(__m256i data)
+    {
+        __m256i result = _mm256_or_si256(_mm256_cmpeq_epi8(data, _mm256_set1_epi8(Quote)),
+                                         _mm256_cmpeq_epi8(data, _mm256_set1_epi8('\\')));
+        if (NonAscii)
+            result = _mm256_or_si256(result, _mm256_cmpgt_epi8(_mm256_setzero_si256(), data));
+        return result;
+    }
+#endif
+#if defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64)
+    static uint8x16_t matches(uint8x16_t data)
+    {
+        uint8x16_t result = vorrq_u8(vceqq_u8(data, vdupq_n_u8(Quote)),
+                                     vceqq_u8(data, vdupq_n_u8('\\')));
+        if (NonAscii)
+            result = vorrq_u8(result, vcgeq_u8(data, vdupq_n_u8(0x80)));
+        return result;
+    }
+#endif
+};
+
+// a quotation mark or one of the brackets and braces; '[' and '{' as well as
+// ']' and '}' only differ in bit 5
+struct Structural
+{
+    static bool matches(uchar c)
+    { return c == Quote || (c | 0x20) == BeginObject || (c | 0x20) == EndObject; }
+#ifdef __SSE2__
+    static __m128i matches(__m128i data)
+    {
+        const __m128i folded = _mm_or_si128(data, _mm_set1_epi8(0x20));
+        return _mm_or_si128(_mm_cmpeq_epi8(data, _mm_set1_epi8(Quote)),
+                            _mm_or_si128(_mm_cmpeq_epi8(folded, _mm_set1_epi8(BeginObject)),
+                                         _mm_cmpeq_epi8(folded, _mm_set1_epi8(EndObject))));
+    }
+#endif
+#ifdef __AVX2__
+    static __m256i matches(__m256i data)
+    {
+        const __m256i folded = _mm256_or_si256(data, _mm256_set1_epi8(0x20));
+        return _mm256_or_si256(_mm256_cmpeq_epi8(data, _mm256_set1_epi8(Quote)),
+                               _mm256_or_si256(_mm256_cmpeq_epi8(folded, _mm256_set1_epi8(BeginObject)),
+                                               _mm256_cmpeq_epi8(folded, _mm256_set1_epi8(EndObject))));
+    }
+#endif
+#if defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64)
+    static uint8x16_t matches(uint8x16_t data)
+    {
+        const uint8x16_t folded = vorrq_u8(data, vdupq_n_u8(0x20));
+        return vorrq_u8(vceqq_u8(data, vdupq_n_u8(Quote)),
+                        vorrq_u8(vceqq_u8(folded, vdupq_n_u8(BeginObject)),
+                                 vceqq_u8(folded, vdupq_n_u8(EndObject))));
+    }
+#endif
+};
+} // unnamed namespace
+
+// returns the first position in [ptr, end) whose byte is matched by Matcher, or end
+template <typename Matcher>
+static inline const char *scanForward(const char *ptr, const char *end)
+{
+#if defined(__AVX2__) && !defined(__OPTIMIZE_SIZE__)
+    for (; end - ptr >= 32; ptr += 32) {
+        const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ptr));
+        const uint mask = uint(_mm256_movemask_epi8(Matcher::matches(data)));
+        if (mask)
+            return ptr + qCountTrailingZeroBits(mask);
+    }
+#endif
+#if defined(__SSE2__)
+    for (; end - ptr >= 16; ptr += 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr));
+        const uint mask = uint(_mm_movemask_epi8(Matcher::matches(data)));
+        if (mask)
+            return ptr + qCountTrailingZeroBits(mask);
+    }
+#elif defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64)
+    const uint8x16_t vmask = { 1, 1 << 1, 1 << 2, 1 << 3, 1 << 4, 1 << 5, 1 << 6, 1 << 7,
+                               1, 1 << 1, 1 << 2, 1 << 3, 1 << 4, 1 << 5, 1 << 6, 1 << 7 };
+    for (; end - ptr >= 16; ptr += 16) {
+        const uint8x16_t data = vld1q_u8(reinterpret_cast<const uint8_t *>(ptr));
+        const uint8x16_t bits = vandq_u8(Matcher::matches(data), vmask);
+        const uint mask = vaddv_u8(vget_low_u8(bits)) | (uint(vaddv_u8(vget_high_u8(bits))) << 8);
+        if (mask)
+            return ptr + qCountTrailingZeroBits(mask);
+    }
+#endif
+    for (; ptr < end; ++ptr) {
+        if (Matcher::matches(uchar(*ptr)))
+            return ptr;
+    }
+    return end;
+}
+
 void Parser::eatBOM()
 {
     // eat UTF-8 byte order mark
@@ -285,16 +442,10 @@ void Parser::eatBOM()
 
 bool Parser::eatSpace()
 {
-    while (json < end) {
-        if (*json > Space)
-            break;
-        if (*json != Space &&
-            *json != Tab &&
-            *json != LineFeed &&
-            *json != Return)
-            break;
-        ++json;
-    }
+    // compact JSON has no whitespace between tokens, so check the first byte
+    // before starting a vectorized scan
+    if (json < end && !NonSpace::matches(uchar(*json)))
+        json = scanForward<NonSpace>(json + 1, end);
     return (json < end);
 }
 
@@ -335,17 +486,21 @@ QCborValue Parser::parse(QJsonParseError *error)
 
     DEBUG << Qt::hex << (uint)token;
     if (token == BeginArray) {
-        container = new QCborContainerPrivate;
+        if (!validateOnly)
+            container = new QCborContainerPrivate;
         if (!parseArray())
             goto error;
-        data = QCborContainerPrivate::makeValue(QCborValue::Array, -1, container.take(),
-                                                QCborContainerPrivate::MoveContainer);
+        if (!validateOnly)
+            data = QCborContainerPrivate::makeValue(QCborValue::Array, -1, container.take(),
+                                                    QCborContainerPrivate::MoveContainer);
     } else if (token == BeginObject) {
-        container = new QCborContainerPrivate;
+        if (!validateOnly)
+            container = new QCborContainerPrivate;
         if (!parseObject())
             goto error;
-        data = QCborContainerPrivate::makeValue(QCborValue::Map, -1, container.take(),
-                                                QCborContainerPrivate::MoveContainer);
+        if (!validateOnly)
+            data = QCborContainerPrivate::makeValue(QCborValue::Map, -1, container.take(),
+                                                    QCborContainerPrivate::MoveContainer);
     } else {
         lastError = QJsonParseError::IllegalValue;
         goto error;
@@ -379,6 +534,162 @@ error:
     return QCborValue();
 }
 
+/*
+    Checks that the text is a well-formed JSON document without building any
+    containers. Returns the type of the top-level value, QCborValue::Array or
+    QCborValue::Map, or QCborValue::Invalid if parsing failed.
+*/
+QCborValue::Type Parser::validate(QJsonParseError *error)
+{
+    validateOnly = true;
+    parse(error);
+    validateOnly = false;
+    if (lastError != QJsonParseError::NoError)
+        return QCborValue::Invalid;
+
+    // the first token of a valid document opens the top-level container
+    json = head;
+    eatBOM();
+    eatSpace();
+    return *json == BeginArray ? QCborValue::Array : QCborValue::Map;
+}
+
+/*
+    The functions below look up a single value of a document that has already
+    been validated, materializing only that value. Everything else is skipped
+    by looking at the structural characters only.
+*/
+QCborValue Parser::memberValue(QStringView key)
+{
+    return lookupMember(key);
+}
+
+QCborValue Parser::memberValue(QLatin1String key)
+{
+    return lookupMember(key);
+}
+
+template <typename String>
+QCborValue Parser::lookupMember(String key)
+{
+    eatBOM();
+    if (nextToken() != BeginObject)
+        return QCborValue(QCborValue::Undefined);
+
+    // duplicate keys are resolved in favor of the last one, like sortContainer() does
+    const char *valueStart = nullptr;
+    char token = nextToken();
+    while (token == Quote) {
+        const char *keyStart = json;
+        skipString();
+        const char *keyEnd = json - 1;
+        bool matches;
+        if (!memchr(keyStart, '\\', keyEnd - keyStart)) {
+            matches = QUtf8::compareUtf8(QByteArrayView(keyStart, keyEnd - keyStart), key) == 0;
+        } else {
+            json = keyStart;
+            container = new QCborContainerPrivate;
+            matches = parseString() && container->stringEqualsElement(0, key);
+            container.reset();
+        }
+        nextToken();    // name separator
+        eatSpace();
+        if (matches)
+            valueStart = json;
+        skipValue();
+        if (nextToken() != ValueSeparator)
+            break;
+        token = nextToken();
+    }
+
+    if (!valueStart)
+        return QCborValue(QCborValue::Undefined);
+    json = valueStart;
+    return parseSingleValue();
+}
+
+QCborValue Parser::elementValue(qsizetype index)
+{
+    eatBOM();
+    if (nextToken() != BeginArray || index < 0)
+        return QCborValue(QCborValue::Undefined);
+    if (!eatSpace() || *json == EndArray)
+        return QCborValue(QCborValue::Undefined);
+
+    for (qsizetype i = 0; ; ++i) {
+        eatSpace();
+        if (i == index)
+            return parseSingleValue();
+        skipValue();
+        if (nextToken() != ValueSeparator)
+            break;
+    }
+    return QCborValue(QCborValue::Undefined);
+}
+
+QCborValue Parser::parseSingleValue()
+{
+    container = new QCborContainerPrivate;
+    QCborValue result(QCborValue::Undefined);
+    if (parseValue())
+        result = container->valueAt(0);
+    container.reset();
+    return result;
+}
+
+// json points to the first character of a value; leaves it past the end of that value
+void Parser::skipValue()
+{
+    switch (*json) {
+    case Quote:
+        ++json;
+        skipString();
+        return;
+    case BeginArray:
+    case BeginObject: {
+        int depth = 0;
+        while (json < end) {
+            json = scanForward<Structural>(json, end);
+            if (json >= end)
+                return;
+            switch (*json++) {
+            case Quote:
+                skipString();
+                break;
+            case BeginArray:
+            case BeginObject:
+                ++depth;
+                break;
+            default:
+                if (--depth == 0)
+                    return;
+                break;
+            }
+        }
+        return;
+    }
+    default:
+        // literal or number
+        while (json < end && *json != ValueSeparator && *json != EndArray
+               && *json != EndObject && NonSpace::matches(uchar(*json)))
+            ++json;
+        return;
+    }
+}
+
+// json points past the opening quotation mark; leaves it past the closing one
+void Parser::skipString()
+{
+    while (json < end) {
+        json = scanForward<StringSpecial<false>>(json, end);
+        if (json >= end)
+            return;
+        if (*json++ == Quote)
+            return;
+        ++json;     // escaped character
+    }
+}
+
 // We need to retain the _last_ value for any duplicate keys and we need to deref containers.
 // Therefore the manual implementation of std::unique().
 template<typename Iterator, typename Compare, typename Assign>
@@ -484,7 +795,7 @@ bool Parser::parseObject()
 
     char token = nextToken();
     while (token == Quote) {
-        if (!container)
+        if (!container && !validateOnly)
             container = new QCborContainerPrivate;
         if (!parseMember())
             return false;
@@ -562,7 +873,7 @@ bool Parser::parseArray()
                 lastError = QJsonParseError::UnterminatedArray;
                 return false;
             }
-            if (!container)
+            if (!container && !validateOnly)
                 container = new QCborContainerPrivate;
             if (!parseValue())
                 return false;
@@ -605,7 +916,8 @@ bool Parser::parseValue()
         if (*json++ == 'u' &&
             *json++ == 'l' &&
             *json++ == 'l') {
-            container->append(QCborValue(QCborValue::Null));
+            if (!validateOnly)
+                container->append(QCborValue(QCborValue::Null));
             DEBUG << "value: null";
             END;
             return true;
@@ -620,7 +932,8 @@ bool Parser::parseValue()
         if (*json++ == 'r' &&
             *json++ == 'u' &&
             *json++ == 'e') {
-            container->append(QCborValue(true));
+            if (!validateOnly)
+                container->append(QCborValue(true));
             DEBUG << "value: true";
             END;
             return true;
@@ -636,7 +949,8 @@ bool Parser::parseValue()
             *json++ == 'l' &&
             *json++ == 's' &&
             *json++ == 'e') {
-            container->append(QCborValue(false));
+            if (!validateOnly)
+                container->append(QCborValue(false));
             DEBUG << "value: false";
             END;
             return true;
@@ -651,6 +965,8 @@ bool Parser::parseValue()
         return true;
     }
     case BeginArray: {
+        if (validateOnly)
+            return parseArray();
         StashedContainer stashedContainer(&container, QCborValue::Array);
         if (!parseArray())
             return false;
@@ -659,6 +975,8 @@ bool Parser::parseValue()
         return true;
     }
     case BeginObject: {
+        if (validateOnly)
+            return parseObject();
         StashedContainer stashedContainer(&container, QCborValue::Map);
         if (!parseObject())
             return false;
@@ -754,7 +1072,8 @@ bool Parser::parseNumber()
         bool ok;
         qlonglong n = number.toLongLong(&ok);
         if (ok) {
-            container->append(QCborValue(n));
+            if (!validateOnly)
+                container->append(QCborValue(n));
             END;
             return true;
         }
@@ -768,11 +1087,13 @@ bool Parser::parseNumber()
         return false;
     }
 
-    qint64 n;
-    if (convertDoubleTo(d, &n))
-        container->append(QCborValue(n));
-    else
-        container->append(QCborValue(d));
+    if (!validateOnly) {
+        qint64 n;
+        if (convertDoubleTo(d, &n))
+            container->append(QCborValue(n));
+        else
+            container->append(QCborValue(d));
+    }
 
     END;
     return true;
@@ -882,6 +1203,10 @@ bool Parser::parseString()
     bool isUtf8 = true;
     bool isAscii = true;
     while (json < end) {
+        // skip over plain ASCII characters in bulk
+        json = scanForward<StringSpecial<true>>(json, end);
+        if (json >= end)
+            break;
         uint ch = 0;
         if (*json == '"')
             break;
@@ -910,10 +1235,12 @@ bool Parser::parseString()
 
     // no escape sequences, we are done
     if (isUtf8) {
-        if (isAscii)
-            container->appendAsciiString(start, json - start - 1);
-        else
-            container->appendUtf8String(start, json - start - 1);
+        if (!validateOnly) {
+            if (isAscii)
+                container->appendAsciiString(start, json - start - 1);
+            else
+                container->appendUtf8String(start, json - start - 1);
+        }
         END;
         return true;
     }
@@ -924,6 +1251,12 @@ bool Parser::parseString()
 
     QString ucs4;
     while (json < end) {
+        const char *run = json;
+        json = scanForward<StringSpecial<true>>(json, end);
+        if (json != run && !validateOnly)
+            ucs4.append(QLatin1String(run, json - run));
+        if (json >= end)
+            break;
         uint ch = 0;
         if (*json == '"')
             break;
@@ -938,7 +1271,8 @@ bool Parser::parseString()
                 return false;
             }
         }
-        ucs4.append(QChar::fromUcs4(ch));
+        if (!validateOnly)
+            ucs4.append(QChar::fromUcs4(ch));
     }
     ++json;
 
@@ -947,8 +1281,10 @@ bool Parser::parseString()
         return false;
     }
 
-    container->appendByteData(reinterpret_cast<const char *>(ucs4.utf16()), ucs4.size() * 2,
-                              QCborValue::String, QtCbor::Element::StringIsUtf16);
+    if (!validateOnly) {
+        container->appendByteData(reinterpret_cast<const char *>(ucs4.utf16()), ucs4.size() * 2,
+                                  QCborValue::String, QtCbor::Element::StringIsUtf16);
+    }
     END;
     return true;
 }
@@ -65,6 +65,12 @@ public:
     Parser(const char *json, int length);
 
     QCborValue parse(QJsonParseError *error);
+    QCborValue::Type validate(QJsonParseError *error);
+
+    // only valid on text that passed validate()
+    QCborValue memberValue(QStringView key);
+    QCborValue memberValue(QLatin1String key);
+    QCborValue elementValue(qsizetype index);
 
 private:
     inline void eatBOM();
@@ -77,11 +83,18 @@ private:
     bool parseString();
     bool parseValue();
     bool parseNumber();
+
+    template <typename String> QCborValue lookupMember(String key);
+    QCborValue parseSingleValue();
+    void skipValue();
+    void skipString();
+
     const char *head;
     const char *json;
     const char *end;
 
     int nestingLevel;
+    bool validateOnly = false;
     QJsonParseError::ParseError lastError;
     QExplicitlySharedDataPointer<QCborContainerPrivate> container;
 };
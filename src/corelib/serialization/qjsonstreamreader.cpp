@@ -0,0 +1,908 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qjsonstreamreader.h"
+
+#include <qiodevice.h>
+#include <qjsonarray.h>
+#include <qjsonobject.h>
+#include <qvarlengtharray.h>
+#include <private/qnumeric_p.h>
+#include <private/qstringconverter_p.h>
+#include <private/qtools_p.h>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QJsonStreamReader
+    \inmodule QtCore
+    \ingroup json
+    \reentrant
+    \since 6.3
+
+    \brief The QJsonStreamReader class is a simple JSON stream decoder,
+    operating on either a QByteArray or QIODevice.
+
+    This class can be used to decode a stream of JSON content directly from
+    either a QByteArray or a QIODevice, without building the whole document
+    in memory the way QJsonDocument::fromJson() does. Only the value
+    currently being decoded is kept in memory, so the memory use does not
+    depend on the size of the document, only on the size of its largest
+    string or number and on the nesting depth.
+
+    The reader is a pull parser, modeled after QCborStreamReader: the
+    current element is inspected with type() and the isXxx() functions,
+    scalar values are retrieved with toBool(), toDouble(), toInteger() and
+    readString(), and next() moves to the following element. Arrays and
+    objects are entered with enterContainer() and left with
+    leaveContainer(); inside an object, the elements alternate between the
+    member names, which are always strings, and their values.
+
+    \code
+        // process a huge array of records one at a time
+        QJsonStreamReader reader(&file);
+        if (reader.isArray() && reader.enterContainer()) {
+            while (reader.hasNext())
+                processRecord(reader.readValue().toObject());
+            reader.leaveContainer();
+        }
+        if (reader.lastError().error != QJsonParseError::NoError)
+            qWarning() << reader.lastError().errorString();
+    \endcode
+
+    The reader accepts any JSON value at the top level and also a sequence
+    of top-level values separated by whitespace, such as the newline
+    delimited format commonly used for logs. hasNext() returns \c false at
+    the top level once all available data has been decoded.
+
+    \section1 Incremental data
+
+    When the data is not available all at once, for instance when reading
+    from a socket, the reader stops at the element that could not be
+    decoded completely and reports the same error that
+    QJsonDocument::fromJson() would report for truncated input (such as
+    QJsonParseError::UnterminatedString or
+    QJsonParseError::UnterminatedArray). After more data has been made
+    available, either with addData() or on the device, call reparse() to
+    resume decoding.
+
+    \sa QJsonStreamWriter, QJsonDocument, QCborStreamReader
+*/
+
+static const int nestingLimit = 1024;
+enum : qsizetype { ReadChunkSize = 16 * 1024 };
+
+class QJsonStreamReaderPrivate
+{
+public:
+    struct Container
+    {
+        QJsonValue::Type type;
+        bool expectValue;       // an object member's name was read, its value is next
+        qsizetype count;
+    };
+
+    QIODevice *device = nullptr;
+    QByteArray buffer;
+    qint64 bufferOffset = 0;    // stream offset of buffer[0]
+    qsizetype pos = 0;          // current element, or the closing bracket of its container
+    qsizetype tokenSize = 0;
+    qsizetype topLevelCount = 0;
+
+    QVarLengthArray<Container, 16> containers;
+
+    QJsonValue::Type type = QJsonValue::Undefined;
+    QJsonParseError::ParseError error = QJsonParseError::NoError;
+    qint64 errorOffset = 0;
+    bool incomplete = false;    // the error was caused by running out of data
+
+    bool boolean = false;
+    bool isInteger = false;
+    qint64 integer = 0;
+    double number = 0;
+
+    void clear()
+    {
+        buffer.clear();
+        bufferOffset = 0;
+        pos = 0;
+        tokenSize = 0;
+        topLevelCount = 0;
+        containers.clear();
+        type = QJsonValue::Undefined;
+        error = QJsonParseError::NoError;
+        errorOffset = 0;
+        incomplete = false;
+    }
+
+    char at(qsizetype i) const { return buffer.constData()[pos + i]; }
+
+    void setError(QJsonParseError::ParseError code, qsizetype i, bool isIncomplete = false)
+    {
+        type = QJsonValue::Undefined;
+        error = code;
+        errorOffset = bufferOffset + pos + i;
+        incomplete = isIncomplete;
+    }
+
+    bool ensureAvailable(qsizetype n);
+    bool skipSpace(qsizetype &i);
+    bool parseElement(qsizetype i);
+    bool parseNumber(qsizetype i);
+    void preparse();
+    void elementDone();
+    bool decodeString(QString *result);
+};
+
+// makes sure that at least n bytes starting at pos are buffered
+bool QJsonStreamReaderPrivate::ensureAvailable(qsizetype n)
+{
+    while (buffer.size() - pos < n) {
+        if (!device)
+            return false;
+
+        // only the current element needs to stay in memory
+        if (pos) {
+            buffer.remove(0, pos);
+            bufferOffset += pos;
+            pos = 0;
+        }
+
+        const qsizetype oldSize = buffer.size();
+        const qsizetype chunk = qMax(qsizetype(ReadChunkSize), n - oldSize);
+        buffer.resize(oldSize + chunk);
+        const qint64 bytesRead = device->read(buffer.data() + oldSize, chunk);
+        buffer.resize(oldSize + qMax(bytesRead, qint64(0)));
+        if (bytesRead <= 0)
+            return false;
+    }
+    return true;
+}
+
+bool QJsonStreamReaderPrivate::skipSpace(qsizetype &i)
+{
+    forever {
+        const char *data = buffer.constData() + pos;
+        const qsizetype available = buffer.size() - pos;
+        for ( ; i < available; ++i) {
+            const char c = data[i];
+            if (c != ' ' && c != '\t' && c != '\n' && c != '\r')
+                return true;
+        }
+        if (!ensureAvailable(i + 1))
+            return false;
+    }
+}
+
+/*
+    Determines the type and extent of the element starting at pos + i. The
+    whole token of strings, numbers and literals is buffered, so the value
+    can be decoded later without reading from the device.
+*/
+bool QJsonStreamReaderPrivate::parseElement(qsizetype i)
+{
+    const char c = at(i);
+    switch (c) {
+    case '[':
+        type = QJsonValue::Array;
+        tokenSize = 1;
+        return true;
+    case '{':
+        type = QJsonValue::Object;
+        tokenSize = 1;
+        return true;
+    case '"': {
+        qsizetype j = i + 1;
+        forever {
+            const char *data = buffer.constData() + pos;
+            const qsizetype available = buffer.size() - pos;
+            while (j < available && data[j] != '"')
+                j += data[j] == '\\' ? 2 : 1;
+            if (j < available)
+                break;
+            if (!ensureAvailable(j + 1)) {
+                setError(QJsonParseError::UnterminatedString, j, true);
+                return false;
+            }
+        }
+        type = QJsonValue::String;
+        tokenSize = j + 1 - i;
+        return true;
+    }
+    case 't':
+    case 'f':
+    case 'n': {
+        const char *literal = c == 't' ? "true" : c == 'f' ? "false" : "null";
+        const qsizetype length = qsizetype(strlen(literal));
+        if (!ensureAvailable(i + length)) {
+            setError(QJsonParseError::IllegalValue, i, true);
+            return false;
+        }
+        if (memcmp(buffer.constData() + pos + i, literal, length) != 0) {
+            setError(QJsonParseError::IllegalValue, i);
+            return false;
+        }
+        type = c == 'n' ? QJsonValue::Null : QJsonValue::Bool;
+        boolean = c == 't';
+        tokenSize = length;
+        return true;
+    }
+    case ']':
+    case '}':
+        setError(QJsonParseError::MissingObject, i);
+        return false;
+    default:
+        if (c == '-' || (c >= '0' && c <= '9'))
+            return parseNumber(i);
+        setError(QJsonParseError::IllegalValue, i);
+        return false;
+    }
+}
+
+static inline bool isNumberCharacter(char c)
+{
+    return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+}
+
+// follows the grammar and conversions of QJsonPrivate::Parser::parseNumber()
+bool QJsonStreamReaderPrivate::parseNumber(qsizetype i)
+{
+    // buffer the whole run of characters that can be part of a number
+    qsizetype j = i;
+    forever {
+        const char *data = buffer.constData() + pos;
+        const qsizetype available = buffer.size() - pos;
+        while (j < available && isNumberCharacter(data[j]))
+            ++j;
+        if (j < available)
+            break;
+        if (!ensureAvailable(j + 1)) {
+            // a top-level number may end with the data
+            if (!containers.isEmpty()) {
+                setError(QJsonParseError::TerminationByNumber, j, true);
+                return false;
+            }
+            break;
+        }
+    }
+
+    const char *start = buffer.constData() + pos + i;
+    const char *end = buffer.constData() + pos + j;
+    const char *json = start;
+    bool isInt = true;
+
+    if (json < end && *json == '-')
+        ++json;
+    if (json < end && *json == '0') {
+        ++json;
+    } else {
+        while (json < end && *json >= '0' && *json <= '9')
+            ++json;
+    }
+    if (json < end && *json == '.') {
+        ++json;
+        while (json < end && *json >= '0' && *json <= '9') {
+            isInt = isInt && *json == '0';
+            ++json;
+        }
+    }
+    if (json < end && (*json == 'e' || *json == 'E')) {
+        isInt = false;
+        ++json;
+        if (json < end && (*json == '-' || *json == '+'))
+            ++json;
+        while (json < end && *json >= '0' && *json <= '9')
+            ++json;
+    }
+
+    const QByteArray text = QByteArray::fromRawData(start, json - start);
+    bool ok = false;
+    if (isInt) {
+        integer = text.toLongLong(&ok);
+        isInteger = ok;
+    }
+    if (!ok) {
+        number = text.toDouble(&ok);
+        if (!ok) {
+            setError(QJsonParseError::IllegalNumber, i);
+            return false;
+        }
+        isInteger = convertDoubleTo(number, &integer);
+    }
+    if (isInteger)
+        number = double(integer);
+
+    type = QJsonValue::Double;
+    tokenSize = json - start;
+    return true;
+}
+
+/*
+    Positions the reader on the element following the one just consumed:
+    skips whitespace and the separators, then parses the element. Nothing is
+    consumed unless this succeeds, so that it can be retried with reparse()
+    after running out of data.
+*/
+void QJsonStreamReaderPrivate::preparse()
+{
+    type = QJsonValue::Undefined;
+    tokenSize = 0;
+    if (error != QJsonParseError::NoError)
+        return;
+
+    qsizetype i = 0;
+    if (containers.isEmpty()) {
+        if (!skipSpace(i)) {
+            // end of the data, which is not an error between top-level values
+            pos += i;
+            return;
+        }
+        if (!parseElement(i)) {
+            if (topLevelCount && !incomplete)
+                error = QJsonParseError::GarbageAtEnd;
+            return;
+        }
+        pos += i;
+        return;
+    }
+
+    Container &container = containers.last();
+    const bool inObject = container.type == QJsonValue::Object;
+    const auto unterminated = inObject ? QJsonParseError::UnterminatedObject
+                                       : QJsonParseError::UnterminatedArray;
+    if (!skipSpace(i)) {
+        setError(unterminated, i, true);
+        return;
+    }
+
+    char c = at(i);
+    if (container.expectValue) {
+        if (c != ':') {
+            setError(QJsonParseError::MissingNameSeparator, i);
+            return;
+        }
+        ++i;
+        if (!skipSpace(i)) {
+            setError(unterminated, i, true);
+            return;
+        }
+    } else {
+        if (c == (inObject ? '}' : ']')) {
+            // end of the container; leaveContainer() consumes the bracket
+            pos += i;
+            return;
+        }
+        if (container.count) {
+            if (c != ',') {
+                setError(inObject ? QJsonParseError::UnterminatedObject
+                                  : QJsonParseError::MissingValueSeparator, i);
+                return;
+            }
+            ++i;
+            if (!skipSpace(i)) {
+                setError(unterminated, i, true);
+                return;
+            }
+            c = at(i);
+            if (c == ']' || c == '}') {
+                setError(QJsonParseError::MissingObject, i);
+                return;
+            }
+        }
+        if (inObject && c != '"') {
+            setError(QJsonParseError::UnterminatedObject, i);
+            return;
+        }
+    }
+
+    if (parseElement(i))
+        pos += i;
+}
+
+void QJsonStreamReaderPrivate::elementDone()
+{
+    if (containers.isEmpty()) {
+        ++topLevelCount;
+    } else {
+        Container &container = containers.last();
+        if (container.type == QJsonValue::Object && !container.expectValue) {
+            container.expectValue = true;
+        } else {
+            container.expectValue = false;
+            ++container.count;
+        }
+    }
+    preparse();
+}
+
+// follows the decoding of QJsonPrivate::Parser::parseString()
+bool QJsonStreamReaderPrivate::decodeString(QString *result)
+{
+    const char *json = buffer.constData() + pos + 1;
+    const char *end = buffer.constData() + pos + tokenSize - 1;
+
+    if (!memchr(json, '\\', end - json)) {
+        const QByteArrayView utf8(json, end - json);
+        const QUtf8::ValidUtf8Result validity = QUtf8::isValidUtf8(utf8);
+        if (!validity.isValidUtf8) {
+            setError(QJsonParseError::IllegalUTF8String, 0);
+            return false;
+        }
+        *result = validity.isValidAscii ? QString::fromLatin1(utf8.data(), utf8.size())
+                                        : QString::fromUtf8(utf8);
+        return true;
+    }
+
+    QString string;
+    string.reserve(end - json);
+    while (json < end) {
+        uint ch = uchar(*json);
+        if (ch == '\\') {
+            if (++json >= end) {
+                setError(QJsonParseError::IllegalEscapeSequence, 0);
+                return false;
+            }
+            switch (*json++) {
+            case 'b': ch = 0x8; break;
+            case 'f': ch = 0xc; break;
+            case 'n': ch = 0xa; break;
+            case 'r': ch = 0xd; break;
+            case 't': ch = 0x9; break;
+            case 'u':
+                ch = 0;
+                for (int k = 0; k < 4; ++k, ++json) {
+                    const int digit = json < end ? QtMiscUtils::fromHex(uchar(*json)) : -1;
+                    if (digit < 0) {
+                        setError(QJsonParseError::IllegalEscapeSequence, 0);
+                        return false;
+                    }
+                    ch = (ch << 4) | uint(digit);
+                }
+                break;
+            default:
+                // like the parser, take any other escaped character as-is
+                ch = uchar(json[-1]);
+                break;
+            }
+        } else if (ch < 0x80) {
+            ++json;
+        } else {
+            const uchar *usrc = reinterpret_cast<const uchar *>(json) + 1;
+            uint *dst = &ch;
+            if (QUtf8Functions::fromUtf8<QUtf8BaseTraits>(uchar(*json), dst, usrc,
+                    reinterpret_cast<const uchar *>(end)) < 0) {
+                setError(QJsonParseError::IllegalUTF8String, 0);
+                return false;
+            }
+            json = reinterpret_cast<const char *>(usrc);
+        }
+        string.append(QChar::fromUcs4(ch));
+    }
+    *result = std::move(string);
+    return true;
+}
+
+/*!
+    Creates a QJsonStreamReader object with no source data. After
+    construction, the reader reports no current element. Add data with
+    addData() or set a device with setDevice().
+*/
+QJsonStreamReader::QJsonStreamReader()
+    : d(new QJsonStreamReaderPrivate)
+{
+}
+
+/*!
+    Creates a QJsonStreamReader object that decodes the JSON text in \a data.
+
+    \sa addData()
+*/
+QJsonStreamReader::QJsonStreamReader(const QByteArray &data)
+    : d(new QJsonStreamReaderPrivate)
+{
+    d->buffer = data;
+    d->preparse();
+}
+
+/*!
+    Creates a QJsonStreamReader object that reads the JSON text from \a
+    device. The device must be open for reading before the reader is used.
+
+    \sa setDevice()
+*/
+QJsonStreamReader::QJsonStreamReader(QIODevice *device)
+    : d(new QJsonStreamReaderPrivate)
+{
+    setDevice(device);
+}
+
+/*!
+    Destroys this QJsonStreamReader object and frees any associated
+    resources.
+*/
+QJsonStreamReader::~QJsonStreamReader()
+{
+}
+
+/*!
+    Sets the source of data to \a device, resetting the decoder to its
+    initial state.
+
+    \sa device(), clear()
+*/
+void QJsonStreamReader::setDevice(QIODevice *device)
+{
+    clear();
+    d->device = device;
+    d->preparse();
+}
+
+/*!
+    Returns the QIODevice that was set with either setDevice() or the
+    QJsonStreamReader constructor. If that object was reading from a
+    QByteArray, this function returns nullptr instead.
+
+    \sa setDevice()
+*/
+QIODevice *QJsonStreamReader::device() const
+{
+    return d->device;
+}
+
+/*!
+    Adds \a data to the JSON stream. After adding data, call reparse() to
+    decode an element that could not be decoded before. This function must
+    not be called if the reader reads from a device.
+
+    \sa reparse()
+*/
+void QJsonStreamReader::addData(const QByteArray &data)
+{
+    addData(data.constData(), data.size());
+}
+
+/*!
+    \overload
+
+    Adds \a len bytes of data starting at \a data to the JSON stream.
+*/
+void QJsonStreamReader::addData(const char *data, qsizetype len)
+{
+    if (d->device) {
+        qWarning("QJsonStreamReader: addData() with a device set is not supported");
+        return;
+    }
+
+    // drop what has been consumed, unless it's cheaper to keep it
+    if (d->pos > d->buffer.size() / 2) {
+        d->buffer.remove(0, d->pos);
+        d->bufferOffset += d->pos;
+        d->pos = 0;
+    }
+    d->buffer.append(data, len);
+}
+
+/*!
+    Decodes the current element again after more data has become available.
+    This only has an effect if the reader stopped because the data ended in
+    the middle of an element, or at the top level after the last complete
+    value.
+
+    \sa addData(), lastError()
+*/
+void QJsonStreamReader::reparse()
+{
+    if (d->incomplete) {
+        d->error = QJsonParseError::NoError;
+        d->incomplete = false;
+    }
+    if (d->error == QJsonParseError::NoError && d->type == QJsonValue::Undefined)
+        d->preparse();
+}
+
+/*!
+    Clears the decoder state and resets the input source data to an empty
+    byte array. After this function is called, the reader reports no
+    current element.
+
+    \sa addData(), setDevice()
+*/
+void QJsonStreamReader::clear()
+{
+    d->device = nullptr;
+    d->clear();
+}
+
+/*!
+    Returns the last error in decoding the stream, if any, and the offset
+    at which it occurred. If no error was encountered, the error code is
+    QJsonParseError::NoError.
+*/
+QJsonParseError QJsonStreamReader::lastError() const
+{
+    QJsonParseError result;
+    result.error = d->error;
+    result.offset = d->error == QJsonParseError::NoError ? 0 : int(d->errorOffset);
+    return result;
+}
+
+/*!
+    Returns the offset in the input stream of the element currently being
+    decoded. For the first element in a device, that is the position the
+    device had when the reader was created.
+*/
+qint64 QJsonStreamReader::currentOffset() const
+{
+    return d->bufferOffset + d->pos;
+}
+
+/*!
+    Returns the number of containers that the reader has entered with
+    enterContainer() but not yet left.
+
+    \sa enterContainer(), leaveContainer()
+*/
+int QJsonStreamReader::containerDepth() const
+{
+    return int(d->containers.size());
+}
+
+/*!
+    Returns either QJsonValue::Array or QJsonValue::Object, indicating the
+    type of the container that contains the current element, or
+    QJsonValue::Undefined at the top level.
+
+    \sa containerDepth(), enterContainer()
+*/
+QJsonValue::Type QJsonStreamReader::parentContainerType() const
+{
+    return d->containers.isEmpty() ? QJsonValue::Undefined : d->containers.last().type;
+}
+
+/*!
+    Returns \c true if the reader is positioned on an element, that is, if
+    the end of the current container (or, at the top level, of the data)
+    has not been reached and no error occurred.
+
+    \sa next(), leaveContainer()
+*/
+bool QJsonStreamReader::hasNext() const noexcept
+{
+    return d->type != QJsonValue::Undefined;
+}
+
+/*!
+    Returns the type of the current element, or QJsonValue::Undefined if
+    there is none: at the end of a container, at the end of the data, or
+    after an error.
+
+    The elements of an object alternate between member names, which are of
+    type QJsonValue::String, and member values.
+*/
+QJsonValue::Type QJsonStreamReader::type() const
+{
+    return d->type;
+}
+
+/*!
+    Skips the current element, including all the elements of an array or
+    object, and moves to the next one. Returns \c true if the element was
+    skipped successfully.
+
+    Strings are not decoded and therefore not validated when skipped.
+
+    \sa hasNext(), lastError()
+*/
+bool QJsonStreamReader::next()
+{
+    if (!hasNext())
+        return false;
+
+    if (isContainer()) {
+        if (!enterContainer())
+            return false;
+        while (hasNext()) {
+            if (!next())
+                return false;
+        }
+        return leaveContainer();
+    }
+
+    d->pos += d->tokenSize;
+    d->elementDone();
+    return true;
+}
+
+/*!
+    Enters the array or object that is the current element and positions
+    the reader on its first element. Returns \c true on success.
+
+    \sa leaveContainer(), isContainer()
+*/
+bool QJsonStreamReader::enterContainer()
+{
+    if (!isContainer())
+        return false;
+    if (d->containers.size() >= nestingLimit) {
+        d->setError(QJsonParseError::DeepNesting, 0);
+        return false;
+    }
+
+    d->containers.append({ d->type, false, 0 });
+    d->pos += d->tokenSize;
+    d->preparse();
+    return true;
+}
+
+/*!
+    Skips any remaining elements of the current container, leaves it and
+    positions the reader on the element following the container. Returns
+    \c true on success.
+
+    \sa enterContainer(), parentContainerType()
+*/
+bool QJsonStreamReader::leaveContainer()
+{
+    if (d->containers.isEmpty())
+        return false;
+    while (hasNext()) {
+        if (!next())
+            return false;
+    }
+    if (d->error != QJsonParseError::NoError)
+        return false;
+
+    // pos is on the closing bracket
+    d->containers.removeLast();
+    d->pos += 1;
+    d->elementDone();
+    return true;
+}
+
+/*!
+    Decodes the current element, which must be a string, and moves to the
+    next element. Returns a null QString if the current element is not a
+    string or if it contains invalid escape sequences or UTF-8.
+
+    \sa isString(), lastError()
+*/
+QString QJsonStreamReader::readString()
+{
+    QString result;
+    if (!isString() || !d->decodeString(&result))
+        return QString();
+
+    d->pos += d->tokenSize;
+    d->elementDone();
+    return result;
+}
+
+/*!
+    Decodes the current element, including all the elements of an array or
+    object, into a QJsonValue and moves to the next element. Returns
+    QJsonValue::Undefined if there is no current element or if an error
+    occurs.
+
+    This is a convenient way to process a large stream one record at a time:
+    only the value being read is held in memory.
+
+    \sa next(), QJsonValue
+*/
+QJsonValue QJsonStreamReader::readValue()
+{
+    QJsonValue result;
+    switch (type()) {
+    case QJsonValue::Null:
+        break;
+    case QJsonValue::Bool:
+        result = toBool();
+        break;
+    case QJsonValue::Double:
+        result = d->isInteger ? QJsonValue(d->integer) : QJsonValue(d->number);
+        break;
+    case QJsonValue::String:
+        result = readString();
+        return d->error == QJsonParseError::NoError ? result : QJsonValue(QJsonValue::Undefined);
+    case QJsonValue::Array: {
+        QJsonArray array;
+        if (!enterContainer())
+            return QJsonValue(QJsonValue::Undefined);
+        while (hasNext())
+            array.append(readValue());
+        if (!leaveContainer())
+            return QJsonValue(QJsonValue::Undefined);
+        return array;
+    }
+    case QJsonValue::Object: {
+        QJsonObject object;
+        if (!enterContainer())
+            return QJsonValue(QJsonValue::Undefined);
+        while (hasNext()) {
+            const QString key = readString();
+            if (!hasNext())
+                break;
+            object.insert(key, readValue());
+        }
+        if (!leaveContainer())
+            return QJsonValue(QJsonValue::Undefined);
+        return object;
+    }
+    case QJsonValue::Undefined:
+        return QJsonValue(QJsonValue::Undefined);
+    }
+
+    next();
+    return result;
+}
+
+/*!
+    Returns the value of the current element if it is a boolean, or \c false
+    otherwise. This function does not move to the next element.
+
+    \sa isBool(), next()
+*/
+bool QJsonStreamReader::toBool() const
+{
+    return isBool() && d->boolean;
+}
+
+/*!
+    Returns the value of the current element if it is a number, or 0
+    otherwise. This function does not move to the next element.
+
+    \sa isDouble(), toInteger(), next()
+*/
+double QJsonStreamReader::toDouble() const
+{
+    return isDouble() ? d->number : 0;
+}
+
+/*!
+    Returns the value of the current element if it is a number with an
+    integral value that fits in a qint64, or \a defaultValue otherwise. This
+    function does not move to the next element.
+
+    \sa isDouble(), toDouble(), QJsonValue::toInteger()
+*/
+qint64 QJsonStreamReader::toInteger(qint64 defaultValue) const
+{
+    return isDouble() && d->isInteger ? d->integer : defaultValue;
+}
+
+QT_END_NAMESPACE
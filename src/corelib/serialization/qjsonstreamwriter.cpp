@@ -0,0 +1,459 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qjsonstreamwriter.h"
+
+#include <qbuffer.h>
+#include <qcborvalue.h>
+#include <qjsonvalue.h>
+#include <qlocale.h>
+#include <qvarlengtharray.h>
+#include <private/qnumeric_p.h>
+#include "qjsonwriter_p.h"
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QJsonStreamWriter
+    \inmodule QtCore
+    \ingroup json
+    \reentrant
+    \since 6.3
+
+    \brief The QJsonStreamWriter class is a simple JSON stream encoder,
+    operating on a one-way stream.
+
+    This class can be used to quickly encode a stream of JSON content
+    directly to either a QByteArray or QIODevice, without building a
+    QJsonDocument first. Each value is written out as soon as it is
+    appended, so the memory use does not depend on the size of the output.
+
+    Like QCborStreamWriter, the writer is used by appending values in the
+    order in which they appear in the output, starting and ending arrays and
+    objects around their contents with startArray() / endArray() and
+    startObject() / endObject(). Inside an object, the appended values
+    alternate between the member names, which must be strings, and the
+    member values.
+
+    \code
+        QJsonStreamWriter writer(&file, QJsonDocument::Compact);
+        writer.startArray();
+        for (const Record &record : records) {
+            writer.startObject();
+            writer.append(QLatin1String("id"));
+            writer.append(record.id);
+            writer.append(QLatin1String("message"));
+            writer.append(record.message);
+            writer.endObject();
+        }
+        writer.endArray();
+    \endcode
+
+    The output is formatted the same way as QJsonDocument::toJson() with the
+    chosen format, so writing the contents of a QJsonDocument through this
+    class produces the same text. Several top-level values may be written to
+    the same stream; they are separated by newlines, producing the newline
+    delimited JSON format commonly used for logs.
+
+    QJsonStreamWriter does not check that the output is complete when it is
+    destroyed; it is the programmer's responsibility to end all arrays and
+    objects that were started.
+
+    \sa QJsonStreamReader, QJsonDocument, QCborStreamWriter
+*/
+
+class QJsonStreamWriterPrivate
+{
+public:
+    struct Container
+    {
+        bool isObject;
+        qsizetype count;
+    };
+
+    QJsonStreamWriterPrivate(QIODevice *device, QJsonDocument::JsonFormat format)
+        : device(device), compact(format == QJsonDocument::Compact)
+    {
+    }
+
+    ~QJsonStreamWriterPrivate()
+    {
+        if (deleteDevice)
+            delete device;
+    }
+
+    QIODevice *device;
+    bool deleteDevice = false;
+    bool compact;
+    bool needNewline = false;   // after a top-level value that didn't end with one
+    QVarLengthArray<Container, 16> containers;
+    QByteArray buffer;
+
+    bool beginValue();
+    void endValue(bool isKey, bool isContainer);
+    void startContainer(bool isObject);
+    bool endContainer(bool isObject);
+
+    void flush()
+    {
+        if (device)
+            device->write(buffer);
+        buffer.truncate(0);
+    }
+};
+
+// writes the separator and indentation for the next value; returns whether it is an object key
+bool QJsonStreamWriterPrivate::beginValue()
+{
+    if (containers.isEmpty()) {
+        if (needNewline) {
+            buffer += '\n';
+            needNewline = false;
+        }
+        return false;
+    }
+
+    Container &container = containers.last();
+    const bool isKey = container.isObject && container.count % 2 == 0;
+    ++container.count;
+    if (container.isObject && !isKey)
+        return false;   // a member value directly follows its name
+
+    if (container.count > 1)
+        buffer += compact ? "," : ",\n";
+    if (!compact)
+        buffer.append(4 * containers.size(), ' ');
+    return isKey;
+}
+
+void QJsonStreamWriterPrivate::endValue(bool isKey, bool isContainer)
+{
+    if (isKey) {
+        buffer += compact ? ":" : ": ";
+    } else if (containers.isEmpty()) {
+        // like QJsonDocument::toJson(), indented documents end with a newline
+        if (isContainer && !compact)
+            buffer += '\n';
+        else
+            needNewline = true;
+    }
+    flush();
+}
+
+void QJsonStreamWriterPrivate::startContainer(bool isObject)
+{
+    const bool isKey = beginValue();
+    Q_ASSERT_X(!isKey, "QJsonStreamWriter", "object member names must be strings");
+    Q_UNUSED(isKey);
+    if (compact)
+        buffer += isObject ? '{' : '[';
+    else
+        buffer += isObject ? "{\n" : "[\n";
+    containers.append({ isObject, 0 });
+    flush();
+}
+
+bool QJsonStreamWriterPrivate::endContainer(bool isObject)
+{
+    if (containers.isEmpty() || containers.last().isObject != isObject)
+        return false;
+    const qsizetype count = containers.last().count;
+    if (isObject && count % 2)
+        return false;   // a member name without a value
+    containers.removeLast();
+
+    if (!compact) {
+        if (count)
+            buffer += '\n';
+        buffer.append(4 * containers.size(), ' ');
+    }
+    buffer += isObject ? '}' : ']';
+    endValue(false, true);
+    return true;
+}
+
+/*!
+    Creates a QJsonStreamWriter object that will write the stream to \a
+    device, formatted according to \a format. The device must be opened
+    before the first append() call is made.
+
+    \sa setDevice()
+*/
+QJsonStreamWriter::QJsonStreamWriter(QIODevice *device, QJsonDocument::JsonFormat format)
+    : d(new QJsonStreamWriterPrivate(device, format))
+{
+}
+
+/*!
+    Creates a QJsonStreamWriter object that will append the stream to \a
+    data, formatted according to \a format. All streaming is done
+    immediately to the byte array, without the need for flushing any
+    buffers.
+*/
+QJsonStreamWriter::QJsonStreamWriter(QByteArray *data, QJsonDocument::JsonFormat format)
+    : d(new QJsonStreamWriterPrivate(new QBuffer(data), format))
+{
+    d->deleteDevice = true;
+    d->device->open(QIODevice::WriteOnly | QIODevice::Unbuffered | QIODevice::Append);
+}
+
+/*!
+    Destroys this QJsonStreamWriter object and frees any resources
+    associated.
+
+    QJsonStreamWriter does not check that all arrays and objects that were
+    started have been ended.
+*/
+QJsonStreamWriter::~QJsonStreamWriter()
+{
+}
+
+/*!
+    Replaces the device or byte array that this QJsonStreamWriter object is
+    writing to with \a device. The formatting state is kept, so this can be
+    used to continue a stream on a different device.
+
+    \sa device()
+*/
+void QJsonStreamWriter::setDevice(QIODevice *device)
+{
+    if (d->deleteDevice)
+        delete d->device;
+    d->device = device;
+    d->deleteDevice = false;
+}
+
+/*!
+    Returns the QIODevice that this QJsonStreamWriter object is writing to.
+    The device must have previously been set with either the class
+    constructor or with setDevice().
+
+    If this object was created by writing to a QByteArray, this function
+    will return an internal instance of QBuffer, which is owned by
+    QJsonStreamWriter.
+
+    \sa setDevice()
+*/
+QIODevice *QJsonStreamWriter::device() const
+{
+    return d->device;
+}
+
+/*!
+    Returns the format used for the output.
+*/
+QJsonDocument::JsonFormat QJsonStreamWriter::format() const
+{
+    return d->compact ? QJsonDocument::Compact : QJsonDocument::Indented;
+}
+
+/*!
+    \overload
+
+    Appends the integer \a i to the stream.
+*/
+void QJsonStreamWriter::append(qint64 i)
+{
+    const bool isKey = d->beginValue();
+    Q_ASSERT_X(!isKey, "QJsonStreamWriter", "object member names must be strings");
+    d->buffer += QByteArray::number(i);
+    d->endValue(isKey, false);
+}
+
+/*!
+    \overload
+
+    Appends the floating point number \a d to the stream. Since JSON cannot
+    represent infinities and NaN, those are written as \c null.
+*/
+void QJsonStreamWriter::append(double d)
+{
+    const bool isKey = this->d->beginValue();
+    Q_ASSERT_X(!isKey, "QJsonStreamWriter", "object member names must be strings");
+    if (qIsFinite(d))
+        this->d->buffer += QByteArray::number(d, 'g', QLocale::FloatingPointShortest);
+    else
+        this->d->buffer += "null"; // +INF || -INF || NaN (see RFC4627#section2.4)
+    this->d->endValue(isKey, false);
+}
+
+/*!
+    \overload
+
+    Appends the boolean value \a b to the stream.
+*/
+void QJsonStreamWriter::append(bool b)
+{
+    const bool isKey = d->beginValue();
+    Q_ASSERT_X(!isKey, "QJsonStreamWriter", "object member names must be strings");
+    d->buffer += b ? "true" : "false";
+    d->endValue(isKey, false);
+}
+
+/*!
+    \overload
+
+    Appends the Latin-1 string viewed by \a str to the stream, escaping
+    characters as required by JSON.
+*/
+void QJsonStreamWriter::append(QLatin1String str)
+{
+    append(QStringView(QString(str)));
+}
+
+/*!
+    Appends the string viewed by \a str to the stream, escaping characters
+    as required by JSON. Inside an object, every other string appended is
+    the name of the following member.
+*/
+void QJsonStreamWriter::append(QStringView str)
+{
+    const bool isKey = d->beginValue();
+    d->buffer += '"';
+    d->buffer += QJsonPrivate::Writer::escapedString(str);
+    d->buffer += '"';
+    d->endValue(isKey, false);
+}
+
+/*!
+    \fn void QJsonStreamWriter::append(const QString &str)
+    \overload
+*/
+
+/*!
+    \overload
+
+    Appends the complete \a value to the stream, including all the elements
+    of an array or object.
+*/
+void QJsonStreamWriter::append(const QJsonValue &value)
+{
+    if (value.isString()) {
+        append(QStringView(value.toString()));
+        return;
+    }
+
+    const bool isKey = d->beginValue();
+    Q_ASSERT_X(!isKey, "QJsonStreamWriter", "object member names must be strings");
+    QJsonPrivate::Writer::valueToJson(QCborValue::fromJsonValue(value), d->buffer,
+                                      int(d->containers.size()), d->compact);
+    d->endValue(isKey, value.isArray() || value.isObject());
+}
+
+/*!
+    \fn void QJsonStreamWriter::append(std::nullptr_t)
+    \overload
+
+    Appends \c null to the stream.
+*/
+
+/*!
+    Appends \c null to the stream.
+*/
+void QJsonStreamWriter::appendNull()
+{
+    const bool isKey = d->beginValue();
+    Q_ASSERT_X(!isKey, "QJsonStreamWriter", "object member names must be strings");
+    d->buffer += "null";
+    d->endValue(isKey, false);
+}
+
+/*!
+    Appends the UTF-8 string of \a len bytes starting at \a utf8 to the
+    stream, escaping characters as required by JSON.
+*/
+void QJsonStreamWriter::appendTextString(const char *utf8, qsizetype len)
+{
+    append(QStringView(QString::fromUtf8(utf8, len)));
+}
+
+/*!
+    \fn void QJsonStreamWriter::append(const char *str, qsizetype size)
+    \overload
+
+    Appends the UTF-8 string \a str of \a size bytes to the stream. If \a
+    size is -1, the string must be null-terminated.
+*/
+
+/*!
+    Starts a JSON array. The following values are the elements of the array,
+    until the matching endArray() call.
+
+    \sa endArray(), startObject()
+*/
+void QJsonStreamWriter::startArray()
+{
+    d->startContainer(false);
+}
+
+/*!
+    Ends the array started by the innermost startArray() call. Returns \c
+    false if the innermost open container is not an array.
+
+    \sa startArray()
+*/
+bool QJsonStreamWriter::endArray()
+{
+    return d->endContainer(false);
+}
+
+/*!
+    Starts a JSON object. The following values alternate between member
+    names and member values, until the matching endObject() call.
+
+    \sa endObject(), startArray()
+*/
+void QJsonStreamWriter::startObject()
+{
+    d->startContainer(true);
+}
+
+/*!
+    Ends the object started by the innermost startObject() call. Returns \c
+    false if the innermost open container is not an object or if the last
+    member has no value.
+
+    \sa startObject()
+*/
+bool QJsonStreamWriter::endObject()
+{
+    return d->endContainer(true);
+}
+
+QT_END_NAMESPACE
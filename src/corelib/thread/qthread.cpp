@@ -93,6 +93,7 @@ QThreadData::~QThreadData()
     thread.storeRelease(nullptr);
     delete t;
 
+    acceptIncomingPostedEvents();
     for (int i = 0; i < postEventList.size(); ++i) {
         const QPostEvent &pe = postEventList.at(i);
         if (pe.event) {
@@ -105,6 +106,53 @@ QThreadData::~QThreadData()
     // fprintf(stderr, "QThreadData %p destroyed\n", this);
 }
 
+/*
+    Moves the events that were posted to this thread without locking (see
+    QCoreApplication::postEvent()) into the post event list, preserving the
+    order in which they were posted. Events whose receiver has been moved to
+    another thread in the meantime are handed over to that thread.
+
+    Must be called with postEventList.mutex locked.
+*/
+void QThreadData::acceptIncomingPostedEvents()
+{
+    QPostEventList::IncomingEvent *e =
+            postEventList.incoming.exchange(nullptr, std::memory_order_acq_rel);
+    if (!e)
+        return;
+
+    QPostEventList::IncomingEvent *inOrder = nullptr;
+    while (e) {
+        QPostEventList::IncomingEvent *next = e->next;
+        e->next = inOrder;
+        inOrder = e;
+        e = next;
+    }
+
+    while (inOrder) {
+        e = inOrder;
+        inOrder = inOrder->next;
+
+        QObjectPrivate *receiver = QObjectPrivate::get(e->postEvent.receiver);
+        QThreadData *data = receiver->threadData.loadAcquire();
+        if (data == this) {
+            postEventList.addEvent(e->postEvent);
+            ++receiver->postedEvents;
+            canWait = false;
+        } else if (data) {
+            if (data->postEventList.addIncomingEvent(e)) {
+                if (QAbstractEventDispatcher *dispatcher = data->eventDispatcher.loadRelaxed())
+                    dispatcher->wakeUp();
+            }
+            continue;
+        } else {
+            e->postEvent.event->m_posted = false;
+            delete e->postEvent.event;
+        }
+        delete e;
+    }
+}
+
 void QThreadData::ref()
 {
 #if QT_CONFIG(thread)
@@ -127,6 +127,63 @@ public:
         }
     }
 
+    // Events posted without taking the mutex, most recent first. They are
+    // moved into the list by QThreadData::acceptIncomingPostedEvents().
+    struct IncomingEvent
+    {
+        QPostEvent postEvent;
+        IncomingEvent *next;
+    };
+    std::atomic<IncomingEvent *> incoming = nullptr;
+
+    // lock-free; returns true if there were no other incoming events
+    bool addIncomingEvent(IncomingEvent *e) noexcept
+    {
+        IncomingEvent *head = incoming.load(std::memory_order_relaxed);
+        do {
+            e->next = head;
+        } while (!incoming.compare_exchange_weak(head, e, std::memory_order_acq_rel,
+                                                 std::memory_order_relaxed));
+        return head == nullptr;
+    }
+
+    bool hasIncomingEvents() const noexcept
+    {
+        return incoming.load(std::memory_order_acquire) != nullptr;
+    }
+
+    // Lock-free posters register here between reading the receiver's
+    // threadData and publishing their event, so that QObject::moveToThread()
+    // can wait for the ones that might have missed the move before handing
+    // the incoming events over. Two phases keep later posters from delaying
+    // the wait indefinitely.
+    std::atomic<int> incomingPhase = 0;
+    std::atomic<int> incomingPosters[2] = {};
+
+    int beginIncomingPost() noexcept
+    {
+        const int phase = incomingPhase.load();
+        incomingPosters[phase].fetch_add(1);
+        // pairs with the fence in waitForIncomingPosts()
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return phase;
+    }
+
+    void endIncomingPost(int phase) noexcept
+    {
+        incomingPosters[phase].fetch_sub(1, std::memory_order_release);
+    }
+
+    // must be called with the mutex locked, after changing the threadData
+    void waitForIncomingPosts() noexcept
+    {
+        const int phase = incomingPhase.load(std::memory_order_relaxed);
+        incomingPhase.store(1 - phase);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        while (incomingPosters[phase].load(std::memory_order_acquire) != 0)
+            QThread::yieldCurrentThread();
+    }
+
 private:
     //hides because they do not keep that list sorted. addEvent must be used
     using QList<QPostEvent>::append;
@@ -264,9 +321,11 @@ public:
     bool canWaitLocked()
     {
         QMutexLocker locker(&postEventList.mutex);
-        return canWait;
+        return canWait && !postEventList.hasIncomingEvents();
     }
 
+    void acceptIncomingPostedEvents();
+
     // This class provides per-thread (by way of being a QThreadData
     // member) storage for qFlagLocation()
     class FlaggedDebugSignatures
@@ -57,11 +57,23 @@ public:
     void run() override;
     void registerThreadInactive();
 
+    bool pushLocalTask(QRunnable *task, bool onlyIfEmpty);
+    QRunnable *takeLocalTask();
+    bool tryTakeLocalTask(QRunnable *task);
+
     QWaitCondition runnableReady;
     QThreadPoolPrivate *manager;
     QRunnable *runnable;
+
+    // Tasks started from within this thread. Only this thread pushes to the
+    // queue; any thread of the pool may take from it.
+    QMutex localMutex;
+    QQueue<QRunnable *> localQueue;
 };
 
+// the pool thread running on the current thread, if any
+static thread_local QThreadPoolThread *currentPoolThread = nullptr;
+
 /*
     QThreadPool private class.
 */
@@ -81,6 +93,7 @@ QThreadPoolThread::QThreadPoolThread(QThreadPoolPrivate *manager)
 */
 void QThreadPoolThread::run()
 {
+    currentPoolThread = this;
     QMutexLocker locker(&manager->mutex);
     for(;;) {
         QRunnable *r = runnable;
@@ -88,27 +101,36 @@ void QThreadPoolThread::run()
 
         do {
             if (r) {
-                // If autoDelete() is false, r might already be deleted after run(), so check status now.
-                const bool del = r->autoDelete();
-
-                // run the task
                 locker.unlock();
+                do {
+                    // If autoDelete() is false, r might already be deleted after run(), so check status now.
+                    const bool del = r->autoDelete();
+
+                    // run the task
 #ifndef QT_NO_EXCEPTIONS
-                try {
+                    try {
 #endif
-                    r->run();
+                        r->run();
 #ifndef QT_NO_EXCEPTIONS
-                } catch (...) {
-                    qWarning("Qt Concurrent has caught an exception thrown from a worker thread.\n"
-                             "This is not supported, exceptions thrown in worker threads must be\n"
-                             "caught before control returns to Qt Concurrent.");
-                    registerThreadInactive();
-                    throw;
-                }
+                    } catch (...) {
+                        qWarning("Qt Concurrent has caught an exception thrown from a worker thread.\n"
+                                 "This is not supported, exceptions thrown in worker threads must be\n"
+                                 "caught before control returns to Qt Concurrent.");
+                        registerThreadInactive();
+                        throw;
+                    }
 #endif
 
-                if (del)
-                    delete r;
+                    if (del)
+                        delete r;
+
+                    // run the tasks started by the one that just finished without
+                    // going through the pool's mutex, unless there is more urgent
+                    // work in the pool's queue
+                    r = nullptr;
+                    if (manager->highPriorityTasks.loadAcquire() == 0)
+                        r = takeLocalTask();
+                } while (r);
                 locker.relock();
             }
 
@@ -117,18 +139,14 @@ void QThreadPoolThread::run()
                 break;
 
             // all work is done, time to wait for more
-            if (manager->queue.isEmpty())
+            r = manager->takeQueuedTask(this);
+            if (!r)
                 break;
-
-            QueuePage *page = manager->queue.first();
-            r = page->pop();
-
-            if (page->isFinished()) {
-                manager->queue.removeFirst();
-                delete page;
-            }
         } while (true);
 
+        // don't sit on work that other threads could do
+        manager->flushLocalTasks(this);
+
         // this thread is about to be deleted, do not wait or expire
         if (!manager->allThreads.contains(this)) {
             registerThreadInactive();
@@ -160,10 +178,32 @@ void QThreadPoolThread::run()
 
 void QThreadPoolThread::registerThreadInactive()
 {
+    manager->allThreadsBusy.storeRelease(0);
     if (--manager->activeThreads == 0)
         manager->noActiveThreads.wakeAll();
 }
 
+bool QThreadPoolThread::pushLocalTask(QRunnable *task, bool onlyIfEmpty)
+{
+    QMutexLocker locker(&localMutex);
+    if (onlyIfEmpty && !localQueue.isEmpty())
+        return false;
+    localQueue.enqueue(task);
+    return true;
+}
+
+QRunnable *QThreadPoolThread::takeLocalTask()
+{
+    QMutexLocker locker(&localMutex);
+    return localQueue.isEmpty() ? nullptr : localQueue.dequeue();
+}
+
+bool QThreadPoolThread::tryTakeLocalTask(QRunnable *task)
+{
+    QMutexLocker locker(&localMutex);
+    return localQueue.removeOne(task);
+}
+
 
 /*
     \internal
@@ -181,8 +221,10 @@ bool QThreadPoolPrivate::tryStart(QRunnable *task)
     }
 
     // can't do anything if we're over the limit
-    if (areAllThreadsActive())
+    if (areAllThreadsActive()) {
+        allThreadsBusy.storeRelease(1);
         return false;
+    }
 
     if (!waitingThreads.isEmpty()) {
         // recycle an available thread
@@ -221,16 +263,110 @@ inline bool comparePriority(int priority, const QueuePage *p)
 void QThreadPoolPrivate::enqueueTask(QRunnable *runnable, int priority)
 {
     Q_ASSERT(runnable != nullptr);
-    for (QueuePage *page : qAsConst(queue)) {
+    if (priority > 0)
+        highPriorityTasks.ref();
+
+    // The queue is sorted by priority and pages are only ever filled at the
+    // back, so only the last page of a given priority can have room left.
+    auto it = std::upper_bound(queue.constBegin(), queue.constEnd(), priority, comparePriority);
+    if (it != queue.constBegin()) {
+        QueuePage *page = *(it - 1);
         if (page->priority() == priority && !page->isFull()) {
             page->push(runnable);
             return;
         }
     }
-    auto it = std::upper_bound(queue.constBegin(), queue.constEnd(), priority, comparePriority);
     queue.insert(std::distance(queue.constBegin(), it), new QueuePage(runnable, priority));
 }
 
+/*!
+    \internal
+
+    Queues \a runnable on the current thread if it is a worker of this pool
+    and all workers are busy, without locking the pool's mutex. The worker
+    will run the task itself once its current task has finished, unless an
+    idle worker steals it first. Returns \c false if the task has to go
+    through tryStart() and the pool's queue instead.
+
+    For \a mode TryStart, the task is only queued if the thread's queue is
+    empty: tryStart() promises that the task starts soon, and it is how
+    Qt Concurrent asks for more threads until it is refused.
+*/
+bool QThreadPoolPrivate::enqueueLocalTask(QRunnable *runnable, LocalTaskMode mode)
+{
+    QThreadPoolThread *thread = currentPoolThread;
+    if (!thread || thread->manager != this || !allThreadsBusy.loadAcquire())
+        return false;
+
+    if (!thread->pushLocalTask(runnable, mode == TryStart))
+        return false;
+
+    // A worker clears the hint before looking for tasks to steal for the
+    // last time, so if it is still set, that worker is going to find ours.
+    if (!allThreadsBusy.loadAcquire()) {
+        QMutexLocker locker(&mutex);
+        if (QRunnable *task = thread->takeLocalTask()) {
+            if (!tryStart(task))
+                enqueueTask(task);
+        }
+    }
+    return true;
+}
+
+/*!
+    \internal
+
+    Returns the next task for \a thread to run: queued tasks with a
+    priority above the default go first, then the tasks \a thread started
+    itself, then the rest of the queue, and finally tasks stolen from other
+    threads. Must be called with the mutex locked.
+*/
+QRunnable *QThreadPoolPrivate::takeQueuedTask(QThreadPoolThread *thread)
+{
+    if (!queue.isEmpty() && queue.constFirst()->priority() > 0)
+        return popQueuedTask();
+    if (QRunnable *r = thread->takeLocalTask())
+        return r;
+    if (!queue.isEmpty())
+        return popQueuedTask();
+    return stealTask(thread);
+}
+
+QRunnable *QThreadPoolPrivate::popQueuedTask()
+{
+    Q_ASSERT(!queue.isEmpty());
+    QueuePage *page = queue.constFirst();
+    if (page->priority() > 0)
+        highPriorityTasks.deref();
+    QRunnable *r = page->pop();
+
+    if (page->isFinished()) {
+        queue.removeFirst();
+        delete page;
+    }
+    return r;
+}
+
+QRunnable *QThreadPoolPrivate::stealTask(QThreadPoolThread *thief)
+{
+    // Clear the hint before looking, so that a thread queuing a local task
+    // after we looked wakes us up through the mutex (see enqueueLocalTask()).
+    allThreadsBusy.fetchAndStoreOrdered(0);
+    for (QThreadPoolThread *thread : qAsConst(allThreads)) {
+        if (thread == thief)
+            continue;
+        if (QRunnable *r = thread->takeLocalTask())
+            return r;
+    }
+    return nullptr;
+}
+
+void QThreadPoolPrivate::flushLocalTasks(QThreadPoolThread *thread)
+{
+    while (QRunnable *r = thread->takeLocalTask())
+        enqueueTask(r);
+}
+
 int QThreadPoolPrivate::activeThreadCount() const
 {
     return (allThreads.count()
@@ -241,18 +377,15 @@ int QThreadPoolPrivate::activeThreadCount() const
 
 void QThreadPoolPrivate::tryToStartMoreThreads()
 {
+    allThreadsBusy.storeRelease(0);
+
     // try to push tasks on the queue to any available threads
     while (!queue.isEmpty()) {
         QueuePage *page = queue.first();
         if (!tryStart(page->first()))
             break;
 
-        page->pop();
-
-        if (page->isFinished()) {
-            queue.removeFirst();
-            delete page;
-        }
+        popQueuedTask();
     }
 }
 
@@ -342,6 +475,9 @@ bool QThreadPoolPrivate::waitForDone(int msecs)
 void QThreadPoolPrivate::clear()
 {
     QMutexLocker locker(&mutex);
+    for (QThreadPoolThread *thread : qAsConst(allThreads))
+        flushLocalTasks(thread);
+    highPriorityTasks.storeRelaxed(0);
     while (!queue.isEmpty()) {
         auto *page = queue.takeLast();
         while (!page->isFinished()) {
@@ -383,6 +519,8 @@ bool QThreadPool::tryTake(QRunnable *runnable)
     QMutexLocker locker(&d->mutex);
     for (QueuePage *page : qAsConst(d->queue)) {
         if (page->tryTake(runnable)) {
+            if (page->priority() > 0)
+                d->highPriorityTasks.deref();
             if (page->isFinished()) {
                 d->queue.removeOne(page);
                 delete page;
@@ -391,6 +529,11 @@ bool QThreadPool::tryTake(QRunnable *runnable)
         }
     }
 
+    for (QThreadPoolThread *thread : qAsConst(d->allThreads)) {
+        if (thread->tryTakeLocalTask(runnable))
+            return true;
+    }
+
     return false;
 }
 
@@ -399,19 +542,26 @@ bool QThreadPool::tryTake(QRunnable *runnable)
      Searches for \a runnable in the queue, removes it from the queue and
      runs it if found. This function does not return until the runnable
      has completed.
+
+     A runnable that is not auto-deleted can be queued more than once, for
+     instance on the threads that were busy when it called tryStart(this).
+     All of these are run, so that the caller does not wait for threads
+     that may be waiting for it.
      */
 void QThreadPoolPrivate::stealAndRunRunnable(QRunnable *runnable)
 {
     Q_Q(QThreadPool);
-    if (!q->tryTake(runnable))
-        return;
-    // If autoDelete() is false, runnable might already be deleted after run(), so check status now.
-    const bool del = runnable->autoDelete();
+    while (q->tryTake(runnable)) {
+        // If autoDelete() is false, runnable might already be deleted after run(), so check status now.
+        const bool del = runnable->autoDelete();
 
-    runnable->run();
+        runnable->run();
 
-    if (del)
-        delete runnable;
+        if (del) {
+            delete runnable;
+            return;
+        }
+    }
 }
 
 /*!
@@ -513,6 +663,14 @@ QThreadPool *QThreadPool::globalInstance()
     \a runnable is added to a run queue instead. The \a priority argument can
     be used to control the run queue's order of execution.
 
+    When called from a runnable that is running in this pool, with the
+    default \a priority, while all of the pool's threads are busy,
+    \a runnable is queued on the calling thread without locking the pool.
+    That thread runs it after its current runnable, unless an idle thread
+    takes it first. Such runnables run in the order they were started, but
+    may run before runnables of the same priority that were queued
+    earlier. Runnables with a higher priority always run first.
+
     Note that the thread pool takes ownership of the \a runnable if
     \l{QRunnable::autoDelete()}{runnable->autoDelete()} returns \c true,
     and the \a runnable will be deleted automatically by the thread
@@ -528,6 +686,9 @@ void QThreadPool::start(QRunnable *runnable, int priority)
         return;
 
     Q_D(QThreadPool);
+    if (priority == 0 && d->enqueueLocalTask(runnable, QThreadPoolPrivate::Start))
+        return;
+
     QMutexLocker locker(&d->mutex);
 
     if (!d->tryStart(runnable))
@@ -557,6 +718,11 @@ void QThreadPool::start(std::function<void()> functionToRun, int priority)
     does nothing and returns \c false.  Otherwise, \a runnable is run immediately
     using one available thread and this function returns \c true.
 
+    When called from a thread of this pool while all of its threads are busy,
+    \a runnable can also be queued on the calling thread, unless that thread
+    already has queued tasks. It then runs on the first thread that becomes
+    idle, or on the calling thread once its current task has finished.
+
     Note that on success the thread pool takes ownership of the \a runnable if
     \l{QRunnable::autoDelete()}{runnable->autoDelete()} returns \c true,
     and the \a runnable will be deleted automatically by the thread
@@ -572,6 +738,9 @@ bool QThreadPool::tryStart(QRunnable *runnable)
         return false;
 
     Q_D(QThreadPool);
+    if (d->enqueueLocalTask(runnable, QThreadPoolPrivate::TryStart))
+        return true;
+
     QMutexLocker locker(&d->mutex);
     if (d->tryStart(runnable))
         return true;
@@ -594,11 +763,11 @@ bool QThreadPool::tryStart(std::function<void()> functionToRun)
         return false;
 
     Q_D(QThreadPool);
-    QMutexLocker locker(&d->mutex);
-    if (!d->allThreads.isEmpty() && d->areAllThreadsActive())
-        return false;
-
     QRunnable *runnable = QRunnable::create(std::move(functionToRun));
+    if (d->enqueueLocalTask(runnable, QThreadPoolPrivate::TryStart))
+        return true;
+
+    QMutexLocker locker(&d->mutex);
     if (d->tryStart(runnable))
         return true;
     delete runnable;
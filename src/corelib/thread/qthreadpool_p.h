@@ -154,6 +154,12 @@ public:
 
     bool tryStart(QRunnable *task);
     void enqueueTask(QRunnable *task, int priority = 0);
+    enum LocalTaskMode { Start, TryStart };
+    bool enqueueLocalTask(QRunnable *task, LocalTaskMode mode);
+    QRunnable *takeQueuedTask(QThreadPoolThread *thread);
+    QRunnable *popQueuedTask();
+    QRunnable *stealTask(QThreadPoolThread *thief);
+    void flushLocalTasks(QThreadPoolThread *thread);
     int activeThreadCount() const;
 
     void tryToStartMoreThreads();
@@ -176,6 +182,11 @@ public:
     QQueue<QThreadPoolThread *> expiredThreads;
     QList<QueuePage *> queue;
     QWaitCondition noActiveThreads;
+
+    // Read without holding the mutex, so that worker threads can run the
+    // tasks they started themselves without contending on it.
+    QAtomicInt highPriorityTasks;   // queued tasks with priority > 0
+    QAtomicInt allThreadsBusy;      // hint, set when tryStart() failed
     QString objectName;
 
     int expiryTimeout = 30000;
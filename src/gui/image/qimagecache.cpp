@@ -0,0 +1,339 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtGui module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qimagecache.h"
+#include "qatomic.h"
+#include "qcache.h"
+#include "qhash.h"
+#include "qmutex.h"
+#include "qpixmapcache_p.h"
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QImageCache
+    \inmodule QtGui
+    \since 6.3
+
+    \brief The QImageCache class provides an application-wide cache for
+    images that can be used from any thread.
+
+    QImageCache is the counterpart of QPixmapCache for QImage. As QImage
+    does not depend on the windowing system, images can be decoded or
+    scaled in worker threads, and QImageCache allows these threads to share
+    the results with each other and with the main thread. Use insert() to
+    insert images, find() to find them, and clear() to empty the cache.
+
+    QImageCache contains no member data, only static functions to access
+    the global image cache. All of them are thread-safe.
+
+    Large caches are divided into up to 16 partitions, each protected by
+    its own lock, so that threads working on different keys rarely wait for
+    each other. Every key belongs to exactly one partition, and each
+    partition gets an equal share of the cacheLimit(), which is at least
+    4096 KB; smaller caches use a single partition.
+
+    If two images are inserted into the cache using equal keys then the
+    last image will replace the first image in the cache.
+
+    The cache becomes full when the total size of all images in the cache
+    exceeds cacheLimit(). The initial cache limit is 10240 KB (10 MB); you
+    can change this by calling setCacheLimit() with the required value.
+    When a partition is full, its least recently accessed images are
+    removed first. An image takes QImage::sizeInBytes() bytes of memory.
+
+    hitCount() and missCount() tell how many lookups succeeded and failed,
+    which helps to choose a suitable cache limit.
+
+    \sa QPixmapCache, QCache, QImage
+*/
+
+static const int cache_limit_default = 10240; // 10 MB cache limit
+
+static inline qsizetype cost(const QImage &image)
+{
+    return qt_pixmapcache_cost(image.sizeInBytes());
+}
+
+namespace {
+
+// separate cache lines, so that the locks of the shards don't contend
+struct alignas(64) QImageCacheShard
+{
+    QMutex mutex;
+    QCache<QString, QImage> cache;
+    qint64 hits = 0;
+    qint64 misses = 0;
+};
+
+struct QImageCacheData
+{
+    enum { MaxShardCount = 16, MinShardLimit = 4096 };
+
+    QImageCacheData() { setCacheLimit(cache_limit_default); }
+
+    void setCacheLimit(int n);
+
+    QMutex limitMutex;
+    int limit = 0;
+    // only changes while all shards are locked
+    QAtomicInt shardCount = 1;
+    QImageCacheShard shards[MaxShardCount];
+};
+
+void QImageCacheData::setCacheLimit(int n)
+{
+    QMutexLocker locker(&limitMutex);
+    limit = qMax(n, 0);
+    // a shard only holds images up to its share of the limit, so the limit
+    // is only divided when the shares are still large
+    const int count = qBound(1, limit / MinShardLimit, int(MaxShardCount));
+    const qsizetype shardLimit = limit > 0 ? qMax(1, limit / count) : 0;
+
+    for (QImageCacheShard &shard : shards)
+        shard.mutex.lock();
+    const int oldCount = shardCount.loadRelaxed();
+    // the keys belong to other shards when their number changes
+    QList<std::pair<QString, QImage *>> images;
+    if (count != oldCount) {
+        for (int i = 0; i < oldCount; ++i) {
+            const QList<QString> keys = shards[i].cache.keys();
+            for (const QString &key : keys)
+                images.append({ key, shards[i].cache.take(key) });
+        }
+        shardCount.storeRelaxed(count);
+    }
+    for (int i = 0; i < MaxShardCount; ++i)
+        shards[i].cache.setMaxCost(i < count ? shardLimit : 0);
+    for (const auto &[key, image] : qAsConst(images)) {
+        QImageCacheShard &shard = shards[qHash(key) % count];
+        shard.cache.insert(key, image, cost(*image));
+    }
+    for (QImageCacheShard &shard : shards)
+        shard.mutex.unlock();
+}
+
+// Locks the shard that \a key belongs to.
+class QImageCacheShardLocker
+{
+public:
+    QImageCacheShardLocker(QImageCacheData *data, const QString &key)
+    {
+        const size_t hash = qHash(key);
+        for (;;) {
+            const int count = data->shardCount.loadAcquire();
+            shard = &data->shards[hash % count];
+            shard->mutex.lock();
+            // the number of shards can't change anymore once one is locked
+            if (count == data->shardCount.loadRelaxed())
+                break;
+            shard->mutex.unlock();
+        }
+    }
+    ~QImageCacheShardLocker() { shard->mutex.unlock(); }
+
+    QImageCacheShard *operator->() const { return shard; }
+
+private:
+    Q_DISABLE_COPY_MOVE(QImageCacheShardLocker)
+    QImageCacheShard *shard;
+};
+
+} // unnamed namespace
+
+Q_GLOBAL_STATIC(QImageCacheData, im_cache)
+
+/*!
+    Looks for a cached image associated with the given \a key in the cache.
+    If the image is found, the function sets \a image to that image and
+    returns \c true; otherwise it leaves \a image alone and returns \c false.
+*/
+bool QImageCache::find(const QString &key, QImage *image)
+{
+    QImageCacheData *data = im_cache();
+    if (!data)
+        return false;
+    QImageCacheShardLocker shard(data, key);
+    const QImage *ptr = shard->cache.object(key);
+    if (!ptr) {
+        ++shard->misses;
+        return false;
+    }
+    ++shard->hits;
+    if (image)
+        *image = *ptr;
+    return true;
+}
+
+/*!
+    Inserts a copy of the image \a image associated with the \a key into
+    the cache.
+
+    When an image is inserted and its partition of the cache is about to
+    exceed its share of the limit, it removes images until there is enough
+    room for the image to be inserted.
+
+    The oldest images (least recently accessed in the cache) are
+    deleted when more space is needed.
+
+    The function returns \c true if the object was inserted into the
+    cache; otherwise it returns \c false.
+
+    \sa setCacheLimit()
+*/
+bool QImageCache::insert(const QString &key, const QImage &image)
+{
+    QImageCacheData *data = im_cache();
+    if (!data || image.isNull())
+        return false;
+    QImageCacheShardLocker shard(data, key);
+    return shard->cache.insert(key, new QImage(image), cost(image));
+}
+
+/*!
+    Returns the cache limit (in kilobytes).
+
+    The default cache limit is 10240 KB.
+
+    \sa setCacheLimit()
+*/
+int QImageCache::cacheLimit()
+{
+    QImageCacheData *data = im_cache();
+    if (!data)
+        return 0;
+    QMutexLocker locker(&data->limitMutex);
+    return data->limit;
+}
+
+/*!
+    Sets the cache limit to \a n kilobytes.
+
+    The limit is shared evenly between the partitions of the cache, so an
+    image that is larger than that share is not cached. Caches with a limit
+    below 8192 KB are not partitioned, so that images up to the full limit
+    can be cached.
+
+    The default setting is 10240 KB.
+
+    \sa cacheLimit()
+*/
+void QImageCache::setCacheLimit(int n)
+{
+    if (QImageCacheData *data = im_cache())
+        data->setCacheLimit(n);
+}
+
+/*!
+    Removes the image associated with \a key from the cache.
+*/
+void QImageCache::remove(const QString &key)
+{
+    QImageCacheData *data = im_cache();
+    if (!data)
+        return;
+    QImageCacheShardLocker shard(data, key);
+    shard->cache.remove(key);
+}
+
+/*!
+    Removes all images from the cache.
+*/
+void QImageCache::clear()
+{
+    if (!im_cache.exists())
+        return;
+    for (QImageCacheShard &shard : im_cache->shards) {
+        QMutexLocker locker(&shard.mutex);
+        shard.cache.clear();
+    }
+}
+
+/*!
+    Returns how many calls to find() found an image since the start of the
+    application or the last call to resetStatistics().
+
+    \sa missCount()
+*/
+qint64 QImageCache::hitCount()
+{
+    if (!im_cache.exists())
+        return 0;
+    qint64 hits = 0;
+    for (QImageCacheShard &shard : im_cache->shards) {
+        QMutexLocker locker(&shard.mutex);
+        hits += shard.hits;
+    }
+    return hits;
+}
+
+/*!
+    Returns how many calls to find() did not find an image since the start
+    of the application or the last call to resetStatistics().
+
+    \sa hitCount()
+*/
+qint64 QImageCache::missCount()
+{
+    if (!im_cache.exists())
+        return 0;
+    qint64 misses = 0;
+    for (QImageCacheShard &shard : im_cache->shards) {
+        QMutexLocker locker(&shard.mutex);
+        misses += shard.misses;
+    }
+    return misses;
+}
+
+/*!
+    Sets hitCount() and missCount() back to zero.
+*/
+void QImageCache::resetStatistics()
+{
+    if (!im_cache.exists())
+        return;
+    for (QImageCacheShard &shard : im_cache->shards) {
+        QMutexLocker locker(&shard.mutex);
+        shard.hits = 0;
+        shard.misses = 0;
+    }
+}
+
+QT_END_NAMESPACE
@@ -95,12 +95,8 @@ static const int cache_limit_default = 10240; // 10 MB cache limit
 
 static inline qsizetype cost(const QPixmap &pixmap)
 {
-    // make sure to do a 64bit calculation; qsizetype might be smaller
-    const qint64 costKb = static_cast<qint64>(pixmap.width())
-                        * pixmap.height() * pixmap.depth() / (8 * 1024);
-    const qint64 costMax = std::numeric_limits<qsizetype>::max();
-    // a small pixmap should have at least a cost of 1(kb)
-    return static_cast<qsizetype>(qBound(1LL, costKb, costMax));
+    return qt_pixmapcache_cost(static_cast<qint64>(pixmap.width())
+                               * pixmap.height() * pixmap.depth() / 8);
 }
 
 static inline bool qt_pixmapcache_thread_test()
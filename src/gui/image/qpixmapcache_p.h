@@ -57,10 +57,23 @@
 #include <private/qpixmap_raster_p.h>
 #include "qcache.h"
 
+#include <limits>
+
 QT_BEGIN_NAMESPACE
 
 size_t qHash(const QPixmapCache::Key &k, size_t seed = 0);
 
+// The cost of an image of the given size in bytes in QPixmapCache and
+// QImageCache, in kilobytes.
+inline qsizetype qt_pixmapcache_cost(qint64 sizeInBytes)
+{
+    // make sure to do a 64bit calculation; qsizetype might be smaller
+    const qint64 costKb = sizeInBytes / 1024;
+    const qint64 costMax = std::numeric_limits<qsizetype>::max();
+    // a small pixmap should have at least a cost of 1(kb)
+    return static_cast<qsizetype>(qBound(1LL, costKb, costMax));
+}
+
 class QPixmapCache::KeyData
 {
 public:
@@ -40,6 +40,7 @@
 #include "hpacktable_p.h"
 
 #include <QtCore/qdebug.h>
+#include <QtCore/qhash.h>
 
 #include <algorithm>
 #include <cstddef>
@@ -444,8 +445,7 @@ void FieldLookupTable::setMaxDynamicTableSize(quint32 size)
     updateDynamicTableSize(size);
 }
 
-// This data is from the HPACK's specs and it's quite conveniently sorted,
-// except ... 'accept' is in the wrong position, see how we handle it below.
+// This data is from the HPACK's specs, fields with the same name are adjacent.
 const std::vector<HeaderField> &FieldLookupTable::staticPart()
 {
     static std::vector<HeaderField> table = {
@@ -517,28 +517,34 @@ const std::vector<HeaderField> &FieldLookupTable::staticPart()
 
 std::vector<HeaderField>::const_iterator FieldLookupTable::findInStaticPart(const HeaderField &field, CompareMode mode)
 {
-    const auto &table = staticPart();
-    const auto acceptPos = table.begin() + 18;
-    if (field.name == "accept") {
-        if (mode == CompareMode::nameAndValue && field.value != "")
-            return table.end();
-        return acceptPos;
-    }
+    // Every header field we encode is looked up here first, so instead
+    // of a binary search over the names we hash them. Fields with
+    // the same name are adjacent, the hash has the first one of them:
+    static const QHash<QByteArray, quint32> names = [] {
+        QHash<QByteArray, quint32> hash;
+        const auto &table = staticPart();
+        for (quint32 i = 0; i < table.size(); ++i) {
+            if (!hash.contains(table[i].name))
+                hash.insert(table[i].name, i);
+        }
+        return hash;
+    }();
 
-    auto predicate = [mode](const HeaderField &lhs, const HeaderField &rhs) {
-        const int cmp = compare(lhs.name, rhs.name);
-        if (cmp)
-            return cmp < 0;
-        else if (mode == CompareMode::nameAndValue)
-            return compare(lhs.value, rhs.value) < 0;
-        return false;
-    };
+    const auto &table = staticPart();
+    const auto it = names.constFind(field.name);
+    if (it == names.cend())
+        return table.end();
 
-    const auto staticPos = std::lower_bound(table.begin(), acceptPos, field, predicate);
-    if (staticPos != acceptPos)
+    auto staticPos = table.begin() + *it;
+    if (mode == CompareMode::nameOnly)
         return staticPos;
 
-    return std::lower_bound(acceptPos + 1, table.end(), field, predicate);
+    for (; staticPos != table.end() && staticPos->name == field.name; ++staticPos) {
+        if (staticPos->value == field.value)
+            return staticPos;
+    }
+
+    return table.end();
 }
 
 }
@@ -90,6 +90,11 @@ QHttpNetworkRequest::Priority Stream::priority() const
     return httpPair.first.priority();
 }
 
+int Stream::urgency() const
+{
+    return httpPair.first.urgency();
+}
+
 uchar Stream::weight() const
 {
     switch (priority()) {
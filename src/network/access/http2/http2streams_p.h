@@ -93,6 +93,7 @@ struct Q_AUTOTEST_EXPORT Stream
     const QHttpNetworkRequest &request() const;
     QHttpNetworkRequest &request();
     QHttpNetworkRequest::Priority priority() const;
+    int urgency() const;
     uchar weight() const;
 
     QNonContiguousByteDevice *data() const;
@@ -102,6 +103,8 @@ struct Q_AUTOTEST_EXPORT Stream
     // Signed as window sizes can become negative:
     qint32 sendWindow = 65535;
     qint32 recvWindow = 65535;
+    // DATA received while the bandwidth-delay product is being sampled:
+    qint64 bdpSample = 0;
 
     StreamState state = idle;
     QString key; // for PUSH_PROMISE
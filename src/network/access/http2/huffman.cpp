@@ -385,7 +385,7 @@ quint64 huffman_encoded_bit_length(const QByteArray &inputData)
 {
     quint64 bitLength = 0;
     for (int i = 0, e = inputData.size(); i < e; ++i)
-        bitLength += staticHuffmanCodeTable[int(inputData[i])].bitLength;
+        bitLength += staticHuffmanCodeTable[uchar(inputData[i])].bitLength;
 
     return bitLength;
 }
@@ -490,11 +490,42 @@ HuffmanDecoder::HuffmanDecoder()
             }
         }
     }
+
+    addMultiSymbolTable();
 }
 
 bool HuffmanDecoder::decodeStream(BitIStream &inputStream, QByteArray &outputBuffer)
 {
+    // Every symbol takes at least minCodeLength bits:
+    const quint64 bitsLeft = inputStream.bitLength() - inputStream.streamOffset();
+    outputBuffer.reserve(outputBuffer.size() + qsizetype(bitsLeft / minCodeLength));
+
+    const quint32 multiSymbolLength = quint32(BitConstants::multiSymbolPrefix);
+    bool longCode = false;
+
     while (true) {
+        // Fast path: decode short codes, several symbols per lookup, while
+        // at least 'multiSymbolLength' bits remain in a 64-bit window.
+        // Long codes tend to come in a row (binary data), so we skip it
+        // after one of them:
+        if (!longCode) {
+            quint64 window = 0;
+            const quint64 windowBits = inputStream.peekBits(inputStream.streamOffset(), 64, &window);
+            quint64 consumed = 0;
+            while (windowBits - consumed >= multiSymbolLength) {
+                const MultiSymbolEntry &entry =
+                        multiSymbolTable[(window << consumed) >> (64 - multiSymbolLength)];
+                if (!entry.symbolCount)
+                    break;
+                outputBuffer.append(char(entry.symbols[0]));
+                if (entry.symbolCount > 1)
+                    outputBuffer.append(char(entry.symbols[1]));
+                consumed += entry.bitLength;
+            }
+            inputStream.skipBits(consumed);
+        }
+
+        // A long code or the last few bits of the stream, one symbol at a time:
         quint32 chunk = 0;
         const quint32 readBits = inputStream.peekBits(inputStream.streamOffset(), 32, &chunk);
         if (!readBits)
@@ -505,20 +536,7 @@ bool HuffmanDecoder::decodeStream(BitIStream &inputStream, QByteArray &outputBuf
             return padding_is_valid(chunk, readBits);
         }
 
-        quint32 tableIndex = 0;
-        const PrefixTable *table = &prefixTables[tableIndex];
-        quint32 entryIndex = chunk >> (32 - table->indexLength);
-        PrefixTableEntry entry = tableEntry(*table, entryIndex);
-
-        while (true) {
-            if (entry.nextTable == tableIndex)
-                break;
-
-            tableIndex = entry.nextTable;
-            table = &prefixTables[tableIndex];
-            entryIndex = chunk << table->prefixLength >> (32 - table->indexLength);
-            entry = tableEntry(*table, entryIndex);
-        }
+        const PrefixTableEntry entry = decodeSymbol(chunk);
 
         if (entry.bitLength > readBits) {
             inputStream.skipBits(readBits);
@@ -533,11 +551,54 @@ bool HuffmanDecoder::decodeStream(BitIStream &inputStream, QByteArray &outputBuf
 
         outputBuffer.append(entry.byteValue);
         inputStream.skipBits(entry.bitLength);
+        longCode = entry.bitLength > multiSymbolLength;
     }
 
     return false;
 }
 
+PrefixTableEntry HuffmanDecoder::decodeSymbol(quint32 chunk)
+{
+    quint32 tableIndex = 0;
+    const PrefixTable *table = &prefixTables[tableIndex];
+    quint32 entryIndex = chunk >> (32 - table->indexLength);
+    PrefixTableEntry entry = tableEntry(*table, entryIndex);
+
+    while (true) {
+        if (entry.nextTable == tableIndex)
+            break;
+
+        tableIndex = entry.nextTable;
+        table = &prefixTables[tableIndex];
+        entryIndex = chunk << table->prefixLength >> (32 - table->indexLength);
+        entry = tableEntry(*table, entryIndex);
+    }
+
+    return entry;
+}
+
+void HuffmanDecoder::addMultiSymbolTable()
+{
+    const quint32 indexLength = quint32(BitConstants::multiSymbolPrefix);
+    multiSymbolTable.resize(std::size_t(1) << indexLength);
+
+    for (quint32 index = 0; index < multiSymbolTable.size(); ++index) {
+        MultiSymbolEntry &multiEntry = multiSymbolTable[index];
+        // The bits past the index are zeros, so only the codes that
+        // end within the index are taken:
+        const quint32 bits = index << (32 - indexLength);
+        while (multiEntry.symbolCount < sizeof multiEntry.symbols) {
+            const PrefixTableEntry entry = decodeSymbol(bits << multiEntry.bitLength);
+            if (!entry.bitLength || entry.byteValue == 256
+                || multiEntry.bitLength + entry.bitLength > indexLength) {
+                break;
+            }
+            multiEntry.symbols[multiEntry.symbolCount++] = uchar(entry.byteValue);
+            multiEntry.bitLength += entry.bitLength;
+        }
+    }
+}
+
 quint32 HuffmanDecoder::addTable(quint32 prefix, quint32 index)
 {
     PrefixTable newTable{prefix, index};
@@ -134,6 +134,31 @@ struct PrefixTableEntry
     quint32 byteValue;
 };
 
+// MultiSymbolEntry:
+// the prefix tables above decode one symbol per lookup.
+// Most of the symbols in real headers have short codes
+// (5 to 8 bits), so several of them fit into one index
+// of 'multiSymbolPrefix' bits. A MultiSymbolEntry holds
+// all the symbols whose codes are complete within its
+// index, and their total bit length. An entry with no
+// symbols means the index starts with a longer code,
+// decoded by the prefix tables.
+
+struct MultiSymbolEntry
+{
+    MultiSymbolEntry()
+        : symbolCount(),
+          bitLength(),
+          symbols()
+    {
+    }
+
+    quint8 symbolCount;
+    quint8 bitLength;
+    // Codes are at least 5 bits long, two of them fit into 12 bits:
+    uchar symbols[2];
+};
+
 class BitIStream;
 
 class HuffmanDecoder
@@ -142,7 +167,8 @@ public:
     enum class BitConstants
     {
         rootPrefix = 9,
-        childPrefix = 6
+        childPrefix = 6,
+        multiSymbolPrefix = 12
     };
 
     HuffmanDecoder();
@@ -153,9 +179,12 @@ private:
     quint32 addTable(quint32 prefixLength, quint32 indexLength);
     PrefixTableEntry tableEntry(const PrefixTable &table, quint32 index);
     void setTableEntry(const PrefixTable &table, quint32 index, const PrefixTableEntry &entry);
+    PrefixTableEntry decodeSymbol(quint32 chunk);
+    void addMultiSymbolTable();
 
     std::vector<PrefixTable> prefixTables;
     std::vector<PrefixTableEntry> tableData;
+    std::vector<MultiSymbolEntry> multiSymbolTable;
     quint32 minCodeLength;
 };
 
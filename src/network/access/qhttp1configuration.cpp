@@ -0,0 +1,302 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtNetwork module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qhttp1configuration.h"
+
+#include "private/qhttpnetworkconnection_p.h"
+
+QT_BEGIN_NAMESPACE
+
+// Every connection to a host reserves a channel up front, whether it is
+// opened or not.
+static constexpr qsizetype MaximumConnectionsPerHost = 256;
+
+/*!
+    \class QHttp1Configuration
+    \brief The QHttp1Configuration class controls HTTP/1.1 parameters and settings.
+    \since 6.3
+
+    \reentrant
+    \inmodule QtNetwork
+    \ingroup network
+    \ingroup shared
+
+    QHttp1Configuration controls the pool of HTTP/1.1 connections that
+    QNetworkAccessManager opens to a host. The parameters that
+    QHttp1Configuration currently supports are:
+
+    \list
+      \li The number of connections that can be open to the host at the
+         same time. Each connection carries one request at a time, or
+         several if pipelining is allowed.
+      \li Whether the pool starts small and only grows towards that
+         number while requests are queued.
+      \li How many requests can be pipelined on one connection, for
+         requests that allow pipelining with
+         QNetworkRequest::HttpPipeliningAllowedAttribute.
+      \li How long the connections to the host are kept open while no
+         requests use them.
+    \endlist
+
+    \note The configuration must be set before the first request is sent
+    to a given host. QNetworkAccessManager uses the configuration of the
+    request that opens the connections to a host for all requests that
+    later reuse them.
+
+    \sa QNetworkRequest::setHttp1Configuration(), QNetworkRequest::http1Configuration(),
+        QHttp2Configuration, QNetworkAccessManager
+*/
+
+class QHttp1ConfigurationPrivate : public QSharedData
+{
+public:
+    qsizetype numberOfConnectionsPerHost = QHttpNetworkConnectionPrivate::defaultHttpChannelCount;
+    qsizetype maximumPipelineLength = QHttpNetworkConnectionPrivate::defaultPipelineLength;
+    int idleTimeout = QHttpNetworkConnectionPrivate::defaultIdleTimeout;
+    bool adaptiveConnectionCount = false;
+};
+
+/*!
+    Default constructs a QHttp1Configuration object.
+
+    Such a configuration has the following values:
+    \list
+        \li Up to 6 connections are opened per host
+        \li The connection count is not adaptive
+        \li Up to 3 requests are pipelined on a connection
+        \li Idle connections are closed after 120 seconds
+    \endlist
+*/
+QHttp1Configuration::QHttp1Configuration()
+    : d(new QHttp1ConfigurationPrivate)
+{
+}
+
+/*!
+    Copy-constructs this QHttp1Configuration.
+*/
+QHttp1Configuration::QHttp1Configuration(const QHttp1Configuration &) = default;
+
+/*!
+    Move-constructs this QHttp1Configuration from \a other
+*/
+QHttp1Configuration::QHttp1Configuration(QHttp1Configuration &&other) noexcept
+{
+    swap(other);
+}
+
+/*!
+    Copy-assigns \a other to this QHttp1Configuration.
+*/
+QHttp1Configuration &QHttp1Configuration::operator=(const QHttp1Configuration &) = default;
+
+/*!
+    Move-assigns \a other to this QHttp1Configuration.
+*/
+QHttp1Configuration &QHttp1Configuration::operator=(QHttp1Configuration &&) noexcept = default;
+
+/*!
+    Destructor.
+*/
+QHttp1Configuration::~QHttp1Configuration()
+{
+}
+
+/*!
+    Sets the maximum number of connections that QNetworkAccessManager
+    opens to a host to \a number. \a number must be between 1 and 256.
+
+    Connections are only opened when there are requests for them. A
+    higher number lets more requests to a single host run in parallel,
+    at the cost of more sockets on both ends.
+
+    Returns \c true on success, \c false otherwise.
+
+    \sa numberOfConnectionsPerHost, setAdaptiveConnectionCountEnabled
+*/
+bool QHttp1Configuration::setNumberOfConnectionsPerHost(qsizetype number)
+{
+    if (number < 1 || number > MaximumConnectionsPerHost) {
+        qWarning("QHttp1Configuration::setNumberOfConnectionsPerHost: invalid number of connections");
+        return false;
+    }
+
+    d->numberOfConnectionsPerHost = number;
+    return true;
+}
+
+/*!
+    Returns the maximum number of connections opened to a host. The
+    default is 6.
+
+    \sa setNumberOfConnectionsPerHost
+*/
+qsizetype QHttp1Configuration::numberOfConnectionsPerHost() const
+{
+    return d->numberOfConnectionsPerHost;
+}
+
+/*!
+    If \a enable is \c true, QNetworkAccessManager starts with at most 6
+    connections to a host, and doubles that limit, up to
+    numberOfConnectionsPerHost(), whenever more requests are queued than
+    it has connections. A short burst of requests then does not open
+    many connections, while a sustained load can still use all of them.
+
+    \sa adaptiveConnectionCountEnabled, setNumberOfConnectionsPerHost
+*/
+void QHttp1Configuration::setAdaptiveConnectionCountEnabled(bool enable)
+{
+    d->adaptiveConnectionCount = enable;
+}
+
+/*!
+    Returns \c true if the number of connections grows with the number
+    of queued requests. Disabled by default.
+
+    \sa setAdaptiveConnectionCountEnabled
+*/
+bool QHttp1Configuration::adaptiveConnectionCountEnabled() const
+{
+    return d->adaptiveConnectionCount;
+}
+
+/*!
+    Sets the number of requests that can be pipelined on a connection,
+    in addition to the request it is currently processing, to \a length.
+    \a length must be at least 1.
+
+    This only applies to requests that allow pipelining with
+    QNetworkRequest::HttpPipeliningAllowedAttribute.
+
+    Returns \c true on success, \c false otherwise.
+
+    \sa maximumPipelineLength
+*/
+bool QHttp1Configuration::setMaximumPipelineLength(qsizetype length)
+{
+    if (length < 1) {
+        qWarning("QHttp1Configuration::setMaximumPipelineLength: invalid pipeline length");
+        return false;
+    }
+
+    d->maximumPipelineLength = length;
+    return true;
+}
+
+/*!
+    Returns the number of requests that can be pipelined on a connection.
+    The default is 3.
+
+    \sa setMaximumPipelineLength
+*/
+qsizetype QHttp1Configuration::maximumPipelineLength() const
+{
+    return d->maximumPipelineLength;
+}
+
+/*!
+    Sets the time, in \a seconds, for which the connections to a host are
+    kept open after the last request using them has finished. \a seconds
+    cannot be negative.
+
+    Returns \c true on success, \c false otherwise.
+
+    \note A server can close idle connections earlier.
+
+    \sa idleTimeout
+*/
+bool QHttp1Configuration::setIdleTimeout(int seconds)
+{
+    if (seconds < 0) {
+        qWarning("QHttp1Configuration::setIdleTimeout: invalid timeout");
+        return false;
+    }
+
+    d->idleTimeout = seconds;
+    return true;
+}
+
+/*!
+    Returns the time, in seconds, for which idle connections to a host
+    are kept open. The default is 120 seconds.
+
+    \sa setIdleTimeout
+*/
+int QHttp1Configuration::idleTimeout() const
+{
+    return d->idleTimeout;
+}
+
+/*!
+    Swaps this configuration with the \a other configuration.
+*/
+void QHttp1Configuration::swap(QHttp1Configuration &other) noexcept
+{
+    d.swap(other.d);
+}
+
+/*!
+    \fn bool QHttp1Configuration::operator==(const QHttp1Configuration &lhs, const QHttp1Configuration &rhs) noexcept
+    Returns \c true if \a lhs and \a rhs have the same set of HTTP/1.1
+    parameters.
+*/
+
+/*!
+    \fn bool QHttp1Configuration::operator!=(const QHttp1Configuration &lhs, const QHttp1Configuration &rhs) noexcept
+    Returns \c true if \a lhs and \a rhs do not have the same set of HTTP/1.1
+    parameters.
+*/
+
+/*!
+    \internal
+*/
+bool QHttp1Configuration::isEqual(const QHttp1Configuration &other) const noexcept
+{
+    if (d == other.d)
+        return true;
+
+    return d->numberOfConnectionsPerHost == other.d->numberOfConnectionsPerHost
+           && d->adaptiveConnectionCount == other.d->adaptiveConnectionCount
+           && d->maximumPipelineLength == other.d->maximumPipelineLength
+           && d->idleTimeout == other.d->idleTimeout;
+}
+
+QT_END_NAMESPACE
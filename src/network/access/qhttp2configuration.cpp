@@ -77,6 +77,9 @@ QT_BEGIN_NAMESPACE
       \li The server push. Allows to enable or disable server push. Sent
          as 'SETTINGS_ENABLE_PUSH' parameter in the initial 'SETTINGS'
          frame.
+      \li The receive window auto-tuning. Lets QNetworkAccessManager grow
+         the stream receive windows to match the measured bandwidth-delay
+         product of the connection.
     \endlist
 
     The QHttp2Configuration class also controls if the header compression
@@ -103,6 +106,7 @@ public:
     unsigned maxFrameSize = Http2::minPayloadLimit; // Initial (default) value of 16Kb.
 
     bool pushEnabled = false;
+    bool windowAutoTuningEnabled = false;
     // TODO: for now those two below are noop.
     bool huffmanCompressionEnabled = true;
 };
@@ -117,6 +121,7 @@ public:
         \li Window size for connection-level flow control is 65535 octets
         \li Window size for stream-level flow control is 65535 octets
         \li Frame size is 16384 octets
+        \li Receive window auto-tuning is disabled
     \endlist
 */
 QHttp2Configuration::QHttp2Configuration()
@@ -289,6 +294,40 @@ unsigned QHttp2Configuration::maxFrameSize() const
     return d->maxFrameSize;
 }
 
+/*!
+    \since 6.3
+
+    If \a enable is \c true, QNetworkAccessManager estimates the
+    bandwidth-delay product of the connection and grows the stream
+    receive windows accordingly. Disabled by default.
+
+    The estimate is the amount of data received during one round trip,
+    measured with 'PING' frames while responses are being downloaded.
+    Whenever the estimate gets close to the current stream window, the
+    window is doubled, so that a single stream is no longer limited to
+    one window per round trip on high-latency links. The stream receive
+    window size set with setStreamReceiveWindowSize() is the initial
+    value, and the session receive window size is the upper limit.
+
+    \sa receiveWindowAutoTuningEnabled, setStreamReceiveWindowSize
+*/
+void QHttp2Configuration::setReceiveWindowAutoTuningEnabled(bool enable)
+{
+    d->windowAutoTuningEnabled = enable;
+}
+
+/*!
+    \since 6.3
+
+    Returns \c true if the receive window auto-tuning is enabled.
+
+    \sa setReceiveWindowAutoTuningEnabled
+*/
+bool QHttp2Configuration::receiveWindowAutoTuningEnabled() const
+{
+    return d->windowAutoTuningEnabled;
+}
+
 /*!
     Swaps this configuration with the \a other configuration.
 */
@@ -320,7 +359,8 @@ bool QHttp2Configuration::isEqual(const QHttp2Configuration &other) const noexce
     return d->pushEnabled == other.d->pushEnabled
            && d->huffmanCompressionEnabled == other.d->huffmanCompressionEnabled
            && d->sessionWindowSize == other.d->sessionWindowSize
-           && d->streamWindowSize == other.d->streamWindowSize;
+           && d->streamWindowSize == other.d->streamWindowSize
+           && d->windowAutoTuningEnabled == other.d->windowAutoTuningEnabled;
 }
 
 QT_END_NAMESPACE
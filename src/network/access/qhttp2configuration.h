@@ -77,6 +77,9 @@ public:
     bool setMaxFrameSize(unsigned size);
     unsigned maxFrameSize() const;
 
+    void setReceiveWindowAutoTuningEnabled(bool enable);
+    bool receiveWindowAutoTuningEnabled() const;
+
     void swap(QHttp2Configuration &other) noexcept;
 
 private:
@@ -116,6 +116,25 @@ HPack::HttpHeader build_headers(const QHttpNetworkRequest &request, quint32 maxH
         header.push_back(HeaderField(field.first.toLower(), field.second));
     }
 
+    // RFC 9218, 5: the priority signal, unless the application already
+    // set the header field itself. The defaults (u=3, non-incremental)
+    // are implied by its absence.
+    if (request.headerField("priority").isEmpty()) {
+        QByteArray priority;
+        if (const int urgency = request.urgency(); urgency != 3)
+            priority = "u=" + QByteArray::number(urgency);
+        if (request.isIncremental())
+            priority += priority.size() ? ", i" : "i";
+
+        if (priority.size()) {
+            const HeaderSize delta = entry_size("priority", priority);
+            if (delta.first && std::numeric_limits<quint32>::max() - delta.second >= size.second
+                && size.second + delta.second <= maxHeaderListSize) {
+                header.push_back(HeaderField("priority", priority));
+            }
+        }
+    }
+
     return header;
 }
 
@@ -181,6 +200,8 @@ QHttp2ProtocolHandler::QHttp2ProtocolHandler(QHttpNetworkConnectionChannel *chan
     maxSessionReceiveWindowSize = h2Config.sessionReceiveWindowSize();
     pushPromiseEnabled = h2Config.serverPushEnabled();
     streamInitialReceiveWindowSize = h2Config.streamReceiveWindowSize();
+    streamReceiveWindowSize = streamInitialReceiveWindowSize;
+    windowAutoTuning = h2Config.receiveWindowAutoTuningEnabled();
     encoder.setCompressStrings(h2Config.huffmanCompressionEnabled());
 
     if (!channel->ssl && m_connection->connectionType() != QHttpNetworkConnection::ConnectionTypeHTTP2Direct) {
@@ -612,6 +633,9 @@ void QHttp2ProtocolHandler::handleDATA()
 
     sessionReceiveWindowSize -= inboundFrame.payloadSize();
 
+    if (windowAutoTuning)
+        sampleBandwidthDelayProduct(streamID, inboundFrame.payloadSize());
+
     if (activeStreams.contains(streamID)) {
         auto &stream = activeStreams[streamID];
 
@@ -629,11 +653,11 @@ void QHttp2ProtocolHandler::handleDATA()
             if (inboundFrame.flags().testFlag(FrameFlag::END_STREAM)) {
                 finishStream(stream);
                 deleteActiveStream(stream.streamID);
-            } else if (stream.recvWindow < streamInitialReceiveWindowSize / 2) {
+            } else if (stream.recvWindow < streamReceiveWindowSize / 2) {
                 QMetaObject::invokeMethod(this, "sendWINDOW_UPDATE", Qt::QueuedConnection,
                                           Q_ARG(quint32, stream.streamID),
-                                          Q_ARG(quint32, streamInitialReceiveWindowSize - stream.recvWindow));
-                stream.recvWindow = streamInitialReceiveWindowSize;
+                                          Q_ARG(quint32, streamReceiveWindowSize - stream.recvWindow));
+                stream.recvWindow = streamReceiveWindowSize;
             }
         }
     }
@@ -824,24 +848,79 @@ void QHttp2ProtocolHandler::handlePUSH_PROMISE()
 
 void QHttp2ProtocolHandler::handlePING()
 {
-    // Since we're implementing a client and not
-    // a server, we only reply to a PING, ACKing it.
+    // We reply to a PING, ACKing it. The only PING we send
+    // ourselves is the one measuring the bandwidth-delay product.
     Q_ASSERT(inboundFrame.type() == FrameType::PING);
     Q_ASSERT(m_socket);
 
     if (inboundFrame.streamID() != connectionStreamID)
         return connectionError(PROTOCOL_ERROR, "PING on invalid stream");
 
-    if (inboundFrame.flags() & FrameFlag::ACK)
-        return connectionError(PROTOCOL_ERROR, "unexpected PING ACK");
-
     Q_ASSERT(inboundFrame.dataSize() == 8);
 
+    if (inboundFrame.flags() & FrameFlag::ACK) {
+        if (!bdpPingSent || qFromBigEndian<quint64>(inboundFrame.dataBegin()) != bdpPingPayload)
+            return connectionError(PROTOCOL_ERROR, "unexpected PING ACK");
+        return updateReceiveWindowSize();
+    }
+
     frameWriter.start(FrameType::PING, FrameFlag::ACK, connectionStreamID);
     frameWriter.append(inboundFrame.dataBegin(), inboundFrame.dataBegin() + 8);
     frameWriter.write(*m_socket);
 }
 
+void QHttp2ProtocolHandler::sampleBandwidthDelayProduct(quint32 streamID, quint32 dataSize)
+{
+    Q_ASSERT(windowAutoTuning);
+    Q_ASSERT(m_socket);
+
+    // Stream windows never exceed the session window, nothing to tune:
+    if (streamReceiveWindowSize >= maxSessionReceiveWindowSize)
+        return;
+
+    if (!bdpPingSent) {
+        // What a stream receives until this PING gets ACKed is what it
+        // gets delivered in one round trip, its bandwidth-delay product:
+        frameWriter.start(FrameType::PING, FrameFlag::EMPTY, connectionStreamID);
+        frameWriter.append(++bdpPingPayload);
+        if (!frameWriter.write(*m_socket))
+            return;
+
+        bdpPingSent = true;
+        bdpSample = 0;
+        for (auto &stream : activeStreams)
+            stream.bdpSample = 0;
+    }
+
+    // Streams share the session window, so a sample summed over all of
+    // them says nothing about the stream window. Keep the largest one:
+    const auto it = activeStreams.find(streamID);
+    if (it != activeStreams.end()) {
+        it->bdpSample += dataSize;
+        bdpSample = std::max(bdpSample, it->bdpSample);
+    }
+}
+
+void QHttp2ProtocolHandler::updateReceiveWindowSize()
+{
+    Q_ASSERT(bdpPingSent);
+
+    bdpPingSent = false;
+    // If a stream received (almost) its whole window in one round trip,
+    // it's the window and not the bandwidth that limits its throughput.
+    // Give the peer room for twice the measured amount; streams pick up
+    // the new size with their next WINDOW_UPDATE:
+    if (bdpSample >= qint64(streamReceiveWindowSize) * 2 / 3) {
+        const qint64 newSize = std::min<qint64>(bdpSample * 2, maxSessionReceiveWindowSize);
+        if (newSize > streamReceiveWindowSize) {
+            qCDebug(QT_HTTP2) << "stream receive window grows from" << streamReceiveWindowSize
+                              << "to" << newSize << "bytes";
+            streamReceiveWindowSize = qint32(newSize);
+        }
+    }
+    bdpSample = 0;
+}
+
 void QHttp2ProtocolHandler::handleGOAWAY()
 {
     // 6.8 GOAWAY
@@ -1189,7 +1268,7 @@ void QHttp2ProtocolHandler::updateStream(Stream &stream, const HPack::HttpHeader
                 // Add the request back in queue, we'll retry later now that
                 // we've gotten some username/password set on it:
                 httpRequest.d->needResendWithCredentials = true;
-                m_channel->h2RequestsToSend.insert(httpRequest.priority(), stream.httpPair);
+                m_channel->h2RequestsToSend.insert(httpRequest.urgency(), stream.httpPair);
                 httpReply->d_func()->clearHeaders();
                 // If we have data we were uploading we need to reset it:
                 if (stream.data()) {
@@ -1403,9 +1482,9 @@ void QHttp2ProtocolHandler::addToSuspended(Stream &stream)
 {
     qCDebug(QT_HTTP2) << "stream" << stream.streamID
                       << "suspended by flow control";
-    const auto priority = stream.priority();
-    Q_ASSERT(int(priority) >= 0 && int(priority) < 3);
-    suspendedStreams[priority].push_back(stream.streamID);
+    const int urgency = stream.urgency();
+    Q_ASSERT(urgency >= 0 && urgency < numberOfUrgencies);
+    suspendedStreams[urgency].push_back(stream.streamID);
 }
 
 void QHttp2ProtocolHandler::markAsReset(quint32 streamID)
@@ -1433,13 +1512,10 @@ void QHttp2ProtocolHandler::markAsReset(quint32 streamID)
 quint32 QHttp2ProtocolHandler::popStreamToResume()
 {
     quint32 streamID = connectionStreamID;
-    using QNR = QHttpNetworkRequest;
-    const QNR::Priority ranks[] = {QNR::HighPriority,
-                                   QNR::NormalPriority,
-                                   QNR::LowPriority};
 
-    for (const QNR::Priority rank : ranks) {
-        auto &queue = suspendedStreams[rank];
+    // The most urgent first. Within one urgency, streams are resumed
+    // in the order they were suspended:
+    for (auto &queue : suspendedStreams) {
         auto it = queue.begin();
         for (; it != queue.end(); ++it) {
             if (!activeStreams.contains(*it))
@@ -128,6 +128,10 @@ private:
 
     void handleContinuedHEADERS();
 
+    // Receive window auto-tuning:
+    void sampleBandwidthDelayProduct(quint32 streamID, quint32 dataSize);
+    void updateReceiveWindowSize();
+
     bool acceptSetting(Http2::Settings identifier, quint32 newValue);
 
     void updateStream(Stream &stream, const HPack::HttpHeader &headers,
@@ -164,7 +168,9 @@ private:
 
     QHash<QObject *, int> streamIDs;
     QHash<quint32, Stream> activeStreams;
-    std::deque<quint32> suspendedStreams[3]; // 3 for priorities: High, Normal, Low.
+    // RFC 9218: urgencies range from 0 (the most urgent) to 7.
+    static const int numberOfUrgencies = 8;
+    std::deque<quint32> suspendedStreams[numberOfUrgencies];
     static const std::deque<quint32>::size_type maxRecycledStreams;
     std::deque<quint32> recycledStreams;
 
@@ -201,6 +207,16 @@ private:
     // Our per-stream receive window size, default is 64 Kb, will be updated
     // from QHttp2Configuration. Again, signed - can become negative.
     qint32 streamInitialReceiveWindowSize = Http2::defaultSessionWindowSize;
+    // The size we replenish our per-stream receive windows to, starts as
+    // streamInitialReceiveWindowSize and only grows if the window
+    // auto-tuning is enabled in QHttp2Configuration:
+    qint32 streamReceiveWindowSize = Http2::defaultSessionWindowSize;
+    bool windowAutoTuning = false;
+    // While our PING is in flight, streams accumulate the DATA they receive,
+    // bdpSample is the largest of these samples:
+    bool bdpPingSent = false;
+    quint64 bdpPingPayload = 0;
+    qint64 bdpSample = 0;
 
     // These are our peer's receive window sizes, they will be updated by the
     // peer's SETTINGS and WINDOW_UPDATE frames, defaults presumed to be 64Kb.
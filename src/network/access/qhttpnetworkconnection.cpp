@@ -72,6 +72,8 @@ const int QHttpNetworkConnectionPrivate::defaultPipelineLength = 3;
 // Only re-fill the pipeline if there's defaultRePipelineLength slots free in the pipeline.
 // This means that there are 2 requests in flight and 2 slots free that will be re-filled.
 const int QHttpNetworkConnectionPrivate::defaultRePipelineLength = 2;
+// Seconds an unused connection stays in QNetworkAccessManager's cache.
+const int QHttpNetworkConnectionPrivate::defaultIdleTimeout = 120;
 
 
 QHttpNetworkConnectionPrivate::QHttpNetworkConnectionPrivate(const QString &hostName,
@@ -102,7 +104,10 @@ QHttpNetworkConnectionPrivate::QHttpNetworkConnectionPrivate(quint16 connectionC
                                                              QHttpNetworkConnection::ConnectionType type)
 : state(RunningState), networkLayerState(Unknown),
   hostName(hostName), port(port), encrypt(encrypt), delayIpv4(true),
-  activeChannelCount(connectionCount), channelCount(connectionCount)
+  activeChannelCount(type == QHttpNetworkConnection::ConnectionTypeHTTP2
+                     || type == QHttpNetworkConnection::ConnectionTypeHTTP2Direct
+                     ? 1 : connectionCount),
+  channelCount(connectionCount)
 #ifndef QT_NO_NETWORKPROXY
   , networkProxy(QNetworkProxy::NoProxy)
 #endif
@@ -178,6 +183,15 @@ void QHttpNetworkConnectionPrivate::resumeConnection()
     QMetaObject::invokeMethod(this->q_func(), "_q_startNextRequest", Qt::QueuedConnection);
 }
 
+// An adaptive pool starts with the default number of channels and grows
+// from there, see _q_startNextRequest().
+int QHttpNetworkConnectionPrivate::http1ChannelCount() const
+{
+    if (http1Parameters.adaptiveConnectionCountEnabled())
+        return qMin(defaultHttpChannelCount, channelCount);
+    return channelCount;
+}
+
 int QHttpNetworkConnectionPrivate::indexOf(QAbstractSocket *socket) const
 {
     for (int i = 0; i < activeChannelCount; ++i)
@@ -206,7 +220,7 @@ bool QHttpNetworkConnectionPrivate::shouldEmitChannelError(QAbstractSocket *sock
         channels[otherSocket].ensureConnection();
     }
 
-    if (activeChannelCount < channelCount) {
+    if (activeChannelCount == 1) {
         if (networkLayerState == HostLookupPending || networkLayerState == IPv4or6)
             networkLayerState = QHttpNetworkConnectionPrivate::Unknown;
         channels[0].close();
@@ -644,7 +658,7 @@ QHttpNetworkReply* QHttpNetworkConnectionPrivate::queueRequest(const QHttpNetwor
     else { // HTTP/2 ('h2' mode)
         if (!pair.second->d_func()->requestIsPrepared)
             prepareRequest(pair);
-        channels[0].h2RequestsToSend.insert(request.priority(), pair);
+        channels[0].h2RequestsToSend.insert(request.urgency(), pair);
     }
 
     // For Happy Eyeballs the networkLayerState is set to Unknown
@@ -672,7 +686,7 @@ void QHttpNetworkConnectionPrivate::fillHttp2Queue()
     for (auto &pair : highPriorityQueue) {
         if (!pair.second->d_func()->requestIsPrepared)
             prepareRequest(pair);
-        channels[0].h2RequestsToSend.insert(QHttpNetworkRequest::HighPriority, pair);
+        channels[0].h2RequestsToSend.insert(pair.first.urgency(), pair);
     }
 
     highPriorityQueue.clear();
@@ -680,7 +694,7 @@ void QHttpNetworkConnectionPrivate::fillHttp2Queue()
     for (auto &pair : lowPriorityQueue) {
         if (!pair.second->d_func()->requestIsPrepared)
             prepareRequest(pair);
-        channels[0].h2RequestsToSend.insert(pair.first.priority(), pair);
+        channels[0].h2RequestsToSend.insert(pair.first.urgency(), pair);
     }
 
     lowPriorityQueue.clear();
@@ -761,7 +775,9 @@ void QHttpNetworkConnectionPrivate::fillPipeline(QAbstractSocket *socket)
     if (channels[i].reply == nullptr)
         return;
 
-    if (! (defaultPipelineLength - channels[i].alreadyPipelinedRequests.length() >= defaultRePipelineLength)) {
+    const qsizetype pipelineLength = http1Parameters.maximumPipelineLength();
+    if (pipelineLength - channels[i].alreadyPipelinedRequests.length()
+        < qMin<qsizetype>(defaultRePipelineLength, pipelineLength)) {
         return;
     }
 
@@ -805,7 +821,7 @@ void QHttpNetworkConnectionPrivate::fillPipeline(QAbstractSocket *socket)
         lengthBefore = channels[i].alreadyPipelinedRequests.length();
         fillPipeline(highPriorityQueue, channels[i]);
 
-        if (channels[i].alreadyPipelinedRequests.length() >= defaultPipelineLength) {
+        if (channels[i].alreadyPipelinedRequests.length() >= pipelineLength) {
             channels[i].pipelineFlush();
             return;
         }
@@ -818,7 +834,7 @@ void QHttpNetworkConnectionPrivate::fillPipeline(QAbstractSocket *socket)
         lengthBefore = channels[i].alreadyPipelinedRequests.length();
         fillPipeline(lowPriorityQueue, channels[i]);
 
-        if (channels[i].alreadyPipelinedRequests.length() >= defaultPipelineLength) {
+        if (channels[i].alreadyPipelinedRequests.length() >= pipelineLength) {
             channels[i].pipelineFlush();
             return;
         }
@@ -1148,6 +1164,19 @@ void QHttpNetworkConnectionPrivate::_q_startNextRequest()
         neededOpenChannels--;
     }
 
+    // An adaptive pool grows while at least as many requests are waiting
+    // for a channel as it is using.
+    if (neededOpenChannels >= activeChannelCount && activeChannelCount < channelCount
+        && connectionType == QHttpNetworkConnection::ConnectionTypeHTTP
+        && http1Parameters.adaptiveConnectionCountEnabled()) {
+        const int previousChannelCount = activeChannelCount;
+        activeChannelCount = qMin(2 * activeChannelCount, channelCount);
+        for (int i = previousChannelCount; i < activeChannelCount && neededOpenChannels > 0; ++i) {
+            channelsToConnect.enqueue(i);
+            neededOpenChannels--;
+        }
+    }
+
     while (!channelsToConnect.isEmpty()) {
         const int channel = channelsToConnect.dequeue();
 
@@ -1394,7 +1423,7 @@ void QHttpNetworkConnection::setCacheProxy(const QNetworkProxy &networkProxy)
     d->networkProxy = networkProxy;
     // update the authenticator
     if (!d->networkProxy.user().isEmpty()) {
-        for (int i = 0; i < d->activeChannelCount; ++i) {
+        for (int i = 0; i < d->channelCount; ++i) {
             d->channels[i].proxyAuthenticator.setUser(d->networkProxy.user());
             d->channels[i].proxyAuthenticator.setPassword(d->networkProxy.password());
         }
@@ -1410,7 +1439,7 @@ QNetworkProxy QHttpNetworkConnection::cacheProxy() const
 void QHttpNetworkConnection::setTransparentProxy(const QNetworkProxy &networkProxy)
 {
     Q_D(QHttpNetworkConnection);
-    for (int i = 0; i < d->activeChannelCount; ++i)
+    for (int i = 0; i < d->channelCount; ++i)
         d->channels[i].setProxy(networkProxy);
 }
 
@@ -1433,6 +1462,20 @@ void QHttpNetworkConnection::setConnectionType(ConnectionType type)
     d->connectionType = type;
 }
 
+QHttp1Configuration QHttpNetworkConnection::http1Parameters() const
+{
+    Q_D(const QHttpNetworkConnection);
+    return d->http1Parameters;
+}
+
+void QHttpNetworkConnection::setHttp1Parameters(const QHttp1Configuration &params)
+{
+    Q_D(QHttpNetworkConnection);
+    d->http1Parameters = params;
+    if (d->connectionType == ConnectionTypeHTTP)
+        d->activeChannelCount = d->http1ChannelCount();
+}
+
 QHttp2Configuration QHttpNetworkConnection::http2Parameters() const
 {
     Q_D(const QHttpNetworkConnection);
@@ -1454,7 +1497,7 @@ void QHttpNetworkConnection::setSslConfiguration(const QSslConfiguration &config
         return;
 
     // set the config on all channels
-    for (int i = 0; i < d->activeChannelCount; ++i)
+    for (int i = 0; i < d->channelCount; ++i)
         d->channels[i].setSslConfiguration(config);
 }
 
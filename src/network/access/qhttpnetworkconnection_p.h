@@ -56,6 +56,7 @@
 #include <QtNetwork/qnetworkreply.h>
 #include <QtNetwork/qabstractsocket.h>
 
+#include <qhttp1configuration.h>
 #include <qhttp2configuration.h>
 
 #include <private/qobject_p.h>
@@ -131,6 +132,9 @@ public:
     ConnectionType connectionType();
     void setConnectionType(ConnectionType type);
 
+    QHttp1Configuration http1Parameters() const;
+    void setHttp1Parameters(const QHttp1Configuration &params);
+
     QHttp2Configuration http2Parameters() const;
     void setHttp2Parameters(const QHttp2Configuration &params);
 
@@ -177,6 +181,7 @@ public:
     static const int defaultHttpChannelCount;
     static const int defaultPipelineLength;
     static const int defaultRePipelineLength;
+    static const int defaultIdleTimeout;
 
     enum ConnectionState {
         RunningState = 0,
@@ -249,6 +254,8 @@ public:
     int activeChannelCount;
     // The total number of channels we reserved:
     const int channelCount;
+    // Number of channels to start with for HTTP/1:
+    int http1ChannelCount() const;
     QTimer delayedConnectionTimer;
     QHttpNetworkConnectionChannel *channels; // parallel connections to the server
     bool shouldEmitChannelError(QAbstractSocket *socket);
@@ -278,6 +285,7 @@ public:
     QSharedPointer<QSslContext> sslContext;
 #endif
 
+    QHttp1Configuration http1Parameters;
     QHttp2Configuration http2Parameters;
 
     QString peerVerifyName;
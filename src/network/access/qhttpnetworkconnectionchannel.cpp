@@ -492,7 +492,7 @@ void QHttpNetworkConnectionChannel::allDone()
         } else {
             // Ok, whatever happened, we do not try HTTP/2 anymore ...
             connection->setConnectionType(QHttpNetworkConnection::ConnectionTypeHTTP);
-            connection->d_func()->activeChannelCount = connection->d_func()->channelCount;
+            connection->d_func()->activeChannelCount = connection->d_func()->http1ChannelCount();
         }
     }
 
@@ -1231,8 +1231,8 @@ void QHttpNetworkConnectionChannel::_q_encrypted()
             // We use only one channel for HTTP/2, but normally six for
             // HTTP/1.1 - let's restore this number to the reserved number of
             // channels:
-            if (connection->d_func()->activeChannelCount < connection->d_func()->channelCount) {
-                connection->d_func()->activeChannelCount = connection->d_func()->channelCount;
+            if (connection->d_func()->activeChannelCount < connection->d_func()->http1ChannelCount()) {
+                connection->d_func()->activeChannelCount = connection->d_func()->http1ChannelCount();
                 // re-queue requests from HTTP/2 queue to HTTP queue, if any
                 requeueHttp2Requests();
             }
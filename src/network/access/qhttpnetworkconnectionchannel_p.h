@@ -121,7 +121,7 @@ public:
     bool authenticationCredentialsSent;
     bool proxyCredentialsSent;
     QScopedPointer<QAbstractProtocolHandler> protocolHandler;
-    QMultiMap<int, HttpMessagePair> h2RequestsToSend;
+    QMultiMap<int, HttpMessagePair> h2RequestsToSend; // Keyed by urgency.
     bool switchedToHttp2 = false;
 #ifndef QT_NO_SSL
     bool ignoreAllSslErrors;
@@ -56,6 +56,8 @@ QHttpNetworkRequestPrivate::QHttpNetworkRequestPrivate(const QHttpNetworkRequest
       operation(other.operation),
       customVerb(other.customVerb),
       priority(other.priority),
+      urgency(other.urgency),
+      incremental(other.incremental),
       uploadByteDevice(other.uploadByteDevice),
       minimumArchiveBombSize(other.minimumArchiveBombSize),
       autoDecompress(other.autoDecompress),
@@ -81,6 +83,8 @@ bool QHttpNetworkRequestPrivate::operator==(const QHttpNetworkRequestPrivate &ot
     return QHttpNetworkHeaderPrivate::operator==(other)
         && (operation == other.operation)
         && (priority == other.priority)
+        && (urgency == other.urgency)
+        && (incremental == other.incremental)
         && (uploadByteDevice == other.uploadByteDevice)
         && (autoDecompress == other.autoDecompress)
         && (pipeliningAllowed == other.pipeliningAllowed)
@@ -336,6 +340,40 @@ void QHttpNetworkRequest::setPriority(Priority priority)
     d->priority = priority;
 }
 
+// The urgency of RFC 9218 (0 is the most urgent, 7 the least). Unless
+// set explicitly, it follows priority(), NormalPriority mapping to the
+// RFC's default urgency of 3.
+int QHttpNetworkRequest::urgency() const
+{
+    if (d->urgency >= 0)
+        return d->urgency;
+
+    switch (d->priority) {
+    case HighPriority:
+        return 1;
+    case LowPriority:
+        return 5;
+    case NormalPriority:
+    default:
+        return 3;
+    }
+}
+
+void QHttpNetworkRequest::setUrgency(int urgency)
+{
+    d->urgency = qBound(-1, urgency, 7);
+}
+
+bool QHttpNetworkRequest::isIncremental() const
+{
+    return d->incremental;
+}
+
+void QHttpNetworkRequest::setIncremental(bool b)
+{
+    d->incremental = b;
+}
+
 bool QHttpNetworkRequest::isPipeliningAllowed() const
 {
     return d->pipeliningAllowed;
@@ -116,6 +116,12 @@ public:
     Priority priority() const;
     void setPriority(Priority priority);
 
+    int urgency() const;
+    void setUrgency(int urgency);
+
+    bool isIncremental() const;
+    void setIncremental(bool b);
+
     bool isPipeliningAllowed() const;
     void setPipeliningAllowed(bool b);
 
@@ -180,6 +186,8 @@ public:
     QHttpNetworkRequest::Operation operation;
     QByteArray customVerb;
     QHttpNetworkRequest::Priority priority;
+    int urgency = -1; // -1: derived from priority
+    bool incremental = false;
     mutable QNonContiguousByteDevice* uploadByteDevice;
     qint64 minimumArchiveBombSize = 0;
     bool autoDecompress;
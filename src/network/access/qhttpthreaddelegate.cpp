@@ -181,12 +181,16 @@ class QNetworkAccessCachedHttpConnection: public QHttpNetworkConnection,
 {
     // Q_OBJECT
 public:
-    QNetworkAccessCachedHttpConnection(const QString &hostName, quint16 port, bool encrypt,
+    QNetworkAccessCachedHttpConnection(const QHttp1Configuration &http1Parameters,
+                                       const QString &hostName, quint16 port, bool encrypt,
                                        QHttpNetworkConnection::ConnectionType connectionType)
-        : QHttpNetworkConnection(hostName, port, encrypt, connectionType)
+        : QHttpNetworkConnection(quint16(http1Parameters.numberOfConnectionsPerHost()),
+                                 hostName, port, encrypt, nullptr, connectionType)
     {
+        setHttp1Parameters(http1Parameters);
         setExpires(true);
         setShareable(true);
+        setExpiryTimeout(http1Parameters.idleTimeout());
     }
 
     virtual void dispose() override
@@ -332,8 +336,8 @@ void QHttpThreadDelegate::startRequest()
     if (!httpConnection) {
         // no entry in cache; create an object
         // the http object is actually a QHttpNetworkConnection
-        httpConnection = new QNetworkAccessCachedHttpConnection(urlCopy.host(), urlCopy.port(), ssl,
-                                                                connectionType);
+        httpConnection = new QNetworkAccessCachedHttpConnection(http1Parameters, urlCopy.host(),
+                                                                urlCopy.port(), ssl, connectionType);
         if (connectionType == QHttpNetworkConnection::ConnectionTypeHTTP2
             || connectionType == QHttpNetworkConnection::ConnectionTypeHTTP2Direct) {
             httpConnection->setHttp2Parameters(http2Parameters);
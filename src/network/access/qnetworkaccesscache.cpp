@@ -44,6 +44,7 @@
 #include "qnetworkreply_p.h"
 #include "qnetworkrequest.h"
 
+#include <limits>
 #include <vector>
 
 QT_BEGIN_NAMESPACE
@@ -78,8 +79,9 @@ struct QNetworkAccessCache::Node
 };
 
 QNetworkAccessCache::CacheableObject::CacheableObject()
+    : expiryTimeout(ExpiryTime)
 {
-    // leave the members uninitialized
+    // leave the other members uninitialized
     // they must be initialized by the derived class's constructor
 }
 
@@ -102,6 +104,11 @@ void QNetworkAccessCache::CacheableObject::setShareable(bool enable)
     shareable = enable;
 }
 
+void QNetworkAccessCache::CacheableObject::setExpiryTimeout(int seconds)
+{
+    expiryTimeout = seconds;
+}
+
 QNetworkAccessCache::QNetworkAccessCache()
     : oldest(nullptr), newest(nullptr)
 {
@@ -135,8 +142,8 @@ void QNetworkAccessCache::clear()
 }
 
 /*!
-    Appends the entry given by \a key to the end of the linked list.
-    (i.e., makes it the newest entry)
+    Inserts the entry given by \a key into the linked list, which is
+    sorted by expiry time. (i.e., usually makes it the newest entry)
  */
 void QNetworkAccessCache::linkEntry(const QByteArray &key)
 {
@@ -148,18 +155,24 @@ void QNetworkAccessCache::linkEntry(const QByteArray &key)
     Q_ASSERT(node->older == nullptr && node->newer == nullptr);
     Q_ASSERT(node->useCount == 0);
 
-    if (newest) {
-        Q_ASSERT(newest->newer == nullptr);
-        newest->newer = node;
-        node->older = newest;
-    }
-    if (!oldest) {
-        // there are no entries, so this is the oldest one too
-        oldest = node;
-    }
+    node->timestamp = QDateTime::currentDateTimeUtc().addSecs(node->object->expiryTimeout);
+
+    // keep the list sorted by expiry time; as long as all entries use
+    // the same timeout, this appends the entry
+    Node *older = newest;
+    while (older && node->timestamp < older->timestamp)
+        older = older->older;
 
-    node->timestamp = QDateTime::currentDateTimeUtc().addSecs(ExpiryTime);
-    newest = node;
+    node->older = older;
+    node->newer = older ? older->newer : oldest;
+    if (node->older)
+        node->older->newer = node;
+    else
+        oldest = node;
+    if (node->newer)
+        node->newer->older = node;
+    else
+        newest = node;
 }
 
 /*!
@@ -195,15 +208,12 @@ void QNetworkAccessCache::updateTimer()
     if (!oldest)
         return;
 
-    int interval = QDateTime::currentDateTimeUtc().secsTo(oldest->timestamp);
-    if (interval <= 0) {
-        interval = 0;
-    } else {
-        // round up the interval
-        interval = (interval + 15) & ~16;
-    }
+    // a coarse timer is good enough, it lets entries that expire at about
+    // the same time go together
+    qint64 interval = QDateTime::currentDateTimeUtc().msecsTo(oldest->timestamp);
+    interval = qBound(qint64(0), interval + 1, qint64(std::numeric_limits<int>::max()));
 
-    timer.start(interval * 1000, this);
+    timer.start(int(interval), Qt::CoarseTimer, this);
 }
 
 bool QNetworkAccessCache::emitEntryReady(Node *node, QObject *target, const char *member)
@@ -79,6 +79,7 @@ public:
         QByteArray key;
         bool expires;
         bool shareable;
+        int expiryTimeout;
     public:
         CacheableObject();
         virtual ~CacheableObject();
@@ -88,6 +89,7 @@ public:
     protected:
         void setExpires(bool enable);
         void setShareable(bool enable);
+        void setExpiryTimeout(int seconds);
     };
 
     QNetworkAccessCache();
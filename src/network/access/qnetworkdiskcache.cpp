@@ -59,6 +59,7 @@
 #define PREPARED_SLASH QLatin1String("prepared/")
 #define CACHE_VERSION 8
 #define DATA_DIR QLatin1String("data")
+#define INDEX_FILE QLatin1String("index")
 
 #define MAX_COMPRESSION_SIZE (1024 * 1024 * 3)
 
@@ -76,12 +77,22 @@ QT_BEGIN_NAMESPACE
     are compressed using qCompress.  Data is written to disk only in insert()
     and updateMetaData().
 
+    The size, and time of last access of every cache file is kept in a
+    memory-mapped index inside the cacheDirectory, so that the size of the
+    cache is known and the least recently used files can be found without
+    reading the directory. The index is rebuilt from the cache files if it
+    is missing or was not closed properly.
+
     Currently you cannot share the same cache files with more than
     one disk cache.
 
     QNetworkDiskCache by default limits the amount of space that the cache will
     use on the system to 50MB.
 
+    Recently used entries can also be kept in memory, so that they are served
+    without reading the cache file, see setMaximumMemoryCacheSize(). Entries
+    are always written to disk as well.
+
     Note you have to set the cache directory before it will work.
 
     A network disk cache can be enabled by:
@@ -151,7 +162,9 @@ void QNetworkDiskCache::setCacheDirectory(const QString &cacheDir)
         d->cacheDirectory += QLatin1Char('/');
 
     d->dataDirectory = d->cacheDirectory + DATA_DIR + QString::number(CACHE_VERSION) + QLatin1Char('/');
+    d->memoryCache.clear();
     d->prepareLayout();
+    d->openIndex();
 }
 
 /*!
@@ -271,6 +284,7 @@ void QNetworkDiskCachePrivate::storeItem(QCacheItem *cacheItem)
 
     QString fileName = cacheFileName(cacheItem->metaData.url());
     Q_ASSERT(!fileName.isEmpty());
+    memoryCache.remove(indexKey(fileName));
 
     if (QFile::exists(fileName)) {
         if (!removeFile(fileName)) {
@@ -294,10 +308,16 @@ void QNetworkDiskCachePrivate::storeItem(QCacheItem *cacheItem)
         && cacheItem->file->error() == QFile::NoError) {
         cacheItem->file->setAutoRemove(false);
         // ### use atomic rename rather then remove & rename
-        if (cacheItem->file->rename(fileName))
-            currentCacheSize += cacheItem->file->size();
-        else
+        if (cacheItem->file->rename(fileName)) {
+            const qint64 size = cacheItem->file->size();
+            currentCacheSize += size;
+            index.insert(indexKey(fileName), size, nextAccessTime());
+            // uncompressed data is only available in memory if it can be compressed
+            if (cacheItem->data.isOpen())
+                cacheInMemory(fileName, cacheItem->metaData, cacheItem->data.data());
+        } else {
             cacheItem->file->setAutoRemove(true);
+        }
     }
     if (cacheItem->metaData.url() == lastItem.metaData.url())
         lastItem.reset();
@@ -343,10 +363,18 @@ bool QNetworkDiskCachePrivate::removeFile(const QString &file)
     if (!fileName.endsWith(CACHE_POSTFIX))
         return false;
     qint64 size = info.size();
+    const quint64 key = indexKey(file);
     if (QFile::remove(file)) {
         currentCacheSize -= size;
+        index.remove(key);
+        memoryCache.remove(key);
         return true;
     }
+    if (!info.exists()) {
+        // removed behind our back, forget about it
+        index.remove(key);
+        memoryCache.remove(key);
+    }
     return false;
 }
 
@@ -359,9 +387,17 @@ QNetworkCacheMetaData QNetworkDiskCache::metaData(const QUrl &url)
     qDebug() << "QNetworkDiskCache::metaData()" << url;
 #endif
     Q_D(QNetworkDiskCache);
-    if (d->lastItem.metaData.url() == url)
+    if (const QNetworkDiskCacheMemoryItem *item = d->memoryItem(url))
+        return item->metaData;
+    const QString fileName = d->cacheFileName(url);
+    if (d->lastItem.metaData.url() == url) {
+        d->recordAccess(fileName);
         return d->lastItem.metaData;
-    return fileMetaData(d->cacheFileName(url));
+    }
+    QNetworkCacheMetaData metaData = fileMetaData(fileName);
+    if (metaData.isValid())
+        d->recordAccess(fileName);
+    return metaData;
 }
 
 /*!
@@ -398,11 +434,18 @@ QIODevice *QNetworkDiskCache::data(const QUrl &url)
     std::unique_ptr<QBuffer> buffer;
     if (!url.isValid())
         return nullptr;
+    if (const QNetworkDiskCacheMemoryItem *item = d->memoryItem(url)) {
+        buffer.reset(new QBuffer);
+        buffer->setData(item->data);
+        buffer->open(QBuffer::ReadOnly);
+        return buffer.release();
+    }
+    const QString fileName = d->cacheFileName(url);
     if (d->lastItem.metaData.url() == url && d->lastItem.data.isOpen()) {
         buffer.reset(new QBuffer);
         buffer->setData(d->lastItem.data.data());
     } else {
-        QScopedPointer<QFile> file(new QFile(d->cacheFileName(url)));
+        QScopedPointer<QFile> file(new QFile(fileName));
         if (!file->open(QFile::ReadOnly | QIODevice::Unbuffered))
             return nullptr;
 
@@ -420,6 +463,8 @@ QIODevice *QNetworkDiskCache::data(const QUrl &url)
             buffer->setData(file->readAll());
         }
     }
+    d->recordAccess(fileName);
+    d->cacheInMemory(fileName, d->lastItem.metaData, buffer->data());
     buffer->open(QBuffer::ReadOnly);
     return buffer.release();
 }
@@ -484,14 +529,49 @@ void QNetworkDiskCache::setMaximumCacheSize(qint64 size)
         d->currentCacheSize = expire();
 }
 
+/*!
+    \since 6.3
+
+    Returns the maximum number of bytes the cache keeps in memory.
+
+    \sa setMaximumMemoryCacheSize()
+ */
+qint64 QNetworkDiskCache::maximumMemoryCacheSize() const
+{
+    Q_D(const QNetworkDiskCache);
+    return d->memoryCache.maxCost();
+}
+
+/*!
+    \since 6.3
+
+    Sets the maximum number of bytes the cache keeps in memory to \a size.
+
+    Cache entries that are read or inserted are kept in memory up to this
+    size, the least recently used ones being dropped first, so that they can
+    be returned by metaData() and data() without reading the cache file.
+    Entries are always written to the cache directory as well, and entries
+    that do not fit are only stored there.
+
+    The default is 0, which disables keeping entries in memory.
+
+    \sa maximumMemoryCacheSize(), setMaximumCacheSize()
+ */
+void QNetworkDiskCache::setMaximumMemoryCacheSize(qint64 size)
+{
+    Q_D(QNetworkDiskCache);
+    d->memoryCache.setMaxCost(qMax<qsizetype>(size, 0));
+}
+
 /*!
     Cleans the cache so that its size is under the maximum cache size.
     Returns the current size of the cache.
 
     When the current size of the cache is greater than the maximumCacheSize()
-    older cache files are removed until the total size is less then 90% of
-    maximumCacheSize() starting with the oldest ones first using the file
-    creation date to determine how old a cache file is.
+    cache files are removed until the total size is less then 90% of
+    maximumCacheSize(), starting with the ones that were least recently
+    inserted or read. The sizes and access times are taken from the cache
+    index, so the cache directory does not have to be read.
 
     Subclasses can reimplement this function to change the order that cache
     files are removed taking into account information in the application
@@ -516,56 +596,28 @@ qint64 QNetworkDiskCache::expire()
     // close file handle to prevent "in use" error when QFile::remove() is called
     d->lastItem.reset();
 
-    QDir::Filters filters = QDir::AllDirs | QDir:: Files | QDir::NoDotAndDotDot;
-    QDirIterator it(cacheDirectory(), filters, QDirIterator::Subdirectories);
-
-    QMultiMap<QDateTime, QString> cacheItems;
-    qint64 totalSize = 0;
-    while (it.hasNext()) {
-        QString path = it.next();
-        QFileInfo info = it.fileInfo();
-        QString fileName = info.fileName();
-        if (fileName.endsWith(CACHE_POSTFIX)) {
-            const QDateTime birthTime = info.fileTime(QFile::FileBirthTime);
-            cacheItems.insert(birthTime.isValid() ? birthTime
-                              : info.fileTime(QFile::FileMetadataChangeTime), path);
-            totalSize += info.size();
-        }
-    }
-
     int removedFiles = 0;
     qint64 goal = (maximumCacheSize() * 9) / 10;
-    QMultiMap<QDateTime, QString>::const_iterator i = cacheItems.constBegin();
-    while (i != cacheItems.constEnd()) {
-        if (totalSize < goal)
-            break;
-        QString name = i.value();
-        QFile file(name);
-
-        if (name.contains(PREPARED_SLASH)) {
-            for (QCacheItem *item : qAsConst(d->inserting)) {
-                if (item && item->file && item->file->fileName() == name) {
-                    delete item->file;
-                    item->file = nullptr;
-                    break;
-                }
-            }
-        }
-
-        qint64 size = file.size();
-        file.remove();
-        totalSize -= size;
+    d->index.removeLeastRecentlyUsed(goal, [d, &removedFiles](quint64 key) {
+        // keep the entries of files that couldn't be removed, so that
+        // they are still accounted for
+        const QString fileName = d->indexFileName(key);
+        if (!QFile::remove(fileName) && QFile::exists(fileName))
+            return false;
+        d->memoryCache.remove(key);
         ++removedFiles;
-        ++i;
-    }
+        return true;
+    });
 #if defined(QNETWORKDISKCACHE_DEBUG)
     if (removedFiles > 0) {
         qDebug() << "QNetworkDiskCache::expire()"
                 << "Removed:" << removedFiles
-                << "Kept:" << cacheItems.count() - removedFiles;
+                << "Kept:" << d->index.count();
     }
+#else
+    Q_UNUSED(removedFiles);
 #endif
-    return totalSize;
+    return d->index.totalSize();
 }
 
 /*!
@@ -577,6 +629,7 @@ void QNetworkDiskCache::clear()
     qDebug("QNetworkDiskCache::clear()");
 #endif
     Q_D(QNetworkDiskCache);
+    d->memoryCache.clear();
     qint64 size = d->maximumCacheSize;
     d->maximumCacheSize = 0;
     d->currentCacheSize = expire();
@@ -584,9 +637,9 @@ void QNetworkDiskCache::clear()
 }
 
 /*!
-    Given a URL, generates a unique enough filename (and subdirectory)
+    Given a URL, generates the unique enough id the filename is made of
  */
-QString QNetworkDiskCachePrivate::uniqueFileName(const QUrl &url)
+QByteArray QNetworkDiskCachePrivate::uniqueId(const QUrl &url)
 {
     QUrl cleanUrl = url;
     cleanUrl.setPassword(QString());
@@ -595,13 +648,159 @@ QString QNetworkDiskCachePrivate::uniqueFileName(const QUrl &url)
     QCryptographicHash hash(QCryptographicHash::Sha1);
     hash.addData(cleanUrl.toEncoded());
     // convert sha1 to base36 form and return first 8 bytes for use as string
-    const QByteArray id = QByteArray::number(*(qlonglong*)hash.result().constData(), 36).left(8);
+    return QByteArray::number(*(qlonglong*)hash.result().constData(), 36).left(8);
+}
+
+static QString pathFragment(QByteArrayView id)
+{
     // generates <one-char subdir>/<8-char filname.d>
     uint code = (uint)id.at(id.length()-1) % 16;
-    QString pathFragment = QString::number(code, 16) + QLatin1Char('/')
-                             + QLatin1String(id) + CACHE_POSTFIX;
+    return QString::number(code, 16) + QLatin1Char('/') + QLatin1String(id.data(), id.size()) + CACHE_POSTFIX;
+}
+
+/*!
+    Given a URL, generates a unique enough filename (and subdirectory)
+ */
+QString QNetworkDiskCachePrivate::uniqueFileName(const QUrl &url)
+{
+    return pathFragment(uniqueId(url));
+}
+
+/*!
+    Returns the key the cache file \a fileName is stored under in the index,
+    or 0 if \a fileName is not a cache file of this cache.
+
+    The id of a file is at most 8 characters long, so it is packed into the
+    key as it is, which allows indexFileName() to reverse the mapping.
+ */
+quint64 QNetworkDiskCachePrivate::indexKey(const QString &fileName) const
+{
+    if (!fileName.startsWith(dataDirectory) || !fileName.endsWith(CACHE_POSTFIX))
+        return 0;
+    const qsizetype start = fileName.lastIndexOf(QLatin1Char('/')) + 1;
+    const QString id = fileName.mid(start, fileName.size() - start - CACHE_POSTFIX.size());
+    const quint64 key = packId(id.toLatin1());
+    return key && indexFileName(key) == fileName ? key : 0;
+}
+
+/*!
+    Packs the file \a id into an index key, returns 0 if \a id is not a
+    possible id.
+ */
+quint64 QNetworkDiskCachePrivate::packId(QByteArrayView id)
+{
+    if (id.isEmpty() || id.size() > 8)
+        return 0;
+
+    quint64 key = 0;
+    for (qsizetype i = 0; i < id.size(); ++i) {
+        const uchar c = uchar(id.at(i));
+        if (c == 0 || c > 0x7f)
+            return 0;
+        key |= quint64(c) << (8 * i);
+    }
+    return key;
+}
+
+/*!
+    Returns the fully qualified path of the cache file stored under \a key
+    in the index.
+ */
+QString QNetworkDiskCachePrivate::indexFileName(quint64 key) const
+{
+    char id[8];
+    qsizetype length = 0;
+    for (; length < 8 && (key >> (8 * length)) & 0xff; ++length)
+        id[length] = char((key >> (8 * length)) & 0xff);
+    if (length == 0)
+        return QString();
+    return dataDirectory + pathFragment(QByteArrayView(id, length));
+}
+
+/*!
+    Opens the index of the current data directory, rebuilding it from the
+    cache files when there is no usable index.
+ */
+void QNetworkDiskCachePrivate::openIndex()
+{
+    currentCacheSize = -1;
+    if (index.open(dataDirectory + INDEX_FILE))
+        return;
+
+    QDirIterator it(dataDirectory, { QLatin1String("*") + CACHE_POSTFIX }, QDir::Files,
+                    QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const quint64 key = indexKey(it.next());
+        if (!key)
+            continue;
+        const QFileInfo info = it.fileInfo();
+        const QDateTime birthTime = info.fileTime(QFile::FileBirthTime);
+        const QDateTime time = birthTime.isValid() ? birthTime
+                               : info.fileTime(QFile::FileMetadataChangeTime);
+        index.insert(key, info.size(), time.toMSecsSinceEpoch());
+    }
+}
+
+/*!
+    Marks the cache file \a fileName as used just now.
+ */
+void QNetworkDiskCachePrivate::recordAccess(const QString &fileName)
+{
+    const quint64 key = indexKey(fileName);
+    if (!key || index.touch(key, nextAccessTime()))
+        return;
+    // not in the index, e.g. because it was put there by someone else
+    const QFileInfo info(fileName);
+    if (info.exists())
+        index.insert(key, info.size(), lastAccessTime);
+}
+
+/*!
+    Returns the entry for \a url kept in memory, or \nullptr if there is
+    none. The entry counts as an access of its cache file.
+ */
+QNetworkDiskCacheMemoryItem *QNetworkDiskCachePrivate::memoryItem(const QUrl &url)
+{
+    if (memoryCache.isEmpty())
+        return nullptr;
+    const quint64 key = packId(uniqueId(url));
+    QNetworkDiskCacheMemoryItem *item = memoryCache.object(key);
+    if (item)
+        index.touch(key, nextAccessTime());
+    return item;
+}
+
+/*!
+    Keeps \a metaData and \a data of the cache file \a fileName in memory,
+    if they fit.
+ */
+void QNetworkDiskCachePrivate::cacheInMemory(const QString &fileName,
+                                             const QNetworkCacheMetaData &metaData,
+                                             const QByteArray &data)
+{
+    if (memoryCache.maxCost() <= 0 || !metaData.isValid())
+        return;
+    const quint64 key = indexKey(fileName);
+    if (!key)
+        return;
+
+    qsizetype cost = data.size() + metaData.url().toEncoded().size();
+    const auto headers = metaData.rawHeaders();
+    for (const auto &header : headers)
+        cost += header.first.size() + header.second.size();
+    if (cost > memoryCache.maxCost())
+        return;
+    memoryCache.insert(key, new QNetworkDiskCacheMemoryItem{ metaData, data }, cost);
+}
 
-    return pathFragment;
+/*!
+    Returns the current time, made strictly increasing so that accesses
+    within the same millisecond are still ordered.
+ */
+qint64 QNetworkDiskCachePrivate::nextAccessTime()
+{
+    lastAccessTime = qMax(QDateTime::currentMSecsSinceEpoch(), lastAccessTime + 1);
+    return lastAccessTime;
 }
 
 QString QNetworkDiskCachePrivate::tmpCacheFileName() const
@@ -725,4 +924,179 @@ bool QCacheItem::read(QFile *device, bool readData)
     return metaData.isValid();
 }
 
+enum
+{
+    IndexMagic = 0x51444349,
+    IndexVersion = 1,
+    IndexInitialCapacity = 64
+};
+
+/*!
+    Opens and maps the index file \a fileName. Returns \c true if the file
+    held a valid index, otherwise the index is empty and should be filled.
+
+    The file is only meaningful to the host that wrote it: it stores the
+    entries in native byte order.
+ */
+bool QNetworkDiskCacheIndex::open(const QString &fileName)
+{
+    close();
+    file.setFileName(fileName);
+    bool valid = false;
+    if (file.open(QIODevice::ReadWrite)) {
+        const qint64 fileSize = file.size();
+        if (fileSize >= qint64(sizeof(Header)))
+            storage = file.map(0, fileSize);
+        if (storage) {
+            capacity = qsizetype((fileSize - qint64(sizeof(Header))) / qint64(sizeof(Entry)));
+            const Header *h = header();
+            valid = h->magic == IndexMagic && h->version == IndexVersion && h->clean
+                    && qsizetype(h->count) <= capacity;
+        }
+    }
+
+    if (valid) {
+        const quint32 count = header()->count;
+        const Entry *e = entries();
+        positions.reserve(count);
+        for (quint32 i = 0; i < count; ++i) {
+            positions.insert(e[i].key, i);
+            lru.insert(e[i].lastAccess, e[i].key);
+            total += e[i].size;
+        }
+        valid = positions.size() == qsizetype(count);
+    }
+
+    if (!valid) {
+        positions.clear();
+        lru.clear();
+        total = 0;
+        reserve(IndexInitialCapacity);
+        Header *h = header();
+        h->magic = IndexMagic;
+        h->version = IndexVersion;
+        h->count = 0;
+    }
+    // an index that is not closed is rebuilt next time
+    header()->clean = 0;
+    return valid;
+}
+
+void QNetworkDiskCacheIndex::close()
+{
+    if (storage && file.isOpen()) {
+        header()->clean = 1;
+        file.unmap(storage);
+    }
+    storage = nullptr;
+    file.close();
+    fallback.clear();
+    capacity = 0;
+    clear();
+}
+
+void QNetworkDiskCacheIndex::clear()
+{
+    positions.clear();
+    lru.clear();
+    total = 0;
+    if (storage)
+        header()->count = 0;
+}
+
+/*!
+    Makes room for \a size entries. The index stays in memory if the file
+    cannot be grown or mapped, and as the file is still marked dirty it will
+    be rebuilt when it is opened the next time.
+ */
+void QNetworkDiskCacheIndex::reserve(qsizetype size)
+{
+    if (storage && size <= capacity)
+        return;
+
+    const qsizetype newCapacity = qMax(size, capacity * 2);
+    const qint64 bytes = qint64(sizeof(Header)) + newCapacity * qint64(sizeof(Entry));
+    if (file.isOpen()) {
+        if (storage)
+            file.unmap(storage);
+        storage = nullptr;
+        // size() also refreshes the size the file engine has cached
+        if (file.resize(bytes) && file.size() == bytes)
+            storage = file.map(0, bytes);
+        if (!storage) {
+            file.seek(0);
+            fallback = file.read(bytes);
+            file.close();
+        }
+    }
+    if (!storage) {
+        fallback.resize(bytes);
+        storage = reinterpret_cast<uchar *>(fallback.data());
+    }
+    capacity = newCapacity;
+}
+
+void QNetworkDiskCacheIndex::insert(quint64 key, qint64 size, qint64 lastAccess)
+{
+    if (!key)
+        return;
+    const auto it = positions.constFind(key);
+    if (it != positions.cend()) {
+        Entry &e = entries()[it.value()];
+        lru.remove(e.lastAccess, key);
+        total += size - e.size;
+        e.size = size;
+        e.lastAccess = lastAccess;
+        lru.insert(lastAccess, key);
+        return;
+    }
+
+    const qsizetype slot = positions.size();
+    reserve(slot + 1);
+    entries()[slot] = { key, size, lastAccess };
+    positions.insert(key, slot);
+    lru.insert(lastAccess, key);
+    total += size;
+    header()->count = quint32(positions.size());
+}
+
+bool QNetworkDiskCacheIndex::touch(quint64 key, qint64 lastAccess)
+{
+    const auto it = positions.constFind(key);
+    if (it == positions.cend())
+        return false;
+    Entry &e = entries()[it.value()];
+    lru.remove(e.lastAccess, key);
+    e.lastAccess = lastAccess;
+    lru.insert(lastAccess, key);
+    return true;
+}
+
+bool QNetworkDiskCacheIndex::remove(quint64 key)
+{
+    const auto it = positions.constFind(key);
+    if (it == positions.cend())
+        return false;
+    const qsizetype slot = it.value();
+    lru.remove(entries()[slot].lastAccess, key);
+    removeAt(slot);
+    return true;
+}
+
+// removes the entry in slot, which must already have been taken out of lru
+void QNetworkDiskCacheIndex::removeAt(qsizetype slot)
+{
+    Entry *e = entries();
+    positions.remove(e[slot].key);
+    total -= e[slot].size;
+
+    // keep the entries packed by moving the last one into the hole
+    const qsizetype last = positions.size();
+    if (slot != last) {
+        e[slot] = e[last];
+        positions[e[slot].key] = slot;
+    }
+    header()->count = quint32(last);
+}
+
 QT_END_NAMESPACE
@@ -62,6 +62,9 @@ public:
     qint64 maximumCacheSize() const;
     void setMaximumCacheSize(qint64 size);
 
+    qint64 maximumMemoryCacheSize() const;
+    void setMaximumMemoryCacheSize(qint64 size);
+
     qint64 cacheSize() const override;
     QNetworkCacheMetaData metaData(const QUrl &url) override;
     void updateMetaData(const QNetworkCacheMetaData &metaData) override;
@@ -55,7 +55,10 @@
 #include "private/qabstractnetworkcache_p.h"
 
 #include <qbuffer.h>
+#include <qcache.h>
+#include <qfile.h>
 #include <qhash.h>
+#include <qmap.h>
 #include <qtemporaryfile.h>
 
 QT_REQUIRE_CONFIG(networkdiskcache);
@@ -94,6 +97,90 @@ public:
     bool canCompress() const;
 };
 
+/*
+    Persistent index of the committed cache files: for every file it records
+    a key derived from the file name (and thus from the URL hash), the file
+    size and the time of the last access. The entries live in a memory-mapped
+    file so that updates are plain stores, while a hash and an ordered map
+    give constant time lookups and logarithmic time LRU ordering.
+
+    The index is marked dirty while it is in use; an index that was not
+    closed cleanly is discarded and rebuilt from the cache directory.
+*/
+class QNetworkDiskCacheIndex
+{
+public:
+    struct Entry
+    {
+        quint64 key;
+        qint64 size;
+        qint64 lastAccess;
+    };
+
+    QNetworkDiskCacheIndex() = default;
+    ~QNetworkDiskCacheIndex() { close(); }
+
+    bool open(const QString &fileName);
+    void close();
+    void clear();
+
+    bool isEmpty() const { return positions.isEmpty(); }
+    qsizetype count() const { return positions.size(); }
+    qint64 totalSize() const { return total; }
+    bool contains(quint64 key) const { return positions.contains(key); }
+
+    void insert(quint64 key, qint64 size, qint64 lastAccess);
+    bool touch(quint64 key, qint64 lastAccess);
+    bool remove(quint64 key);
+
+    // Removes entries, least recently used first, until totalSize() drops
+    // below goal. Entries for which removeFile(key) returns false are kept.
+    template <typename RemoveFile>
+    void removeLeastRecentlyUsed(qint64 goal, RemoveFile removeFile)
+    {
+        auto it = lru.begin();
+        while (it != lru.end() && total >= goal) {
+            const quint64 key = it.value();
+            if (!removeFile(key)) {
+                ++it;
+                continue;
+            }
+            it = lru.erase(it);
+            removeAt(positions.value(key));
+        }
+    }
+
+private:
+    Q_DISABLE_COPY_MOVE(QNetworkDiskCacheIndex)
+
+    struct Header
+    {
+        quint32 magic;
+        quint32 version;
+        quint32 count;
+        quint32 clean;
+    };
+
+    Header *header() const { return reinterpret_cast<Header *>(storage); }
+    Entry *entries() const { return reinterpret_cast<Entry *>(storage + sizeof(Header)); }
+    void reserve(qsizetype size);
+    void removeAt(qsizetype slot);
+
+    QFile file;
+    QByteArray fallback;
+    uchar *storage = nullptr;
+    qsizetype capacity = 0;
+    QHash<quint64, qsizetype> positions;
+    QMultiMap<qint64, quint64> lru;
+    qint64 total = 0;
+};
+
+struct QNetworkDiskCacheMemoryItem
+{
+    QNetworkCacheMetaData metaData;
+    QByteArray data;
+};
+
 class QNetworkDiskCachePrivate : public QAbstractNetworkCachePrivate
 {
 public:
@@ -101,10 +188,21 @@ public:
         : QAbstractNetworkCachePrivate()
         , maximumCacheSize(1024 * 1024 * 50)
         , currentCacheSize(-1)
+        , memoryCache(0)
         {}
 
+    static QByteArray uniqueId(const QUrl &url);
+    static quint64 packId(QByteArrayView id);
     static QString uniqueFileName(const QUrl &url);
     QString cacheFileName(const QUrl &url) const;
+    quint64 indexKey(const QString &fileName) const;
+    QString indexFileName(quint64 key) const;
+    void openIndex();
+    void recordAccess(const QString &fileName);
+    qint64 nextAccessTime();
+    QNetworkDiskCacheMemoryItem *memoryItem(const QUrl &url);
+    void cacheInMemory(const QString &fileName, const QNetworkCacheMetaData &metaData,
+                       const QByteArray &data);
     QString tmpCacheFileName() const;
     bool removeFile(const QString &file);
     void storeItem(QCacheItem *item);
@@ -116,7 +214,10 @@ public:
     QString dataDirectory;
     qint64 maximumCacheSize;
     qint64 currentCacheSize;
+    qint64 lastAccessTime = 0;
 
+    QNetworkDiskCacheIndex index;
+    QCache<quint64, QNetworkDiskCacheMemoryItem> memoryCache;
     QHash<QIODevice*, QCacheItem*> inserting;
     Q_DECLARE_PUBLIC(QNetworkDiskCache)
 };
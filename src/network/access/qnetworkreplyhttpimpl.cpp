@@ -680,6 +680,12 @@ void QNetworkReplyHttpImplPrivate::postRequest(const QNetworkRequest &newHttpReq
     httpRequest.setRedirectPolicy(redirectPolicy);
 
     httpRequest.setPriority(convert(newHttpRequest.priority()));
+    if (const QVariant urgency = newHttpRequest.attribute(QNetworkRequest::HttpPriorityUrgencyAttribute);
+        urgency.isValid()) {
+        httpRequest.setUrgency(urgency.toInt());
+    }
+    httpRequest.setIncremental(
+            newHttpRequest.attribute(QNetworkRequest::HttpPriorityIncrementalAttribute).toBool());
 
     switch (operation) {
     case QNetworkAccessManager::GetOperation:
@@ -780,6 +786,7 @@ void QNetworkReplyHttpImplPrivate::postRequest(const QNetworkRequest &newHttpReq
     // Create the HTTP thread delegate
     QHttpThreadDelegate *delegate = new QHttpThreadDelegate;
     // Propagate Http/2 settings:
+    delegate->http1Parameters = request.http1Configuration();
     delegate->http2Parameters = request.http2Configuration();
 
     // For the synchronous HTTP, this is the normal way the delegate gets deleted
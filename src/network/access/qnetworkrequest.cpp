@@ -43,6 +43,7 @@
 #include "qnetworkcookie.h"
 #include "qsslconfiguration.h"
 #if QT_CONFIG(http) || defined(Q_CLANG_QDOC)
+#include "qhttp1configuration.h"
 #include "qhttp2configuration.h"
 #include "private/http2protocol_p.h"
 #endif
@@ -319,6 +320,26 @@ QT_BEGIN_NAMESPACE
         the QNetworkReply after having emitted "finished".
         (This value was introduced in 5.14.)
 
+    \value HttpPriorityUrgencyAttribute
+        Requests only, type: QMetaType::Int (default: derived from priority())
+        The urgency of the request as defined by the
+        \l {https://www.rfc-editor.org/rfc/rfc9218.html}{Extensible Prioritization
+        Scheme for HTTP} (RFC 9218), from 0 (most urgent) to 7 (least urgent).
+        If not set, HighPriority requests use urgency 1, NormalPriority
+        requests the default urgency 3 and LowPriority requests urgency 5.
+        With HTTP/2, the urgency is sent to the server in the 'priority'
+        header field and decides in which order QNetworkAccessManager
+        opens streams and sends request bodies.
+        (This value was introduced in 6.3.)
+
+    \value HttpPriorityIncrementalAttribute
+        Requests only, type: QMetaType::Bool (default: false)
+        If set, tells an HTTP/2 server (via the 'priority' header field,
+        see RFC 9218) that the response can be processed incrementally,
+        so the server may interleave it with other responses of the same
+        urgency instead of sending them one after another.
+        (This value was introduced in 6.3.)
+
     \value User
         Special type. Additional information can be passed in
         QVariants with types ranging from User to UserMax. The default
@@ -440,6 +461,7 @@ public:
 #endif
         peerVerifyName = other.peerVerifyName;
 #if QT_CONFIG(http)
+        h1Configuration = other.h1Configuration;
         h2Configuration = other.h2Configuration;
         decompressedSafetyCheckThreshold = other.decompressedSafetyCheckThreshold;
 #endif
@@ -455,6 +477,7 @@ public:
             maxRedirectsAllowed == other.maxRedirectsAllowed &&
             peerVerifyName == other.peerVerifyName
 #if QT_CONFIG(http)
+            && h1Configuration == other.h1Configuration
             && h2Configuration == other.h2Configuration
             && decompressedSafetyCheckThreshold == other.decompressedSafetyCheckThreshold
 #endif
@@ -471,6 +494,7 @@ public:
     int maxRedirectsAllowed;
     QString peerVerifyName;
 #if QT_CONFIG(http)
+    QHttp1Configuration h1Configuration;
     QHttp2Configuration h2Configuration;
     qint64 decompressedSafetyCheckThreshold = 10ll * 1024ll * 1024ll;
 #endif
@@ -857,6 +881,39 @@ void QNetworkRequest::setPeerVerifyName(const QString &peerName)
 }
 
 #if QT_CONFIG(http) || defined(Q_CLANG_QDOC)
+/*!
+    \since 6.3
+
+    Returns the current parameters that QNetworkAccessManager is
+    using for this request and its underlying HTTP/1.1 connections.
+    This is either a configuration previously set by an application
+    or a default-constructed QHttp1Configuration.
+
+    \sa setHttp1Configuration
+*/
+QHttp1Configuration QNetworkRequest::http1Configuration() const
+{
+    return d->h1Configuration;
+}
+
+/*!
+    \since 6.3
+
+    Sets request's HTTP/1.1 parameters from \a configuration.
+
+    \note The configuration must be set prior to making a request.
+    \note QNetworkAccessManager shares its connections to a host between
+    the requests to that host. It uses the configuration found in the
+    request that makes it connect to the host, and keeps using it until
+    the connections expire.
+
+    \sa http1Configuration, QNetworkAccessManager, QHttp1Configuration
+*/
+void QNetworkRequest::setHttp1Configuration(const QHttp1Configuration &configuration)
+{
+    d->h1Configuration = configuration;
+}
+
 /*!
     \since 5.14
 
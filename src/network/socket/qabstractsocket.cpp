@@ -470,6 +470,7 @@
 #include "private/qhostinfo_p.h"
 
 #include <qabstracteventdispatcher.h>
+#include <qfile.h>
 #include <qhostaddress.h>
 #include <qhostinfo.h>
 #include <qmetaobject.h>
@@ -532,6 +533,7 @@ QAbstractSocketPrivate::QAbstractSocketPrivate()
       peerPort(0),
       socketEngine(nullptr),
       cachedSocketDescriptor(-1),
+      pendingFileBytes(0),
       readBufferMaxSize(0),
       isBuffered(false),
       hasPendingData(false),
@@ -792,7 +794,7 @@ bool QAbstractSocketPrivate::writeToSocket()
 {
     Q_Q(QAbstractSocket);
     if (!socketEngine || !socketEngine->isValid() || (writeBuffer.isEmpty()
-        && socketEngine->bytesToWrite() == 0)) {
+        && pendingFiles.isEmpty() && socketEngine->bytesToWrite() == 0)) {
 #if defined (QABSTRACTSOCKET_DEBUG)
     qDebug("QAbstractSocketPrivate::writeToSocket() nothing to do: valid ? %s, writeBuffer.isEmpty() ? %s",
            (socketEngine && socketEngine->isValid()) ? "yes" : "no", writeBuffer.isEmpty() ? "yes" : "no");
@@ -809,11 +811,28 @@ bool QAbstractSocketPrivate::writeToSocket()
         return false;
     }
 
-    qint64 nextSize = writeBuffer.nextDataBlockSize();
-    const char *ptr = writeBuffer.readPointer();
+    // Files queued by writeFile() are sent once the data written before
+    // them has left the write buffer.
+    const bool writingFile = !pendingFiles.isEmpty() && pendingFiles.constFirst().bufferedBefore == 0;
+    qint64 written;
+    if (writingFile) {
+        const PendingFile &pendingFile = pendingFiles.constFirst();
+        if (!pendingFile.file) {
+            setErrorAndEmit(QAbstractSocket::UnknownSocketError,
+                            QAbstractSocket::tr("File was deleted before it was written"));
+            q->abort();
+            return false;
+        }
+        written = socketEngine->writeFile(pendingFile.file, pendingFile.offset, pendingFile.length);
+    } else {
+        qint64 nextSize = writeBuffer.nextDataBlockSize();
+        if (!pendingFiles.isEmpty())
+            nextSize = qMin(nextSize, pendingFiles.constFirst().bufferedBefore);
+        const char *ptr = writeBuffer.readPointer();
 
-    // Attempt to write it all in one chunk.
-    qint64 written = nextSize ? socketEngine->write(ptr, nextSize) : Q_INT64_C(0);
+        // Attempt to write it all in one chunk.
+        written = nextSize ? socketEngine->write(ptr, nextSize) : Q_INT64_C(0);
+    }
     if (written < 0) {
 #if defined (QABSTRACTSOCKET_DEBUG)
         qDebug() << "QAbstractSocketPrivate::writeToSocket() write error, aborting."
@@ -832,13 +851,24 @@ bool QAbstractSocketPrivate::writeToSocket()
 
     if (written > 0) {
         // Remove what we wrote so far.
-        writeBuffer.free(written);
+        if (writingFile) {
+            PendingFile &pendingFile = pendingFiles.first();
+            pendingFile.offset += written;
+            pendingFile.length -= written;
+            pendingFileBytes -= written;
+            if (pendingFile.length == 0)
+                pendingFiles.removeFirst();
+        } else {
+            writeBuffer.free(written);
+            if (!pendingFiles.isEmpty())
+                pendingFiles.first().bufferedBefore -= written;
+        }
 
         // Emit notifications.
         emitBytesWritten(written);
     }
 
-    if (writeBuffer.isEmpty() && socketEngine && !socketEngine->bytesToWrite())
+    if (writeBuffer.isEmpty() && pendingFiles.isEmpty() && socketEngine && !socketEngine->bytesToWrite())
         socketEngine->setWriteNotificationEnabled(false);
     if (state == QAbstractSocket::ClosingState)
         q->disconnectFromHost();
@@ -856,12 +886,63 @@ bool QAbstractSocketPrivate::flush()
 {
     bool dataWasWritten = false;
 
-    while (!allWriteBuffersEmpty() && writeToSocket())
+    while (!allWritesDone() && writeToSocket())
         dataWasWritten = true;
 
     return dataWasWritten;
 }
 
+/*! \internal
+
+    Queues \a length bytes of \a file, starting at \a offset, to be sent
+    after the data already in the write buffer. Sockets other than TCP
+    sockets copy the data instead.
+*/
+qint64 QAbstractSocketPrivate::writeFile(QFile *file, qint64 offset, qint64 length)
+{
+    if (socketType != QAbstractSocket::TcpSocket)
+        return copyFile(file, offset, length);
+
+    qint64 bufferedBefore = writeBuffer.size();
+    for (const PendingFile &pendingFile : qAsConst(pendingFiles))
+        bufferedBefore -= pendingFile.bufferedBefore;
+    pendingFiles.append({file, offset, length, bufferedBefore});
+    pendingFileBytes += length;
+
+    if (socketEngine)
+        socketEngine->setWriteNotificationEnabled(true);
+    return length;
+}
+
+/*! \internal
+
+    Reads \a length bytes of \a file, starting at \a offset, and writes
+    them to the socket with write(). Returns the number of bytes written,
+    or -1 if nothing could be written.
+*/
+qint64 QAbstractSocketPrivate::copyFile(QFile *file, qint64 offset, qint64 length)
+{
+    Q_Q(QAbstractSocket);
+    if (!file->seek(offset)) {
+        setError(QAbstractSocket::UnknownSocketError, file->errorString());
+        return -1;
+    }
+
+    qint64 written = 0;
+    while (written < length) {
+        const QByteArray block = file->read(qMin<qint64>(length - written, 65536));
+        if (block.isEmpty()) {
+            setError(QAbstractSocket::UnknownSocketError, file->errorString());
+            break;
+        }
+        const qint64 result = q->write(block);
+        if (result <= 0)
+            break;
+        written += result;
+    }
+    return written ? written : qint64(-1);
+}
+
 #ifndef QT_NO_NETWORKPROXY
 /*! \internal
 
@@ -1754,7 +1835,7 @@ void QAbstractSocket::connectToHost(const QHostAddress &address, quint16 port,
 */
 qint64 QAbstractSocket::bytesToWrite() const
 {
-    const qint64 pendingBytes = QIODevice::bytesToWrite();
+    const qint64 pendingBytes = QIODevice::bytesToWrite() + d_func()->pendingFileBytes;
 #if defined(QABSTRACTSOCKET_DEBUG)
     qDebug("QAbstractSocket::bytesToWrite() == %lld", pendingBytes);
 #endif
@@ -2181,7 +2262,7 @@ bool QAbstractSocket::waitForReadyRead(int msecs)
 
         bool readyToRead = false;
         bool readyToWrite = false;
-        if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite, true, !d->writeBuffer.isEmpty(),
+        if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite, true, !d->writeBuffer.isEmpty() || !d->pendingFiles.isEmpty(),
                                                qt_subtract_from_timeout(msecs, stopWatch.elapsed()))) {
 #if defined (QABSTRACTSOCKET_DEBUG)
             qDebug("QAbstractSocket::waitForReadyRead(%i) failed (%i, %s)",
@@ -2233,7 +2314,7 @@ bool QAbstractSocket::waitForBytesWritten(int msecs)
         return false;
     }
 
-    if (d->writeBuffer.isEmpty())
+    if (d->writeBuffer.isEmpty() && d->pendingFiles.isEmpty())
         return false;
 
     QElapsedTimer stopWatch;
@@ -2250,7 +2331,7 @@ bool QAbstractSocket::waitForBytesWritten(int msecs)
         bool readyToWrite = false;
         if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite,
                                   !d->readBufferMaxSize || d->buffer.size() < d->readBufferMaxSize,
-                                  !d->writeBuffer.isEmpty(),
+                                  !d->writeBuffer.isEmpty() || !d->pendingFiles.isEmpty(),
                                   qt_subtract_from_timeout(msecs, stopWatch.elapsed()))) {
 #if defined (QABSTRACTSOCKET_DEBUG)
             qDebug("QAbstractSocket::waitForBytesWritten(%i) failed (%i, %s)",
@@ -2330,7 +2411,7 @@ bool QAbstractSocket::waitForDisconnected(int msecs)
         bool readyToRead = false;
         bool readyToWrite = false;
         if (!d->socketEngine->waitForReadOrWrite(&readyToRead, &readyToWrite, state() == ConnectedState,
-                                               !d->writeBuffer.isEmpty(),
+                                               !d->writeBuffer.isEmpty() || !d->pendingFiles.isEmpty(),
                                                qt_subtract_from_timeout(msecs, stopWatch.elapsed()))) {
 #if defined (QABSTRACTSOCKET_DEBUG)
             qDebug("QAbstractSocket::waitForReadyRead(%i) failed (%i, %s)",
@@ -2397,6 +2478,57 @@ bool QAbstractSocket::flush()
     return d_func()->flush();
 }
 
+/*!
+    \since 6.3
+
+    Writes \a length bytes of \a file, starting at \a offset, to the
+    socket, after any data already waiting to be written. If \a length is
+    -1 or extends past the end of the file, the rest of the file is
+    written. Returns the number of bytes that will be written, or -1 if an
+    error occurred.
+
+    For a TCP socket, the file is not read into memory. Its contents are
+    sent as the socket becomes ready for writing, and are counted in
+    bytesToWrite() and reported by bytesWritten() like other data. On
+    Linux, they are sent with sendfile(), which copies them from the page
+    cache to the socket without passing through the application. Files
+    without a native handle, such as Qt resources, are read in blocks
+    instead. For other sockets, such as encrypted QSslSocket connections,
+    the contents have to be processed by the application, and this
+    function reads the file and writes it as write() would.
+
+    \a file must be open for reading and must not be deleted or truncated
+    until its contents have been written. Its current position is not
+    used and may change. If the file is deleted early, the socket reports
+    an error and is aborted.
+
+    \sa write(), bytesToWrite(), bytesWritten()
+*/
+qint64 QAbstractSocket::writeFile(QFile *file, qint64 offset, qint64 length)
+{
+    Q_D(QAbstractSocket);
+    if (!isWritable()) {
+        qWarning("QAbstractSocket::writeFile: device not open for writing");
+        return -1;
+    }
+    if (!file || !file->isReadable()) {
+        qWarning("QAbstractSocket::writeFile: file not open for reading");
+        return -1;
+    }
+
+    const qint64 fileSize = file->size();
+    if (offset < 0 || offset > fileSize) {
+        qWarning("QAbstractSocket::writeFile: invalid offset %lld", offset);
+        return -1;
+    }
+    if (length < 0 || length > fileSize - offset)
+        length = fileSize - offset;
+    if (length == 0)
+        return 0;
+
+    return d->writeFile(file, offset, length);
+}
+
 /*! \reimp
 */
 qint64 QAbstractSocket::readData(char *data, qint64 maxSize)
@@ -2449,7 +2581,7 @@ qint64 QAbstractSocket::writeData(const char *data, qint64 size)
     }
 
     if (!d->isBuffered && d->socketType == TcpSocket
-        && d->socketEngine && d->writeBuffer.isEmpty()) {
+        && d->socketEngine && d->writeBuffer.isEmpty() && d->pendingFiles.isEmpty()) {
         // This code is for the new Unbuffered QTcpSocket use case
         qint64 written = size ? d->socketEngine->write(data, size) : Q_INT64_C(0);
         if (written < 0) {
@@ -2676,7 +2808,7 @@ void QAbstractSocket::disconnectFromHost()
         }
 
         // Wait for pending data to be written.
-        if (d->socketEngine && d->socketEngine->isValid() && (!d->allWriteBuffersEmpty()
+        if (d->socketEngine && d->socketEngine->isValid() && (!d->allWritesDone()
             || d->socketEngine->bytesToWrite() > 0)) {
             d->socketEngine->setWriteNotificationEnabled(true);
 
@@ -2707,6 +2839,8 @@ void QAbstractSocket::disconnectFromHost()
     d->peerAddress.clear();
     d->peerName.clear();
     d->setWriteChannelCount(0);
+    d->pendingFiles.clear();
+    d->pendingFileBytes = 0;
 
 #if defined(QABSTRACTSOCKET_DEBUG)
         qDebug("QAbstractSocket::disconnectFromHost() disconnected!");
@@ -62,6 +62,7 @@ class QNetworkProxy;
 #endif
 class QAbstractSocketPrivate;
 class QAuthenticator;
+class QFile;
 
 class Q_NETWORK_EXPORT QAbstractSocket : public QIODevice
 {
@@ -210,6 +211,8 @@ public:
     bool isSequential() const override;
     bool flush();
 
+    qint64 writeFile(QFile *file, qint64 offset = 0, qint64 length = -1);
+
     // for synchronous access
     virtual bool waitForConnected(int msecs = 30000);
     bool waitForReadyRead(int msecs = 30000) override;
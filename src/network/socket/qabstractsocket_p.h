@@ -55,6 +55,7 @@
 #include "QtNetwork/qabstractsocket.h"
 #include "QtCore/qbytearray.h"
 #include "QtCore/qlist.h"
+#include "QtCore/qpointer.h"
 #include "QtCore/qtimer.h"
 #include "private/qiodevice_p.h"
 #include "private/qabstractsocketengine_p.h"
@@ -131,6 +132,21 @@ public:
     void resetSocketLayer();
     virtual bool flush();
 
+    // A part of a file queued by writeFile(), to be sent after
+    // bufferedBefore more bytes of the write buffer.
+    struct PendingFile
+    {
+        QPointer<QFile> file;
+        qint64 offset;
+        qint64 length;
+        qint64 bufferedBefore;
+    };
+    QList<PendingFile> pendingFiles;
+    qint64 pendingFileBytes;
+    inline bool allWritesDone() const { return allWriteBuffersEmpty() && pendingFiles.isEmpty(); }
+    virtual qint64 writeFile(QFile *file, qint64 offset, qint64 length);
+    qint64 copyFile(QFile *file, qint64 offset, qint64 length);
+
     bool initSocketLayer(QAbstractSocket::NetworkLayerProtocol protocol);
     virtual void configureCreatedSocket();
     void startConnectingByName(const QString &host);
@@ -41,6 +41,7 @@
 
 #include "qnativesocketengine_p.h"
 
+#include "qfile.h"
 #include "qmutex.h"
 #include "qnetworkproxy.h"
 
@@ -269,6 +270,78 @@ int QAbstractSocketEngine::outboundStreamCount() const
     return d_func()->outboundStreamCount;
 }
 
+/*!
+    Writes up to \a len bytes of \a file, starting at \a offset, to the
+    socket. Returns the number of bytes written, or -1 if an error
+    occurred. Reaching the end of \a file before \a len bytes could be
+    read is an error.
+
+    The default implementation reads a block of the file and passes it
+    to write(). The current position of \a file is not preserved.
+*/
+qint64 QAbstractSocketEngine::writeFile(QFile *file, qint64 offset, qint64 len)
+{
+    QByteArray block(qMin<qint64>(len, 65536), Qt::Uninitialized);
+    if (!file->seek(offset)) {
+        setError(QAbstractSocket::UnknownSocketError, file->errorString());
+        return -1;
+    }
+    const qint64 readBytes = file->read(block.data(), block.size());
+    if (readBytes <= 0) {
+        setError(QAbstractSocket::UnknownSocketError,
+                 readBytes < 0 ? file->errorString() : tr("Unexpected end of file"));
+        return -1;
+    }
+    return write(block.constData(), readBytes);
+}
+
+#ifndef QT_NO_UDPSOCKET
+/*!
+    Reads up to \a count pending datagrams into \a datagrams, each one
+    truncated to the capacity of its buffer, and sets their sizes and
+    headers. Returns the number of datagrams read, or -1 if an error
+    occurred before any datagram could be read.
+
+    The default implementation reads one datagram at a time.
+*/
+qint64 QAbstractSocketEngine::readDatagrams(QDatagramBuffer *datagrams, qint64 count,
+                                            PacketHeaderOptions options)
+{
+    qint64 received = 0;
+    for (; received < count && hasPendingDatagrams(); ++received) {
+        QDatagramBuffer &datagram = datagrams[received];
+        const qint64 result = readDatagram(datagram.data, datagram.size, datagram.header, options);
+        if (result == -2)
+            break;
+        if (result < 0)
+            return received ? received : -1;
+        datagram.size = result;
+    }
+    return received;
+}
+
+/*!
+    Writes the \a count datagrams in \a datagrams, and returns the number
+    of datagrams written, which can be fewer than \a count. Returns -2 if
+    the socket cannot send without blocking, and -1 if an error occurred,
+    before any datagram was written.
+
+    The default implementation writes one datagram at a time.
+*/
+qint64 QAbstractSocketEngine::writeDatagrams(const QDatagramBuffer *datagrams, qint64 count)
+{
+    const QIpPacketHeader noHeader;
+    for (qint64 sent = 0; sent < count; ++sent) {
+        const QDatagramBuffer &datagram = datagrams[sent];
+        const qint64 result = writeDatagram(datagram.data, datagram.size,
+                                            datagram.header ? *datagram.header : noHeader);
+        if (result < 0)
+            return sent ? sent : result;
+    }
+    return count;
+}
+#endif // QT_NO_UDPSOCKET
+
 QT_END_NAMESPACE
 
 #include "moc_qabstractsocketengine_p.cpp"
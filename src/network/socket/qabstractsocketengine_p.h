@@ -61,12 +61,22 @@
 QT_BEGIN_NAMESPACE
 
 class QAuthenticator;
+class QFile;
 class QAbstractSocketEnginePrivate;
 #ifndef QT_NO_NETWORKINTERFACE
 class QNetworkInterface;
 #endif
 class QNetworkProxy;
 
+// One datagram of a batch: size is the capacity of data when reading, and
+// the size of the datagram otherwise. header may be null if not needed.
+struct QDatagramBuffer
+{
+    char *data;
+    qint64 size;
+    QIpPacketHeader *header;
+};
+
 class QAbstractSocketEngineReceiver {
 public:
     virtual ~QAbstractSocketEngineReceiver(){}
@@ -141,6 +151,7 @@ public:
 
     virtual qint64 read(char *data, qint64 maxlen) = 0;
     virtual qint64 write(const char *data, qint64 len) = 0;
+    virtual qint64 writeFile(QFile *file, qint64 offset, qint64 len);
 
 #ifndef QT_NO_UDPSOCKET
 #ifndef QT_NO_NETWORKINTERFACE
@@ -159,6 +170,11 @@ public:
     virtual qint64 readDatagram(char *data, qint64 maxlen, QIpPacketHeader *header = nullptr,
                                 PacketHeaderOptions = WantNone) = 0;
     virtual qint64 writeDatagram(const char *data, qint64 len, const QIpPacketHeader &header) = 0;
+#ifndef QT_NO_UDPSOCKET
+    virtual qint64 readDatagrams(QDatagramBuffer *datagrams, qint64 count,
+                                 PacketHeaderOptions options = WantNone);
+    virtual qint64 writeDatagrams(const QDatagramBuffer *datagrams, qint64 count);
+#endif
     virtual qint64 bytesToWrite() const = 0;
 
     virtual int option(SocketOption option) const = 0;
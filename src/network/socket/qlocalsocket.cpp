@@ -227,6 +227,26 @@ QT_BEGIN_NAMESPACE
     \sa write(), waitForBytesWritten()
 */
 
+/*!
+    \fn qint64 QLocalSocket::writeFile(QFile *file, qint64 offset, qint64 length)
+    \since 6.3
+
+    Writes \a length bytes of \a file, starting at \a offset, to the
+    socket, after any data already waiting to be written. If \a length is
+    -1 or extends past the end of the file, the rest of the file is
+    written. Returns the number of bytes that will be written, or -1 if an
+    error occurred.
+
+    On Unix, the file is not read into memory: its contents are sent as
+    the socket becomes ready for writing, directly from the file where the
+    system supports it, and are reported by bytesWritten() like other
+    data. \a file must then stay open, and must not be truncated, until
+    they have been written. On Windows, the file is read and written as
+    write() would.
+
+    \sa QAbstractSocket::writeFile(), bytesToWrite()
+*/
+
 /*!
     \fn void QLocalSocket::disconnectFromServer()
 
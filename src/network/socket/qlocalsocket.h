@@ -112,6 +112,7 @@ public:
     virtual void close() override;
     LocalSocketError error() const;
     bool flush();
+    qint64 writeFile(QFile *file, qint64 offset = 0, qint64 length = -1);
     bool isValid() const;
     qint64 readBufferSize() const;
     void setReadBufferSize(qint64 size);
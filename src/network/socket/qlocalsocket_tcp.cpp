@@ -358,6 +358,12 @@ bool QLocalSocket::flush()
     return d->tcpSocket->flush();
 }
 
+qint64 QLocalSocket::writeFile(QFile *file, qint64 offset, qint64 length)
+{
+    Q_D(QLocalSocket);
+    return d->tcpSocket->writeFile(file, offset, length);
+}
+
 void QLocalSocket::disconnectFromServer()
 {
     Q_D(QLocalSocket);
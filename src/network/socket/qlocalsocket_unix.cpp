@@ -546,6 +546,12 @@ bool QLocalSocket::flush()
     return d->unixSocket.flush();
 }
 
+qint64 QLocalSocket::writeFile(QFile *file, qint64 offset, qint64 length)
+{
+    Q_D(QLocalSocket);
+    return d->unixSocket.writeFile(file, offset, length);
+}
+
 void QLocalSocket::disconnectFromServer()
 {
     Q_D(QLocalSocket);
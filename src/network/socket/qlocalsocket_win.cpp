@@ -38,6 +38,7 @@
 ****************************************************************************/
 
 #include "qlocalsocket_p.h"
+#include <qfile.h>
 #include <qscopedvaluerollback.h>
 #include <qdeadlinetimer.h>
 
@@ -382,6 +383,34 @@ bool QLocalSocket::flush()
     return written;
 }
 
+qint64 QLocalSocket::writeFile(QFile *file, qint64 offset, qint64 length)
+{
+    if (!file || !file->isReadable()) {
+        qWarning("QLocalSocket::writeFile: file not open for reading");
+        return -1;
+    }
+    const qint64 fileSize = file->size();
+    if (offset < 0 || offset > fileSize || !file->seek(offset)) {
+        qWarning("QLocalSocket::writeFile: invalid offset %lld", offset);
+        return -1;
+    }
+    if (length < 0 || length > fileSize - offset)
+        length = fileSize - offset;
+
+    // Pipe writes are overlapped from our own buffer, so read the file in.
+    qint64 written = 0;
+    while (written < length) {
+        const QByteArray block = file->read(qMin<qint64>(length - written, 65536));
+        if (block.isEmpty())
+            break;
+        const qint64 result = write(block);
+        if (result <= 0)
+            break;
+        written += result;
+    }
+    return (written || !length) ? written : qint64(-1);
+}
+
 void QLocalSocket::disconnectFromServer()
 {
     Q_D(QLocalSocket);
@@ -117,6 +117,7 @@
 #include "qnativesocketengine_p.h"
 
 #include <qabstracteventdispatcher.h>
+#include <qfile.h>
 #include <qsocketnotifier.h>
 #include <qnetworkinterface.h>
 
@@ -902,6 +903,79 @@ qint64 QNativeSocketEngine::writeDatagram(const char *data, qint64 size, const Q
     return d->nativeSendDatagram(data, size, header);
 }
 
+#ifndef QT_NO_UDPSOCKET
+/*!
+    Reads up to \a count pending datagrams into \a datagrams, each one
+    truncated to the capacity of its buffer, and sets their sizes and the
+    header fields requested in \a options. Returns the number of datagrams
+    read, which is 0 if none was pending, or -1 if an error occurred
+    before any datagram could be read.
+
+    On Linux, this reads many datagrams with one system call.
+
+    \sa readDatagram()
+*/
+qint64 QNativeSocketEngine::readDatagrams(QDatagramBuffer *datagrams, qint64 count,
+                                          PacketHeaderOptions options)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::readDatagrams(), -1);
+    Q_CHECK_STATES(QNativeSocketEngine::readDatagrams(), QAbstractSocket::BoundState,
+                   QAbstractSocket::ConnectedState, -1);
+
+#if defined(Q_OS_LINUX)
+    return d->nativeReceiveDatagrams(datagrams, count, options);
+#else
+    qint64 received = 0;
+    for (; received < count; ++received) {
+        QDatagramBuffer &datagram = datagrams[received];
+        const qint64 result = d->nativeReceiveDatagram(datagram.data, datagram.size,
+                                                       datagram.header, options);
+        if (result == -2)
+            break;
+        if (result < 0)
+            return received ? received : -1;
+        datagram.size = result;
+    }
+    return received;
+#endif
+}
+
+/*!
+    Writes the \a count datagrams in \a datagrams to the destinations in
+    their headers, and returns the number of datagrams written. Returns -2
+    if the socket cannot send without blocking, and -1 if an error
+    occurred, before any datagram was written.
+
+    On Linux, this writes many datagrams with one system call, and lets
+    the kernel segment runs of equally sized datagrams to the same
+    destination if it supports it.
+
+    \sa writeDatagram()
+*/
+qint64 QNativeSocketEngine::writeDatagrams(const QDatagramBuffer *datagrams, qint64 count)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::writeDatagrams(), -1);
+    Q_CHECK_STATES(QNativeSocketEngine::writeDatagrams(), QAbstractSocket::BoundState,
+                   QAbstractSocket::ConnectedState, -1);
+
+#if defined(Q_OS_LINUX)
+    return d->nativeSendDatagrams(datagrams, count);
+#else
+    const QIpPacketHeader noHeader;
+    for (qint64 sent = 0; sent < count; ++sent) {
+        const QDatagramBuffer &datagram = datagrams[sent];
+        const qint64 result = d->nativeSendDatagram(datagram.data, datagram.size,
+                                                    datagram.header ? *datagram.header : noHeader);
+        if (result < 0)
+            return sent ? sent : result;
+    }
+    return count;
+#endif
+}
+#endif // QT_NO_UDPSOCKET
+
 /*!
     Writes a block of \a size bytes from \a data to the socket.
     Returns the number of bytes written, or -1 if an error occurred.
@@ -919,6 +993,33 @@ qint64 QNativeSocketEngine::write(const char *data, qint64 size)
 }
 
 
+/*!
+    Writes up to \a len bytes of \a file, starting at \a offset, to the
+    socket. Returns the number of bytes written, or -1 if an error
+    occurred.
+
+    On Linux, the data goes straight from the file to the socket with
+    sendfile(), without being copied through user space. Elsewhere, and
+    for files without a native handle, it falls back to reading the file.
+*/
+qint64 QNativeSocketEngine::writeFile(QFile *file, qint64 offset, qint64 len)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::writeFile(), -1);
+    Q_CHECK_STATE(QNativeSocketEngine::writeFile(), QAbstractSocket::ConnectedState, -1);
+
+#if defined(Q_OS_LINUX)
+    const int fd = file->handle();
+    if (fd != -1) {
+        const qint64 written = d->nativeWriteFile(fd, offset, len);
+        if (written != -2)
+            return written;
+    }
+#else
+    Q_UNUSED(d);
+#endif
+    return QAbstractSocketEngine::writeFile(file, offset, len);
+}
 qint64 QNativeSocketEngine::bytesToWrite() const
 {
     return 0;
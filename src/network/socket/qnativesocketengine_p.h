@@ -146,6 +146,7 @@ public:
 
     qint64 read(char *data, qint64 maxlen) override;
     qint64 write(const char *data, qint64 len) override;
+    qint64 writeFile(QFile *file, qint64 offset, qint64 len) override;
 
 #ifndef QT_NO_UDPSOCKET
 #ifndef QT_NO_NETWORKINTERFACE
@@ -164,6 +165,11 @@ public:
     qint64 readDatagram(char *data, qint64 maxlen, QIpPacketHeader * = nullptr,
                         PacketHeaderOptions = WantNone) override;
     qint64 writeDatagram(const char *data, qint64 len, const QIpPacketHeader &) override;
+#ifndef QT_NO_UDPSOCKET
+    qint64 readDatagrams(QDatagramBuffer *datagrams, qint64 count,
+                         PacketHeaderOptions options = WantNone) override;
+    qint64 writeDatagrams(const QDatagramBuffer *datagrams, qint64 count) override;
+#endif
     qint64 bytesToWrite() const override;
 
 #if 0   // currently unused
@@ -216,6 +222,13 @@ public:
     LPFN_WSASENDMSG sendmsg;
     LPFN_WSARECVMSG recvmsg;
 #  endif
+#if defined(Q_OS_LINUX)
+    // set when the kernel or the interface cannot segment UDP datagrams
+    bool udpSegmentationUnsupported = false;
+    // the largest segment size to try, -1 until it is determined
+    qint64 udpMaxSegmentSize = -1;
+    qint64 udpSegmentSizeLimit();
+#endif
     enum ErrorString {
         NonBlockingInitFailedErrorString,
         BroadcastingInitFailedErrorString,
@@ -277,8 +290,16 @@ public:
     qint64 nativeReceiveDatagram(char *data, qint64 maxLength, QIpPacketHeader *header,
                                  QAbstractSocketEngine::PacketHeaderOptions options);
     qint64 nativeSendDatagram(const char *data, qint64 length, const QIpPacketHeader &header);
+#if defined(Q_OS_LINUX)
+    qint64 nativeReceiveDatagrams(QDatagramBuffer *datagrams, qint64 count,
+                                  QAbstractSocketEngine::PacketHeaderOptions options);
+    qint64 nativeSendDatagrams(const QDatagramBuffer *datagrams, qint64 count);
+#endif
     qint64 nativeRead(char *data, qint64 maxLength);
     qint64 nativeWrite(const char *data, qint64 length);
+#if defined(Q_OS_LINUX)
+    qint64 nativeWriteFile(int fd, qint64 offset, qint64 length);
+#endif
     int nativeSelect(int timeout, bool selectForRead) const;
     int nativeSelect(int timeout, bool checkRead, bool checkWrite,
                      bool *selectForRead, bool *selectForWrite) const;
@@ -67,6 +67,12 @@
 #endif
 
 #include <netinet/tcp.h>
+#if defined(Q_OS_LINUX)
+#include <netinet/udp.h>
+#  ifdef UDP_SEGMENT
+#    define QNATIVESOCKETENGINE_HAVE_UDP_SEGMENT
+#  endif
+#endif
 #ifndef QT_NO_SCTP
 #include <sys/types.h>
 #include <sys/socket.h>
@@ -904,11 +910,11 @@ qint64 QNativeSocketEnginePrivate::nativePendingDatagramSize() const
     return qint64(recvResult);
 }
 
-qint64 QNativeSocketEnginePrivate::nativeReceiveDatagram(char *data, qint64 maxSize, QIpPacketHeader *header,
-                                                         QAbstractSocketEngine::PacketHeaderOptions options)
+namespace {
+// we use quintptr to force the alignment
+struct ReceiveControlBuffer
 {
-    // we use quintptr to force the alignment
-    quintptr cbuf[(CMSG_SPACE(sizeof(struct in6_pktinfo)) + CMSG_SPACE(sizeof(int))
+    quintptr data[(CMSG_SPACE(sizeof(struct in6_pktinfo)) + CMSG_SPACE(sizeof(int))
 #if !defined(IP_PKTINFO) && defined(IP_RECVIF) && defined(Q_OS_BSD4)
                    + CMSG_SPACE(sizeof(sockaddr_dl))
 #endif
@@ -916,116 +922,163 @@ qint64 QNativeSocketEnginePrivate::nativeReceiveDatagram(char *data, qint64 maxS
                    + CMSG_SPACE(sizeof(struct sctp_sndrcvinfo))
 #endif
                    + sizeof(quintptr) - 1) / sizeof(quintptr)];
+};
 
-    struct msghdr msg;
-    struct iovec vec;
-    qt_sockaddr aa;
-    char c;
-    memset(&msg, 0, sizeof(msg));
-    memset(&aa, 0, sizeof(aa));
+struct SendControlBuffer
+{
+    quintptr data[(CMSG_SPACE(sizeof(struct in6_pktinfo)) + CMSG_SPACE(sizeof(int))
+#ifndef QT_NO_SCTP
+                   + CMSG_SPACE(sizeof(struct sctp_sndrcvinfo))
+#endif
+#ifdef QNATIVESOCKETENGINE_HAVE_UDP_SEGMENT
+                   + CMSG_SPACE(sizeof(quint16))
+#endif
+                   + sizeof(quintptr) - 1) / sizeof(quintptr)];
+};
+} // unnamed namespace
+
+/*
+    Sets up \a msg to receive a datagram of up to \a maxSize bytes into \a data,
+    and the sender and ancillary data requested in \a options into \a aa and \a cbuf.
+*/
+static void qt_prepareReceiveMessage(msghdr *msg, iovec *vec, char *data, qint64 maxSize,
+                                     char *dummy, qt_sockaddr *aa, ReceiveControlBuffer *cbuf,
+                                     QAbstractSocketEngine::PacketHeaderOptions options)
+{
+    memset(msg, 0, sizeof(*msg));
+    memset(aa, 0, sizeof(*aa));
 
     // we need to receive at least one byte, even if our user isn't interested in it
-    vec.iov_base = maxSize ? data : &c;
-    vec.iov_len = maxSize ? maxSize : 1;
-    msg.msg_iov = &vec;
-    msg.msg_iovlen = 1;
+    vec->iov_base = maxSize ? data : dummy;
+    vec->iov_len = maxSize ? maxSize : 1;
+    msg->msg_iov = vec;
+    msg->msg_iovlen = 1;
     if (options & QAbstractSocketEngine::WantDatagramSender) {
-        msg.msg_name = &aa;
-        msg.msg_namelen = sizeof(aa);
+        msg->msg_name = aa;
+        msg->msg_namelen = sizeof(*aa);
     }
     if (options & (QAbstractSocketEngine::WantDatagramHopLimit | QAbstractSocketEngine::WantDatagramDestination
                    | QAbstractSocketEngine::WantStreamNumber)) {
-        msg.msg_control = cbuf;
-        msg.msg_controllen = sizeof(cbuf);
+        msg->msg_control = cbuf;
+        msg->msg_controllen = sizeof(*cbuf);
     }
+}
 
-    ssize_t recvResult = 0;
-    do {
-        recvResult = ::recvmsg(socketDescriptor, &msg, 0);
-    } while (recvResult == -1 && errno == EINTR);
-
-    if (recvResult == -1) {
-        switch (errno) {
-#if defined(EWOULDBLOCK) && EWOULDBLOCK != EAGAIN
-        case EWOULDBLOCK:
-#endif
-        case EAGAIN:
-            // No datagram was available for reading
-            recvResult = -2;
-            break;
-        case ECONNREFUSED:
-            setError(QAbstractSocket::ConnectionRefusedError, ConnectionRefusedErrorString);
-            break;
-        default:
-            setError(QAbstractSocket::NetworkError, ReceiveDatagramErrorString);
+/*
+    Fills \a header from the sender address \a aa and the ancillary data
+    of a datagram received with \a msg.
+*/
+static void qt_parseReceivedMessage(msghdr *msg, qt_sockaddr *aa, quint16 localPort,
+                                    QIpPacketHeader *header)
+{
+    qt_socket_getPortAndAddress(aa, &header->senderPort, &header->senderAddress);
+    header->destinationPort = localPort;
+    header->endOfRecord = (msg->msg_flags & MSG_EOR) != 0;
+
+    // parse the ancillary data
+    struct cmsghdr *cmsgptr;
+    QT_WARNING_PUSH
+    QT_WARNING_DISABLE_CLANG("-Wsign-compare")
+    for (cmsgptr = CMSG_FIRSTHDR(msg); cmsgptr != nullptr;
+         cmsgptr = CMSG_NXTHDR(msg, cmsgptr)) {
+        QT_WARNING_POP
+        if (cmsgptr->cmsg_level == IPPROTO_IPV6 && cmsgptr->cmsg_type == IPV6_PKTINFO
+                && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in6_pktinfo))) {
+            in6_pktinfo *info = reinterpret_cast<in6_pktinfo *>(CMSG_DATA(cmsgptr));
+
+            header->destinationAddress.setAddress(reinterpret_cast<quint8 *>(&info->ipi6_addr));
+            header->ifindex = info->ipi6_ifindex;
+            if (header->ifindex)
+                header->destinationAddress.setScopeId(QString::number(info->ipi6_ifindex));
         }
-        if (header)
-            header->clear();
-    } else if (options != QAbstractSocketEngine::WantNone) {
-        Q_ASSERT(header);
-        qt_socket_getPortAndAddress(&aa, &header->senderPort, &header->senderAddress);
-        header->destinationPort = localPort;
-        header->endOfRecord = (msg.msg_flags & MSG_EOR) != 0;
-
-        // parse the ancillary data
-        struct cmsghdr *cmsgptr;
-        QT_WARNING_PUSH
-        QT_WARNING_DISABLE_CLANG("-Wsign-compare")
-        for (cmsgptr = CMSG_FIRSTHDR(&msg); cmsgptr != nullptr;
-             cmsgptr = CMSG_NXTHDR(&msg, cmsgptr)) {
-            QT_WARNING_POP
-            if (cmsgptr->cmsg_level == IPPROTO_IPV6 && cmsgptr->cmsg_type == IPV6_PKTINFO
-                    && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in6_pktinfo))) {
-                in6_pktinfo *info = reinterpret_cast<in6_pktinfo *>(CMSG_DATA(cmsgptr));
-
-                header->destinationAddress.setAddress(reinterpret_cast<quint8 *>(&info->ipi6_addr));
-                header->ifindex = info->ipi6_ifindex;
-                if (header->ifindex)
-                    header->destinationAddress.setScopeId(QString::number(info->ipi6_ifindex));
-            }
 
 #ifdef IP_PKTINFO
-            if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_PKTINFO
-                    && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in_pktinfo))) {
-                in_pktinfo *info = reinterpret_cast<in_pktinfo *>(CMSG_DATA(cmsgptr));
+        if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_PKTINFO
+                && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in_pktinfo))) {
+            in_pktinfo *info = reinterpret_cast<in_pktinfo *>(CMSG_DATA(cmsgptr));
 
-                header->destinationAddress.setAddress(ntohl(info->ipi_addr.s_addr));
-                header->ifindex = info->ipi_ifindex;
-            }
+            header->destinationAddress.setAddress(ntohl(info->ipi_addr.s_addr));
+            header->ifindex = info->ipi_ifindex;
+        }
 #else
 #  ifdef IP_RECVDSTADDR
-            if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_RECVDSTADDR
-                    && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in_addr))) {
-                in_addr *addr = reinterpret_cast<in_addr *>(CMSG_DATA(cmsgptr));
+        if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_RECVDSTADDR
+                && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in_addr))) {
+            in_addr *addr = reinterpret_cast<in_addr *>(CMSG_DATA(cmsgptr));
 
-                header->destinationAddress.setAddress(ntohl(addr->s_addr));
-            }
+            header->destinationAddress.setAddress(ntohl(addr->s_addr));
+        }
 #  endif
 #  if defined(IP_RECVIF) && defined(Q_OS_BSD4)
-            if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_RECVIF
-                    && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(sockaddr_dl))) {
-                sockaddr_dl *sdl = reinterpret_cast<sockaddr_dl *>(CMSG_DATA(cmsgptr));
-                header->ifindex = sdl->sdl_index;
-            }
+        if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_RECVIF
+                && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(sockaddr_dl))) {
+            sockaddr_dl *sdl = reinterpret_cast<sockaddr_dl *>(CMSG_DATA(cmsgptr));
+            header->ifindex = sdl->sdl_index;
+        }
 #  endif
 #endif
 
-            if (cmsgptr->cmsg_len == CMSG_LEN(sizeof(int))
-                    && ((cmsgptr->cmsg_level == IPPROTO_IPV6 && cmsgptr->cmsg_type == IPV6_HOPLIMIT)
-                        || (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_TTL))) {
-                static_assert(sizeof(header->hopLimit) == sizeof(int));
-                memcpy(&header->hopLimit, CMSG_DATA(cmsgptr), sizeof(header->hopLimit));
-            }
+        if (cmsgptr->cmsg_len == CMSG_LEN(sizeof(int))
+                && ((cmsgptr->cmsg_level == IPPROTO_IPV6 && cmsgptr->cmsg_type == IPV6_HOPLIMIT)
+                    || (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_TTL))) {
+            static_assert(sizeof(header->hopLimit) == sizeof(int));
+            memcpy(&header->hopLimit, CMSG_DATA(cmsgptr), sizeof(header->hopLimit));
+        }
 
 #ifndef QT_NO_SCTP
-            if (cmsgptr->cmsg_level == IPPROTO_SCTP && cmsgptr->cmsg_type == SCTP_SNDRCV
-                && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(sctp_sndrcvinfo))) {
-                sctp_sndrcvinfo *rcvInfo = reinterpret_cast<sctp_sndrcvinfo *>(CMSG_DATA(cmsgptr));
+        if (cmsgptr->cmsg_level == IPPROTO_SCTP && cmsgptr->cmsg_type == SCTP_SNDRCV
+            && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(sctp_sndrcvinfo))) {
+            sctp_sndrcvinfo *rcvInfo = reinterpret_cast<sctp_sndrcvinfo *>(CMSG_DATA(cmsgptr));
 
-                header->streamNumber = int(rcvInfo->sinfo_stream);
-            }
-#endif
+            header->streamNumber = int(rcvInfo->sinfo_stream);
         }
+#endif
+    }
+}
+
+/*
+    Sets the error for a failed receive and returns -2 if no datagram was available,
+    or -1 otherwise.
+*/
+static qint64 qt_receiveError(QNativeSocketEnginePrivate *d)
+{
+    switch (errno) {
+#if defined(EWOULDBLOCK) && EWOULDBLOCK != EAGAIN
+    case EWOULDBLOCK:
+#endif
+    case EAGAIN:
+        // No datagram was available for reading
+        return -2;
+    case ECONNREFUSED:
+        d->setError(QAbstractSocket::ConnectionRefusedError,
+                    QNativeSocketEnginePrivate::ConnectionRefusedErrorString);
+        break;
+    default:
+        d->setError(QAbstractSocket::NetworkError,
+                    QNativeSocketEnginePrivate::ReceiveDatagramErrorString);
+    }
+    return -1;
+}
+
+qint64 QNativeSocketEnginePrivate::nativeReceiveDatagram(char *data, qint64 maxSize, QIpPacketHeader *header,
+                                                         QAbstractSocketEngine::PacketHeaderOptions options)
+{
+    ReceiveControlBuffer cbuf;
+    struct msghdr msg;
+    struct iovec vec;
+    qt_sockaddr aa;
+    char c;
+    qt_prepareReceiveMessage(&msg, &vec, data, maxSize, &c, &aa, &cbuf, options);
+
+    ssize_t recvResult = qt_safe_recvmsg(socketDescriptor, &msg, 0);
+
+    if (recvResult == -1) {
+        recvResult = qt_receiveError(this);
+        if (header)
+            header->clear();
+    } else if (options != QAbstractSocketEngine::WantNone) {
+        Q_ASSERT(header);
+        qt_parseReceivedMessage(&msg, &aa, localPort, header);
     }
 
 #if defined (QNATIVESOCKETENGINE_DEBUG)
@@ -1040,37 +1093,33 @@ qint64 QNativeSocketEnginePrivate::nativeReceiveDatagram(char *data, qint64 maxS
     return qint64((maxSize || recvResult < 0) ? recvResult : Q_INT64_C(0));
 }
 
-qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 len, const QIpPacketHeader &header)
+/*
+    Sets up \a msg to send the \a len bytes at \a data to the destination in
+    \a header, with the other fields of \a header as ancillary data in \a cbuf.
+*/
+static void qt_prepareSendMessage(QNativeSocketEnginePrivate *d, msghdr *msg, iovec *vec,
+                                  const char *data, qint64 len, const QIpPacketHeader &header,
+                                  qt_sockaddr *aa, SendControlBuffer *cbuf)
 {
-    // we use quintptr to force the alignment
-    quintptr cbuf[(CMSG_SPACE(sizeof(struct in6_pktinfo)) + CMSG_SPACE(sizeof(int))
-#ifndef QT_NO_SCTP
-                   + CMSG_SPACE(sizeof(struct sctp_sndrcvinfo))
-#endif
-                   + sizeof(quintptr) - 1) / sizeof(quintptr)];
-
     struct cmsghdr *cmsgptr = reinterpret_cast<struct cmsghdr *>(cbuf);
-    struct msghdr msg;
-    struct iovec vec;
-    qt_sockaddr aa;
 
-    memset(&msg, 0, sizeof(msg));
-    memset(&aa, 0, sizeof(aa));
-    vec.iov_base = const_cast<char *>(data);
-    vec.iov_len = len;
-    msg.msg_iov = &vec;
-    msg.msg_iovlen = 1;
-    msg.msg_control = &cbuf;
+    memset(msg, 0, sizeof(*msg));
+    memset(aa, 0, sizeof(*aa));
+    vec->iov_base = const_cast<char *>(data);
+    vec->iov_len = len;
+    msg->msg_iov = vec;
+    msg->msg_iovlen = 1;
+    msg->msg_control = cbuf;
 
     if (header.destinationPort != 0) {
-        msg.msg_name = &aa.a;
-        setPortAndAddress(header.destinationPort, header.destinationAddress,
-                          &aa, &msg.msg_namelen);
+        msg->msg_name = &aa->a;
+        d->setPortAndAddress(header.destinationPort, header.destinationAddress,
+                             aa, &msg->msg_namelen);
     }
 
-    if (msg.msg_namelen == sizeof(aa.a6)) {
+    if (msg->msg_namelen == sizeof(aa->a6)) {
         if (header.hopLimit != -1) {
-            msg.msg_controllen += CMSG_SPACE(sizeof(int));
+            msg->msg_controllen += CMSG_SPACE(sizeof(int));
             cmsgptr->cmsg_len = CMSG_LEN(sizeof(int));
             cmsgptr->cmsg_level = IPPROTO_IPV6;
             cmsgptr->cmsg_type = IPV6_HOPLIMIT;
@@ -1080,7 +1129,7 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
         if (header.ifindex != 0 || !header.senderAddress.isNull()) {
             struct in6_pktinfo *data = reinterpret_cast<in6_pktinfo *>(CMSG_DATA(cmsgptr));
             memset(data, 0, sizeof(*data));
-            msg.msg_controllen += CMSG_SPACE(sizeof(*data));
+            msg->msg_controllen += CMSG_SPACE(sizeof(*data));
             cmsgptr->cmsg_len = CMSG_LEN(sizeof(*data));
             cmsgptr->cmsg_level = IPPROTO_IPV6;
             cmsgptr->cmsg_type = IPV6_PKTINFO;
@@ -1092,7 +1141,7 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
         }
     } else {
         if (header.hopLimit != -1) {
-            msg.msg_controllen += CMSG_SPACE(sizeof(int));
+            msg->msg_controllen += CMSG_SPACE(sizeof(int));
             cmsgptr->cmsg_len = CMSG_LEN(sizeof(int));
             cmsgptr->cmsg_level = IPPROTO_IP;
             cmsgptr->cmsg_type = IP_TTL;
@@ -1114,7 +1163,7 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
             data->s_addr = htonl(header.senderAddress.toIPv4Address());
 #  endif
             cmsgptr->cmsg_level = IPPROTO_IP;
-            msg.msg_controllen += CMSG_SPACE(sizeof(*data));
+            msg->msg_controllen += CMSG_SPACE(sizeof(*data));
             cmsgptr->cmsg_len = CMSG_LEN(sizeof(*data));
             cmsgptr = reinterpret_cast<cmsghdr *>(reinterpret_cast<char *>(cmsgptr) + CMSG_SPACE(sizeof(*data)));
         }
@@ -1125,7 +1174,7 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
     if (header.streamNumber != -1) {
         struct sctp_sndrcvinfo *data = reinterpret_cast<sctp_sndrcvinfo *>(CMSG_DATA(cmsgptr));
         memset(data, 0, sizeof(*data));
-        msg.msg_controllen += CMSG_SPACE(sizeof(sctp_sndrcvinfo));
+        msg->msg_controllen += CMSG_SPACE(sizeof(sctp_sndrcvinfo));
         cmsgptr->cmsg_len = CMSG_LEN(sizeof(sctp_sndrcvinfo));
         cmsgptr->cmsg_level = IPPROTO_SCTP;
         cmsgptr->cmsg_type =  SCTP_SNDRCV;
@@ -1134,28 +1183,48 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
     }
 #endif
 
-    if (msg.msg_controllen == 0)
-        msg.msg_control = nullptr;
-    ssize_t sentBytes = qt_safe_sendmsg(socketDescriptor, &msg, 0);
+    if (msg->msg_controllen == 0)
+        msg->msg_control = nullptr;
+}
 
-    if (sentBytes < 0) {
-        switch (errno) {
+/*
+    Sets the error for a failed send and returns -2 if the send would have
+    blocked, or -1 otherwise.
+*/
+static qint64 qt_sendError(QNativeSocketEnginePrivate *d)
+{
+    switch (errno) {
 #if defined(EWOULDBLOCK) && EWOULDBLOCK != EAGAIN
-        case EWOULDBLOCK:
+    case EWOULDBLOCK:
 #endif
-        case EAGAIN:
-            sentBytes = -2;
-            break;
-        case EMSGSIZE:
-            setError(QAbstractSocket::DatagramTooLargeError, DatagramTooLargeErrorString);
-            break;
-        case ECONNRESET:
-            setError(QAbstractSocket::RemoteHostClosedError, RemoteHostClosedErrorString);
-            break;
-        default:
-            setError(QAbstractSocket::NetworkError, SendDatagramErrorString);
-        }
+    case EAGAIN:
+        return -2;
+    case EMSGSIZE:
+        d->setError(QAbstractSocket::DatagramTooLargeError,
+                    QNativeSocketEnginePrivate::DatagramTooLargeErrorString);
+        break;
+    case ECONNRESET:
+        d->setError(QAbstractSocket::RemoteHostClosedError,
+                    QNativeSocketEnginePrivate::RemoteHostClosedErrorString);
+        break;
+    default:
+        d->setError(QAbstractSocket::NetworkError,
+                    QNativeSocketEnginePrivate::SendDatagramErrorString);
     }
+    return -1;
+}
+
+qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 len, const QIpPacketHeader &header)
+{
+    SendControlBuffer cbuf;
+    struct msghdr msg;
+    struct iovec vec;
+    qt_sockaddr aa;
+    qt_prepareSendMessage(this, &msg, &vec, data, len, header, &aa, &cbuf);
+
+    ssize_t sentBytes = qt_safe_sendmsg(socketDescriptor, &msg, 0);
+    if (sentBytes < 0)
+        sentBytes = qt_sendError(this);
 
 #if defined (QNATIVESOCKETENGINE_DEBUG)
     qDebug("QNativeSocketEngine::sendDatagram(%p \"%s\", %lli, \"%s\", %i) == %lli", data,
@@ -1167,6 +1236,229 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
     return qint64(sentBytes);
 }
 
+#if defined(Q_OS_LINUX)
+// datagrams passed to one recvmmsg() or sendmmsg() call
+enum { DatagramBatchSize = 64 };
+
+qint64 QNativeSocketEnginePrivate::nativeReceiveDatagrams(QDatagramBuffer *datagrams, qint64 count,
+                                                          QAbstractSocketEngine::PacketHeaderOptions options)
+{
+    struct mmsghdr messages[DatagramBatchSize];
+    struct iovec vecs[DatagramBatchSize];
+    qt_sockaddr addresses[DatagramBatchSize];
+    const bool wantControl = options & (QAbstractSocketEngine::WantDatagramHopLimit
+                                        | QAbstractSocketEngine::WantDatagramDestination
+                                        | QAbstractSocketEngine::WantStreamNumber);
+    QVarLengthArray<ReceiveControlBuffer, DatagramBatchSize> cbufs(wantControl ? DatagramBatchSize : 1);
+    char c;
+
+    qint64 received = 0;
+    while (received < count) {
+        const int batch = int(qMin(count - received, qint64(DatagramBatchSize)));
+        for (int i = 0; i < batch; ++i) {
+            const QDatagramBuffer &datagram = datagrams[received + i];
+            qt_prepareReceiveMessage(&messages[i].msg_hdr, &vecs[i], datagram.data, datagram.size,
+                                     &c, &addresses[i], &cbufs[wantControl ? i : 0], options);
+            messages[i].msg_len = 0;
+        }
+
+        const int result = qt_safe_recvmmsg(socketDescriptor, messages, batch, 0);
+        if (result < 0) {
+            // report errors with the next call if some datagrams were read
+            if (received)
+                break;
+            return qt_receiveError(this) == -2 ? 0 : -1;
+        }
+
+        for (int i = 0; i < result; ++i) {
+            QDatagramBuffer &datagram = datagrams[received + i];
+            if (datagram.size)
+                datagram.size = messages[i].msg_len;
+            if (options != QAbstractSocketEngine::WantNone) {
+                Q_ASSERT(datagram.header);
+                qt_parseReceivedMessage(&messages[i].msg_hdr, &addresses[i], localPort,
+                                        datagram.header);
+            }
+        }
+        received += result;
+        if (result < batch)
+            break;
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeReceiveDatagrams(%p, %lli) == %lli",
+           datagrams, count, received);
+#endif
+
+    return received;
+}
+
+#ifdef QNATIVESOCKETENGINE_HAVE_UDP_SEGMENT
+/*
+    Returns how many datagrams starting at \a datagrams the kernel can send
+    as the segments of one UDP_SEGMENT message: they need to go to the same
+    destination with the same header, and all but the last one need to have
+    the same size.
+*/
+static int qt_segmentableDatagrams(const QDatagramBuffer *datagrams, qint64 count,
+                                   qint64 maxSegmentSize)
+{
+    // the limits of the kernel
+    constexpr int MaxSegments = 64;
+    constexpr qint64 MaxMessageSize = 65507;
+
+    const QDatagramBuffer &first = datagrams[0];
+    const qint64 segmentSize = first.size;
+    if (segmentSize <= 0 || segmentSize > maxSegmentSize || !first.header
+            || first.header->streamNumber != -1) {
+        return 1;
+    }
+
+    const QIpPacketHeader &header = *first.header;
+    qint64 total = segmentSize;
+    int segments = 1;
+    for (; segments < qMin(count, qint64(MaxSegments)); ++segments) {
+        const QDatagramBuffer &next = datagrams[segments];
+        if (next.size <= 0 || next.size > segmentSize || total + next.size > MaxMessageSize)
+            break;
+        if (!next.header || next.header->destinationPort != header.destinationPort
+                || next.header->destinationAddress != header.destinationAddress
+                || next.header->senderAddress != header.senderAddress
+                || next.header->ifindex != header.ifindex
+                || next.header->hopLimit != header.hopLimit
+                || next.header->streamNumber != header.streamNumber) {
+            break;
+        }
+        total += next.size;
+        if (next.size < segmentSize) {
+            // only the last segment can be shorter
+            ++segments;
+            break;
+        }
+    }
+    return segments;
+}
+
+/*
+    Returns the size of the largest datagrams to send as segments of one
+    message. The kernel rejects segments that don't fit into a packet on
+    the path to the destination, which is known for connected sockets. For
+    the others, it assumes an Ethernet MTU of 1500 bytes and IPv6.
+*/
+qint64 QNativeSocketEnginePrivate::udpSegmentSizeLimit()
+{
+    if (udpMaxSegmentSize >= 0)
+        return udpMaxSegmentSize;
+
+    udpMaxSegmentSize = 1500 - 40 - 8;
+    int mtu = 0;
+    QT_SOCKLEN_T len = sizeof(mtu);
+    if (socketProtocol == QAbstractSocket::IPv4Protocol) {
+        if (::getsockopt(socketDescriptor, IPPROTO_IP, IP_MTU, &mtu, &len) == 0 && mtu > 28)
+            udpMaxSegmentSize = mtu - 20 - 8;
+    } else if (::getsockopt(socketDescriptor, IPPROTO_IPV6, IPV6_MTU, &mtu, &len) == 0
+               && mtu > 48) {
+        udpMaxSegmentSize = mtu - 40 - 8;
+    }
+    return udpMaxSegmentSize;
+}
+#endif
+
+qint64 QNativeSocketEnginePrivate::nativeSendDatagrams(const QDatagramBuffer *datagrams, qint64 count)
+{
+    struct mmsghdr messages[DatagramBatchSize];
+    struct iovec vecs[DatagramBatchSize];
+    qt_sockaddr addresses[DatagramBatchSize];
+    SendControlBuffer cbufs[DatagramBatchSize];
+    int segments[DatagramBatchSize];
+    const QIpPacketHeader noHeader;
+
+    qint64 sent = 0;
+    while (sent < count) {
+        // one message per datagram, or per run of datagrams the kernel segments,
+        // but never more datagrams than iovecs
+        const int batch = int(qMin(count - sent, qint64(DatagramBatchSize)));
+        int messageCount = 0;
+        qint64 largestSegment = 0;
+        for (int i = 0; i < batch; ) {
+            const QDatagramBuffer &datagram = datagrams[sent + i];
+            const QIpPacketHeader &header = datagram.header ? *datagram.header : noHeader;
+            msghdr &msg = messages[messageCount].msg_hdr;
+            qt_prepareSendMessage(this, &msg, &vecs[i], datagram.data, datagram.size, header,
+                                  &addresses[messageCount], &cbufs[messageCount]);
+            messages[messageCount].msg_len = 0;
+            segments[messageCount] = 1;
+
+#ifdef QNATIVESOCKETENGINE_HAVE_UDP_SEGMENT
+            const int run = udpSegmentationUnsupported || socketType != QAbstractSocket::UdpSocket
+                    ? 1 : qt_segmentableDatagrams(datagrams + sent + i, batch - i,
+                                                  udpSegmentSizeLimit());
+            if (run > 1) {
+                for (int j = 1; j < run; ++j) {
+                    const QDatagramBuffer &segment = datagrams[sent + i + j];
+                    vecs[i + j].iov_base = segment.data;
+                    vecs[i + j].iov_len = size_t(segment.size);
+                }
+                msg.msg_iovlen = run;
+
+                const quint16 segmentSize = quint16(datagram.size);
+                msg.msg_control = &cbufs[messageCount];
+                struct cmsghdr *cmsgptr = reinterpret_cast<struct cmsghdr *>(
+                            reinterpret_cast<char *>(msg.msg_control) + msg.msg_controllen);
+                msg.msg_controllen += CMSG_SPACE(sizeof(segmentSize));
+                cmsgptr->cmsg_len = CMSG_LEN(sizeof(segmentSize));
+                cmsgptr->cmsg_level = SOL_UDP;
+                cmsgptr->cmsg_type = UDP_SEGMENT;
+                memcpy(CMSG_DATA(cmsgptr), &segmentSize, sizeof(segmentSize));
+
+                segments[messageCount] = run;
+                largestSegment = qMax(largestSegment, datagram.size);
+            }
+#endif
+            i += segments[messageCount];
+            ++messageCount;
+        }
+
+        int result = qt_safe_sendmmsg(socketDescriptor, messages, messageCount, 0);
+#ifdef QNATIVESOCKETENGINE_HAVE_UDP_SEGMENT
+        if (result < 0 && largestSegment && errno == EINVAL && largestSegment > 512) {
+            // the segments don't fit into a packet on the path, which can
+            // be smaller than assumed; send larger datagrams individually
+            udpMaxSegmentSize = largestSegment - 1;
+            continue;
+        }
+        if (result < 0 && largestSegment && (errno == EIO || errno == EINVAL
+                                             || errno == ENOPROTOOPT || errno == EOPNOTSUPP)) {
+            // the kernel or the interface cannot segment, e.g. without
+            // checksum offloading; send the datagrams individually from now on
+            udpSegmentationUnsupported = true;
+            continue;
+        }
+#else
+        Q_UNUSED(largestSegment);
+#endif
+        if (result < 0) {
+            // report errors with the next call if some datagrams were sent
+            if (sent)
+                break;
+            return qt_sendError(this);
+        }
+
+        for (int i = 0; i < result; ++i)
+            sent += segments[i];
+        if (result < messageCount)
+            break;
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeSendDatagrams(%p, %lli) == %lli",
+           datagrams, count, sent);
+#endif
+
+    return sent;
+}
+#endif // Q_OS_LINUX
+
 bool QNativeSocketEnginePrivate::fetchConnectionParameters()
 {
     localPort = 0;
@@ -1331,6 +1623,52 @@ qint64 QNativeSocketEnginePrivate::nativeWrite(const char *data, qint64 len)
 
     return qint64(writtenBytes);
 }
+#if defined(Q_OS_LINUX)
+/*
+    Sends up to \a len bytes of the file \a fd from \a offset with
+    sendfile(2). Returns -2 if the file cannot be sent this way (for
+    instance because it ended early, or because its file system does not
+    support it), so that the caller can read it instead.
+*/
+qint64 QNativeSocketEnginePrivate::nativeWriteFile(int fd, qint64 offset, qint64 len)
+{
+    Q_Q(QNativeSocketEngine);
+
+    // sendfile(2) is limited in the kernel to 2G - 4k
+    const qint64 SendfileSize = 0x7ffff000;
+
+    off_t fileOffset = offset;
+    qint64 writtenBytes = qt_safe_sendfile(socketDescriptor, fd, &fileOffset,
+                                           size_t(qMin(len, SendfileSize)));
+
+    if (writtenBytes < 0) {
+        switch (errno) {
+        case EPIPE:
+        case ECONNRESET:
+            writtenBytes = -1;
+            setError(QAbstractSocket::RemoteHostClosedError, RemoteHostClosedErrorString);
+            q->close();
+            break;
+        case EAGAIN:
+            writtenBytes = 0;
+            break;
+        default:
+            writtenBytes = -2;
+            break;
+        }
+    } else if (writtenBytes == 0 && len > 0) {
+        writtenBytes = -2;
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeWriteFile(%d, %lld, %lld) == %lld",
+           fd, offset, len, writtenBytes);
+#endif
+
+    return writtenBytes;
+}
+#endif
+
 /*
 */
 qint64 QNativeSocketEnginePrivate::nativeRead(char *data, qint64 maxSize)
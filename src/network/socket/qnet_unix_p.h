@@ -61,6 +61,9 @@
 #if defined(Q_OS_VXWORKS)
 #  include <sockLib.h>
 #endif
+#if defined(Q_OS_LINUX)
+#  include <sys/sendfile.h>
+#endif
 
 // for inet_addr
 #include <netdb.h>
@@ -192,6 +195,35 @@ static inline int qt_safe_recvmsg(int sockfd, struct msghdr *msg, int flags)
     return ret;
 }
 
+#if defined(Q_OS_LINUX)
+static inline int qt_safe_sendmmsg(int sockfd, struct mmsghdr *msgvec, unsigned int vlen, int flags)
+{
+    flags |= MSG_NOSIGNAL;
+
+    int ret;
+    EINTR_LOOP(ret, ::sendmmsg(sockfd, msgvec, vlen, flags));
+    return ret;
+}
+
+static inline int qt_safe_recvmmsg(int sockfd, struct mmsghdr *msgvec, unsigned int vlen, int flags)
+{
+    int ret;
+
+    EINTR_LOOP(ret, ::recvmmsg(sockfd, msgvec, vlen, flags, nullptr));
+    return ret;
+}
+
+static inline qint64 qt_safe_sendfile(int sockfd, int fd, off_t *offset, size_t count)
+{
+    // sendfile(2) has no MSG_NOSIGNAL equivalent
+    qt_ignore_sigpipe();
+
+    qint64 ret;
+    EINTR_LOOP(ret, ::sendfile(sockfd, fd, offset, count));
+    return ret;
+}
+#endif
+
 QT_END_NAMESPACE
 
 #endif // QNET_UNIX_P_H
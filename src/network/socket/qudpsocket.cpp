@@ -102,6 +102,7 @@
 #include "qnetworkdatagram.h"
 #include "qnetworkinterface.h"
 #include "qabstractsocket_p.h"
+#include "qvarlengtharray.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -125,6 +126,11 @@ public:
 
     inline bool ensureInitialized(const QHostAddress &remoteAddress)
     { return doEnsureInitialized(QHostAddress(), 0, remoteAddress); }
+
+    // receive buffer for receiveDatagrams(), kept between calls unless it
+    // is larger than MaxKeptDatagramBufferSize
+    QByteArray datagramBuffer;
+    static constexpr qsizetype MaxKeptDatagramBufferSize = 256 * 1024;
 };
 
 bool QUdpSocketPrivate::doEnsureInitialized(const QHostAddress &bindAddress, quint16 bindPort,
@@ -528,6 +534,150 @@ qint64 QUdpSocket::readDatagram(char *data, qint64 maxSize, QHostAddress *addres
     return readBytes;
 }
 
+/*!
+    \since 6.3
+
+    Receives up to \a maxCount pending datagrams, each one no larger than
+    \a maxSize bytes, and returns them along with their sender's host address
+    and port and, if possible, their destination address, port, and hop
+    count, like receiveDatagram() does.
+
+    The datagrams are read with as few system calls as the platform allows,
+    which makes this function much more efficient than calling
+    receiveDatagram() repeatedly when datagrams arrive at a high rate. It
+    returns fewer than \a maxCount datagrams if no more are pending, and an
+    empty list if an error occurred before any datagram could be read.
+
+    If \a maxSize is too small, the rest of a datagram will be lost. If \a
+    maxSize is -1 (the default), a datagram can have up to 65536 bytes; pass
+    the largest size you expect instead to avoid reserving that much memory
+    for every datagram. The memory reserved for small datagrams is reused by
+    the next call.
+
+    \sa writeDatagrams(), receiveDatagram(), hasPendingDatagrams()
+*/
+QList<QNetworkDatagram> QUdpSocket::receiveDatagrams(qsizetype maxCount, qint64 maxSize)
+{
+    Q_D(QUdpSocket);
+
+#if defined QUDPSOCKET_DEBUG
+    qDebug("QUdpSocket::receiveDatagrams(%lld, %lld)", qlonglong(maxCount), maxSize);
+#endif
+    QT_CHECK_BOUND("QUdpSocket::receiveDatagrams()", QList<QNetworkDatagram>());
+
+    // large enough for any UDP datagram
+    if (maxSize < 0)
+        maxSize = 65536;
+
+    // read in batches so that the buffer stays small
+    constexpr qsizetype BatchSize = 64;
+    QList<QNetworkDatagram> result;
+    QVarLengthArray<QDatagramBuffer, BatchSize> buffers;
+    QVarLengthArray<QIpPacketHeader, BatchSize> headers;
+    while (result.size() < maxCount) {
+        const qsizetype batch = qMin(maxCount - result.size(), BatchSize);
+        if (d->datagramBuffer.size() < batch * maxSize)
+            d->datagramBuffer.resize(batch * maxSize);
+        buffers.resize(batch);
+        headers.resize(batch);
+        for (qsizetype i = 0; i < batch; ++i) {
+            headers[i].clear();
+            buffers[i] = { d->datagramBuffer.data() + i * maxSize, maxSize, &headers[i] };
+        }
+
+        const qint64 received = d->socketEngine->readDatagrams(buffers.data(), batch,
+                                                               QAbstractSocketEngine::WantAll);
+        if (received < 0) {
+            if (result.isEmpty())
+                d->setErrorAndEmit(d->socketEngine->error(), d->socketEngine->errorString());
+            break;
+        }
+
+        result.reserve(result.size() + received);
+        for (qint64 i = 0; i < received; ++i) {
+            QNetworkDatagram datagram(QByteArray(buffers[i].data, buffers[i].size));
+            datagram.d->header = headers[i];
+            result.append(std::move(datagram));
+        }
+        if (received < batch)
+            break;
+    }
+    // don't keep the 4 MiB a batch of datagrams of the default maxSize needs
+    if (d->datagramBuffer.size() > QUdpSocketPrivate::MaxKeptDatagramBufferSize)
+        d->datagramBuffer = QByteArray();
+
+    d->hasPendingData = false;
+    d->socketEngine->setReadNotificationEnabled(true);
+    return result;
+}
+
+/*!
+    \since 6.3
+
+    Sends the \a datagrams to the host addresses and port numbers contained
+    in them, like writeDatagram() does for a single datagram, and returns the
+    number of datagrams sent, which can be fewer than the number passed if
+    the socket's send buffer fills up. Returns -1 if an error occurred before
+    any datagram could be sent.
+
+    The datagrams are sent with as few system calls as the platform allows.
+    On Linux, runs of equally sized datagrams to the same destination are
+    also passed to the network stack as one segmented message if the
+    kernel supports it. This is limited to datagrams that fit into a single
+    packet: the size is taken from the path MTU of connected sockets, and is
+    1452 bytes otherwise. If the network stack rejects a segment size, the
+    socket uses smaller ones from then on.
+
+    The network layer protocol of the socket is determined by the
+    destination of the first datagram if the socket is not bound yet.
+
+    \warning Calling this function on a connected UDP socket may
+    result in an error and no packet being sent, unless the datagrams
+    have no destination set.
+
+    \sa receiveDatagrams(), writeDatagram()
+*/
+qint64 QUdpSocket::writeDatagrams(const QList<QNetworkDatagram> &datagrams)
+{
+    Q_D(QUdpSocket);
+#if defined QUDPSOCKET_DEBUG
+    qDebug("QUdpSocket::writeDatagrams(%lld)", qlonglong(datagrams.size()));
+#endif
+    if (datagrams.isEmpty())
+        return 0;
+    if (!d->doEnsureInitialized(QHostAddress::Any, 0, datagrams.first().destinationAddress()))
+        return -1;
+    if (state() == UnconnectedState)
+        bind();
+
+    QVarLengthArray<QDatagramBuffer, 64> buffers(datagrams.size());
+    for (qsizetype i = 0; i < datagrams.size(); ++i) {
+        QNetworkDatagramPrivate *datagram = datagrams.at(i).d;
+        buffers[i] = { const_cast<char *>(datagram->data.constData()), datagram->data.size(),
+                       &datagram->header };
+    }
+
+    const qint64 sent = d->socketEngine->writeDatagrams(buffers.constData(), buffers.size());
+    d->cachedSocketDescriptor = d->socketEngine->socketDescriptor();
+
+    if (sent >= 0) {
+        qint64 bytes = 0;
+        for (qint64 i = 0; i < sent; ++i)
+            bytes += buffers[i].size;
+        if (sent)
+            emit bytesWritten(bytes);
+    } else {
+        if (sent == -2) {
+            // Socket engine reports EAGAIN. Treat as a temporary error.
+            d->setErrorAndEmit(QAbstractSocket::TemporaryError,
+                               tr("Unable to send a datagram"));
+            return -1;
+        }
+        d->setErrorAndEmit(d->socketEngine->error(), d->socketEngine->errorString());
+    }
+    return sent;
+}
+
 #endif // QT_NO_UDPSOCKET
 
 QT_END_NAMESPACE
@@ -89,6 +89,9 @@ public:
     inline qint64 writeDatagram(const QByteArray &datagram, const QHostAddress &host, quint16 port)
         { return writeDatagram(datagram.constData(), datagram.size(), host, port); }
 
+    QList<QNetworkDatagram> receiveDatagrams(qsizetype maxCount, qint64 maxSize = -1);
+    qint64 writeDatagrams(const QList<QNetworkDatagram> &datagrams);
+
 private:
     Q_DISABLE_COPY_MOVE(QUdpSocket)
     Q_DECLARE_PRIVATE(QUdpSocket)
@@ -2875,6 +2875,19 @@ bool QSslSocketPrivate::flush()
     return plainSocket && plainSocket->flush();
 }
 
+/*!
+    \internal
+
+    Unencrypted data goes straight to the plain socket, which can send
+    files without reading them; encrypted data has to be read.
+*/
+qint64 QSslSocketPrivate::writeFile(QFile *file, qint64 offset, qint64 length)
+{
+    if (mode == QSslSocket::UnencryptedMode && !autoStartHandshake)
+        return plainSocket->writeFile(file, offset, length);
+    return copyFile(file, offset, length);
+}
+
 /*!
     \internal
 */
@@ -181,6 +181,9 @@ protected:
     void virtual_hook(int id, void *data) override;
     void detachFromResultSet() override;
     bool nextResult() override;
+
+private:
+    int fetchRows(QList<QVariantList> &columns, int maxRows);
 };
 
 class QODBCResultPrivate: public QSqlResultPrivate
@@ -1868,8 +1871,30 @@ bool QODBCResult::nextResult()
     return true;
 }
 
+int QODBCResult::fetchRows(QList<QVariantList> &columns, int maxRows)
+{
+    Q_D(QODBCResult);
+    const int fieldCount = d->rInf.count();
+    int fetched = 0;
+    while (fetched < maxRows && QODBCResult::fetchNext()) {
+        // SQLGetData() has to be called in column order; this fills the
+        // whole field cache, which stays valid for the last row
+        if (fieldCount)
+            QODBCResult::data(fieldCount - 1);
+        for (int i = 0; i < fieldCount; ++i)
+            columns[i].append(d->fieldCache.at(i));
+        ++fetched;
+    }
+    return fetched;
+}
+
 void QODBCResult::virtual_hook(int id, void *data)
 {
+    if (id == QSqlResultPrivate::FetchRowsHook) {
+        auto fetchData = static_cast<QSqlResultPrivate::FetchRowsData *>(data);
+        fetchData->fetched = fetchRows(*fetchData->columns, fetchData->maxRows);
+        return;
+    }
     QSqlResult::virtual_hook(id, data);
 }
 
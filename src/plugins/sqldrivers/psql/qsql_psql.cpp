@@ -54,6 +54,9 @@
 #include <QtSql/private/qsqlresult_p.h>
 #include <QtSql/private/qsqldriver_p.h>
 #include <QtCore/private/qlocale_tools_p.h>
+#if QT_CONFIG(future)
+#include <QtCore/qpromise.h>
+#endif
 
 #include <queue>
 
@@ -119,6 +122,7 @@ class QPSQLResultPrivate;
 class QPSQLResult final : public QSqlResult
 {
     Q_DECLARE_PRIVATE(QPSQLResult)
+    friend class QPSQLDriverPrivate;
 
 public:
     QPSQLResult(const QPSQLDriver *db);
@@ -136,6 +140,8 @@ protected:
     bool nextResult() override;
     QVariant data(int i) override;
     bool isNull(int field) override;
+    QVariant value(int currentRow, int i);
+    int fetchRows(QList<QVariantList> &columns, int maxRows);
     bool reset(const QString &query) override;
     int size() override;
     int numRowsAffected() override;
@@ -145,6 +151,21 @@ protected:
     bool exec() override;
 };
 
+#if QT_CONFIG(future)
+struct QPSQLAsyncQuery
+{
+    QPromise<QSqlRecord> promise;
+    QByteArray statement;
+    QSqlRecord record; // the fields of the rows
+    QSqlError error;
+    QPSQLResult *result = nullptr; // receives the error, if still around
+    QSql::NumericalPrecisionPolicy precisionPolicy = QSql::LowPrecisionDouble;
+    bool sent = false;
+    bool singleRowModeSet = false;
+    bool resultsDone = false; // only the pipeline sync is left
+};
+#endif
+
 class QPSQLDriverPrivate final : public QSqlDriverPrivate
 {
     Q_DECLARE_PUBLIC(QPSQLDriver)
@@ -176,7 +197,26 @@ public:
     void setDatestyle();
     void setByteaOutput();
     void detectBackslashEscape();
+    bool ensureSocketNotifier();
+    bool hasAsyncQueries() const;
+    void waitForAsyncQueries();
     mutable QHash<int, QString> oidToTable;
+
+#if QT_CONFIG(future)
+    QFuture<QSqlRecord> sendAsyncQuery(QPSQLResult *result, const QString &stmt);
+    void sendPendingAsyncQueries();
+    void flushAsyncQueries();
+    void processAsyncResults(bool wait);
+    void addAsyncRows(QPSQLAsyncQuery *query, PGresult *result);
+    void finishAsyncQuery();
+    void failAsyncQueries(const QSqlError &error);
+
+    // in execution order, the first one is receiving results
+    QList<QPSQLAsyncQuery *> asyncQueries;
+    // enabled while libpq holds queries it couldn't send without blocking
+    QSocketNotifier *writeNotifier = nullptr;
+    bool pipelineMode = false;
+#endif
 };
 
 void QPSQLDriverPrivate::appendTables(QStringList &tl, QSqlQuery &t, QChar type)
@@ -200,6 +240,7 @@ void QPSQLDriverPrivate::appendTables(QStringList &tl, QSqlQuery &t, QChar type)
 
 PGresult *QPSQLDriverPrivate::exec(const char *stmt)
 {
+    waitForAsyncQueries();
     // PQexec() silently discards any prior query results that the application didn't eat.
     PGresult *result = PQexec(connection, stmt);
     currentStmtId = result ? generateStatementId() : InvalidStatementId;
@@ -214,6 +255,7 @@ PGresult *QPSQLDriverPrivate::exec(const QString &stmt)
 
 StatementId QPSQLDriverPrivate::sendQuery(const QString &stmt)
 {
+    waitForAsyncQueries();
     // Discard any prior query results that the application didn't eat.
     // This is required for PQsendQuery()
     discardResults();
@@ -300,6 +342,10 @@ public:
     int currentSize = -1;
     bool canFetchMoreRows = false;
     bool preparedQueriesEnabled = false;
+#if QT_CONFIG(future)
+    // set while QSqlQuery::execAsync() executes the query
+    QFuture<QSqlRecord> *asyncFuture = nullptr;
+#endif
 
     bool processResults();
 };
@@ -414,6 +460,14 @@ void QPSQLResultPrivate::deallocatePreparedStmt()
 {
     if (drv_d_func()) {
         const QString stmt = QStringLiteral("DEALLOCATE ") + preparedStmtId;
+#if QT_CONFIG(future)
+        if (drv_d_func()->hasAsyncQueries()) {
+            // don't wait, the statement is released after the queries using it
+            drv_d_func()->sendAsyncQuery(nullptr, stmt);
+            preparedStmtId.clear();
+            return;
+        }
+#endif
         PGresult *result = drv_d_func()->exec(stmt);
 
         if (PQresultStatus(result) != PGRES_COMMAND_OK)
@@ -434,6 +488,14 @@ QPSQLResult::~QPSQLResult()
 {
     Q_D(QPSQLResult);
     cleanup();
+#if QT_CONFIG(future)
+    if (d->drv_d_func()) {
+        for (QPSQLAsyncQuery *query : qAsConst(d->drv_d_func()->asyncQueries)) {
+            if (query->result == this)
+                query->result = nullptr;
+        }
+    }
+#endif
 
     if (d->preparedQueriesEnabled && !d->preparedStmtId.isNull())
         d->deallocatePreparedStmt();
@@ -630,17 +692,22 @@ QVariant QPSQLResult::data(int i)
         qWarning("QPSQLResult::data: column %d out of range", i);
         return QVariant();
     }
-    const int currentRow = isForwardOnly() ? 0 : at();
-    int ptype = PQftype(d->result, i);
+    return value(isForwardOnly() ? 0 : at(), i);
+}
+
+static QVariant qPSQLValue(const PGresult *result, int row, int column, bool isUtf8,
+                           QSql::NumericalPrecisionPolicy precisionPolicy)
+{
+    int ptype = PQftype(result, column);
     QMetaType type = qDecodePSQLType(ptype);
-    if (PQgetisnull(d->result, currentRow, i))
+    if (PQgetisnull(result, row, column))
         return QVariant(type, nullptr);
-    const char *val = PQgetvalue(d->result, currentRow, i);
+    const char *val = PQgetvalue(result, row, column);
     switch (type.id()) {
     case QMetaType::Bool:
         return QVariant((bool)(val[0] == 't'));
     case QMetaType::QString:
-        return d->drv_d_func()->isUtf8 ? QString::fromUtf8(val) : QString::fromLatin1(val);
+        return isUtf8 ? QString::fromUtf8(val) : QString::fromLatin1(val);
     case QMetaType::LongLong:
         if (val[0] == '-')
             return QByteArray::fromRawData(val, qstrlen(val)).toLongLong();
@@ -650,7 +717,7 @@ QVariant QPSQLResult::data(int i)
         return atoi(val);
     case QMetaType::Double: {
         if (ptype == QNUMERICOID) {
-            if (numericalPrecisionPolicy() == QSql::HighPrecision)
+            if (precisionPolicy == QSql::HighPrecision)
                 return QString::fromLatin1(val);
         }
         bool ok;
@@ -666,11 +733,11 @@ QVariant QPSQLResult::data(int i)
                 return QVariant();
         }
         if (ptype == QNUMERICOID) {
-            if (numericalPrecisionPolicy() == QSql::LowPrecisionInt64)
+            if (precisionPolicy == QSql::LowPrecisionInt64)
                 return QVariant((qlonglong)dbl);
-            else if (numericalPrecisionPolicy() == QSql::LowPrecisionInt32)
+            else if (precisionPolicy == QSql::LowPrecisionInt32)
                 return QVariant((int)dbl);
-            else if (numericalPrecisionPolicy() == QSql::LowPrecisionDouble)
+            else if (precisionPolicy == QSql::LowPrecisionDouble)
                 return QVariant(dbl);
         }
         return dbl;
@@ -707,6 +774,13 @@ QVariant QPSQLResult::data(int i)
     return QVariant();
 }
 
+QVariant QPSQLResult::value(int currentRow, int i)
+{
+    Q_D(const QPSQLResult);
+    return qPSQLValue(d->result, currentRow, i, d->drv_d_func()->isUtf8,
+                      numericalPrecisionPolicy());
+}
+
 bool QPSQLResult::isNull(int field)
 {
     Q_D(const QPSQLResult);
@@ -714,6 +788,263 @@ bool QPSQLResult::isNull(int field)
     return PQgetisnull(d->result, currentRow, field);
 }
 
+bool QPSQLDriverPrivate::ensureSocketNotifier()
+{
+    Q_Q(QPSQLDriver);
+    if (sn)
+        return true;
+    const int socket = PQsocket(connection);
+    if (socket < 0)
+        return false;
+    sn = new QSocketNotifier(socket, QSocketNotifier::Read, q);
+    QObject::connect(sn, SIGNAL(activated(QSocketDescriptor)), q, SLOT(_q_handleNotification()));
+    return true;
+}
+
+bool QPSQLDriverPrivate::hasAsyncQueries() const
+{
+#if QT_CONFIG(future)
+    return !asyncQueries.isEmpty();
+#else
+    return false;
+#endif
+}
+
+void QPSQLDriverPrivate::waitForAsyncQueries()
+{
+#if QT_CONFIG(future)
+    // synchronous queries can only be sent once the connection is idle
+    if (!asyncQueries.isEmpty()) {
+        if (writeNotifier)
+            writeNotifier->setEnabled(false);
+        // PQgetResult() sends what's left of the queries while waiting
+        PQsetnonblocking(connection, 0);
+        processAsyncResults(true);
+    }
+#endif
+}
+
+#if QT_CONFIG(future)
+QFuture<QSqlRecord> QPSQLDriverPrivate::sendAsyncQuery(QPSQLResult *result, const QString &stmt)
+{
+    // Like sendQuery(), this discards what's left of a forward-only query.
+    // The event loop must not block while libpq sends the queries, so they
+    // are sent in non-blocking mode and flushed when the socket is writable.
+    if (asyncQueries.isEmpty()) {
+        discardResults();
+        PQsetnonblocking(connection, 1);
+    }
+    currentStmtId = InvalidStatementId;
+
+    auto query = new QPSQLAsyncQuery;
+    query->statement = isUtf8 ? stmt.toUtf8() : stmt.toLocal8Bit();
+    query->result = result;
+    if (result)
+        query->precisionPolicy = result->numericalPrecisionPolicy();
+    query->promise.start();
+    QFuture<QSqlRecord> future = query->promise.future();
+    asyncQueries.append(query);
+    ensureSocketNotifier();
+    sendPendingAsyncQueries();
+    return future;
+}
+
+void QPSQLDriverPrivate::sendPendingAsyncQueries()
+{
+    for (qsizetype i = 0; i < asyncQueries.size(); ++i) {
+        QPSQLAsyncQuery *query = asyncQueries.at(i);
+        if (query->sent)
+            continue;
+        // Without pipelining, a query can only be sent once the results of
+        // the previous one have been received.
+        const bool idle = i == 0;
+#ifdef LIBPQ_HAS_PIPELINING
+        if (!pipelineMode && idle)
+            pipelineMode = PQenterPipelineMode(connection) == 1;
+        if (!pipelineMode && !idle)
+            break;
+#else
+        if (!idle)
+            break;
+#endif
+        // PQsendQuery() isn't allowed in pipeline mode, so always use the
+        // extended query protocol, which executes a single statement
+        int sent = PQsendQueryParams(connection, query->statement.constData(), 0,
+                                     nullptr, nullptr, nullptr, nullptr, 0);
+#ifdef LIBPQ_HAS_PIPELINING
+        // a sync after each query, so that a failing query doesn't abort
+        // the ones pipelined after it
+        if (sent && pipelineMode)
+            sent = PQpipelineSync(connection);
+#endif
+        query->sent = true;
+        if (!sent) {
+            const QSqlError error = qMakeError(QCoreApplication::translate("QPSQLResult",
+                                               "Unable to send query"), QSqlError::StatementError, this);
+            if (!idle) {
+                failAsyncQueries(error);
+                return;
+            }
+            query->error = error;
+            finishAsyncQuery(); // sends the next query
+            return;
+        }
+        if (idle)
+            query->singleRowModeSet = setSingleRowMode();
+    }
+    if (!asyncQueries.isEmpty())
+        flushAsyncQueries();
+}
+
+void QPSQLDriverPrivate::flushAsyncQueries()
+{
+    Q_Q(QPSQLDriver);
+    const int flushed = PQflush(connection);
+    if (flushed < 0) {
+        failAsyncQueries(qMakeError(QCoreApplication::translate("QPSQLResult",
+                                    "Unable to send query"), QSqlError::ConnectionError, this));
+        return;
+    }
+    if (flushed > 0 && !writeNotifier) {
+        writeNotifier = new QSocketNotifier(PQsocket(connection), QSocketNotifier::Write, q);
+        QObject::connect(writeNotifier, &QSocketNotifier::activated, q,
+                         [this] { flushAsyncQueries(); });
+    }
+    if (writeNotifier)
+        writeNotifier->setEnabled(flushed > 0);
+}
+
+void QPSQLDriverPrivate::processAsyncResults(bool wait)
+{
+    // PQgetResult() reads from the connection as needed when waiting
+    if (!wait) {
+        if (!PQconsumeInput(connection)) {
+            failAsyncQueries(qMakeError(QCoreApplication::translate("QPSQLResult",
+                                        "Unable to get result"), QSqlError::ConnectionError, this));
+            return;
+        }
+        // the server may have been waiting for us to read before accepting
+        // more of the queries
+        if (writeNotifier && writeNotifier->isEnabled())
+            flushAsyncQueries();
+    }
+
+    while (!asyncQueries.isEmpty()) {
+        QPSQLAsyncQuery *query = asyncQueries.constFirst();
+        if (!query->singleRowModeSet && !query->resultsDone) {
+            // in pipeline mode, only possible once the query is the current one
+            setSingleRowMode();
+            query->singleRowModeSet = true;
+        }
+        if (!wait && PQisBusy(connection))
+            return;
+
+        PGresult *result = PQgetResult(connection);
+        if (!result) {
+            if (!pipelineMode) {
+                finishAsyncQuery();
+            } else if (!query->resultsDone) {
+                query->resultsDone = true;
+            } else {
+                // the pipeline sync never arrives on a broken connection
+                failAsyncQueries(qMakeError(QCoreApplication::translate("QPSQLResult",
+                                            "Unable to get result"), QSqlError::ConnectionError, this));
+            }
+            continue;
+        }
+
+        switch (PQresultStatus(result)) {
+        case PGRES_SINGLE_TUPLE:
+        case PGRES_TUPLES_OK:
+            addAsyncRows(query, result);
+            break;
+        case PGRES_COMMAND_OK:
+            break;
+#ifdef LIBPQ_HAS_PIPELINING
+        case PGRES_PIPELINE_SYNC:
+            PQclear(result);
+            finishAsyncQuery();
+            continue;
+#endif
+        default:
+            if (!query->error.isValid()) {
+                query->error = qMakeError(QCoreApplication::translate("QPSQLResult",
+                                          "Unable to create query"), QSqlError::StatementError, this, result);
+            }
+            break;
+        }
+        PQclear(result);
+    }
+    checkPendingNotifications();
+}
+
+void QPSQLDriverPrivate::addAsyncRows(QPSQLAsyncQuery *query, PGresult *result)
+{
+    const int fieldCount = PQnfields(result);
+    if (query->record.isEmpty()) {
+        for (int i = 0; i < fieldCount; ++i) {
+            const char *name = PQfname(result, i);
+            query->record.append(QSqlField(isUtf8 ? QString::fromUtf8(name) : QString::fromLocal8Bit(name),
+                                           qDecodePSQLType(PQftype(result, i))));
+        }
+    }
+    if (query->promise.isCanceled())
+        return;
+
+    const int rowCount = PQntuples(result);
+    for (int row = 0; row < rowCount; ++row) {
+        QSqlRecord record = query->record;
+        for (int i = 0; i < fieldCount; ++i)
+            record.setValue(i, qPSQLValue(result, row, i, isUtf8, query->precisionPolicy));
+        query->promise.addResult(std::move(record));
+    }
+}
+
+void QPSQLDriverPrivate::finishAsyncQuery()
+{
+    QPSQLAsyncQuery *query = asyncQueries.takeFirst();
+    if (query->error.isValid()) {
+        if (query->result)
+            query->result->setLastError(query->error);
+        query->promise.future().cancel();
+    }
+    query->promise.finish();
+    delete query;
+    if (asyncQueries.isEmpty()) {
+#ifdef LIBPQ_HAS_PIPELINING
+        if (pipelineMode) {
+            PQexitPipelineMode(connection);
+            pipelineMode = false;
+        }
+#endif
+        // everything has been sent once all results have been received
+        if (writeNotifier)
+            writeNotifier->setEnabled(false);
+        PQsetnonblocking(connection, 0);
+    }
+    sendPendingAsyncQueries();
+}
+
+void QPSQLDriverPrivate::failAsyncQueries(const QSqlError &error)
+{
+    for (QPSQLAsyncQuery *query : qAsConst(asyncQueries)) {
+        if (!query->error.isValid())
+            query->error = error;
+        // nothing is going to be received anymore
+        query->sent = true;
+        query->resultsDone = true;
+    }
+#ifdef LIBPQ_HAS_PIPELINING
+    if (pipelineMode) {
+        PQexitPipelineMode(connection);
+        pipelineMode = false;
+    }
+#endif
+    while (!asyncQueries.isEmpty())
+        finishAsyncQuery();
+}
+#endif // QT_CONFIG(future)
+
 bool QPSQLResult::reset(const QString &query)
 {
     Q_D(QPSQLResult);
@@ -723,6 +1054,13 @@ bool QPSQLResult::reset(const QString &query)
     if (!driver()->isOpen() || driver()->isOpenError())
         return false;
 
+#if QT_CONFIG(future)
+    if (d->asyncFuture) {
+        *d->asyncFuture = d->drv_d_func()->sendAsyncQuery(this, query);
+        return true;
+    }
+#endif
+
     d->stmtId = d->drv_d_func()->sendQuery(query);
     if (d->stmtId == InvalidStatementId) {
         setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
@@ -841,9 +1179,61 @@ QSqlRecord QPSQLResult::record() const
     return info;
 }
 
+int QPSQLResult::fetchRows(QList<QVariantList> &columns, int maxRows)
+{
+    Q_D(const QPSQLResult);
+    const int fieldCount = PQnfields(d->result);
+    int fetched = 0;
+
+    if (isForwardOnly()) {
+        // in single-row mode every row arrives in a result of its own
+        while (fetched < maxRows && QPSQLResult::fetchNext()) {
+            for (int i = 0; i < fieldCount; ++i)
+                columns[i].append(value(0, i));
+            ++fetched;
+        }
+        return fetched;
+    }
+
+    const int first = at() + 1;
+    fetched = qBound(0, d->currentSize - first, maxRows);
+    for (int row = first; row < first + fetched; ++row) {
+        for (int i = 0; i < fieldCount; ++i)
+            columns[i].append(value(row, i));
+    }
+    if (fetched)
+        setAt(first + fetched - 1);
+    return fetched;
+}
+
 void QPSQLResult::virtual_hook(int id, void *data)
 {
     Q_ASSERT(data);
+    if (id == QSqlResultPrivate::FetchRowsHook) {
+        auto fetchData = static_cast<QSqlResultPrivate::FetchRowsData *>(data);
+        fetchData->fetched = fetchRows(*fetchData->columns, fetchData->maxRows);
+        return;
+    }
+#if QT_CONFIG(future)
+    if (id == QSqlResultPrivate::ExecAsyncHook) {
+        Q_D(QPSQLResult);
+        auto execData = static_cast<QSqlResultPrivate::ExecAsyncData *>(data);
+        // reset() and exec() hand the statement to the driver instead of
+        // executing it
+        d->asyncFuture = &execData->future;
+        const bool sent = d->preparedQueriesEnabled ? exec() : QSqlResult::exec();
+        d->asyncFuture = nullptr;
+        if (!sent) {
+            QPromise<QSqlRecord> promise;
+            promise.start();
+            promise.future().cancel();
+            promise.finish();
+            execData->future = promise.future();
+        }
+        execData->handled = true;
+        return;
+    }
+#endif
     QSqlResult::virtual_hook(id, data);
 }
 
@@ -888,6 +1278,16 @@ bool QPSQLResult::prepare(const QString &query)
     const QString stmtId = qMakePreparedStmtId();
     const QString stmt = QStringLiteral("PREPARE %1 AS ").arg(stmtId).append(d->positionalToNamedBinding(query));
 
+#if QT_CONFIG(future)
+    if (d->drv_d_func()->hasAsyncQueries()) {
+        // don't wait, the statement is prepared after the running queries;
+        // errors are reported when it is executed
+        d->drv_d_func()->sendAsyncQuery(this, stmt);
+        d->preparedStmtId = stmtId;
+        return true;
+    }
+#endif
+
     PGresult *result = d->drv_d_func()->exec(stmt);
 
     if (PQresultStatus(result) != PGRES_COMMAND_OK) {
@@ -918,6 +1318,13 @@ bool QPSQLResult::exec()
     else
         stmt = QStringLiteral("EXECUTE %1 (%2)").arg(d->preparedStmtId, params);
 
+#if QT_CONFIG(future)
+    if (d->asyncFuture) {
+        *d->asyncFuture = d->drv_d_func()->sendAsyncQuery(this, stmt);
+        return true;
+    }
+#endif
+
     d->stmtId = d->drv_d_func()->sendQuery(stmt);
     if (d->stmtId == InvalidStatementId) {
         setLastError(qMakeError(QCoreApplication::translate("QPSQLResult",
@@ -1138,8 +1545,10 @@ QPSQLDriver::QPSQLDriver(PGconn *conn, QObject *parent)
 QPSQLDriver::~QPSQLDriver()
 {
     Q_D(QPSQLDriver);
-    if (d->connection)
+    if (d->connection) {
+        d->waitForAsyncQueries();
         PQfinish(d->connection);
+    }
 }
 
 QVariant QPSQLDriver::handle() const
@@ -1241,12 +1650,18 @@ void QPSQLDriver::close()
 {
     Q_D(QPSQLDriver);
 
+    if (d->connection)
+        d->waitForAsyncQueries();
     d->seid.clear();
     if (d->sn) {
         disconnect(d->sn, SIGNAL(activated(QSocketDescriptor)), this, SLOT(_q_handleNotification()));
         delete d->sn;
         d->sn = nullptr;
     }
+#if QT_CONFIG(future)
+    delete d->writeNotifier;
+    d->writeNotifier = nullptr;
+#endif
 
     if (d->connection)
         PQfinish(d->connection);
@@ -1596,10 +2011,7 @@ bool QPSQLDriver::subscribeToNotification(const QString &name)
         }
         PQclear(result);
 
-        if (!d->sn) {
-            d->sn = new QSocketNotifier(socket, QSocketNotifier::Read);
-            connect(d->sn, SIGNAL(activated(QSocketDescriptor)), this, SLOT(_q_handleNotification()));
-        }
+        d->ensureSocketNotifier();
     } else {
         qWarning("QPSQLDriver::subscribeToNotificationImplementation: PQsocket didn't return a valid socket to listen on");
         return false;
@@ -1633,7 +2045,7 @@ bool QPSQLDriver::unsubscribeFromNotification(const QString &name)
 
     d->seid.removeAll(name);
 
-    if (d->seid.isEmpty()) {
+    if (d->seid.isEmpty() && !d->hasAsyncQueries()) {
         disconnect(d->sn, SIGNAL(activated(QSocketDescriptor)), this, SLOT(_q_handleNotification()));
         delete d->sn;
         d->sn = nullptr;
@@ -1652,6 +2064,10 @@ void QPSQLDriver::_q_handleNotification()
 {
     Q_D(QPSQLDriver);
     d->pendingNotifyCheck = false;
+#if QT_CONFIG(future)
+    if (!d->asyncQueries.isEmpty())
+        d->processAsyncResults(false);
+#endif
     PQconsumeInput(d->connection);
 
     PGnotify *notify = nullptr;
@@ -144,6 +144,15 @@ protected:
     void virtual_hook(int id, void *data) override;
 };
 
+class QSQLiteCachedStatement : public QSqlCachedStatement
+{
+public:
+    explicit QSQLiteCachedStatement(sqlite3_stmt *stmt) : stmt(stmt) {}
+    ~QSQLiteCachedStatement() { sqlite3_finalize(stmt); }
+
+    sqlite3_stmt *stmt;
+};
+
 class QSQLiteDriverPrivate : public QSqlDriverPrivate
 {
     Q_DECLARE_PUBLIC(QSQLiteDriver)
@@ -165,11 +174,13 @@ public:
     using QSqlCachedResultPrivate::QSqlCachedResultPrivate;
     void cleanup();
     bool fetchNext(QSqlCachedResult::ValueCache &values, int idx, bool initialFetch);
+    int fetchRows(QList<QVariantList> &columns, int maxRows);
     // initializes the recordInfo and the cache
     void initColumns(bool emptyResultset);
     void finalize();
 
     sqlite3_stmt *stmt = nullptr;
+    QString cacheKey; // the query stmt is returned to the statement cache for
     QSqlRecord rInf;
     QList<QVariant> firstRow;
     bool skippedStatus = false; // the status of the fetchNext() that's skipped
@@ -193,8 +204,43 @@ void QSQLiteResultPrivate::finalize()
     if (!stmt)
         return;
 
-    sqlite3_finalize(stmt);
+    QSQLiteDriverPrivate *drv = const_cast<QSQLiteDriverPrivate *>(drv_d_func());
+    if (drv && drv->access && !cacheKey.isNull()) {
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+        drv->cacheStatement(cacheKey, new QSQLiteCachedStatement(stmt));
+    } else {
+        sqlite3_finalize(stmt);
+    }
     stmt = 0;
+    cacheKey.clear();
+}
+
+int QSQLiteResultPrivate::fetchRows(QList<QVariantList> &columns, int maxRows)
+{
+    Q_Q(QSQLiteResult);
+    if (atEnd || rInf.isEmpty())
+        return 0;
+
+    const int start = q->at();
+    int fetched = 0;
+    while (fetched < maxRows) {
+        if (!fetchNext(cache, 0, false)) {
+            atEnd = true;
+            break;
+        }
+        for (int i = 0; i < colCount; ++i)
+            columns[i].append(std::move(cache[i]));
+        ++fetched;
+    }
+
+    if (fetched) {
+        // stay on the last row, like QSqlCachedResult::fetchNext() would
+        q->setAt(start + fetched);
+        for (int i = 0; i < colCount; ++i)
+            cache[i] = columns.at(i).constLast();
+    }
+    return fetched;
 }
 
 void QSQLiteResultPrivate::initColumns(bool emptyResultset)
@@ -367,6 +413,13 @@ QSQLiteResult::~QSQLiteResult()
 
 void QSQLiteResult::virtual_hook(int id, void *data)
 {
+    Q_D(QSQLiteResult);
+    if (id == QSqlResultPrivate::FetchRowsHook && isForwardOnly()) {
+        // scrollable results go through the cache instead
+        auto fetchData = static_cast<QSqlResultPrivate::FetchRowsData *>(data);
+        fetchData->fetched = d->fetchRows(*fetchData->columns, fetchData->maxRows);
+        return;
+    }
     QSqlCachedResult::virtual_hook(id, data);
 }
 
@@ -387,6 +440,14 @@ bool QSQLiteResult::prepare(const QString &query)
 
     setSelect(false);
 
+    QSQLiteDriverPrivate *drv = const_cast<QSQLiteDriverPrivate *>(d->drv_d_func());
+    if (QSqlCachedStatement *cached = drv->takeCachedStatement(query)) {
+        d->stmt = std::exchange(static_cast<QSQLiteCachedStatement *>(cached)->stmt, nullptr);
+        d->cacheKey = query;
+        delete cached;
+        return true;
+    }
+
     const void *pzTail = nullptr;
     const auto size = int((query.size() + 1) * sizeof(QChar));
 
@@ -409,6 +470,8 @@ bool QSQLiteResult::prepare(const QString &query)
         d->finalize();
         return false;
     }
+    if (drv->statementCache.maxCost() > 0)
+        d->cacheKey = query;
     return true;
 }
 
@@ -814,6 +877,7 @@ void QSQLiteDriver::close()
     if (isOpen()) {
         for (QSQLiteResult *result : qAsConst(d->results))
             result->d_func()->finalize();
+        d->statementCache.clear();
 
         if (d->access && (d->notificationid.count() > 0)) {
             d->notificationid.clear();
@@ -51,6 +51,8 @@
 #include <QSqlQuery>
 #include <QSqlDriver>
 #include <QDebug>
+#include <QFutureWatcher>
+#include <QSqlRecord>
 
 void selectEmployees()
 {
@@ -80,3 +82,39 @@ if (!q.execBatch())
     qDebug() << q.lastError();
 //! [2]
 }
+
+void exportEmployees()
+{
+//! [4]
+QSqlQuery q;
+q.setForwardOnly(true);
+q.exec("select id, name from employees");
+
+QList<QVariantList> columns;
+while (q.fetchRows(&columns, 1000) > 0) {
+    const QVariantList &ids = columns.at(0);
+    const QVariantList &names = columns.at(1);
+    for (qsizetype i = 0; i < ids.size(); ++i)
+        qDebug() << ids.at(i).toInt() << names.at(i).toString();
+}
+//! [4]
+}
+
+void selectEmployeesAsync(QObject *context)
+{
+//! [5]
+QSqlQuery query;
+query.prepare("SELECT id, name FROM employees WHERE salary > ?");
+query.addBindValue(50000);
+
+auto watcher = new QFutureWatcher<QSqlRecord>(context);
+QObject::connect(watcher, &QFutureWatcher<QSqlRecord>::resultsReadyAt, watcher,
+                 [watcher](int begin, int end) {
+    for (int i = begin; i < end; ++i)
+        qDebug() << watcher->resultAt(i).value("name").toString();
+});
+QObject::connect(watcher, &QFutureWatcher<QSqlRecord>::finished,
+                 watcher, &QObject::deleteLater);
+watcher->setFuture(query.execAsync());
+//! [5]
+}
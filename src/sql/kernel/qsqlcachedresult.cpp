@@ -55,16 +55,184 @@ QT_BEGIN_NAMESPACE
    will give you an index where you can start filling in your data. Special
    case: If the user actually wants a forward-only query, idx will be -1
    to indicate that we are not interested in the actual values.
+
+   The driver always fills in a single row; unless the query is forward-only,
+   each fetched row is then moved into per-column storage (QSqlCachedColumn).
 */
 
-static const uint initial_cache_size = 128;
+QSqlCachedColumn::Storage QSqlCachedColumn::storageFor(QMetaType type)
+{
+    switch (type.id()) {
+    case QMetaType::Bool:
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::LongLong:
+    case QMetaType::ULongLong:
+        return Integer;
+    case QMetaType::Double:
+        return Real;
+    case QMetaType::QString:
+        return String;
+    default:
+        return Variants;
+    }
+}
+
+void QSqlCachedColumn::setStorage(Storage newStorage)
+{
+    if (newStorage == Variants) {
+        variants.reserve(count + 1);
+        for (qsizetype row = 0; row < count; ++row)
+            variants.append(value(row));
+        integers = {};
+        reals = {};
+        strings = {};
+    } else {
+        // rows so far were all null
+        Q_ASSERT(storage == Untyped);
+        switch (newStorage) {
+        case Integer:
+            integers.resize(count);
+            break;
+        case Real:
+            reals.resize(count);
+            break;
+        case String:
+            strings.resize(count);
+            break;
+        default:
+            Q_UNREACHABLE();
+        }
+    }
+    storage = newStorage;
+}
+
+void QSqlCachedColumn::appendNull()
+{
+    switch (storage) {
+    case Integer:
+        integers.append(0);
+        break;
+    case Real:
+        reals.append(0);
+        break;
+    case String:
+        strings.append(QString());
+        break;
+    default:
+        break;
+    }
+    nulls[count / 64] |= Q_UINT64_C(1) << (count % 64);
+}
+
+void QSqlCachedColumn::appendValue(const QVariant &value)
+{
+    switch (storage) {
+    case Integer:
+        if (type.id() == QMetaType::ULongLong)
+            integers.append(qint64(value.toULongLong()));
+        else
+            integers.append(value.toLongLong());
+        break;
+    case Real:
+        reals.append(value.toDouble());
+        break;
+    case String:
+        // shares the driver's string; reading it back does not copy either
+        strings.append(*static_cast<const QString *>(value.constData()));
+        break;
+    default:
+        Q_UNREACHABLE();
+    }
+}
+
+void QSqlCachedColumn::append(const QVariant &value)
+{
+    if (count % 64 == 0)
+        nulls.append(0);
+
+    const QMetaType valueType = value.metaType();
+    if (storage != Variants) {
+        if (value.isNull()) {
+            if (!nullType.isValid())
+                nullType = valueType;
+            if (valueType == nullType) {
+                appendNull();
+                ++count;
+                return;
+            }
+        } else {
+            if (storage == Untyped) {
+                type = valueType;
+                setStorage(storageFor(type));
+            }
+            if (valueType == type && storage != Variants) {
+                appendValue(value);
+                ++count;
+                return;
+            }
+        }
+        if (storage != Variants)
+            setStorage(Variants);
+    }
+    variants.append(value);
+    ++count;
+}
+
+QVariant QSqlCachedColumn::value(qsizetype row) const
+{
+    Q_ASSERT(row >= 0 && row < count);
+    if (storage == Variants)
+        return variants.at(row);
+    if (nulls.at(row / 64) & (Q_UINT64_C(1) << (row % 64)))
+        return QVariant(nullType);
+
+    switch (storage) {
+    case Integer: {
+        const qint64 v = integers.at(row);
+        switch (type.id()) {
+        case QMetaType::Bool:
+            return QVariant(v != 0);
+        case QMetaType::Int:
+            return QVariant(int(v));
+        case QMetaType::UInt:
+            return QVariant(uint(v));
+        case QMetaType::ULongLong:
+            return QVariant(qulonglong(v));
+        default:
+            return QVariant(qlonglong(v));
+        }
+    }
+    case Real:
+        return QVariant(reals.at(row));
+    case String:
+        return strings.at(row);
+    default:
+        Q_UNREACHABLE();
+        return QVariant();
+    }
+}
+
+bool QSqlCachedColumn::isNull(qsizetype row) const
+{
+    Q_ASSERT(row >= 0 && row < count);
+    if (storage == Variants)
+        return variants.at(row).isNull();
+    return nulls.at(row / 64) & (Q_UINT64_C(1) << (row % 64));
+}
+
+void QSqlCachedColumn::clear()
+{
+    *this = QSqlCachedColumn();
+}
 
 void QSqlCachedResultPrivate::cleanup()
 {
     cache.clear();
+    columns.clear();
     atEnd = false;
     colCount = 0;
-    rowCacheEnd = 0;
+    rowCount = 0;
 }
 
 void QSqlCachedResultPrivate::init(int count, bool fo)
@@ -73,45 +241,32 @@ void QSqlCachedResultPrivate::init(int count, bool fo)
     cleanup();
     forwardOnly = fo;
     colCount = count;
-    if (fo) {
-        cache.resize(count);
-        rowCacheEnd = count;
-    } else {
-        cache.resize(initial_cache_size * count);
-    }
+    cache.resize(count);
+    if (!fo)
+        columns.resize(count);
 }
 
-int QSqlCachedResultPrivate::nextIndex()
+void QSqlCachedResultPrivate::appendRow()
 {
-    if (forwardOnly)
-        return 0;
-    int newIdx = rowCacheEnd;
-    if (newIdx + colCount > cache.size())
-        cache.resize(qMin(cache.size() * 2, cache.size() + 10000));
-    rowCacheEnd += colCount;
-
-    return newIdx;
+    if (columns.size() != colCount)
+        columns.resize(colCount);
+    for (int i = 0; i < colCount; ++i)
+        columns[i].append(cache.at(i));
+    ++rowCount;
 }
 
 bool QSqlCachedResultPrivate::canSeek(int i) const
 {
     if (forwardOnly || i < 0)
         return false;
-    return rowCacheEnd >= (i + 1) * colCount;
-}
-
-void QSqlCachedResultPrivate::revertLast()
-{
-    if (forwardOnly)
-        return;
-    rowCacheEnd -= colCount;
+    return i < rowCount;
 }
 
 inline int QSqlCachedResultPrivate::cacheCount() const
 {
     Q_ASSERT(!forwardOnly);
     Q_ASSERT(colCount);
-    return rowCacheEnd / colCount;
+    return rowCount;
 }
 
 //////////////
@@ -152,7 +307,7 @@ bool QSqlCachedResult::fetch(int i)
         setAt(i);
         return true;
     }
-    if (d->rowCacheEnd > 0)
+    if (d->rowCount > 0)
         setAt(d->cacheCount());
     while (at() < i + 1) {
         if (!cacheNext()) {
@@ -218,21 +373,27 @@ bool QSqlCachedResult::fetchLast()
 QVariant QSqlCachedResult::data(int i)
 {
     Q_D(const QSqlCachedResult);
-    int idx = d->forwardOnly ? i : at() * d->colCount + i;
-    if (i >= d->colCount || i < 0 || at() < 0 || idx >= d->rowCacheEnd)
+    if (i >= d->colCount || i < 0 || at() < 0)
+        return QVariant();
+    if (d->forwardOnly)
+        return d->cache.at(i);
+    if (at() >= d->rowCount)
         return QVariant();
 
-    return d->cache.at(idx);
+    return d->columns.at(i).value(at());
 }
 
 bool QSqlCachedResult::isNull(int i)
 {
     Q_D(const QSqlCachedResult);
-    int idx = d->forwardOnly ? i : at() * d->colCount + i;
-    if (i >= d->colCount || i < 0 || at() < 0 || idx >= d->rowCacheEnd)
+    if (i >= d->colCount || i < 0 || at() < 0)
+        return true;
+    if (d->forwardOnly)
+        return d->cache.at(i).isNull();
+    if (at() >= d->rowCount)
         return true;
 
-    return d->cache.at(idx).isNull();
+    return d->columns.at(i).isNull(at());
 }
 
 void QSqlCachedResult::cleanup()
@@ -247,7 +408,9 @@ void QSqlCachedResult::clearValues()
 {
     Q_D(QSqlCachedResult);
     setAt(QSql::BeforeFirstRow);
-    d->rowCacheEnd = 0;
+    for (QSqlCachedColumn &column : d->columns)
+        column.clear();
+    d->rowCount = 0;
     d->atEnd = false;
 }
 
@@ -257,15 +420,14 @@ bool QSqlCachedResult::cacheNext()
     if (d->atEnd)
         return false;
 
-    if (isForwardOnly()) {
-        d->cache.resize(d->colCount);
-    }
+    d->cache.resize(d->colCount);
 
-    if (!gotoNext(d->cache, d->nextIndex())) {
-        d->revertLast();
+    if (!gotoNext(d->cache, 0)) {
         d->atEnd = true;
         return false;
     }
+    if (!d->forwardOnly)
+        d->appendRow();
     setAt(at() + 1);
     return true;
 }
@@ -54,12 +54,12 @@
 #include <QtSql/private/qtsqlglobal_p.h>
 #include "QtSql/qsqlresult.h"
 #include "QtSql/private/qsqlresult_p.h"
-#include <QtCore/qcontainerfwd.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qmetatype.h>
+#include <QtCore/qvariant.h>
 
 QT_BEGIN_NAMESPACE
 
-class QVariant;
-
 class QSqlCachedResultPrivate;
 
 class Q_SQL_EXPORT QSqlCachedResult: public QSqlResult
@@ -96,6 +96,43 @@ private:
     bool cacheNext();
 };
 
+// Stores the values of one result column. Integers and doubles are kept in
+// contiguous arrays and strings in a list of (implicitly shared) QStrings,
+// with a bitmap for the null values; columns holding values of any other
+// type, or of mixed types, fall back to QVariant.
+class Q_SQL_EXPORT QSqlCachedColumn
+{
+public:
+    void append(const QVariant &value);
+    QVariant value(qsizetype row) const;
+    bool isNull(qsizetype row) const;
+    void clear();
+
+private:
+    enum Storage : quint8 {
+        Untyped,
+        Integer,
+        Real,
+        String,
+        Variants
+    };
+
+    static Storage storageFor(QMetaType type);
+    void setStorage(Storage newStorage);
+    void appendNull();
+    void appendValue(const QVariant &value);
+
+    QList<quint64> nulls;
+    QList<qint64> integers;
+    QList<double> reals;
+    QList<QString> strings;
+    QList<QVariant> variants;
+    QMetaType type;
+    QMetaType nullType;
+    qsizetype count = 0;
+    Storage storage = Untyped;
+};
+
 class Q_SQL_EXPORT QSqlCachedResultPrivate: public QSqlResultPrivate
 {
     Q_DECLARE_PUBLIC(QSqlCachedResult)
@@ -107,11 +144,13 @@ public:
     inline int cacheCount() const;
     void init(int count, bool fo);
     void cleanup();
-    int nextIndex();
-    void revertLast();
+    void appendRow();
 
+    // the row the driver fetches into
     QSqlCachedResult::ValueCache cache;
-    int rowCacheEnd = 0;
+    // all fetched rows, unless the result is forward only
+    QList<QSqlCachedColumn> columns;
+    int rowCount = 0;
     int colCount = 0;
     bool atEnd = false;
 };
@@ -0,0 +1,628 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtSql module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include "qsqlconnectionpool.h"
+
+#include "qdebug.h"
+#include "qelapsedtimer.h"
+#include "qhash.h"
+#include "qlist.h"
+#include "qmutex.h"
+#include "qsqldriver.h"
+#include "qsqlerror.h"
+#include "qsqlquery.h"
+#include "qthread.h"
+#include "qtimer.h"
+#include "qwaitcondition.h"
+#include "private/qobject_p.h"
+
+QT_BEGIN_NAMESPACE
+
+bool qt_sqlDatabaseHasOtherHandles(const QSqlDatabase &db); // qsqldatabase.cpp
+
+struct QSqlPooledConnection
+{
+    QString name;
+    QSqlDatabase db;
+    QElapsedTimer idleTimer;
+    int checkouts = 0;
+};
+
+class QSqlConnectionPoolPrivate : public QObjectPrivate
+{
+    Q_DECLARE_PUBLIC(QSqlConnectionPool)
+
+public:
+    QString nextConnectionName();
+    QSqlPooledConnection *openConnection(const QString &name);
+    bool isHealthy(const QSqlPooledConnection *connection, const QString &query) const;
+    void closeConnection(QSqlPooledConnection *connection);
+    void retireConnection(QSqlPooledConnection *connection);
+    void removeRetired(bool force = false);
+    void restartMaintenance();
+    void maintain();
+
+    // the mutex protects everything below except the connection parameters,
+    // which don't change after construction
+    mutable QMutex mutex;
+    QWaitCondition connectionReleased;
+
+    QString driverName;
+    QString databaseName;
+    QString userName;
+    QString password;
+    QString hostName;
+    QString connectOptions;
+    int port = -1;
+    QSql::NumericalPrecisionPolicy precisionPolicy = QSql::LowPrecisionDouble;
+
+    QList<QSqlPooledConnection *> connections;
+    QList<QSqlPooledConnection *> idleConnections; // least recently released first
+    QHash<QThread *, QSqlPooledConnection *> checkedOut;
+    QList<QSqlPooledConnection *> retired; // closed, but still referenced by handles
+    QSqlError error;
+    QString healthCheckQuery;
+    QTimer *maintenanceTimer = nullptr;
+    int opening = 0; // connections being opened outside of the mutex
+    int minimumSize = 0;
+    int maximumSize = QThread::idealThreadCount();
+    int idleTimeout = 30000;
+    int nextId = 0;
+};
+
+QString QSqlConnectionPoolPrivate::nextConnectionName()
+{
+    return QStringLiteral("qt_sql_connection_pool_%1_%2")
+            .arg(quintptr(this), 0, 16).arg(nextId++);
+}
+
+// Called without the mutex being locked. The connection belongs to the
+// calling thread.
+QSqlPooledConnection *QSqlConnectionPoolPrivate::openConnection(const QString &name)
+{
+    QSqlDatabase db = QSqlDatabase::addDatabase(driverName, name);
+    db.setDatabaseName(databaseName);
+    db.setUserName(userName);
+    db.setPassword(password);
+    db.setHostName(hostName);
+    db.setPort(port);
+    db.setConnectOptions(connectOptions);
+    db.setNumericalPrecisionPolicy(precisionPolicy);
+    if (!db.open()) {
+        const QSqlError openError = db.lastError();
+        db = QSqlDatabase();
+        QSqlDatabase::removeDatabase(name);
+        QMutexLocker locker(&mutex);
+        error = openError;
+        return nullptr;
+    }
+    auto connection = new QSqlPooledConnection;
+    connection->name = name;
+    connection->db = db;
+    return connection;
+}
+
+// Called without the mutex being locked, from the thread that uses the
+// connection.
+bool QSqlConnectionPoolPrivate::isHealthy(const QSqlPooledConnection *connection,
+                                          const QString &query) const
+{
+    if (!connection->db.isOpen() || connection->db.isOpenError())
+        return false;
+    if (query.isEmpty())
+        return true;
+    QSqlQuery q(connection->db);
+    return q.exec(query);
+}
+
+// Called without the mutex being locked, after the connection has been
+// removed from the pool.
+void QSqlConnectionPoolPrivate::closeConnection(QSqlPooledConnection *connection)
+{
+    const QString name = connection->name;
+    connection->db.close();
+    delete connection;
+    QSqlDatabase::removeDatabase(name);
+}
+
+// Called without the mutex being locked, from the thread that used the
+// connection. Removing the connection now would invalidate the handles the
+// caller still holds, so it is only closed here and removed by
+// removeRetired() once they are gone.
+void QSqlConnectionPoolPrivate::retireConnection(QSqlPooledConnection *connection)
+{
+    connection->db.close();
+    connection->db.driver()->moveToThread(nullptr);
+    QMutexLocker locker(&mutex);
+    connections.removeOne(connection);
+    retired.append(connection);
+}
+
+// Called without the mutex being locked.
+void QSqlConnectionPoolPrivate::removeRetired(bool force)
+{
+    QMutexLocker locker(&mutex);
+    if (retired.isEmpty())
+        return;
+    QList<QSqlPooledConnection *> removable;
+    for (auto it = retired.begin(); it != retired.end(); ) {
+        if (!force && qt_sqlDatabaseHasOtherHandles((*it)->db)) {
+            ++it;
+        } else {
+            removable.append(*it);
+            it = retired.erase(it);
+        }
+    }
+    locker.unlock();
+    for (QSqlPooledConnection *connection : qAsConst(removable))
+        closeConnection(connection);
+}
+
+void QSqlConnectionPoolPrivate::restartMaintenance()
+{
+    QMutexLocker locker(&mutex);
+    if (idleTimeout < 0 && minimumSize == 0 && retired.isEmpty()) {
+        maintenanceTimer->stop();
+        return;
+    }
+    // check twice per timeout, so that idle connections are closed at most
+    // 50% later than requested
+    maintenanceTimer->start(idleTimeout < 0 ? 10000 : qBound(10, idleTimeout / 2, 10000));
+}
+
+void QSqlConnectionPoolPrivate::maintain()
+{
+    removeRetired();
+
+    QMutexLocker locker(&mutex);
+    if (idleTimeout < 0 && minimumSize == 0 && retired.isEmpty())
+        maintenanceTimer->stop();
+    QList<QSqlPooledConnection *> expired;
+    if (idleTimeout >= 0) {
+        while (!idleConnections.isEmpty() && connections.count() > minimumSize
+               && idleConnections.constFirst()->idleTimer.hasExpired(idleTimeout)) {
+            QSqlPooledConnection *connection = idleConnections.takeFirst();
+            connections.removeOne(connection);
+            expired.append(connection);
+        }
+    }
+    locker.unlock();
+    for (QSqlPooledConnection *connection : qAsConst(expired))
+        closeConnection(connection);
+
+    locker.relock();
+    while (connections.count() + opening < minimumSize) {
+        const QString name = nextConnectionName();
+        ++opening;
+        locker.unlock();
+        QSqlPooledConnection *connection = openConnection(name);
+        if (connection)
+            connection->db.driver()->moveToThread(nullptr);
+        locker.relock();
+        --opening;
+        if (!connection)
+            break;
+        connection->idleTimer.start();
+        connections.append(connection);
+        idleConnections.append(connection);
+        connectionReleased.wakeOne();
+    }
+}
+
+/*!
+    \class QSqlConnectionPool
+    \brief The QSqlConnectionPool class keeps database connections open for
+    reuse by different threads.
+
+    \ingroup database
+    \inmodule QtSql
+    \since 6.3
+    \threadsafe
+
+    A QSqlDatabase connection can only be used by the thread that created
+    it, so applications running database work in a thread pool usually
+    open a new connection for every task. Opening a connection is expensive
+    for client/server databases, and often takes longer than the task itself.
+
+    QSqlConnectionPool opens connections with the same parameters as a
+    template database connection and hands them out to threads that call
+    acquire(). A thread gives its connection back with release(), which
+    makes it available to any other thread without closing it:
+
+    \snippet code/src_sql_kernel_qsqlconnectionpool.cpp 0
+    \snippet code/src_sql_kernel_qsqlconnectionpool.cpp 1
+
+    Calling acquire() again from a thread that already holds a connection
+    returns the same connection; it is given back to the pool once release()
+    has been called as many times as acquire(). A thread must release its
+    connection before it finishes, and all connections must be released
+    before the pool is destroyed.
+
+    The pool opens new connections on demand until maximumSize() of them
+    are in use; after that, acquire() waits until another thread releases
+    one. Connections that have not been used for idleTimeout() milliseconds
+    are closed, except for the minimumSize() connections the pool keeps
+    open all the time. Before a connection is handed out, the pool checks
+    that it is still open, and executes the healthCheckQuery() if one has
+    been set. Connections failing that check are closed and replaced.
+
+    Idle connections are closed and minimumSize() connections are opened
+    from the thread the pool lives in, which needs to run an event loop.
+
+    \sa QSqlDatabase, {Threads and the SQL Module}
+*/
+
+/*!
+    Creates a pool of connections that are opened with the same driver and
+    connection parameters as \a templateDatabase, with the given \a parent.
+
+    The \a templateDatabase connection is not used by the pool, and does not
+    need to be open. Changes made to its parameters after the pool has been
+    created do not affect the pool.
+*/
+QSqlConnectionPool::QSqlConnectionPool(const QSqlDatabase &templateDatabase, QObject *parent)
+    : QObject(*new QSqlConnectionPoolPrivate, parent)
+{
+    Q_D(QSqlConnectionPool);
+    d->driverName = templateDatabase.driverName();
+    d->databaseName = templateDatabase.databaseName();
+    d->userName = templateDatabase.userName();
+    d->password = templateDatabase.password();
+    d->hostName = templateDatabase.hostName();
+    d->port = templateDatabase.port();
+    d->connectOptions = templateDatabase.connectOptions();
+    d->precisionPolicy = templateDatabase.numericalPrecisionPolicy();
+
+    d->maintenanceTimer = new QTimer(this);
+    connect(d->maintenanceTimer, &QTimer::timeout, this, [d] { d->maintain(); });
+    d->restartMaintenance();
+}
+
+/*!
+    Closes all connections of the pool and destroys it.
+
+    All connections must have been released before. Connections that are
+    still in use are closed and removed as well, which makes the handles of
+    the threads using them invalid, like QSqlDatabase::removeDatabase() does.
+*/
+QSqlConnectionPool::~QSqlConnectionPool()
+{
+    Q_D(QSqlConnectionPool);
+    QMutexLocker locker(&d->mutex);
+    if (!d->checkedOut.isEmpty() || d->opening) {
+        qWarning("QSqlConnectionPool: Destroyed while %d connection(s) are still in use",
+                 int(d->checkedOut.count()) + d->opening);
+    }
+    d->idleConnections.clear();
+    d->checkedOut.clear();
+    const QList<QSqlPooledConnection *> open = std::exchange(d->connections, {});
+    locker.unlock();
+    for (QSqlPooledConnection *connection : open)
+        d->closeConnection(connection);
+    d->removeRetired(true);
+}
+
+/*!
+    Sets the number of connections the pool keeps open, even when they are
+    not used, to \a size. The default is 0.
+
+    Missing connections are opened from the thread the pool lives in.
+
+    \sa minimumSize(), setIdleTimeout()
+*/
+void QSqlConnectionPool::setMinimumSize(int size)
+{
+    Q_D(QSqlConnectionPool);
+    {
+        QMutexLocker locker(&d->mutex);
+        d->minimumSize = qMax(size, 0);
+    }
+    QMetaObject::invokeMethod(this, [d] {
+        d->restartMaintenance();
+        d->maintain();
+    });
+}
+
+/*!
+    Returns the number of connections the pool keeps open, even when they
+    are not used.
+
+    \sa setMinimumSize()
+*/
+int QSqlConnectionPool::minimumSize() const
+{
+    Q_D(const QSqlConnectionPool);
+    QMutexLocker locker(&d->mutex);
+    return d->minimumSize;
+}
+
+/*!
+    Sets the maximum number of connections the pool opens to \a size. The
+    default is QThread::idealThreadCount(), which is also the default
+    number of threads of a QThreadPool.
+
+    Reducing the size does not close connections that are already open;
+    connections above the limit are closed once they reach the idle
+    timeout.
+
+    \sa maximumSize(), acquire()
+*/
+void QSqlConnectionPool::setMaximumSize(int size)
+{
+    Q_D(QSqlConnectionPool);
+    QMutexLocker locker(&d->mutex);
+    d->maximumSize = qMax(size, 1);
+    d->connectionReleased.wakeAll();
+}
+
+/*!
+    Returns the maximum number of connections the pool opens.
+
+    \sa setMaximumSize()
+*/
+int QSqlConnectionPool::maximumSize() const
+{
+    Q_D(const QSqlConnectionPool);
+    QMutexLocker locker(&d->mutex);
+    return d->maximumSize;
+}
+
+/*!
+    Sets the time after which connections that are not used are closed to
+    \a msecs milliseconds. The default is 30000 milliseconds. A negative
+    value keeps connections open until the pool is destroyed.
+
+    Connections are never closed when that would leave less than
+    minimumSize() connections open.
+
+    \sa idleTimeout(), setMinimumSize()
+*/
+void QSqlConnectionPool::setIdleTimeout(int msecs)
+{
+    Q_D(QSqlConnectionPool);
+    {
+        QMutexLocker locker(&d->mutex);
+        d->idleTimeout = msecs;
+    }
+    QMetaObject::invokeMethod(this, [d] { d->restartMaintenance(); });
+}
+
+/*!
+    Returns the time in milliseconds after which connections that are not
+    used are closed.
+
+    \sa setIdleTimeout()
+*/
+int QSqlConnectionPool::idleTimeout() const
+{
+    Q_D(const QSqlConnectionPool);
+    QMutexLocker locker(&d->mutex);
+    return d->idleTimeout;
+}
+
+/*!
+    Sets the statement executed on a connection before it is handed out by
+    acquire() to \a query. If executing it fails, the connection is closed
+    and another one is used.
+
+    By default, no statement is executed, and only connections that have
+    been closed or lost are replaced. A cheap statement like
+    \c{SELECT 1} detects more failures, like connections dropped by the
+    server, at the price of a round trip for every acquire() call.
+
+    \sa healthCheckQuery()
+*/
+void QSqlConnectionPool::setHealthCheckQuery(const QString &query)
+{
+    Q_D(QSqlConnectionPool);
+    QMutexLocker locker(&d->mutex);
+    d->healthCheckQuery = query;
+}
+
+/*!
+    Returns the statement executed on a connection before it is handed out.
+
+    \sa setHealthCheckQuery()
+*/
+QString QSqlConnectionPool::healthCheckQuery() const
+{
+    Q_D(const QSqlConnectionPool);
+    QMutexLocker locker(&d->mutex);
+    return d->healthCheckQuery;
+}
+
+/*!
+    Returns the number of open connections, including the idle ones.
+
+    \sa idleCount(), maximumSize()
+*/
+int QSqlConnectionPool::size() const
+{
+    Q_D(const QSqlConnectionPool);
+    QMutexLocker locker(&d->mutex);
+    return int(d->connections.count());
+}
+
+/*!
+    Returns the number of open connections that are not used by any thread.
+
+    \sa size()
+*/
+int QSqlConnectionPool::idleCount() const
+{
+    Q_D(const QSqlConnectionPool);
+    QMutexLocker locker(&d->mutex);
+    return int(d->idleConnections.count());
+}
+
+/*!
+    Returns the error that occurred when the pool last failed to open a
+    connection.
+
+    \sa acquire()
+*/
+QSqlError QSqlConnectionPool::lastError() const
+{
+    Q_D(const QSqlConnectionPool);
+    QMutexLocker locker(&d->mutex);
+    return d->error;
+}
+
+/*!
+    Returns an open connection for use by the calling thread, waiting until
+    \a deadline expires if maximumSize() connections are used by other
+    threads.
+
+    The returned connection is an idle one if possible, otherwise a new
+    connection is opened. If the calling thread already holds a connection
+    of this pool, that connection is returned again.
+
+    Returns an invalid QSqlDatabase if the deadline expired, or if a new
+    connection could not be opened; lastError() then reports why.
+
+    \sa release()
+*/
+QSqlDatabase QSqlConnectionPool::acquire(QDeadlineTimer deadline)
+{
+    Q_D(QSqlConnectionPool);
+    QThread *thread = QThread::currentThread();
+    const auto checkOut = [d, thread](QSqlPooledConnection *connection) {
+        connection->checkouts = 1;
+        d->checkedOut.insert(thread, connection);
+        return connection->db;
+    };
+
+    d->removeRetired();
+
+    QMutexLocker locker(&d->mutex);
+    if (QSqlPooledConnection *connection = d->checkedOut.value(thread)) {
+        ++connection->checkouts;
+        return connection->db;
+    }
+
+    for (;;) {
+        if (!d->idleConnections.isEmpty()) {
+            // prefer the connection released last, so that the ones not
+            // needed anymore reach the idle timeout
+            QSqlPooledConnection *connection = d->idleConnections.takeLast();
+            const QString query = d->healthCheckQuery;
+            locker.unlock();
+            connection->db.driver()->moveToThread(thread);
+            const bool healthy = d->isHealthy(connection, query);
+            locker.relock();
+            if (healthy)
+                return checkOut(connection);
+            locker.unlock();
+            // handles from before the connection was released may still
+            // exist, so it cannot always be removed right away
+            d->retireConnection(connection);
+            QMetaObject::invokeMethod(this, [d] { d->restartMaintenance(); });
+            locker.relock();
+            continue;
+        }
+
+        if (d->connections.count() + d->opening < d->maximumSize) {
+            const QString name = d->nextConnectionName();
+            ++d->opening;
+            locker.unlock();
+            QSqlPooledConnection *connection = d->openConnection(name);
+            locker.relock();
+            --d->opening;
+            if (!connection) {
+                // let another thread try
+                d->connectionReleased.wakeOne();
+                return QSqlDatabase();
+            }
+            d->connections.append(connection);
+            return checkOut(connection);
+        }
+
+        if (!d->connectionReleased.wait(&d->mutex, deadline))
+            return QSqlDatabase();
+    }
+}
+
+/*!
+    Gives the connection \a database, which the calling thread acquired
+    from this pool, back to the pool.
+
+    The connection stays open, and becomes available to other threads once
+    the calling thread has released it as many times as it acquired it. It
+    must not be used by the calling thread after that, and all queries on
+    it should have been finished or destroyed before.
+
+    Connections that have been closed are removed from the pool, and from
+    the list of QSqlDatabase connections once the calling thread's handles
+    to them have been destroyed.
+
+    \sa acquire()
+*/
+void QSqlConnectionPool::release(const QSqlDatabase &database)
+{
+    Q_D(QSqlConnectionPool);
+    QThread *thread = QThread::currentThread();
+    QMutexLocker locker(&d->mutex);
+    QSqlPooledConnection *connection = d->checkedOut.value(thread);
+    if (!connection || connection->name != database.connectionName()) {
+        qWarning("QSqlConnectionPool::release: Connection '%s' was not acquired from this pool"
+                 " by the calling thread", qPrintable(database.connectionName()));
+        return;
+    }
+    if (--connection->checkouts > 0)
+        return;
+    d->checkedOut.remove(thread);
+
+    if (connection->db.isOpen() && !connection->db.isOpenError()) {
+        locker.unlock();
+        // let the next thread pull the driver to itself
+        connection->db.driver()->moveToThread(nullptr);
+        locker.relock();
+        connection->idleTimer.start();
+        d->idleConnections.append(connection);
+    } else {
+        locker.unlock();
+        d->retireConnection(connection);
+        QMetaObject::invokeMethod(this, [d] { d->restartMaintenance(); });
+        locker.relock();
+    }
+    d->connectionReleased.wakeOne();
+}
+
+QT_END_NAMESPACE
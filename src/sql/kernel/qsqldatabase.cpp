@@ -118,6 +118,7 @@ public:
     static void invalidateDb(const QSqlDatabase &db, const QString &name, bool doWarn = true);
     static DriverDict &driverDict();
     static void cleanConnections();
+    static int handleCount(const QSqlDatabase &db) { return db.d->ref.loadRelaxed(); }
 };
 
 QSqlDatabasePrivate::QSqlDatabasePrivate(const QSqlDatabasePrivate &other) : ref(1)
@@ -192,6 +193,14 @@ void QSqlDatabasePrivate::invalidateDb(const QSqlDatabase &db, const QString &na
     }
 }
 
+// Used by QSqlConnectionPool, which keeps a handle to each of its
+// connections: returns whether \a db is also referenced by handles other
+// than that one and the one in the connection dictionary.
+bool qt_sqlDatabaseHasOtherHandles(const QSqlDatabase &db)
+{
+    return QSqlDatabasePrivate::handleCount(db) > 2;
+}
+
 void QSqlDatabasePrivate::removeDatabase(const QString &name)
 {
     QConnectionDict *dict = dbDict();
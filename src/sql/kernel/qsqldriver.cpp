@@ -844,4 +844,78 @@ int QSqlDriver::maximumIdentifierLength(QSqlDriver::IdentifierType type) const
     return INT_MAX;
 }
 
+/*!
+    \since 6.3
+
+    Sets the maximum number of compiled statements the connection keeps
+    for reuse to \a size. The default is 0, which disables the cache.
+
+    When the cache is enabled, statements are kept after the query that
+    prepared them has been finished or destroyed, and a later
+    QSqlQuery::prepare() or QSqlQuery::exec() with the same SQL text on
+    this connection reuses the compiled statement instead of compiling it
+    again. The statement that has been used least recently is released
+    when the cache is full. This pays off for applications that execute a
+    small set of statements many times.
+
+    A cached statement is only used by one query at a time. Reducing the
+    size releases the statements that no longer fit, and all of them are
+    released when the connection is closed.
+
+    Currently only the SQLite driver supports caching statements; for the
+    other drivers, this setting has no effect.
+
+    \sa statementCacheSize(), statementCacheHits(), statementCacheMisses()
+*/
+void QSqlDriver::setStatementCacheSize(int size)
+{
+    Q_D(QSqlDriver);
+    d->statementCache.setMaxCost(qMax(size, 0));
+}
+
+/*!
+    \since 6.3
+
+    Returns the maximum number of compiled statements the connection keeps
+    for reuse.
+
+    \sa setStatementCacheSize()
+*/
+int QSqlDriver::statementCacheSize() const
+{
+    Q_D(const QSqlDriver);
+    return int(d->statementCache.maxCost());
+}
+
+/*!
+    \since 6.3
+
+    Returns how many times a query on this connection has been prepared
+    with a statement taken from the statement cache.
+
+    \sa statementCacheMisses(), setStatementCacheSize()
+*/
+qint64 QSqlDriver::statementCacheHits() const
+{
+    Q_D(const QSqlDriver);
+    return d->statementCacheHits;
+}
+
+/*!
+    \since 6.3
+
+    Returns how many times a query on this connection had to be compiled
+    while the statement cache was enabled, because no statement was cached
+    for its SQL text.
+
+    \sa statementCacheHits(), setStatementCacheSize()
+*/
+qint64 QSqlDriver::statementCacheMisses() const
+{
+    Q_D(const QSqlDriver);
+    return d->statementCacheMisses;
+}
+
+QSqlCachedStatement::~QSqlCachedStatement() = default;
+
 QT_END_NAMESPACE
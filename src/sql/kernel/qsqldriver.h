@@ -131,6 +131,11 @@ public:
 
     DbmsType dbmsType() const;
     virtual int maximumIdentifierLength(IdentifierType type) const;
+
+    void setStatementCacheSize(int size);
+    int statementCacheSize() const;
+    qint64 statementCacheHits() const;
+    qint64 statementCacheMisses() const;
 public Q_SLOTS:
     virtual bool cancelQuery();
 
@@ -55,9 +55,18 @@
 #include "private/qobject_p.h"
 #include "qsqldriver.h"
 #include "qsqlerror.h"
+#include <QtCore/qcache.h>
 
 QT_BEGIN_NAMESPACE
 
+// Driver specific compiled statement kept in the statement cache of a
+// connection. Deleting it must release the statement.
+class Q_SQL_EXPORT QSqlCachedStatement
+{
+public:
+    virtual ~QSqlCachedStatement();
+};
+
 class QSqlDriverPrivate : public QObjectPrivate
 {
     Q_DECLARE_PUBLIC(QSqlDriver)
@@ -73,6 +82,31 @@ public:
     QSqlDriver::DbmsType dbmsType;
     bool isOpen = false;
     bool isOpenError = false;
+
+    // Removes the statement compiled for \a query from the cache, so that
+    // a result can use it exclusively until it hands it back with
+    // cacheStatement().
+    QSqlCachedStatement *takeCachedStatement(const QString &query)
+    {
+        if (statementCache.maxCost() <= 0)
+            return nullptr;
+        if (QSqlCachedStatement *statement = statementCache.take(query)) {
+            ++statementCacheHits;
+            return statement;
+        }
+        ++statementCacheMisses;
+        return nullptr;
+    }
+    // Takes ownership of \a statement, deleting it right away if the cache
+    // is disabled.
+    void cacheStatement(const QString &query, QSqlCachedStatement *statement)
+    {
+        statementCache.insert(query, statement);
+    }
+
+    QCache<QString, QSqlCachedStatement> statementCache{0};
+    qint64 statementCacheHits = 0;
+    qint64 statementCacheMisses = 0;
 };
 
 QT_END_NAMESPACE
@@ -50,6 +50,11 @@
 #include "qsqldriver.h"
 #include "qsqldatabase.h"
 #include "private/qsqlnulldriver_p.h"
+#include "private/qsqlresult_p.h"
+
+#if QT_CONFIG(future)
+#include "qpromise.h"
+#endif
 
 QT_BEGIN_NAMESPACE
 
@@ -696,6 +701,63 @@ bool QSqlQuery::next()
     }
 }
 
+/*!
+  \since 6.3
+
+  Retrieves up to \a maxRows records following the current one and
+  positions the query on the last record retrieved. Returns the number of
+  records retrieved. If less than \a maxRows records could be retrieved,
+  the end of the result has been reached and the query is positioned after
+  the last record, like with next().
+
+  The contents of \a columns are replaced by the values of the retrieved
+  records, with one QVariantList per field, in the same way execBatch()
+  expects bound values. Reusing the same \a columns for consecutive calls
+  avoids reallocating the lists:
+
+  \snippet code/src_sql_kernel_qsqlquery.cpp 4
+
+  Drivers that support it retrieve the records without going through
+  next() and value() for each of them, which makes this function the
+  fastest way to read large results, in particular from forward only
+  queries.
+
+  The query must be \l{isActive()}{active} and isSelect() must return
+  true, otherwise this function does nothing and returns 0.
+
+  \sa next(), value(), setForwardOnly()
+*/
+int QSqlQuery::fetchRows(QList<QVariantList> *columns, int maxRows)
+{
+    if (!columns || maxRows <= 0 || !isSelect() || !isActive())
+        return 0;
+
+    const int fieldCount = d->sqlResult->record().count();
+    columns->resize(fieldCount);
+    for (QVariantList &column : *columns) {
+        column.clear();
+        column.reserve(qMin(maxRows, 1024));
+    }
+    if (at() == QSql::AfterLastRow)
+        return 0;
+
+    QSqlResultPrivate::FetchRowsData data{columns, maxRows};
+    d->sqlResult->virtual_hook(QSqlResultPrivate::FetchRowsHook, &data);
+    if (data.fetched >= 0) {
+        if (data.fetched < maxRows)
+            d->sqlResult->setAt(QSql::AfterLastRow);
+        return data.fetched;
+    }
+
+    int fetched = 0;
+    while (fetched < maxRows && next()) {
+        for (int i = 0; i < fieldCount; ++i)
+            (*columns)[i].append(d->sqlResult->data(i));
+        ++fetched;
+    }
+    return fetched;
+}
+
 /*!
 
   Retrieves the previous record in the result, if available, and
@@ -1050,6 +1112,72 @@ bool QSqlQuery::exec()
     return retval;
 }
 
+#if QT_CONFIG(future)
+/*!
+  \since 6.3
+
+  Starts executing a previously prepared SQL query with the bound values,
+  and returns a future that receives the records the query returns.
+
+  Drivers that support asynchronous execution send the query to the
+  database and return immediately. The records are then reported to the
+  future one by one while they arrive, as long as the thread that called
+  this function runs an event loop, so that large results can be
+  processed before the query has finished:
+
+  \snippet code/src_sql_kernel_qsqlquery.cpp 5
+
+  Do not block that thread waiting for the future, for instance with
+  QFuture::waitForFinished(), as this prevents the records from being
+  received.
+
+  Queries executed asynchronously on the same connection are executed in
+  the order in which they were started. Where the database client library
+  supports it, they are pipelined: each query is sent without waiting for
+  the results of the previous ones, which saves a round trip per query.
+  Executing a query synchronously on the same connection waits until all
+  asynchronous queries have finished. Preparing one doesn't: the statement
+  is prepared after the running queries, and prepare() returns \c true
+  without checking it, so that errors in it are only reported when the
+  query is executed.
+
+  If the query fails, the future is canceled, and lastError() describes the
+  error once it has finished. The query itself is not positioned on any
+  record and is not \l{isActive()}{active} after calling this function.
+
+  With drivers that don't support asynchronous execution, the query is
+  executed by this function, which returns a future that has finished and
+  holds all records. Currently only the PostgreSQL driver executes queries
+  asynchronously; it can only execute a single SQL statement per query
+  this way.
+
+  \sa exec(), prepare(), QFutureWatcher
+*/
+QFuture<QSqlRecord> QSqlQuery::execAsync()
+{
+    QSqlResultPrivate::ExecAsyncData data;
+    if (driver() && driver()->isOpen() && !driver()->isOpenError()) {
+        d->sqlResult->resetBindCount();
+        if (d->sqlResult->lastError().isValid())
+            d->sqlResult->setLastError(QSqlError());
+        d->sqlResult->virtual_hook(QSqlResultPrivate::ExecAsyncHook, &data);
+    }
+    if (data.handled)
+        return data.future;
+
+    QPromise<QSqlRecord> promise;
+    promise.start();
+    if (exec()) {
+        while (next())
+            promise.addResult(record());
+    } else {
+        promise.future().cancel();
+    }
+    promise.finish();
+    return promise.future();
+}
+#endif // QT_CONFIG(future)
+
 /*! \enum QSqlQuery::BatchExecutionMode
 
     \value ValuesAsRows - Updates multiple rows. Treats every entry in a QVariantList as a value for updating the next row.
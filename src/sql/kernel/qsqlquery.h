@@ -44,6 +44,9 @@
 #include <QtSql/qsqldatabase.h>
 #include <QtCore/qstring.h>
 #include <QtCore/qvariant.h>
+#if QT_CONFIG(future)
+#include <QtCore/qfuture.h>
+#endif
 
 QT_BEGIN_NAMESPACE
 
@@ -109,6 +112,7 @@ public:
 
     bool seek(int i, bool relative = false);
     bool next();
+    int fetchRows(QList<QVariantList> *columns, int maxRows);
     bool previous();
     bool first();
     bool last();
@@ -119,6 +123,9 @@ public:
     bool exec();
     enum BatchExecutionMode { ValuesAsRows, ValuesAsColumns };
     bool execBatch(BatchExecutionMode mode = ValuesAsRows);
+#if QT_CONFIG(future)
+    QFuture<QSqlRecord> execAsync();
+#endif
     bool prepare(const QString& query);
     void bindValue(const QString& placeholder, const QVariant& val,
                    QSql::ParamType type = QSql::In);
@@ -53,7 +53,11 @@
 
 #include <QtSql/private/qtsqlglobal_p.h>
 #include <QtCore/qpointer.h>
+#if QT_CONFIG(future)
+#include <QtCore/qfuture.h>
+#endif
 #include "qsqlerror.h"
+#include "qsqlrecord.h"
 #include "qsqlresult.h"
 #include "qsqldriver.h"
 
@@ -83,6 +87,37 @@ public:
     { }
     virtual ~QSqlResultPrivate() = default;
 
+    // QSqlResult::virtual_hook() operations
+    enum VirtualHookOperation {
+        // data is a FetchRowsData
+        FetchRowsHook = 0x100,
+        // data is an ExecAsyncData
+        ExecAsyncHook = 0x101
+    };
+
+    // Used by QSqlQuery::fetchRows(). A result implementing the hook appends
+    // up to maxRows rows following the current one to columns (which already
+    // has one list per column), leaves the result positioned on the last row
+    // it fetched and sets fetched to the number of rows.
+    struct FetchRowsData
+    {
+        QList<QVariantList> *columns;
+        int maxRows;
+        int fetched = -1;
+    };
+
+#if QT_CONFIG(future)
+    // Used by QSqlQuery::execAsync(). A result implementing the hook starts
+    // executing the prepared query with the bound values and sets handled to
+    // true. The future receives one record per row and is canceled if the
+    // query fails, in which case the result's lastError() is set.
+    struct ExecAsyncData
+    {
+        QFuture<QSqlRecord> future;
+        bool handled = false;
+    };
+#endif
+
     void clearValues()
     {
         values.clear();
@@ -0,0 +1,100 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the tools applications of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+
+#include <private/qbinarylog_p.h>
+
+#include <stdio.h>
+
+QT_USE_NAMESPACE
+
+static const char *typeName(QtMsgType type)
+{
+    switch (type) {
+    case QtDebugMsg: return "debug";
+    case QtInfoMsg: return "info";
+    case QtWarningMsg: return "warning";
+    case QtCriticalMsg: return "critical";
+    case QtFatalMsg: return "fatal";
+    }
+    return "unknown";
+}
+
+int main(int argc, char **argv)
+{
+    // don't truncate the log we are about to read
+    qunsetenv("QT_LOGGING_BINARY_FILE");
+
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationVersion(QLatin1String(QT_VERSION_STR));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral(
+            "Prints the messages of a log written with QT_LOGGING_BINARY_FILE set."));
+    parser.addHelpOption();
+    parser.addVersionOption();
+    QCommandLineOption absoluteOption(QStringList() << QStringLiteral("a") << QStringLiteral("absolute"),
+            QStringLiteral("Print the time of day instead of the seconds since the log was created."));
+    parser.addOption(absoluteOption);
+    parser.addPositionalArgument(QStringLiteral("file"), QStringLiteral("The binary log file."));
+    parser.process(app);
+
+    const QStringList files = parser.positionalArguments();
+    if (files.size() != 1)
+        parser.showHelp(1);
+
+    QBinaryLogReader reader;
+    if (!reader.open(files.first())) {
+        fprintf(stderr, "qlogdecode: %s: %s\n", qPrintable(files.first()),
+                qPrintable(reader.errorString()));
+        return 1;
+    }
+
+    const bool absolute = parser.isSet(absoluteOption);
+    const QList<QBinaryLogReader::Entry> entries = reader.entries();
+    for (const QBinaryLogReader::Entry &entry : entries) {
+        QByteArray time;
+        if (absolute) {
+            time = QDateTime::fromMSecsSinceEpoch(reader.startTime() + entry.timestamp / 1000000)
+                    .toString(Qt::ISODateWithMs).toLatin1();
+        } else {
+            time = QByteArray::number(entry.timestamp / 1e9, 'f', 6);
+        }
+        printf("%s %#llx %s %s: %s\n", time.constData(), qulonglong(entry.threadId),
+               typeName(entry.type), entry.category.constData(),
+               entry.message.toLocal8Bit().constData());
+    }
+
+    if (reader.droppedCount())
+        fprintf(stderr, "qlogdecode: %llu records did not fit into the log\n",
+                qulonglong(reader.droppedCount()));
+    return 0;
+}
@@ -234,7 +234,7 @@ int runRcc(int argc, char *argv[])
         formatVersion = parser.value(formatVersionOption).toUInt(&ok);
         if (!ok) {
             errorMsg = QLatin1String("Invalid format version specified");
-        } else if (formatVersion < 1 || formatVersion > 3) {
+        } else if (formatVersion < 1 || formatVersion > 4) {
             errorMsg = QLatin1String("Unsupported format version specified");
         }
     }
@@ -41,6 +41,7 @@
 #include <qxmlstream.h>
 
 #include <algorithm>
+#include <numeric>
 
 #if QT_CONFIG(zstd)
 #  include <zstd.h>
@@ -1245,6 +1246,106 @@ struct qt_rcc_compare_hash
     }
 };
 
+// Must match qt_resource_index_slot() in qresource.cpp
+static inline uint qt_rcc_index_slot(uint hash, uint seed, uint slotCount)
+{
+    uint h = hash ^ (seed * 0x9e3779b9U);
+    h ^= h >> 16;
+    h *= 0x85ebca6bU;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35U;
+    h ^= h >> 16;
+    return h % slotCount;
+}
+
+/*
+    Builds the perfect hash index of format version 4 for the tree nodes in
+    \a nodes, ordered by node number. See QResourceRoot::findNodeInIndex()
+    for the layout. Returns an empty list if no index could be built.
+*/
+static QList<quint32> buildResourceIndex(const QList<RCCFileInfo *> &nodes)
+{
+    QHash<const RCCFileInfo *, quint32> numbers;
+    QList<QString> paths(nodes.size());
+    QList<quint32> parents(nodes.size(), 0);
+    numbers.insert(nodes.constFirst(), 0);
+    for (int i = 1; i < nodes.size(); ++i) {
+        const RCCFileInfo *node = nodes.at(i);
+        numbers.insert(node, i);
+        parents[i] = numbers.value(node->m_parent);
+        paths[i] = parents[i] ? paths.at(parents[i]) + QLatin1Char('/') + node->m_name
+                              : node->m_name;
+    }
+
+    // localized variants of a file share the path; the lowest node wins
+    QList<quint32> keyNodes;
+    QList<uint> keyHashes;
+    QHash<QString, quint32> seenPaths;
+    QHash<uint, quint32> seenHashes;
+    for (int i = 1; i < nodes.size(); ++i) {
+        if (seenPaths.contains(paths.at(i)))
+            continue;
+        const uint h = qt_hash(paths.at(i));
+        if (seenHashes.contains(h))
+            return QList<quint32>(); // two paths with the same hash can't be told apart
+        seenPaths.insert(paths.at(i), i);
+        seenHashes.insert(h, i);
+        keyNodes.append(i);
+        keyHashes.append(h);
+    }
+    if (keyNodes.isEmpty())
+        return QList<quint32>();
+
+    const uint keyCount = uint(keyNodes.size());
+    const uint bucketCount = keyCount / 4 + 1;
+    const uint slotCount = keyCount + keyCount / 4 + 1;
+
+    QList<QList<int>> buckets(bucketCount);
+    for (uint i = 0; i < keyCount; ++i)
+        buckets[keyHashes.at(i) % bucketCount].append(i);
+    QList<int> order(bucketCount);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&buckets](int left, int right) {
+        return buckets.at(left).size() > buckets.at(right).size();
+    });
+
+    // place the largest buckets first, looking for a seed that puts all of
+    // their keys into free slots
+    QList<quint32> seeds(bucketCount, 0);
+    QList<quint32> slotNodes(slotCount, 0);
+    QList<uint> bucketSlots;
+    for (int b : qAsConst(order)) {
+        const QList<int> &bucket = buckets.at(b);
+        if (bucket.isEmpty())
+            break;
+        bool placed = false;
+        for (uint seed = 0; !placed && seed < 0x100000; ++seed) {
+            bucketSlots.clear();
+            placed = true;
+            for (int key : bucket) {
+                const uint slot = qt_rcc_index_slot(keyHashes.at(key), seed, slotCount);
+                if (slotNodes.at(slot) || bucketSlots.contains(slot)) {
+                    placed = false;
+                    break;
+                }
+                bucketSlots.append(slot);
+            }
+            if (placed) {
+                seeds[b] = seed;
+                for (int i = 0; i < bucket.size(); ++i)
+                    slotNodes[bucketSlots.at(i)] = keyNodes.at(bucket.at(i));
+            }
+        }
+        if (!placed)
+            return QList<quint32>();
+    }
+
+    QList<quint32> index;
+    index.reserve(2 + bucketCount + slotCount + nodes.size());
+    index << bucketCount << slotCount << seeds << slotNodes << parents;
+    return index;
+}
+
 bool RCCResourceLibrary::writeDataStructure()
 {
     switch (m_format) {
@@ -1268,6 +1369,8 @@ bool RCCResourceLibrary::writeDataStructure()
         return false;
 
     //calculate the child offsets (flat)
+    QList<RCCFileInfo *> nodes;
+    nodes.append(m_root);
     pending.push(m_root);
     int offset = 1;
     while (!pending.isEmpty()) {
@@ -1282,11 +1385,21 @@ bool RCCResourceLibrary::writeDataStructure()
         for (int i = 0; i < m_children.size(); ++i) {
             RCCFileInfo *child = m_children.at(i);
             ++offset;
+            nodes.append(child);
             if (child->m_flags & RCCFileInfo::Directory)
                 pending.push(child);
         }
     }
 
+    // the root node has no name, so its name offset points to the index
+    QList<quint32> index;
+    if (m_formatVersion >= 4) {
+        index = buildResourceIndex(nodes);
+        if (index.isEmpty() && m_verbose)
+            m_errorDevice->write("Could not build resource index, falling back to tree lookup\n");
+        m_root->m_nameOffset = index.isEmpty() ? 0 : nodes.size() * (14 + 8);
+    }
+
     //write out the structure (ie iterate again!)
     pending.push(m_root);
     m_root->writeDataInfo(*this);
@@ -1305,6 +1418,17 @@ bool RCCResourceLibrary::writeDataStructure()
                 pending.push(child);
         }
     }
+
+    for (int i = 0; i < index.size(); ++i) {
+        if (i % 4 == 0) {
+            if (m_format == C_Code || m_format == Pass1)
+                writeString("\n  ");
+            else if (m_format == Python_Code)
+                writeString("\\\n");
+        }
+        writeNumber4(index.at(i));
+    }
+
     switch (m_format) {
     case C_Code:
     case Pass1:
@@ -32,8 +32,13 @@
 #if QT_CONFIG(process)
 # include <QtCore/QProcess>
 #endif
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QThread>
+#include <QtCore/private/qbinarylog_p.h>
 #include <QtTest/QTest>
 
+#include <memory>
+
 class tst_qmessagehandler : public QObject
 {
     Q_OBJECT
@@ -56,11 +61,18 @@ private slots:
 
     void qMessagePattern_data();
     void qMessagePattern();
+    void setMessagePattern_data();
     void setMessagePattern();
 
     void formatLogMessage_data();
     void formatLogMessage();
 
+#ifdef QT_BUILD_INTERNAL
+    void binaryLog();
+    void binaryLogOverflow();
+#endif
+    void binaryLogFile();
+
 private:
     QStringList m_baseEnvironment;
 };
@@ -813,6 +825,16 @@ void tst_qmessagehandler::qMessagePattern()
 #endif
 }
 
+void tst_qmessagehandler::setMessagePattern_data()
+{
+    QTest::addColumn<QStringList>("extraEnvironment");
+
+    QTest::newRow("default") << QStringList();
+    QTest::newRow("async") << QStringList{ "QT_LOGGING_ASYNC=1" };
+    QTest::newRow("async-small-buffer") << QStringList{ "QT_LOGGING_ASYNC=1",
+                                                        "QT_LOGGING_ASYNC_BUFFER_SIZE=1" };
+}
+
 void tst_qmessagehandler::setMessagePattern()
 {
 #if !QT_CONFIG(process)
@@ -842,6 +864,8 @@ void tst_qmessagehandler::setMessagePattern()
     std::copy_if(m_baseEnvironment.cbegin(), m_baseEnvironment.cend(),
                  std::back_inserter(environment),
                  doesNotStartWith(QLatin1String("QT_MESSAGE_PATTERN")));
+    QFETCH(QStringList, extraEnvironment);
+    environment += extraEnvironment;
     process.setEnvironment(environment);
 
     process.start(appExe);
@@ -928,6 +952,134 @@ void tst_qmessagehandler::formatLogMessage()
     QCOMPARE(r, result);
 }
 
+#ifdef QT_BUILD_INTERNAL
+static bool writeBinaryLog(QBinaryLogWriter *writer, QtMsgType type, const char *category,
+                           const char *format, ...)
+{
+    const QMessageLogContext context(nullptr, 0, nullptr, category);
+    va_list ap;
+    va_start(ap, format);
+    const bool recorded = writer->write(type, context, format, ap);
+    va_end(ap);
+    return recorded;
+}
+
+void tst_qmessagehandler::binaryLog()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString fileName = dir.filePath(QLatin1String("log"));
+
+    {
+        auto writer = std::make_unique<QBinaryLogWriter>();
+        QVERIFY(writer->open(fileName, 0));
+        QVERIFY(writeBinaryLog(writer.get(), QtDebugMsg, nullptr, "plain"));
+        QVERIFY(writeBinaryLog(writer.get(), QtWarningMsg, "qt.test", "%d|%5u|%-4x|%lld|%zd|%c",
+                               -1, 7u, 0xabu, Q_INT64_C(1) << 40, qsizetype(-3), 'x'));
+        QVERIFY(writeBinaryLog(writer.get(), QtInfoMsg, "qt.test", "%.3f %e %s %s %*d %.*f %%",
+                               3.14159, 1e10, "text", static_cast<const char *>(nullptr),
+                               4, 2, 2, 2.5));
+        // the string need not be null-terminated, so it has to be formatted
+        QVERIFY(!writeBinaryLog(writer.get(), QtDebugMsg, nullptr, "%.3s", "abcdef"));
+        writer->write(QtCriticalMsg, QMessageLogContext(nullptr, 0, nullptr, "qt.other"),
+                      QString::fromUtf8("formatted \xc3\xa4"));
+    }
+
+    QBinaryLogReader reader;
+    QVERIFY2(reader.open(fileName), qPrintable(reader.errorString()));
+    QCOMPARE(reader.droppedCount(), 0u);
+
+    const QList<QBinaryLogReader::Entry> entries = reader.entries();
+    QCOMPARE(entries.size(), 4);
+    QCOMPARE(entries.at(0).type, QtDebugMsg);
+    QCOMPARE(entries.at(0).category, QByteArray("default"));
+    QCOMPARE(entries.at(0).message, QLatin1String("plain"));
+    QCOMPARE(entries.at(1).type, QtWarningMsg);
+    QCOMPARE(entries.at(1).category, QByteArray("qt.test"));
+    QCOMPARE(entries.at(1).message,
+             QString::asprintf("%d|%5u|%-4x|%lld|%zd|%c",
+                               -1, 7u, 0xabu, Q_INT64_C(1) << 40, qsizetype(-3), 'x'));
+    QCOMPARE(entries.at(2).type, QtInfoMsg);
+    QCOMPARE(entries.at(2).message,
+             QString::asprintf("%.3f %e %s %s %*d %.*f %%",
+                               3.14159, 1e10, "text", static_cast<const char *>(nullptr),
+                               4, 2, 2, 2.5));
+    QCOMPARE(entries.at(3).type, QtCriticalMsg);
+    QCOMPARE(entries.at(3).category, QByteArray("qt.other"));
+    QCOMPARE(entries.at(3).message, QString::fromUtf8("formatted \xc3\xa4"));
+    QCOMPARE(entries.at(0).threadId, quint64(quintptr(QThread::currentThreadId())));
+    QVERIFY(entries.at(0).timestamp <= entries.at(3).timestamp);
+}
+
+void tst_qmessagehandler::binaryLogOverflow()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString fileName = dir.filePath(QLatin1String("log"));
+
+    {
+        auto writer = std::make_unique<QBinaryLogWriter>();
+        QVERIFY(writer->open(fileName, 4096));
+        for (int i = 0; i < 1000; ++i)
+            QVERIFY(writeBinaryLog(writer.get(), QtDebugMsg, nullptr, "message %d", i));
+    }
+
+    QBinaryLogReader reader;
+    QVERIFY2(reader.open(fileName), qPrintable(reader.errorString()));
+    const QList<QBinaryLogReader::Entry> entries = reader.entries();
+    QVERIFY(!entries.isEmpty());
+    QCOMPARE(quint64(entries.size()) + reader.droppedCount(), 1000u);
+    for (int i = 0; i < entries.size(); ++i)
+        QCOMPARE(entries.at(i).message, QString::asprintf("message %d", i));
+}
+#endif // QT_BUILD_INTERNAL
+
+void tst_qmessagehandler::binaryLogFile()
+{
+#if !QT_CONFIG(process)
+    QSKIP("This test requires QProcess support");
+#else
+#ifdef Q_OS_ANDROID
+    QSKIP("This test crashes on Android");
+#endif
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString fileName = dir.filePath(QLatin1String("log"));
+
+    QProcess process;
+    const QString appExe(QLatin1String(HELPER_BINARY));
+    process.setEnvironment(m_baseEnvironment
+                           + QStringList(QLatin1String("QT_LOGGING_BINARY_FILE=") + fileName));
+    process.start(appExe);
+    QVERIFY2(process.waitForStarted(), qPrintable(
+        QString::fromLatin1("Could not start %1: %2").arg(appExe, process.errorString())));
+    process.waitForFinished();
+
+    // nothing is formatted for stderr
+    QCOMPARE(process.readAllStandardError(), QByteArray());
+
+    QBinaryLogReader reader;
+    QVERIFY2(reader.open(fileName), qPrintable(reader.errorString()));
+    QStringList messages;
+    for (const QBinaryLogReader::Entry &entry : reader.entries()) {
+        messages << QString::fromLatin1("[%1] %2").arg(QLatin1String(entry.category),
+                                                       entry.message);
+    }
+    const QStringList expected = {
+        "[default] static constructor",
+        "[default] qDebug",
+        "[default] qInfo",
+        "[default] qWarning",
+        "[default] qCritical",
+        "[category] qDebug with category",
+        "[default] qDebug2",
+        "[default] from_a_function 34",
+        "[default] static destructor"
+    };
+    QCOMPARE(messages, expected);
+#endif // QT_CONFIG(process)
+}
 
 QTEST_MAIN(tst_qmessagehandler)
 #include "tst_qlogging.moc"
@@ -34,6 +34,7 @@
 #include <qdiriterator.h>
 #include <qfileinfo.h>
 #include <qstringlist.h>
+#include <qtemporarydir.h>
 
 #include <QtCore/private/qfsfileengine_p.h>
 
@@ -99,6 +100,9 @@ private slots:
     void iterateResource_data();
     void iterateResource();
     void stopLinkLoop();
+    void parallelTraversal_data();
+    void parallelTraversal();
+    void parallelTraversalStopEarly();
 #ifdef QT_BUILD_INTERNAL
     void engineWithNoIterator();
 #endif
@@ -333,6 +337,37 @@ void tst_QDirIterator::iterateRelativeDirectory_data()
                    "entrylist/directory/dummy,"
                    "entrylist/writable").split(',');
 
+    QTest::newRow("QDir::Subdirectories | QDirIterator::ParallelTraversal / QDir::Files")
+        << QString("entrylist") << QDirIterator::IteratorFlags(QDirIterator::Subdirectories | QDirIterator::ParallelTraversal)
+        << QDir::Filters(QDir::Files) << QStringList("*")
+        << QString("entrylist/directory/dummy,"
+                   "entrylist/file,"
+#ifndef Q_NO_SYMLINKS
+                   "entrylist/linktofile.lnk,"
+#endif
+                   "entrylist/writable").split(',');
+
+    QTest::newRow("QDir::Subdirectories | QDir::FollowSymlinks | QDirIterator::ParallelTraversal")
+        << QString("entrylist")
+        << QDirIterator::IteratorFlags(QDirIterator::Subdirectories | QDirIterator::FollowSymlinks
+                                       | QDirIterator::ParallelTraversal)
+        << QDir::Filters(QDir::NoFilter) << QStringList("*")
+        << QString(
+                   "entrylist/.,"
+                   "entrylist/..,"
+                   "entrylist/directory/.,"
+                   "entrylist/directory/..,"
+                   "entrylist/file,"
+#ifndef Q_NO_SYMLINKS
+                   "entrylist/linktofile.lnk,"
+#endif
+                   "entrylist/directory,"
+                   "entrylist/directory/dummy,"
+#if !defined(Q_NO_SYMLINKS) && !defined(Q_NO_SYMLINKS_TO_DIRS)
+                   "entrylist/linktodirectory.lnk,"
+#endif
+                   "entrylist/writable").split(',');
+
     QTest::newRow("empty, default")
         << QString("empty") << QDirIterator::IteratorFlags{}
         << QDir::Filters(QDir::NoFilter) << QStringList("*")
@@ -514,6 +549,80 @@ void tst_QDirIterator::absoluteFilePathsFromRelativeIteratorPath()
     }
 }
 
+static bool createTree(const QString &path, int depth)
+{
+    QDir dir(path);
+    for (int i = 0; i < 8; ++i) {
+        QFile file(dir.filePath(QString("file%1.txt").arg(i)));
+        if (!file.open(QIODevice::WriteOnly))
+            return false;
+    }
+    if (!depth)
+        return true;
+    for (int i = 0; i < 6; ++i) {
+        const QString subdir = QString("dir%1").arg(i);
+        if (!dir.mkdir(subdir) || !createTree(dir.filePath(subdir), depth - 1))
+            return false;
+    }
+    return dir.mkdir(".hidden") && createTree(dir.filePath(".hidden"), 0);
+}
+
+void tst_QDirIterator::parallelTraversal_data()
+{
+    QTest::addColumn<QDir::Filters>("filters");
+    QTest::addColumn<QStringList>("nameFilters");
+
+    QTest::newRow("all") << QDir::Filters(QDir::AllEntries | QDir::NoDotAndDotDot) << QStringList();
+    QTest::newRow("files") << QDir::Filters(QDir::Files) << QStringList();
+    QTest::newRow("hidden") << QDir::Filters(QDir::AllEntries | QDir::Hidden) << QStringList();
+    QTest::newRow("nameFilters") << QDir::Filters(QDir::Files) << QStringList("file[13].txt");
+}
+
+void tst_QDirIterator::parallelTraversal()
+{
+    QFETCH(QDir::Filters, filters);
+    QFETCH(QStringList, nameFilters);
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    QVERIFY(createTree(tempDir.path(), 3));
+
+    auto list = [&](QDirIterator::IteratorFlags flags) {
+        QDirIterator it(tempDir.path(), nameFilters, filters, flags);
+        QStringList result;
+        while (it.hasNext()) {
+            const QString path = it.next();
+            if (it.fileInfo().filePath() != path || it.fileInfo().isDir() != QFileInfo(path).isDir())
+                return QStringList();
+            result << path;
+        }
+        // stays at the end
+        if (it.hasNext() || !it.next().isEmpty())
+            return QStringList();
+        result.sort();
+        return result;
+    };
+
+    const QStringList expected = list(QDirIterator::Subdirectories);
+    QVERIFY(expected.size() > 100);
+    QCOMPARE(list(QDirIterator::Subdirectories | QDirIterator::ParallelTraversal), expected);
+}
+
+void tst_QDirIterator::parallelTraversalStopEarly()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    QVERIFY(createTree(tempDir.path(), 3));
+
+    // destroying the iterator while directories are still being scanned
+    for (int i = 0; i < 20; ++i) {
+        QDirIterator it(tempDir.path(), QDir::Files,
+                        QDirIterator::Subdirectories | QDirIterator::ParallelTraversal);
+        for (int j = 0; j < i && it.hasNext(); ++j)
+            QVERIFY(!it.next().isEmpty());
+    }
+}
+
 void tst_QDirIterator::recurseWithFilters() const
 {
     QStringList nameFilters;
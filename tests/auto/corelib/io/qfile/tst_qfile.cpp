@@ -43,6 +43,9 @@
 #include <QOperatingSystemVersion>
 #include <QStorageInfo>
 #include <QScopeGuard>
+#if QT_CONFIG(future)
+#include <QFuture>
+#endif
 
 #include <private/qabstractfileengine_p.h>
 #include <private/qfsfileengine_p.h>
@@ -269,6 +272,10 @@ private slots:
     void mapWrittenFile_data();
     void mapWrittenFile();
 
+    void readWriteAsync();
+    void readAsyncResource();
+    void writeAsyncAfterClose();
+
     void openStandardStreamsFileDescriptors();
     void openStandardStreamsBufferedStreams();
 
@@ -3369,6 +3376,97 @@ void tst_QFile::mapWrittenFile()
     file.remove();
 }
 
+void tst_QFile::readWriteAsync()
+{
+#if !QT_CONFIG(future)
+    QSKIP("This test requires QFuture");
+#else
+    QFile file("qfile_async_testfile");
+    QVERIFY(file.open(QIODevice::ReadWrite | QIODevice::Truncate));
+
+    // buffered writes must be flushed before the asynchronous ones
+    QCOMPARE(file.write("0123456789"), qint64(10));
+
+    QList<QFuture<qint64>> writes;
+    for (int i = 0; i < 100; ++i)
+        writes << file.writeAsync(10 + i * 100, QByteArray(100, char('a' + i % 26)));
+    for (QFuture<qint64> &write : writes)
+        QCOMPARE(write.result(), qint64(100));
+
+    // the position is left untouched
+    QCOMPARE(file.pos(), qint64(10));
+    QCOMPARE(file.size(), qint64(10 + 100 * 100));
+
+    QList<QFuture<QByteArray>> reads;
+    for (int i = 0; i < 100; ++i)
+        reads << file.readAsync(10 + i * 100, 100);
+    for (int i = 0; i < 100; ++i)
+        QCOMPARE(reads[i].result(), QByteArray(100, char('a' + i % 26)));
+
+    QCOMPARE(file.readAsync(0, 10).result(), QByteArray("0123456789"));
+    QCOMPARE(file.readAsync(file.size() - 5, 100).result().size(), 5);
+    QVERIFY(file.readAsync(file.size(), 100).result().isEmpty());
+    QCOMPARE(file.pos(), qint64(10));
+
+    file.close();
+    QTest::ignoreMessage(QtWarningMsg,
+                         "QFileDevice::readAsync: device not open for reading or invalid arguments");
+    QVERIFY(file.readAsync(0, 10).result().isNull());
+    file.remove();
+#endif
+}
+
+void tst_QFile::readAsyncResource()
+{
+#if !QT_CONFIG(future)
+    QSKIP("This test requires QFuture");
+#else
+    // no native handle, so the read happens synchronously
+    QFile file(":/copy-fallback.qrc");
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray contents = file.readAll();
+    QVERIFY(!contents.isEmpty());
+    QVERIFY(file.seek(3));
+
+    QFuture<QByteArray> read = file.readAsync(1, 10);
+    QVERIFY(read.isFinished());
+    QCOMPARE(read.result(), contents.mid(1, 10));
+    QCOMPARE(file.pos(), qint64(3));
+#endif
+}
+
+void tst_QFile::writeAsyncAfterClose()
+{
+#if !QT_CONFIG(future)
+    QSKIP("This test requires QFuture");
+#else
+    QFile file("qfile_async_testfile");
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    QList<QFuture<qint64>> writes;
+    for (int i = 0; i < 100; ++i)
+        writes << file.writeAsync(i * 100, QByteArray(100, char('a' + i % 26)));
+    file.close();
+
+    // likely to get the descriptor that the first file had
+    QFile other("qfile_async_testfile2");
+    QVERIFY(other.open(QIODevice::ReadWrite | QIODevice::Truncate));
+
+    for (QFuture<qint64> &write : writes)
+        QCOMPARE(write.result(), qint64(100));
+    QCOMPARE(other.size(), qint64(0));
+    other.close();
+    other.remove();
+
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray contents = file.readAll();
+    QCOMPARE(contents.size(), 100 * 100);
+    for (int i = 0; i < 100; ++i)
+        QCOMPARE(contents.mid(i * 100, 100), QByteArray(100, char('a' + i % 26)));
+    file.close();
+    file.remove();
+#endif
+}
+
 void tst_QFile::openDirectory()
 {
     QFile f1(m_resourcesDir);
@@ -31,6 +31,7 @@
 #include <QResource>
 #include <QtPlugin>
 #include <QtCore/QCoreApplication>
+#include <QtCore/QDirIterator>
 #include <QtCore/QScopeGuard>
 #include <QtCore/private/qglobal_p.h>
 
@@ -41,9 +42,11 @@ class tst_QResourceEngine: public QObject
 public:
     tst_QResourceEngine()
 #if defined(Q_OS_ANDROID) && !defined(Q_OS_ANDROID_EMBEDDED)
-        : m_runtimeResourceRcc(QFileInfo(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/runtime_resource.rcc")).absoluteFilePath())
+        : m_runtimeResourceRcc(QFileInfo(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/runtime_resource.rcc")).absoluteFilePath()),
+          m_indexedResourceRcc(QFileInfo(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/runtime_resource_v4.rcc")).absoluteFilePath())
 #else
-        : m_runtimeResourceRcc(QFINDTESTDATA("runtime_resource.rcc"))
+        : m_runtimeResourceRcc(QFINDTESTDATA("runtime_resource.rcc")),
+          m_indexedResourceRcc(QFINDTESTDATA("runtime_resource_v4.rcc"))
 #endif
     {}
 
@@ -63,9 +66,12 @@ private slots:
     void setLocale();
     void lastModified();
     void resourcesInStaticPlugins();
+    void indexedLookup_data();
+    void indexedLookup();
 
 private:
     const QString m_runtimeResourceRcc;
+    const QString m_indexedResourceRcc;
 };
 
 
@@ -168,6 +174,12 @@ void tst_QResourceEngine::compressedResource()
     QCOMPARE(data.size(), expectedData.size());
     QCOMPARE(data, expectedData);
 
+    // decompressed data is cached and shared
+    QCOMPARE(static_cast<const void *>(resource.uncompressedData().constData()),
+             static_cast<const void *>(data.constData()));
+    QCOMPARE(static_cast<const void *>(QResource("zero.txt").uncompressedData().constData()),
+             static_cast<const void *>(data.constData()));
+
     // decompression through the engine
     data = f.readAll();
     QCOMPARE(data.size(), expectedData.size());
@@ -625,6 +637,56 @@ void tst_QResourceEngine::resourcesInStaticPlugins()
     QVERIFY(QFile::exists(":/staticplugin/main.cpp"));
 }
 
+void tst_QResourceEngine::indexedLookup_data()
+{
+    QTest::addColumn<QString>("localeName");
+
+    QTest::newRow("C") << QString("C");
+    QTest::newRow("de") << QString("de");
+    QTest::newRow("de_CH") << QString("de_CH");
+    QTest::newRow("ko") << QString("ko");
+    QTest::newRow("en_US") << QString("en_US");
+}
+
+void tst_QResourceEngine::indexedLookup()
+{
+    QFETCH(QString, localeName);
+    const QLocale locale(localeName);
+
+    // runtime_resource_v4.rcc has the same contents as runtime_resource.rcc,
+    // but uses format version 4, so lookups go through the perfect hash index
+    QVERIFY(!m_indexedResourceRcc.isEmpty());
+    QVERIFY(QResource::registerResource(m_indexedResourceRcc, "/indexed/"));
+    auto unregister = qScopeGuard([=] {
+        QResource::unregisterResource(m_indexedResourceRcc, "/indexed/");
+    });
+
+    QStringList paths;
+    QDirIterator it(":/runtime_resource", QDirIterator::Subdirectories);
+    while (it.hasNext())
+        paths << it.next().mid(2);
+    QVERIFY(paths.contains("runtime_resource/aliasdir/aliasdir.txt"));
+    paths << "runtime_resource" << "runtime_resource/" << "runtime_resource/nonexistent.txt"
+          << "runtime_resource/aliasdir/nonexistent.txt" << "runtime_resource/search_file.txt/x"
+          << "runtime_resource/test/abc/123/+++/nonexistent/currentdir.txt"
+          << "nonexistent";
+
+    for (const QString &path : qAsConst(paths)) {
+        const QResource expected(":/" + path, locale);
+        const QResource actual(":/indexed/" + path, locale);
+        QVERIFY2(actual.isValid() == expected.isValid(), qPrintable(path));
+        QCOMPARE(actual.compressionAlgorithm(), expected.compressionAlgorithm());
+        QCOMPARE(actual.uncompressedData(), expected.uncompressedData());
+        QCOMPARE(actual.lastModified(), expected.lastModified());
+
+        const QFileInfo expectedInfo(":/" + path);
+        const QFileInfo actualInfo(":/indexed/" + path);
+        QCOMPARE(actualInfo.isDir(), expectedInfo.isDir());
+        if (expectedInfo.isDir())
+            QCOMPARE(QDir(actualInfo.filePath()).entryList(), QDir(expectedInfo.filePath()).entryList());
+    }
+}
+
 QTEST_MAIN(tst_QResourceEngine)
 
 #include "tst_qresourceengine.moc"
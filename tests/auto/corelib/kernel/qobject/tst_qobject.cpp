@@ -168,6 +168,7 @@ private slots:
     void functorReferencesConnection();
     void disconnectDisconnects();
     void singleShotConnection();
+    void batchedQueuedConnection();
     void objectNameBinding();
 };
 
@@ -8132,6 +8133,85 @@ void tst_QObject::singleShotConnection()
     }
 }
 
+class BatchReceiver : public QObject
+{
+    Q_OBJECT
+public:
+    QList<QPair<int, QString>> calls;
+    int noArgumentCalls = 0;
+
+public slots:
+    void record(int i, const QString &s) { calls.append(qMakePair(i, s)); }
+    void count() { ++noArgumentCalls; }
+};
+
+void tst_QObject::batchedQueuedConnection()
+{
+    {
+        // emissions before the receiver runs end up in one event
+        SenderObject sender;
+        BatchReceiver receiver;
+        EventSpy spy;
+        receiver.installEventFilter(&spy);
+        QVERIFY(connect(&sender, &SenderObject::signal7, &receiver, &BatchReceiver::record,
+                        Qt::BatchedQueuedConnection));
+        QVERIFY(connect(&sender, SIGNAL(signal1()), &receiver, SLOT(count()),
+                        Qt::BatchedQueuedConnection));
+
+        for (int i = 0; i < 100; ++i) {
+            emit sender.signal7(i, QString::number(i));
+            sender.emitSignal1();
+        }
+        QVERIFY(receiver.calls.isEmpty());
+        QCOMPARE(receiver.noArgumentCalls, 0);
+
+        QCoreApplication::sendPostedEvents(&receiver, QEvent::MetaCall);
+        QCOMPARE(spy.eventList().count(), 2);
+        QCOMPARE(receiver.calls.size(), 100);
+        for (int i = 0; i < 100; ++i)
+            QCOMPARE(receiver.calls.at(i), qMakePair(i, QString::number(i)));
+        QCOMPARE(receiver.noArgumentCalls, 100);
+
+        // after delivery, the next emission starts a new batch
+        emit sender.signal7(100, QStringLiteral("last"));
+        QCoreApplication::sendPostedEvents(&receiver, QEvent::MetaCall);
+        QCOMPARE(spy.eventList().count(), 3);
+        QCOMPARE(receiver.calls.size(), 101);
+        QCOMPARE(receiver.calls.last(), qMakePair(100, QStringLiteral("last")));
+    }
+
+    {
+        // deleting the receiver discards the pending batch
+        SenderObject sender;
+        auto receiver = new BatchReceiver;
+        QVERIFY(connect(&sender, &SenderObject::signal7, receiver, &BatchReceiver::record,
+                        Qt::BatchedQueuedConnection));
+        for (int i = 0; i < 10; ++i)
+            emit sender.signal7(i, QString::number(i));
+        delete receiver;
+        emit sender.signal7(10, QString());
+        QCoreApplication::sendPostedEvents();
+    }
+
+    {
+        // emissions from another thread arrive complete and in order
+        constexpr int Emissions = 10000;
+        SenderObject sender;
+        BatchReceiver receiver;
+        QVERIFY(connect(&sender, &SenderObject::signal7, &receiver, &BatchReceiver::record,
+                        Qt::BatchedQueuedConnection));
+        QScopedPointer<QThread> thread(QThread::create([&sender] {
+            for (int i = 0; i < Emissions; ++i)
+                emit sender.signal7(i, QString::number(i));
+        }));
+        thread->start();
+        QTRY_COMPARE(receiver.calls.size(), Emissions);
+        QVERIFY(thread->wait());
+        for (int i = 0; i < Emissions; ++i)
+            QCOMPARE(receiver.calls.at(i).first, i);
+    }
+}
+
 void tst_QObject::objectNameBinding()
 {
     QObject obj;
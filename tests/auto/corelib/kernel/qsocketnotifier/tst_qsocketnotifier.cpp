@@ -59,6 +59,7 @@ private slots:
     void mixingWithTimers();
 #ifdef Q_OS_UNIX
     void posixSockets();
+    void closedDescriptor();
 #endif
     void asyncMultipleDatagram();
     void activationReason_data();
@@ -360,6 +361,29 @@ void tst_QSocketNotifier::posixSockets()
     }
     qt_safe_close(posixSocket);
 }
+
+void tst_QSocketNotifier::closedDescriptor()
+{
+    int fds[2];
+    QCOMPARE(qt_safe_pipe(fds), 0);
+
+    QSocketNotifier notifier(fds[0], QSocketNotifier::Read);
+    QVERIFY(notifier.isEnabled());
+    QCoreApplication::processEvents();
+
+    // re-enabling a notifier for a descriptor that was closed behind
+    // its back gets reported and disables the notifier
+    qt_safe_close(fds[0]);
+    notifier.setEnabled(false);
+    notifier.setEnabled(true);
+
+    const QByteArray message = "QSocketNotifier: Invalid socket " + QByteArray::number(fds[0])
+            + " with type Read, disabling...";
+    QTest::ignoreMessage(QtWarningMsg, message.constData());
+    QTRY_VERIFY(!notifier.isEnabled());
+
+    qt_safe_close(fds[1]);
+}
 #endif
 
 void tst_QSocketNotifier::async_readDatagramSlot()
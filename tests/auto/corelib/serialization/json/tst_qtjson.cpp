@@ -35,6 +35,7 @@ QT_WARNING_DISABLE_DEPRECATED
 #include "qjsonvalue.h"
 #include "qjsondocument.h"
 #include "qregularexpression.h"
+#include "qthread.h"
 #include "private/qnumeric_p.h"
 #include <limits>
 
@@ -109,6 +110,10 @@ private Q_SLOTS:
     void parseNumbers();
     void parseStrings();
     void parseDuplicateKeys();
+    void parseStringsAtBlockBoundaries();
+    void parseOnDemand();
+    void parseOnDemandErrors();
+    void parseOnDemandThreads();
     void testParser();
 
     void assignToDocument();
@@ -2277,6 +2282,166 @@ void tst_QtJson::parseDuplicateKeys()
     QCOMPARE(it.value(), QJsonValue(false));
 }
 
+void tst_QtJson::parseStringsAtBlockBoundaries()
+{
+    // the tokenizer scans strings and whitespace in blocks of up to 32 bytes;
+    // put the interesting characters at every offset around those boundaries
+    const char *specials[] = { "\\\"", "\\\\", "\\u00e9", UNICODE_DJE };
+    const QString decoded[] = { QStringLiteral("\""), QStringLiteral("\\"),
+                                QString(QChar(0xe9)), QString::fromUtf8(UNICODE_DJE) };
+    for (int i = 0; i < 4; ++i) {
+        for (int offset = 0; offset < 70; ++offset) {
+            const QByteArray prefix(offset, 'a');
+            const QByteArray json = "[" + QByteArray(offset, ' ') + "\"" + prefix + specials[i]
+                    + prefix + "\"" + QByteArray(offset, '\n') + "]";
+            QJsonParseError error;
+            QJsonDocument doc = QJsonDocument::fromJson(json, &error);
+            QCOMPARE(error.error, QJsonParseError::NoError);
+            const QString expected = QString::fromLatin1(prefix) + decoded[i]
+                    + QString::fromLatin1(prefix);
+            QCOMPARE(doc.array().at(0).toString(), expected);
+
+            doc = QJsonDocument::fromJson(json, &error, QJsonDocument::ParseOnDemand);
+            QCOMPARE(error.error, QJsonParseError::NoError);
+            QCOMPARE(doc[0].toString(), expected);
+        }
+    }
+
+    // unterminated strings of all lengths
+    for (int length = 0; length < 70; ++length) {
+        const QByteArray json = "[\"" + QByteArray(length, 'a');
+        QJsonParseError error;
+        QJsonDocument::fromJson(json, &error);
+        QCOMPARE(error.error, QJsonParseError::UnterminatedString);
+    }
+}
+
+void tst_QtJson::parseOnDemand()
+{
+    const QByteArray json =
+            "{ \"B\": true, \"A\": null, \"list\": [1, 2.5, \"x\", {\"y\": [[]]}, []],"
+            " \"esc\\u0061ped\": \"v\", \"str\": \"brackets [ { in \\\" a string\","
+            " \"nested\": { \"list\": 42, \"o\": {} }, \"B\": false, \"last\": -1e3 }";
+
+    const QJsonDocument eager = QJsonDocument::fromJson(json);
+    QJsonParseError error;
+    const QJsonDocument lazy = QJsonDocument::fromJson(json, &error, QJsonDocument::ParseOnDemand);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+    QVERIFY(!lazy.isNull());
+    QVERIFY(!lazy.isEmpty());
+    QVERIFY(lazy.isObject());
+    QVERIFY(!lazy.isArray());
+
+    const QStringList keys = eager.object().keys();
+    for (const QString &key : keys)
+        QCOMPARE(lazy[key], eager[key]);
+    QCOMPARE(lazy[QLatin1String("B")], QJsonValue(false));
+    QCOMPARE(lazy[QLatin1String("escaped")], QJsonValue(QLatin1String("v")));
+    QCOMPARE(lazy[QLatin1String("list")].toArray().size(), 5);
+    QCOMPARE(lazy[QLatin1String("nested")].toObject().value(QLatin1String("list")), QJsonValue(42));
+    QCOMPARE(lazy[QLatin1String("last")], QJsonValue(-1000));
+    QVERIFY(lazy[QLatin1String("missing")].isUndefined());
+    QVERIFY(lazy[0].isUndefined());
+
+    // copies share the text until converted
+    QJsonDocument copy = lazy;
+    QCOMPARE(copy.toJson(), eager.toJson());
+    QCOMPARE(copy, eager);
+    QCOMPARE(lazy.object(), eager.object());
+    QCOMPARE(lazy.toVariant(), eager.toVariant());
+    QCOMPARE(lazy[QLatin1String("B")], QJsonValue(false));
+
+    const QByteArray array = "[ 1, \"two\", [3], {\"four\": 4}, null ]";
+    const QJsonDocument lazyArray = QJsonDocument::fromJson(array, nullptr, QJsonDocument::ParseOnDemand);
+    QVERIFY(lazyArray.isArray());
+    const QJsonArray eagerArray = QJsonDocument::fromJson(array).array();
+    for (int i = -1; i < 7; ++i)
+        QCOMPARE(lazyArray[i], eagerArray.at(i));
+    QVERIFY(lazyArray[QLatin1String("one")].isUndefined());
+    QCOMPARE(lazyArray.array(), eagerArray);
+
+    const QJsonDocument empty = QJsonDocument::fromJson("[]", nullptr, QJsonDocument::ParseOnDemand);
+    QVERIFY(empty.isArray());
+    QVERIFY(empty[0].isUndefined());
+
+    // the text must not be referenced after fromJson() returns
+    QJsonDocument fromRaw;
+    {
+        QByteArray buffer = array;
+        fromRaw = QJsonDocument::fromJson(QByteArray::fromRawData(buffer.constData(), buffer.size()),
+                                          nullptr, QJsonDocument::ParseOnDemand);
+        buffer.fill('x');
+    }
+    QCOMPARE(fromRaw[1], QJsonValue(QLatin1String("two")));
+
+    QJsonDocument replaced = lazy;
+    replaced.setArray(eagerArray);
+    QVERIFY(replaced.isArray());
+    QCOMPARE(replaced[1], QJsonValue(QLatin1String("two")));
+}
+
+void tst_QtJson::parseOnDemandErrors()
+{
+    const char *documents[] = {
+        "",
+        "42",
+        "{ \"a\": }",
+        "{ \"a\" 1 }",
+        "[1, 2",
+        "[1 2]",
+        "[\"abc",
+        "[\"\\u12\"]",
+        "{\"a\": [1, {\"b\": tru }]}",
+        "[1] x",
+    };
+
+    for (const char *json : documents) {
+        QJsonParseError eagerError;
+        const QJsonDocument eager = QJsonDocument::fromJson(json, &eagerError);
+        QJsonParseError lazyError;
+        const QJsonDocument lazy = QJsonDocument::fromJson(json, &lazyError,
+                                                           QJsonDocument::ParseOnDemand);
+        QVERIFY2(eager.isNull(), json);
+        QVERIFY2(lazy.isNull(), json);
+        QCOMPARE(lazyError.error, eagerError.error);
+        QCOMPARE(lazyError.offset, eagerError.offset);
+    }
+}
+
+void tst_QtJson::parseOnDemandThreads()
+{
+    QByteArray json = "{";
+    for (int i = 0; i < 1000; ++i)
+        json += "\"key" + QByteArray::number(i) + "\": [" + QByteArray::number(i) + ", \"v\"],";
+    json += "\"last\": true}";
+    const QJsonDocument eager = QJsonDocument::fromJson(json);
+    const QByteArray eagerJson = eager.toJson();
+
+    // concurrent const access converts the document once, without races
+    for (int round = 0; round < 20; ++round) {
+        const QJsonDocument lazy = QJsonDocument::fromJson(json, nullptr, QJsonDocument::ParseOnDemand);
+        QAtomicInt mismatches;
+        QList<QThread *> threads;
+        for (int i = 0; i < 4; ++i) {
+            threads << QThread::create([&, i] {
+                if (lazy[QLatin1String("key7")] != eager[QLatin1String("key7")])
+                    mismatches.ref();
+                if (i % 2 ? lazy.object() != eager.object() : lazy.toJson() != eagerJson)
+                    mismatches.ref();
+                if (lazy != eager || !lazy[QLatin1String("last")].toBool())
+                    mismatches.ref();
+            });
+        }
+        for (QThread *thread : qAsConst(threads))
+            thread->start();
+        for (QThread *thread : qAsConst(threads)) {
+            QVERIFY(thread->wait());
+            delete thread;
+        }
+        QCOMPARE(mismatches.loadRelaxed(), 0);
+    }
+}
+
 void tst_QtJson::testParser()
 {
     QFile file(testDataDir + "/test.json");
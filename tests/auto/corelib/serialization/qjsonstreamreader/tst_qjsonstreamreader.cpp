@@ -0,0 +1,333 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QTest>
+#include <QBuffer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonStreamReader>
+
+class tst_QJsonStreamReader : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void empty();
+    void scalars();
+    void containers();
+    void readValue_data();
+    void readValue();
+    void errors_data();
+    void errors();
+    void topLevelSequence();
+    void device();
+    void incremental();
+};
+
+static const char document[] =
+        "{\n"
+        "    \"integer\": 1234567890,\n"
+        "    \"real\": -9876.543210,\n"
+        "    \"e\": 0.123456789e-12,\n"
+        "    \"big\": 23456789012E66,\n"
+        "    \"zero\": 0,\n"
+        "    \"escapes\": \"\\\" \\\\ \\/ \\b\\f\\n\\r\\t \\u0041\\u00e9\\ud83d\\ude00\",\n"
+        "    \"utf8\": \"S\xc3\xa3o Paulo \xe2\x82\xac\",\n"
+        "    \"t\": true, \"f\": false, \"n\": null,\n"
+        "    \"array\": [ [], {}, [1, [2, [3]]], \"x\", -0.5 ],\n"
+        "    \"object\": { \"inner\": { \"deeper\": [ {} ] } },\n"
+        "    \"esc\\u0061ped key\": 1,\n"
+        "    \"integer\": 42\n"
+        "}\n";
+
+void tst_QJsonStreamReader::empty()
+{
+    QJsonStreamReader reader;
+    QVERIFY(!reader.isValid());
+    QVERIFY(!reader.hasNext());
+    QCOMPARE(reader.type(), QJsonValue::Undefined);
+    QCOMPARE(reader.containerDepth(), 0);
+    QCOMPARE(reader.lastError().error, QJsonParseError::NoError);
+    QVERIFY(!reader.next());
+
+    QJsonStreamReader spaces(QByteArray(" \n\t\r "));
+    QVERIFY(!spaces.hasNext());
+    QCOMPARE(spaces.lastError().error, QJsonParseError::NoError);
+}
+
+void tst_QJsonStreamReader::scalars()
+{
+    QJsonStreamReader reader(QByteArray("[ 1, -2.5, 1e3, 9223372036854775807, 1e100, \"s\", true, false, null ]"));
+    QVERIFY(reader.isArray());
+    QVERIFY(reader.enterContainer());
+    QCOMPARE(reader.containerDepth(), 1);
+    QCOMPARE(reader.parentContainerType(), QJsonValue::Array);
+
+    QVERIFY(reader.isDouble());
+    QCOMPARE(reader.toInteger(), 1);
+    QCOMPARE(reader.toDouble(), 1.0);
+    QVERIFY(reader.next());
+
+    QVERIFY(reader.isDouble());
+    QCOMPARE(reader.toDouble(), -2.5);
+    QCOMPARE(reader.toInteger(-1), -1);
+    QVERIFY(reader.next());
+
+    QCOMPARE(reader.toInteger(), 1000);
+    QVERIFY(reader.next());
+    QCOMPARE(reader.toInteger(), std::numeric_limits<qint64>::max());
+    QVERIFY(reader.next());
+    QCOMPARE(reader.toDouble(), 1e100);
+    QVERIFY(reader.next());
+
+    QVERIFY(reader.isString());
+    QCOMPARE(reader.readString(), QLatin1String("s"));
+
+    QVERIFY(reader.isBool());
+    QCOMPARE(reader.toBool(), true);
+    QVERIFY(reader.next());
+    QVERIFY(reader.isBool());
+    QCOMPARE(reader.toBool(), false);
+    QVERIFY(reader.next());
+    QVERIFY(reader.isNull());
+    QVERIFY(reader.next());
+
+    QVERIFY(!reader.hasNext());
+    QVERIFY(reader.leaveContainer());
+    QCOMPARE(reader.containerDepth(), 0);
+    QVERIFY(!reader.hasNext());
+    QCOMPARE(reader.lastError().error, QJsonParseError::NoError);
+}
+
+void tst_QJsonStreamReader::containers()
+{
+    const QByteArray json(document);
+    QJsonStreamReader reader(json);
+    QVERIFY(reader.isObject());
+    QVERIFY(reader.enterContainer());
+
+    QStringList keys;
+    while (reader.hasNext()) {
+        QVERIFY(reader.isString());
+        keys << reader.readString();
+        QVERIFY(reader.hasNext());
+        if (keys.last() == QLatin1String("object")) {
+            // leave a container without reading all of it
+            QVERIFY(reader.enterContainer());
+            QCOMPARE(reader.readString(), QLatin1String("inner"));
+            QVERIFY(reader.enterContainer());
+            QCOMPARE(reader.containerDepth(), 3);
+            QVERIFY(reader.leaveContainer());
+            QVERIFY(!reader.hasNext());
+            QVERIFY(reader.leaveContainer());
+        } else {
+            QVERIFY(reader.next());
+        }
+    }
+    QCOMPARE(reader.lastError().error, QJsonParseError::NoError);
+    QVERIFY(reader.leaveContainer());
+    QVERIFY(!reader.hasNext());
+
+    QCOMPARE(keys, QStringList({ "integer", "real", "e", "big", "zero", "escapes", "utf8",
+                                 "t", "f", "n", "array", "object", "escaped key", "integer" }));
+}
+
+void tst_QJsonStreamReader::readValue_data()
+{
+    QTest::addColumn<QByteArray>("json");
+
+    QTest::newRow("document") << QByteArray(document);
+    QTest::newRow("empty-array") << QByteArray("[]");
+    QTest::newRow("empty-object") << QByteArray("{}");
+    QTest::newRow("nested") << QByteArray("[[[[[[[[[[{\"a\":[{}]}]]]]]]]]]]");
+    QTest::newRow("long-strings") << ("[\"" + QByteArray(100000, 'a') + "\", \"\\n"
+                                      + QByteArray(50000, 'b') + "\"]");
+}
+
+void tst_QJsonStreamReader::readValue()
+{
+    QFETCH(QByteArray, json);
+
+    QJsonParseError error;
+    const QJsonDocument doc = QJsonDocument::fromJson(json, &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+
+    QJsonStreamReader reader(json);
+    const QJsonValue value = reader.readValue();
+    QCOMPARE(reader.lastError().error, QJsonParseError::NoError);
+    QVERIFY(!reader.hasNext());
+    if (doc.isArray())
+        QCOMPARE(value, QJsonValue(doc.array()));
+    else
+        QCOMPARE(value, QJsonValue(doc.object()));
+}
+
+void tst_QJsonStreamReader::errors_data()
+{
+    QTest::addColumn<QByteArray>("json");
+
+    QTest::newRow("missing-value") << QByteArray("{ \"a\": }");
+    QTest::newRow("missing-name-separator") << QByteArray("{ \"a\" 1 }");
+    QTest::newRow("missing-value-separator") << QByteArray("[1 2]");
+    QTest::newRow("wrong-bracket") << QByteArray("[1}");
+    QTest::newRow("trailing-comma-array") << QByteArray("[1,]");
+    QTest::newRow("trailing-comma-object") << QByteArray("{\"a\":1,}");
+    QTest::newRow("non-string-key") << QByteArray("{1:2}");
+    QTest::newRow("unterminated-array") << QByteArray("[1, 2");
+    QTest::newRow("unterminated-object") << QByteArray("{\"a\": 1");
+    QTest::newRow("unterminated-string") << QByteArray("[\"abc");
+    QTest::newRow("termination-by-number") << QByteArray("[12");
+    QTest::newRow("illegal-value") << QByteArray("[tru]");
+    QTest::newRow("illegal-number") << QByteArray("[-]");
+    QTest::newRow("illegal-escape") << QByteArray("[\"\\u12\"]");
+    QTest::newRow("illegal-utf8") << QByteArray("[\"\xff\"]");
+    QTest::newRow("garbage-at-end") << QByteArray("[1] ]");
+    QTest::newRow("deep-nesting") << (QByteArray(1100, '[') + QByteArray(1100, ']'));
+}
+
+void tst_QJsonStreamReader::errors()
+{
+    QFETCH(QByteArray, json);
+
+    QJsonParseError expected;
+    QVERIFY(QJsonDocument::fromJson(json, &expected).isNull());
+
+    QJsonStreamReader reader(json);
+    const QJsonValue value = reader.readValue();
+    if (expected.error == QJsonParseError::GarbageAtEnd) {
+        // the first top-level value is complete
+        QVERIFY(value.isArray());
+    } else {
+        QVERIFY(value.isUndefined());
+    }
+    QCOMPARE(reader.lastError().error, expected.error);
+    QVERIFY(!reader.hasNext());
+}
+
+void tst_QJsonStreamReader::topLevelSequence()
+{
+    QJsonStreamReader reader(QByteArray("{\"a\":1}\n{\"a\":2}\n\"s\" 3 [4]\n"));
+    QCOMPARE(reader.readValue().toObject().value(QLatin1String("a")), QJsonValue(1));
+    QCOMPARE(reader.readValue().toObject().value(QLatin1String("a")), QJsonValue(2));
+    QCOMPARE(reader.readValue(), QJsonValue(QLatin1String("s")));
+    QCOMPARE(reader.readValue(), QJsonValue(3));
+    QCOMPARE(reader.readValue(), QJsonValue(QJsonArray { 4 }));
+    QVERIFY(!reader.hasNext());
+    QCOMPARE(reader.lastError().error, QJsonParseError::NoError);
+}
+
+void tst_QJsonStreamReader::device()
+{
+    // large enough to need several reads from the device
+    QByteArray json = "[";
+    const int count = 100000;
+    for (int i = 0; i < count; ++i) {
+        if (i)
+            json += ",\n";
+        json += "{\"id\": " + QByteArray::number(i) + ", \"name\": \"item "
+                + QByteArray::number(i) + "\"}";
+    }
+    json += "]";
+
+    QBuffer buffer(&json);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QJsonStreamReader reader(&buffer);
+    QCOMPARE(reader.device(), &buffer);
+    QVERIFY(reader.enterContainer());
+    int i = 0;
+    qint64 lastOffset = 0;
+    while (reader.hasNext()) {
+        QVERIFY(reader.currentOffset() > lastOffset);
+        lastOffset = reader.currentOffset();
+        QCOMPARE(json.at(lastOffset), '{');
+        const QJsonObject object = reader.readValue().toObject();
+        QCOMPARE(object.value(QLatin1String("id")).toInt(), i);
+        QCOMPARE(object.value(QLatin1String("name")).toString(), QLatin1String("item ") + QString::number(i));
+        ++i;
+    }
+    QCOMPARE(i, count);
+    QVERIFY(reader.leaveContainer());
+    QCOMPARE(reader.lastError().error, QJsonParseError::NoError);
+    QVERIFY(buffer.atEnd());
+}
+
+void tst_QJsonStreamReader::incremental()
+{
+    const QByteArray json = "[1, \"abc\\n\", true, [null, -12.5e1], 23]";
+    QJsonStreamReader reader;
+    qsizetype fed = 0;
+    auto feed = [&]() {
+        if (fed == json.size())
+            return false;
+        reader.addData(json.mid(fed++, 1));
+        reader.reparse();
+        return true;
+    };
+
+    QStringList events;
+    while (!reader.isArray())
+        QVERIFY(feed());
+    QVERIFY(reader.enterContainer());
+    while (reader.containerDepth()) {
+        if (reader.hasNext()) {
+            switch (reader.type()) {
+            case QJsonValue::Double:
+                events << QString::number(reader.toDouble());
+                reader.next();
+                break;
+            case QJsonValue::String:
+                events << reader.readString();
+                break;
+            case QJsonValue::Array:
+                events << QStringLiteral("[");
+                reader.enterContainer();
+                break;
+            default:
+                events << QString::number(reader.type());
+                reader.next();
+                break;
+            }
+        } else if (reader.lastError().error != QJsonParseError::NoError) {
+            QVERIFY2(feed(), qPrintable(reader.lastError().errorString()));
+        } else if (!reader.leaveContainer()) {
+            // the closing bracket is there, but not the next separator
+            QVERIFY(feed());
+        } else {
+            events << QStringLiteral("]");
+        }
+    }
+
+    QCOMPARE(events, QStringList({ "1", "abc\n", QString::number(QJsonValue::Bool), "[",
+                                   QString::number(QJsonValue::Null), "-125", "]", "23", "]" }));
+    QCOMPARE(reader.lastError().error, QJsonParseError::NoError);
+    QCOMPARE(fed, json.size());
+}
+
+QTEST_MAIN(tst_QJsonStreamReader)
+#include "tst_qjsonstreamreader.moc"
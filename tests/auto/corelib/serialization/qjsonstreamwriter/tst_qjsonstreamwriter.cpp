@@ -0,0 +1,289 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QTest>
+#include <QBuffer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonStreamReader>
+#include <QJsonStreamWriter>
+
+class tst_QJsonStreamWriter : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void scalars_data();
+    void scalars();
+    void sameAsToJson_data();
+    void sameAsToJson();
+    void topLevelSequence();
+    void mismatchedContainers();
+    void device();
+    void roundTrip();
+};
+
+void tst_QJsonStreamWriter::scalars_data()
+{
+    QTest::addColumn<QJsonValue>("value");
+    QTest::addColumn<QByteArray>("expected");
+
+    QTest::newRow("null") << QJsonValue() << QByteArray("null");
+    QTest::newRow("true") << QJsonValue(true) << QByteArray("true");
+    QTest::newRow("false") << QJsonValue(false) << QByteArray("false");
+    QTest::newRow("integer") << QJsonValue(-42) << QByteArray("-42");
+    QTest::newRow("double") << QJsonValue(0.5) << QByteArray("0.5");
+    QTest::newRow("inf") << QJsonValue(qInf()) << QByteArray("null");
+    QTest::newRow("string") << QJsonValue(QStringLiteral("a\"b\\c\n\x01"))
+                            << QByteArray("\"a\\\"b\\\\c\\n\\u0001\"");
+    QTest::newRow("utf8") << QJsonValue(QString::fromUtf8("S\xc3\xa3o"))
+                          << QByteArray("\"S\xc3\xa3o\"");
+}
+
+void tst_QJsonStreamWriter::scalars()
+{
+    QFETCH(QJsonValue, value);
+    QFETCH(QByteArray, expected);
+
+    QByteArray output;
+    {
+        QJsonStreamWriter writer(&output, QJsonDocument::Compact);
+        writer.append(value);
+    }
+    QCOMPARE(output, expected);
+
+    // the type-specific overloads
+    output.clear();
+    {
+        QJsonStreamWriter writer(&output, QJsonDocument::Compact);
+        switch (value.type()) {
+        case QJsonValue::Null:
+            writer.appendNull();
+            break;
+        case QJsonValue::Bool:
+            writer.append(value.toBool());
+            break;
+        case QJsonValue::Double:
+            if (value.toInteger(-1) == -42)
+                writer.append(value.toInteger());
+            else
+                writer.append(value.toDouble());
+            break;
+        case QJsonValue::String:
+            writer.append(value.toString());
+            break;
+        default:
+            QFAIL("unexpected type");
+        }
+    }
+    QCOMPARE(output, expected);
+}
+
+static void writeValue(QJsonStreamWriter &writer, const QJsonValue &value)
+{
+    if (value.isArray()) {
+        writer.startArray();
+        const QJsonArray array = value.toArray();
+        for (const QJsonValue &element : array)
+            writeValue(writer, element);
+        QVERIFY(writer.endArray());
+    } else if (value.isObject()) {
+        writer.startObject();
+        const QJsonObject object = value.toObject();
+        for (auto it = object.begin(); it != object.end(); ++it) {
+            writer.append(it.key());
+            writeValue(writer, it.value());
+        }
+        QVERIFY(writer.endObject());
+    } else {
+        writer.append(value);
+    }
+}
+
+void tst_QJsonStreamWriter::sameAsToJson_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<bool>("compact");
+
+    const QByteArray documents[] = {
+        "[]",
+        "{}",
+        "[[], {}, [[]], {\"a\": {}}]",
+        "{\"a\": 1, \"b\": [true, false, null, 0.25, \"x\"], \"c\": {\"d\": [{\"e\": []}]}}",
+        "[\"\\u00e9\\n\", -1e300, 12345678901234, {\"k\\\"ey\": \"v\"}]",
+    };
+    for (const QByteArray &json : documents) {
+        QTest::addRow("compact:%s", json.constData()) << json << true;
+        QTest::addRow("indented:%s", json.constData()) << json << false;
+    }
+}
+
+void tst_QJsonStreamWriter::sameAsToJson()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(bool, compact);
+    const auto format = compact ? QJsonDocument::Compact : QJsonDocument::Indented;
+
+    const QJsonDocument doc = QJsonDocument::fromJson(json);
+    QVERIFY(!doc.isNull());
+    const QJsonValue value = doc.isArray() ? QJsonValue(doc.array()) : QJsonValue(doc.object());
+
+    QByteArray streamed;
+    {
+        QJsonStreamWriter writer(&streamed, format);
+        QCOMPARE(writer.format(), format);
+        writeValue(writer, value);
+    }
+    QCOMPARE(streamed, doc.toJson(format));
+
+    // whole values, at the top level and nested
+    QByteArray appended;
+    {
+        QJsonStreamWriter writer(&appended, format);
+        writer.append(value);
+    }
+    QCOMPARE(appended, doc.toJson(format));
+
+    QByteArray nested;
+    {
+        QJsonStreamWriter writer(&nested, format);
+        writer.startArray();
+        writer.append(value);
+        writer.startObject();
+        writer.append(QLatin1String("key"));
+        writer.append(value);
+        writer.endObject();
+        writer.endArray();
+    }
+    const QJsonArray wrapper { value, QJsonObject { { QLatin1String("key"), value } } };
+    QCOMPARE(nested, QJsonDocument(wrapper).toJson(format));
+}
+
+void tst_QJsonStreamWriter::topLevelSequence()
+{
+    QByteArray output;
+    {
+        QJsonStreamWriter writer(&output, QJsonDocument::Compact);
+        for (int i = 0; i < 3; ++i) {
+            writer.startObject();
+            writer.append("id");
+            writer.append(i);
+            writer.endObject();
+        }
+        writer.append(true);
+    }
+    QCOMPARE(output, QByteArray("{\"id\":0}\n{\"id\":1}\n{\"id\":2}\ntrue"));
+
+    output.clear();
+    {
+        QJsonStreamWriter writer(&output);
+        writer.startArray();
+        writer.endArray();
+        writer.append(1);
+        writer.append(2);
+    }
+    QCOMPARE(output, QByteArray("[\n]\n1\n2"));
+}
+
+void tst_QJsonStreamWriter::mismatchedContainers()
+{
+    QByteArray output;
+    QJsonStreamWriter writer(&output, QJsonDocument::Compact);
+    QVERIFY(!writer.endArray());
+    QVERIFY(!writer.endObject());
+
+    writer.startArray();
+    QVERIFY(!writer.endObject());
+    writer.startObject();
+    writer.append("key");
+    QVERIFY(!writer.endObject());   // no value for the key
+    writer.append(1);
+    QVERIFY(!writer.endArray());
+    QVERIFY(writer.endObject());
+    QVERIFY(writer.endArray());
+    QCOMPARE(output, QByteArray("[{\"key\":1}]"));
+}
+
+void tst_QJsonStreamWriter::device()
+{
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QJsonStreamWriter writer(&buffer, QJsonDocument::Compact);
+    QCOMPARE(writer.device(), &buffer);
+
+    // everything is written as soon as it is appended
+    writer.startArray();
+    QCOMPARE(buffer.data(), QByteArray("["));
+    writer.append(QLatin1String("a"));
+    QCOMPARE(buffer.data(), QByteArray("[\"a\""));
+    writer.endArray();
+    QCOMPARE(buffer.data(), QByteArray("[\"a\"]"));
+
+    QBuffer other;
+    QVERIFY(other.open(QIODevice::WriteOnly));
+    writer.setDevice(&other);
+    writer.appendNull();
+    QCOMPARE(other.data(), QByteArray("\nnull"));
+}
+
+void tst_QJsonStreamWriter::roundTrip()
+{
+    QByteArray json;
+    const int count = 10000;
+    {
+        QJsonStreamWriter writer(&json);
+        writer.startArray();
+        for (int i = 0; i < count; ++i) {
+            writer.startObject();
+            writer.append(QLatin1String("id"));
+            writer.append(i);
+            writer.append(QLatin1String("text"));
+            writer.append(QString::number(i) + QChar(0xe9) + QLatin1Char('"'));
+            writer.endObject();
+        }
+        writer.endArray();
+    }
+
+    QJsonStreamReader reader(json);
+    QVERIFY(reader.enterContainer());
+    int i = 0;
+    while (reader.hasNext()) {
+        const QJsonObject object = reader.readValue().toObject();
+        QCOMPARE(object.value(QLatin1String("id")).toInt(), i);
+        QCOMPARE(object.value(QLatin1String("text")).toString(),
+                 QString::number(i) + QChar(0xe9) + QLatin1Char('"'));
+        ++i;
+    }
+    QCOMPARE(i, count);
+    QVERIFY(reader.leaveContainer());
+    QCOMPARE(reader.lastError().error, QJsonParseError::NoError);
+}
+
+QTEST_MAIN(tst_QJsonStreamWriter)
+#include "tst_qjsonstreamwriter.moc"
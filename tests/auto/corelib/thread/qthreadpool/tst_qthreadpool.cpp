@@ -100,6 +100,10 @@ private slots:
     void clear();
     void clearWithAutoDelete();
     void tryTake();
+    void tryTakeLocalTask();
+    void clearLocalTasks();
+    void stealLocalTasks_data();
+    void stealLocalTasks();
     void waitForDoneTimeout();
     void destroyingWaitsForTasksToFinish();
     void stackSize();
@@ -1153,6 +1157,136 @@ void tst_QThreadPool::tryTake()
     delete runnables[0]; // if the pool deletes them then we'll get double-free crash
 }
 
+// A task running in the pool that starts tasks of the default priority
+// while all threads are busy queues them on its own thread. The first one
+// still goes through the pool's queue, which is how the pool learns that
+// all threads are busy.
+
+void tst_QThreadPool::tryTakeLocalTask()
+{
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(1);
+    QSemaphore queued, proceed;
+    const QSemaphoreReleaser releaser(proceed);
+    QAtomicInt runCounter;
+    QRunnable *queuedTask = QRunnable::create([&runCounter] { runCounter.ref(); });
+    QRunnable *localTask = QRunnable::create([&runCounter] { runCounter.ref(); });
+
+    threadPool.start([&] {
+        threadPool.start(queuedTask);
+        threadPool.start(localTask);
+        queued.release();
+        proceed.acquire();
+    });
+    QVERIFY(queued.tryAcquire(1, 60 * 1000));
+
+    QVERIFY(threadPool.tryTake(localTask));
+    QVERIFY(!threadPool.tryTake(localTask));
+    delete localTask;
+    QVERIFY(threadPool.tryTake(queuedTask));
+    delete queuedTask;
+
+    proceed.release();
+    QVERIFY(threadPool.waitForDone());
+    QCOMPARE(runCounter.loadRelaxed(), 0);
+}
+
+void tst_QThreadPool::clearLocalTasks()
+{
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(1);
+    QSemaphore queued, proceed;
+    const QSemaphoreReleaser releaser(proceed);
+    QAtomicInt runCounter;
+
+    threadPool.start([&] {
+        for (int i = 0; i < 10; ++i)
+            threadPool.start([&runCounter] { runCounter.ref(); });
+        queued.release();
+        proceed.acquire();
+    });
+    QVERIFY(queued.tryAcquire(1, 60 * 1000));
+
+    threadPool.clear();
+    proceed.release();
+    QVERIFY(threadPool.waitForDone());
+    QCOMPARE(runCounter.loadRelaxed(), 0);
+
+    // the pool is still usable afterwards
+    threadPool.start([&] {
+        for (int i = 0; i < 10; ++i)
+            threadPool.start([&runCounter] { runCounter.ref(); });
+    });
+    QVERIFY(threadPool.waitForDone());
+    QCOMPARE(runCounter.loadRelaxed(), 10);
+}
+
+void tst_QThreadPool::stealLocalTasks_data()
+{
+    QTest::addColumn<bool>("useTryStart");
+    QTest::newRow("start") << false;
+    QTest::newRow("tryStart") << true;
+}
+
+void tst_QThreadPool::stealLocalTasks()
+{
+    QFETCH(bool, useTryStart);
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(2);
+    QSemaphore blockerStarted, releaseBlocker, localTasksDone;
+    const QSemaphoreReleaser releaser(releaseBlocker);
+    // tryStart() queues one task per thread, start() as many as it is given
+    const int localTaskCount = useTryStart ? 1 : 10;
+
+    QThread *queuingThread = nullptr;
+    bool acceptedAll = true;
+    bool refusedExtra = true;
+    bool stolen = false;
+    QMutex mutex;
+    QSet<QThread *> runningThreads;
+
+    threadPool.start([&] {
+        queuingThread = QThread::currentThread();
+        // keep the other thread busy
+        threadPool.start([&] {
+            blockerStarted.release();
+            releaseBlocker.acquire();
+        });
+        blockerStarted.acquire();
+        // goes to the pool's queue, which tells the pool that all threads are busy
+        threadPool.start([] {});
+
+        const auto localTask = [&] {
+            {
+                QMutexLocker locker(&mutex);
+                runningThreads.insert(QThread::currentThread());
+            }
+            localTasksDone.release();
+        };
+        for (int i = 0; i < localTaskCount; ++i) {
+            if (useTryStart)
+                acceptedAll = acceptedAll && threadPool.tryStart(localTask);
+            else
+                threadPool.start(localTask);
+        }
+        if (useTryStart)
+            refusedExtra = !threadPool.tryStart(localTask);
+
+        // this thread stays busy until its tasks ran, so another one has to
+        // steal them
+        releaseBlocker.release();
+        stolen = localTasksDone.tryAcquire(localTaskCount, 60 * 1000);
+    });
+    QVERIFY(threadPool.waitForDone());
+
+    QVERIFY(acceptedAll);
+    QVERIFY(refusedExtra);
+    QVERIFY(stolen);
+    QCOMPARE(runningThreads.size(), 1);
+    QVERIFY(!runningThreads.contains(queuingThread));
+}
+
 void tst_QThreadPool::destroyingWaitsForTasksToFinish()
 {
     QElapsedTimer total, pass;
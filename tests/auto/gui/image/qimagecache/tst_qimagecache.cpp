@@ -0,0 +1,232 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QTest>
+
+#include <QImageCache>
+#include <QAtomicInt>
+#include <QThread>
+
+#include <memory>
+#include <vector>
+
+class tst_QImageCache : public QObject
+{
+    Q_OBJECT
+
+public slots:
+    void init();
+    void cleanupTestCase();
+
+private slots:
+    void cacheLimit();
+    void insertAndFind();
+    void remove();
+    void clear();
+    void statistics();
+    void eviction();
+    void largeImages();
+    void changeLimitKeepsImages();
+    void concurrentAccess();
+};
+
+static QImage filledImage(int size, QRgb color)
+{
+    QImage image(size, size, QImage::Format_ARGB32);
+    image.fill(color);
+    return image;
+}
+
+void tst_QImageCache::init()
+{
+    QImageCache::setCacheLimit(10240);
+    QImageCache::clear();
+    QImageCache::resetStatistics();
+}
+
+void tst_QImageCache::cleanupTestCase()
+{
+    QImageCache::clear();
+}
+
+void tst_QImageCache::cacheLimit()
+{
+    QCOMPARE(QImageCache::cacheLimit(), 10240);
+    QImageCache::setCacheLimit(100);
+    QCOMPARE(QImageCache::cacheLimit(), 100);
+    QImageCache::setCacheLimit(-1);
+    QCOMPARE(QImageCache::cacheLimit(), 0);
+    QVERIFY(!QImageCache::insert(QStringLiteral("image"), filledImage(16, Qt::red)));
+}
+
+void tst_QImageCache::insertAndFind()
+{
+    QImage image;
+    QVERIFY(!QImageCache::find(QStringLiteral("image"), &image));
+    QVERIFY(image.isNull());
+
+    QVERIFY(!QImageCache::insert(QStringLiteral("null"), QImage()));
+
+    const QImage red = filledImage(16, qRgb(255, 0, 0));
+    QVERIFY(QImageCache::insert(QStringLiteral("image"), red));
+    QVERIFY(QImageCache::find(QStringLiteral("image"), &image));
+    QCOMPARE(image, red);
+    QVERIFY(QImageCache::find(QStringLiteral("image"), nullptr));
+
+    // equal keys replace the previous image
+    const QImage blue = filledImage(16, qRgb(0, 0, 255));
+    QVERIFY(QImageCache::insert(QStringLiteral("image"), blue));
+    QVERIFY(QImageCache::find(QStringLiteral("image"), &image));
+    QCOMPARE(image, blue);
+
+    // images larger than the cache are not kept
+    QImageCache::setCacheLimit(16);
+    QVERIFY(!QImageCache::insert(QStringLiteral("large"), filledImage(128, qRgb(0, 255, 0))));
+    QVERIFY(!QImageCache::find(QStringLiteral("large"), nullptr));
+}
+
+void tst_QImageCache::remove()
+{
+    QVERIFY(QImageCache::insert(QStringLiteral("a"), filledImage(16, qRgb(255, 0, 0))));
+    QVERIFY(QImageCache::insert(QStringLiteral("b"), filledImage(16, qRgb(0, 255, 0))));
+    QImageCache::remove(QStringLiteral("a"));
+    QVERIFY(!QImageCache::find(QStringLiteral("a"), nullptr));
+    QVERIFY(QImageCache::find(QStringLiteral("b"), nullptr));
+    QImageCache::remove(QStringLiteral("unknown"));
+}
+
+void tst_QImageCache::clear()
+{
+    for (int i = 0; i < 100; ++i)
+        QVERIFY(QImageCache::insert(QString::number(i), filledImage(8, qRgb(i, i, i))));
+    QImageCache::clear();
+    for (int i = 0; i < 100; ++i)
+        QVERIFY(!QImageCache::find(QString::number(i), nullptr));
+}
+
+void tst_QImageCache::statistics()
+{
+    QCOMPARE(QImageCache::hitCount(), qint64(0));
+    QCOMPARE(QImageCache::missCount(), qint64(0));
+
+    QVERIFY(QImageCache::insert(QStringLiteral("image"), filledImage(16, qRgb(255, 0, 0))));
+    QVERIFY(QImageCache::find(QStringLiteral("image"), nullptr));
+    QVERIFY(QImageCache::find(QStringLiteral("image"), nullptr));
+    QVERIFY(!QImageCache::find(QStringLiteral("other"), nullptr));
+    QCOMPARE(QImageCache::hitCount(), qint64(2));
+    QCOMPARE(QImageCache::missCount(), qint64(1));
+
+    QImageCache::resetStatistics();
+    QCOMPARE(QImageCache::hitCount(), qint64(0));
+    QCOMPARE(QImageCache::missCount(), qint64(0));
+}
+
+void tst_QImageCache::eviction()
+{
+    // 64x64 ARGB32 images cost 16 KB each
+    const int count = 1000;
+    const QImage image = filledImage(64, qRgb(255, 0, 0));
+    for (int i = 0; i < count; ++i)
+        QVERIFY(QImageCache::insert(QString::number(i), image));
+
+    int found = 0;
+    for (int i = 0; i < count; ++i) {
+        if (QImageCache::find(QString::number(i), nullptr))
+            ++found;
+    }
+    QVERIFY(found > 0);
+    QVERIFY(found <= QImageCache::cacheLimit() / 16);
+
+    // the most recently inserted image is still there
+    QVERIFY(QImageCache::find(QString::number(count - 1), nullptr));
+}
+
+void tst_QImageCache::largeImages()
+{
+    // a 1024x1024 ARGB32 image costs 4096 KB, which is more than a
+    // sixteenth of the default limit
+    const QImage image = filledImage(1024, qRgb(0, 255, 0));
+    QVERIFY(QImageCache::insert(QStringLiteral("large"), image));
+    QVERIFY(QImageCache::find(QStringLiteral("large"), nullptr));
+
+    // small caches are not partitioned, so an image can use all of it
+    QImageCache::setCacheLimit(4096);
+    QVERIFY(QImageCache::insert(QStringLiteral("large"), image));
+    QVERIFY(QImageCache::find(QStringLiteral("large"), nullptr));
+}
+
+void tst_QImageCache::changeLimitKeepsImages()
+{
+    const QImage image = filledImage(16, qRgb(0, 0, 255));
+    for (int i = 0; i < 100; ++i)
+        QVERIFY(QImageCache::insert(QString::number(i), image));
+
+    // changing the number of partitions moves the images to their new ones
+    for (int limit : { 1024, 65536, 10240 }) {
+        QImageCache::setCacheLimit(limit);
+        for (int i = 0; i < 100; ++i)
+            QVERIFY(QImageCache::find(QString::number(i), nullptr));
+    }
+}
+
+void tst_QImageCache::concurrentAccess()
+{
+    const int threadCount = 8;
+    const int iterations = 2000;
+    QAtomicInt mismatches = 0;
+    std::vector<std::unique_ptr<QThread>> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back(QThread::create([t, &mismatches] {
+            for (int i = 0; i < iterations; ++i) {
+                const QString key = QString::number(i % 100);
+                QImage image;
+                if (!QImageCache::find(key, &image)) {
+                    image = filledImage(16, qRgb(i % 100, 0, 0));
+                    QImageCache::insert(key, image);
+                }
+                if (image.pixel(0, 0) != qRgb(i % 100, 0, 0))
+                    mismatches.ref();
+                if (i % 50 == t)
+                    QImageCache::remove(key);
+                // repartitions the cache while other threads use it
+                if (t == 0 && i % 500 == 0)
+                    QImageCache::setCacheLimit(i % 1000 ? 65536 : 10240);
+            }
+        }));
+        threads.back()->start();
+    }
+    for (const auto &thread : threads)
+        QVERIFY(thread->wait());
+
+    QCOMPARE(mismatches.loadRelaxed(), 0);
+    QCOMPARE(QImageCache::hitCount() + QImageCache::missCount(), qint64(threadCount) * iterations);
+    QVERIFY(QImageCache::hitCount() > 0);
+}
+
+QTEST_MAIN(tst_QImageCache)
+#include "tst_qimagecache.moc"
@@ -35,6 +35,7 @@
 
 #include <QtCore/qbytearray.h>
 
+#include <algorithm>
 #include <cstdlib>
 #include <vector>
 #include <string>
@@ -54,6 +55,7 @@ private Q_SLOTS:
     void bitstreamWrite();
     void bitstreamReadWrite();
     void bitstreamCompression();
+    void bitstreamHuffman();
     void bitstreamErrors();
 
     void lookupTableConstructor();
@@ -318,6 +320,44 @@ void tst_Hpack::bitstreamCompression()
     }
 }
 
+void tst_Hpack::bitstreamHuffman()
+{
+    // Huffman codes are 5 to 30 bits long, the decoder takes
+    // the short ones several at a time. Mix all of them.
+    std::vector<QByteArray> strings;
+    QByteArray allBytes;
+    for (int i = 0; i < 256; ++i)
+        allBytes.append(char(i));
+    strings.push_back(allBytes);
+    std::reverse(allBytes.begin(), allBytes.end());
+    strings.push_back(allBytes);
+    strings.push_back(QByteArray("text/html,application/xhtml+xml,application/xml;q=0.9"));
+
+    for (int i = 0; i < 1000; ++i) {
+        QByteArray data(QRandomGenerator::global()->bounded(64), Qt::Uninitialized);
+        for (char &c : data) {
+            // Mostly ASCII (short codes), with some bytes having long codes:
+            c = QRandomGenerator::global()->bounded(10) ? char(QRandomGenerator::global()->bounded(32, 127))
+                                                        : char(QRandomGenerator::global()->bounded(256));
+        }
+        strings.push_back(data);
+    }
+
+    std::vector<uchar> buffer;
+    BitOStream out(buffer);
+    for (const QByteArray &data : strings)
+        out.write(data, true);
+
+    BitIStream in(out.begin(), out.end());
+    for (const QByteArray &data : strings) {
+        QByteArray decoded;
+        QVERIFY(in.read(&decoded));
+        QCOMPARE(in.error(), StreamError::NoError);
+        QCOMPARE(decoded, data);
+    }
+    QVERIFY(!in.hasMoreBits());
+}
+
 void tst_Hpack::bitstreamErrors()
 {
     {
@@ -397,8 +437,24 @@ void tst_Hpack::lookupTableStatic()
         QVERIFY(table.field(index, &name, &value));
         QCOMPARE(name, field.name);
         QCOMPARE(value, field.value);
+        // A name-only lookup finds the first field with this name:
+        const quint32 nameIndex = table.indexOf(field.name);
+        QVERIFY(nameIndex != 0 && nameIndex <= index);
+        QVERIFY(table.field(nameIndex, &name, &value));
+        QCOMPARE(name, field.name);
+        if (nameIndex > 1) {
+            QVERIFY(table.field(nameIndex - 1, &name, &value));
+            QVERIFY(name != field.name);
+        }
         ++currentIndex;
     }
+
+    QCOMPARE(table.indexOf("accept"), 19u);
+    // Misses fall through to the (empty) dynamic part:
+    const FieldLookupTable indexed(0, true);
+    QCOMPARE(indexed.indexOf(":method", "PUT"), 0u);
+    QCOMPARE(indexed.indexOf("accept", "text/html"), 0u);
+    QCOMPARE(indexed.indexOf("x-custom-header"), 0u);
 }
 
 void tst_Hpack::lookupTableDynamic()
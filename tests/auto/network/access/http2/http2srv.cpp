@@ -159,6 +159,17 @@ QByteArray Http2Server::requestAuthorizationHeader()
     return authentication == requestHeaders.cend() ? QByteArray() : authentication->value;
 }
 
+QByteArray Http2Server::requestPriorityHeader()
+{
+    const auto isPriorityHeader = [](const HeaderField &field) {
+        return field.name == "priority";
+    };
+    const auto requestHeaders = decoder.decodedHeader();
+    const auto priority =
+            std::find_if(requestHeaders.cbegin(), requestHeaders.cend(), isPriorityHeader);
+    return priority == requestHeaders.cend() ? QByteArray() : priority->value;
+}
+
 void Http2Server::startServer()
 {
     if (listen()) {
@@ -637,7 +648,7 @@ void Http2Server::handleIncomingFrame()
         // TODO: this is not tested for now.
         break;
     case FrameType::PING:
-        // TODO: this is not tested for now.
+        handlePING();
         break;
     case FrameType::GOAWAY:
         // TODO: this is not tested for now.
@@ -788,10 +799,23 @@ void Http2Server::handleWINDOW_UPDATE()
         return;
     }
 
-    emit windowUpdate(streamID);
+    emit windowUpdate(streamID, delta);
     sendDATA(streamID, delta);
 }
 
+void Http2Server::handlePING()
+{
+    Q_ASSERT(inboundFrame.type() == FrameType::PING);
+
+    if (inboundFrame.flags().testFlag(FrameFlag::ACK)) // We never send PINGs.
+        return;
+
+    emit receivedPING();
+    writer.start(FrameType::PING, FrameFlag::ACK, connectionStreamID);
+    writer.append(inboundFrame.dataBegin(), inboundFrame.dataBegin() + 8);
+    writer.write(*socket);
+}
+
 void Http2Server::sendResponse(quint32 streamID, bool emptyBody)
 {
     Q_ASSERT(activeRequests.find(streamID) != activeRequests.end());
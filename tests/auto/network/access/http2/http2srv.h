@@ -96,6 +96,7 @@ public:
     bool isClearText() const;
 
     QByteArray requestAuthorizationHeader();
+    QByteArray requestPriorityHeader();
 
     // Invokables, since we can call them from the main thread,
     // but server (can) work on its own thread.
@@ -114,6 +115,7 @@ public:
     Q_INVOKABLE void handleSETTINGS();
     Q_INVOKABLE void handleDATA();
     Q_INVOKABLE void handleWINDOW_UPDATE();
+    Q_INVOKABLE void handlePING();
 
     Q_INVOKABLE void sendResponse(quint32 streamID, bool emptyBody);
 
@@ -135,7 +137,8 @@ Q_SIGNALS:
     void receivedData(quint32 streamID);
     // Emitted for every DATA frame. Includes the content of the frame as \a body.
     void receivedDATAFrame(quint32 streamID, const QByteArray &body);
-    void windowUpdate(quint32 streamID);
+    void windowUpdate(quint32 streamID, quint32 delta);
+    void receivedPING();
     void sendingData();
 
 private slots:
@@ -59,6 +59,7 @@
 
 Q_DECLARE_METATYPE(H2Type)
 Q_DECLARE_METATYPE(QNetworkRequest::Attribute)
+Q_DECLARE_METATYPE(QNetworkRequest::Priority)
 
 QT_BEGIN_NAMESPACE
 
@@ -112,6 +113,11 @@ private slots:
     void authenticationRequired_data();
     void authenticationRequired();
 
+    void requestPriority_data();
+    void requestPriority();
+
+    void receiveWindowAutoTuning();
+
 protected slots:
     // Slots to listen to our in-process server:
     void serverStarted(quint16 port);
@@ -1073,6 +1079,125 @@ void tst_Http2::authenticationRequired()
     QTRY_VERIFY(serverGotSettingsACK);
 }
 
+void tst_Http2::requestPriority_data()
+{
+    QTest::addColumn<QNetworkRequest::Priority>("priority");
+    QTest::addColumn<QVariant>("urgency");
+    QTest::addColumn<bool>("incremental");
+    QTest::addColumn<QByteArray>("expectedHeader");
+
+    QTest::addRow("default") << QNetworkRequest::NormalPriority << QVariant() << false
+                             << QByteArray();
+    QTest::addRow("high-priority") << QNetworkRequest::HighPriority << QVariant() << false
+                                   << QByteArray("u=1");
+    QTest::addRow("low-priority") << QNetworkRequest::LowPriority << QVariant() << false
+                                  << QByteArray("u=5");
+    QTest::addRow("urgency") << QNetworkRequest::LowPriority << QVariant(0) << false
+                             << QByteArray("u=0");
+    QTest::addRow("default-urgency") << QNetworkRequest::HighPriority << QVariant(3) << false
+                                     << QByteArray();
+    QTest::addRow("incremental") << QNetworkRequest::NormalPriority << QVariant() << true
+                                 << QByteArray("i");
+    QTest::addRow("urgency-incremental") << QNetworkRequest::NormalPriority << QVariant(6) << true
+                                         << QByteArray("u=6, i");
+}
+
+void tst_Http2::requestPriority()
+{
+    clearHTTP2State();
+    serverPort = 0;
+    nRequests = 1;
+
+    ServerPtr srv(newServer(defaultServerSettings, H2Type::h2cDirect));
+    QMetaObject::invokeMethod(srv.data(), "startServer", Qt::QueuedConnection);
+    runEventLoop();
+
+    QVERIFY(serverPort != 0);
+
+    auto url = requestUrl(H2Type::h2cDirect);
+    url.setPath("/index.html");
+
+    QFETCH(const QNetworkRequest::Priority, priority);
+    QFETCH(const QVariant, urgency);
+    QFETCH(const bool, incremental);
+
+    QNetworkRequest request(url);
+    request.setAttribute(QNetworkRequest::Http2DirectAttribute, true);
+    request.setPriority(priority);
+    if (urgency.isValid())
+        request.setAttribute(QNetworkRequest::HttpPriorityUrgencyAttribute, urgency);
+    request.setAttribute(QNetworkRequest::HttpPriorityIncrementalAttribute, incremental);
+
+    auto reply = manager->get(request);
+    connect(reply, &QNetworkReply::finished, this, &tst_Http2::replyFinished);
+
+    runEventLoop();
+    STOP_ON_FAILURE
+
+    QVERIFY(nRequests == 0);
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+
+    QFETCH(const QByteArray, expectedHeader);
+    QCOMPARE(srv->requestPriorityHeader(), expectedHeader);
+}
+
+void tst_Http2::receiveWindowAutoTuning()
+{
+    // The receive windows are small compared to the response. The client
+    // measures the bandwidth-delay product with PING frames, and has to
+    // grow its stream window beyond the initial one.
+    using namespace Http2;
+
+    clearHTTP2State();
+    serverPort = 0;
+    nRequests = 1;
+
+    QHttp2Configuration params;
+    params.setSessionReceiveWindowSize(Http2::defaultSessionWindowSize * 50);
+    params.setStreamReceiveWindowSize(Http2::defaultSessionWindowSize);
+    params.setReceiveWindowAutoTuningEnabled(true);
+
+    ServerPtr srv(newServer(defaultServerSettings, H2Type::h2cDirect,
+                            qt_H2ConfigurationToSettings(params)));
+    const QByteArray respond(int(Http2::defaultSessionWindowSize * 100), 'x');
+    srv->setResponseBody(respond);
+
+    int pings = 0;
+    connect(srv.data(), &Http2Server::receivedPING, this, [&pings]() { ++pings; });
+    quint32 largestWindowUpdate = 0;
+    connect(srv.data(), &Http2Server::windowUpdate, this,
+            [&largestWindowUpdate](quint32 streamID, quint32 delta) {
+        if (streamID != connectionStreamID)
+            largestWindowUpdate = std::max(largestWindowUpdate, delta);
+    });
+
+    QMetaObject::invokeMethod(srv.data(), "startServer", Qt::QueuedConnection);
+    runEventLoop();
+
+    QVERIFY(serverPort != 0);
+
+    auto url = requestUrl(H2Type::h2cDirect);
+    url.setPath("/index.html");
+
+    QNetworkRequest request(url);
+    request.setAttribute(QNetworkRequest::Http2DirectAttribute, true);
+    request.setHttp2Configuration(params);
+
+    auto reply = manager->get(request);
+    connect(reply, &QNetworkReply::finished, this, &tst_Http2::replyFinished);
+
+    runEventLoop(120000);
+    STOP_ON_FAILURE
+
+    QVERIFY(nRequests == 0);
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QCOMPARE(reply->readAll(), respond);
+    QTRY_VERIFY(pings > 0);
+    // A WINDOW_UPDATE never exceeds the window it replenishes:
+    QVERIFY2(largestWindowUpdate > quint32(params.streamReceiveWindowSize()),
+             qPrintable(QString::number(largestWindowUpdate)));
+}
+
 void tst_Http2::serverStarted(quint16 port)
 {
     serverPort = port;
@@ -71,6 +71,7 @@
 #include <QtNetwork/QHttpPart>
 #include <QtNetwork/QHttpMultiPart>
 #include <QtNetwork/QNetworkProxyQuery>
+#include <QtNetwork/QHttp1Configuration>
 #if QT_CONFIG(ssl)
 #include <QtNetwork/qsslerror.h>
 #include <QtNetwork/qsslconfiguration.h>
@@ -387,6 +388,11 @@ private Q_SLOTS:
 
     void httpConnectionCount_data();
     void httpConnectionCount();
+    void http1AdaptiveConnectionCount_data();
+    void http1AdaptiveConnectionCount();
+    void http1MaximumPipelineLength_data();
+    void http1MaximumPipelineLength();
+    void http1IdleTimeout();
 
     void httpReUsingConnectionSequential_data();
     void httpReUsingConnectionSequential();
@@ -6230,6 +6236,226 @@ void tst_QNetworkReply::httpConnectionCount()
     QCOMPARE(pendingConnectionCount, 6);
 }
 
+// Keeps its connections open and answers every request with an empty
+// reply, either right away or once no new requests came in for a while.
+class KeepAliveHttpServer : public QTcpServer
+{
+    Q_OBJECT
+public:
+    int totalConnections = 0;
+    int totalRequests = 0;
+    int maxRequestsInFlight = 0;
+    bool holdResponses = false;
+
+    KeepAliveHttpServer(int batchDelay = 0)
+    {
+        batchTimer.setSingleShot(true);
+        batchTimer.setInterval(batchDelay);
+        connect(&batchTimer, &QTimer::timeout, this, &KeepAliveHttpServer::respond);
+        connect(this, &QTcpServer::newConnection, this, &KeepAliveHttpServer::newConnectionSlot);
+        listen(QHostAddress::LocalHost);
+    }
+
+    QUrl url(const QString &path = QString()) const
+    {
+        return QUrl(QLatin1String("http://127.0.0.1:") + QString::number(serverPort()) + u'/' + path);
+    }
+
+public slots:
+    void respond()
+    {
+        static const QByteArray response = "HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n";
+        for (auto it = clients.begin(); it != clients.end(); ++it) {
+            for (; it->pending > 0; --it->pending)
+                it.key()->write(response);
+        }
+    }
+
+private slots:
+    void newConnectionSlot()
+    {
+        while (QTcpSocket *socket = nextPendingConnection()) {
+            ++totalConnections;
+            socket->setParent(this);
+            clients.insert(socket, Client());
+            connect(socket, &QTcpSocket::readyRead, this, &KeepAliveHttpServer::readyReadSlot);
+            connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+                clients.remove(socket);
+                socket->deleteLater();
+            });
+        }
+    }
+
+    void readyReadSlot()
+    {
+        QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+        Client &client = clients[socket];
+        client.buffer += socket->readAll();
+        qsizetype end;
+        while ((end = client.buffer.indexOf("\r\n\r\n")) != -1) {
+            client.buffer.remove(0, end + 4);
+            ++client.pending;
+            ++totalRequests;
+        }
+        maxRequestsInFlight = qMax(maxRequestsInFlight, client.pending);
+
+        if (holdResponses)
+            return;
+        if (batchTimer.interval() > 0)
+            batchTimer.start();
+        else
+            respond();
+    }
+
+private:
+    struct Client
+    {
+        QByteArray buffer;
+        int pending = 0;
+    };
+    QHash<QTcpSocket *, Client> clients;
+    QTimer batchTimer;
+};
+
+void tst_QNetworkReply::http1AdaptiveConnectionCount_data()
+{
+    QTest::addColumn<bool>("adaptive");
+    QTest::addColumn<int>("connectionsPerHost");
+    QTest::addColumn<int>("requestCount");
+    QTest::addColumn<int>("expectedConnections");
+
+    QTest::addRow("fixed") << false << 12 << 30 << 12;
+    QTest::addRow("fixed-burst") << false << 24 << 10 << 10;
+    // an adaptive pool starts with 6 connections, and only doubles them
+    // while at least as many requests are waiting
+    QTest::addRow("adaptive-burst") << true << 24 << 10 << 6;
+    QTest::addRow("adaptive") << true << 24 << 30 << 24;
+    QTest::addRow("adaptive-limit") << true << 8 << 30 << 8;
+}
+
+void tst_QNetworkReply::http1AdaptiveConnectionCount()
+{
+    QFETCH(bool, adaptive);
+    QFETCH(int, connectionsPerHost);
+    QFETCH(int, requestCount);
+    QFETCH(int, expectedConnections);
+
+    // hold back all responses, so every connection is busy with one request
+    KeepAliveHttpServer server;
+    QVERIFY(server.isListening());
+    server.holdResponses = true;
+
+    QHttp1Configuration config;
+    QVERIFY(config.setNumberOfConnectionsPerHost(connectionsPerHost));
+    config.setAdaptiveConnectionCountEnabled(adaptive);
+
+    QNetworkAccessManager manager;
+    QList<QNetworkReply *> replies;
+    for (int i = 0; i < requestCount; ++i) {
+        QNetworkRequest request(server.url(QString::number(i)));
+        request.setHttp1Configuration(config);
+        request.setAttribute(QNetworkRequest::Http2AllowedAttribute, false);
+        replies << manager.get(request);
+        replies.last()->setParent(&server);
+    }
+
+    QTRY_COMPARE(server.totalRequests, expectedConnections);
+    // give the pool the chance to open more connections than it should
+    QTest::qWait(200);
+    QCOMPARE(server.totalConnections, expectedConnections);
+    QCOMPARE(server.totalRequests, expectedConnections);
+
+    server.holdResponses = false;
+    server.respond();
+    QTRY_VERIFY(std::all_of(replies.cbegin(), replies.cend(),
+                            [](QNetworkReply *reply) { return reply->isFinished(); }));
+    for (QNetworkReply *reply : qAsConst(replies))
+        QCOMPARE(reply->error(), QNetworkReply::NoError);
+    QCOMPARE(server.totalRequests, requestCount);
+    QCOMPARE(server.totalConnections, expectedConnections);
+}
+
+void tst_QNetworkReply::http1MaximumPipelineLength_data()
+{
+    QTest::addColumn<int>("pipelineLength");
+
+    QTest::addRow("1") << 1;
+    QTest::addRow("default") << 3;
+    QTest::addRow("6") << 6;
+}
+
+void tst_QNetworkReply::http1MaximumPipelineLength()
+{
+    QFETCH(int, pipelineLength);
+
+    // answer the requests in batches, so they pile up on the connection
+    KeepAliveHttpServer server(50);
+    QVERIFY(server.isListening());
+
+    QHttp1Configuration config;
+    QVERIFY(config.setNumberOfConnectionsPerHost(1));
+    QVERIFY(config.setMaximumPipelineLength(pipelineLength));
+
+    QNetworkAccessManager manager;
+    const int requestCount = 20;
+    QList<QNetworkReply *> replies;
+    for (int i = 0; i < requestCount; ++i) {
+        QNetworkRequest request(server.url(QString::number(i)));
+        request.setHttp1Configuration(config);
+        request.setAttribute(QNetworkRequest::HttpPipeliningAllowedAttribute, true);
+        request.setAttribute(QNetworkRequest::Http2AllowedAttribute, false);
+        replies << manager.get(request);
+        replies.last()->setParent(&server);
+    }
+
+    QTRY_VERIFY(std::all_of(replies.cbegin(), replies.cend(),
+                            [](QNetworkReply *reply) { return reply->isFinished(); }));
+    bool pipeliningWasUsed = false;
+    for (QNetworkReply *reply : qAsConst(replies)) {
+        QCOMPARE(reply->error(), QNetworkReply::NoError);
+        pipeliningWasUsed |= reply->attribute(QNetworkRequest::HttpPipeliningWasUsedAttribute).toBool();
+    }
+    QVERIFY(pipeliningWasUsed);
+    QCOMPARE(server.totalConnections, 1);
+    QCOMPARE(server.totalRequests, requestCount);
+    // the request being processed plus the pipelined ones
+    QCOMPARE(server.maxRequestsInFlight, pipelineLength + 1);
+}
+
+void tst_QNetworkReply::http1IdleTimeout()
+{
+    KeepAliveHttpServer longLived;
+    KeepAliveHttpServer shortLived;
+    QVERIFY(longLived.isListening());
+    QVERIFY(shortLived.isListening());
+
+    QHttp1Configuration config;
+    QVERIFY(config.setIdleTimeout(1));
+
+    QNetworkAccessManager manager;
+    const auto get = [&manager](const QUrl &url, const QHttp1Configuration &config) {
+        QNetworkRequest request(url);
+        request.setHttp1Configuration(config);
+        request.setAttribute(QNetworkRequest::Http2AllowedAttribute, false);
+        QNetworkReplyPtr reply(manager.get(request));
+        QSignalSpy finished(reply.data(), &QNetworkReply::finished);
+        return finished.wait(5000) && reply->error() == QNetworkReply::NoError;
+    };
+
+    // the connection with the shorter timeout becomes idle last, but has
+    // to expire first
+    QVERIFY(get(longLived.url(), QHttp1Configuration()));
+    QVERIFY(get(shortLived.url(), config));
+    QVERIFY(get(shortLived.url(), config));
+    QCOMPARE(shortLived.totalConnections, 1);
+
+    QTest::qWait(2000);
+    QVERIFY(get(shortLived.url(), config));
+    QVERIFY(get(longLived.url(), QHttp1Configuration()));
+    QCOMPARE(shortLived.totalConnections, 2);
+    QCOMPARE(longLived.totalConnections, 1);
+}
+
 void tst_QNetworkReply::httpReUsingConnectionSequential_data()
 {
     QTest::addColumn<bool>("doDeleteLater");
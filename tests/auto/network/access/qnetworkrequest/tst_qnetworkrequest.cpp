@@ -31,6 +31,9 @@
 #include <QtCore/QUrl>
 #include <QtNetwork/QNetworkRequest>
 #include <QtNetwork/QNetworkCookie>
+#if QT_CONFIG(http)
+#include <QtNetwork/QHttp1Configuration>
+#endif
 
 Q_DECLARE_METATYPE(QNetworkRequest::KnownHeaders)
 
@@ -55,6 +58,9 @@ private slots:
     void originatingObject();
 
     void removeHeader();
+#if QT_CONFIG(http)
+    void http1Configuration();
+#endif
 };
 
 void tst_QNetworkRequest::ctor_data()
@@ -556,5 +562,49 @@ void tst_QNetworkRequest::originatingObject()
     QVERIFY(!request.originatingObject());
 }
 
+#if QT_CONFIG(http)
+void tst_QNetworkRequest::http1Configuration()
+{
+    QHttp1Configuration config;
+    QCOMPARE(config.numberOfConnectionsPerHost(), 6);
+    QVERIFY(!config.adaptiveConnectionCountEnabled());
+    QCOMPARE(config.maximumPipelineLength(), 3);
+    QCOMPARE(config.idleTimeout(), 120);
+
+    QTest::ignoreMessage(QtWarningMsg, "QHttp1Configuration::setNumberOfConnectionsPerHost: "
+                                       "invalid number of connections");
+    QVERIFY(!config.setNumberOfConnectionsPerHost(0));
+    QTest::ignoreMessage(QtWarningMsg, "QHttp1Configuration::setNumberOfConnectionsPerHost: "
+                                       "invalid number of connections");
+    QVERIFY(!config.setNumberOfConnectionsPerHost(257));
+    QTest::ignoreMessage(QtWarningMsg, "QHttp1Configuration::setMaximumPipelineLength: "
+                                       "invalid pipeline length");
+    QVERIFY(!config.setMaximumPipelineLength(0));
+    QTest::ignoreMessage(QtWarningMsg, "QHttp1Configuration::setIdleTimeout: "
+                                       "invalid timeout");
+    QVERIFY(!config.setIdleTimeout(-1));
+    QCOMPARE(config, QHttp1Configuration());
+
+    QVERIFY(config.setNumberOfConnectionsPerHost(256));
+    QCOMPARE(config.numberOfConnectionsPerHost(), 256);
+    QVERIFY(config.setNumberOfConnectionsPerHost(24));
+    config.setAdaptiveConnectionCountEnabled(true);
+    QVERIFY(config.setMaximumPipelineLength(8));
+    QVERIFY(config.setIdleTimeout(0));
+    QVERIFY(config != QHttp1Configuration());
+
+    QNetworkRequest request;
+    QCOMPARE(request.http1Configuration(), QHttp1Configuration());
+    QNetworkRequest other = request;
+    request.setHttp1Configuration(config);
+    QCOMPARE(request.http1Configuration(), config);
+    QCOMPARE(request.http1Configuration().numberOfConnectionsPerHost(), 24);
+    QVERIFY(request.http1Configuration().adaptiveConnectionCountEnabled());
+    QVERIFY(request != other);
+    other.setHttp1Configuration(config);
+    QCOMPARE(request, other);
+}
+#endif
+
 QTEST_MAIN(tst_QNetworkRequest)
 #include "tst_qnetworkrequest.moc"
@@ -62,6 +62,7 @@
 #include <QStringList>
 #include <QTcpServer>
 #include <QTcpSocket>
+#include <QTemporaryFile>
 #ifndef QT_NO_SSL
 #include <QSslSocket>
 #endif
@@ -206,6 +207,7 @@ private slots:
     void socketDiscardDataInWriteMode();
     void writeOnReadBufferOverflow();
     void readNotificationsAfterBind();
+    void writeFile();
 
 protected slots:
     void nonBlockingIMAP_hostFound();
@@ -3240,5 +3242,54 @@ void tst_QTcpSocket::readNotificationsAfterBind()
     QCOMPARE(spyReadyRead.count(), 0);
 }
 
+void tst_QTcpSocket::writeFile()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+
+    QByteArray contents(1024 * 1024 + 7, Qt::Uninitialized);
+    for (int i = 0; i < contents.size(); ++i)
+        contents[i] = char(i % 251);
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QCOMPARE(file.write(contents), qint64(contents.size()));
+    QVERIFY(file.flush());
+
+    QTcpServer tcpServer;
+    QVERIFY(tcpServer.listen(QHostAddress::LocalHost));
+    std::unique_ptr<QTcpSocket> socket(newSocket());
+    socket->connectToHost(tcpServer.serverAddress(), tcpServer.serverPort());
+    QVERIFY(socket->waitForConnected(5000));
+    QVERIFY2(tcpServer.waitForNewConnection(5000), "Network timeout");
+    std::unique_ptr<QTcpSocket> peer(tcpServer.nextPendingConnection());
+    QVERIFY(peer);
+
+    QTest::ignoreMessage(QtWarningMsg, "QAbstractSocket::writeFile: file not open for reading");
+    QCOMPARE(socket->writeFile(nullptr), qint64(-1));
+    QTest::ignoreMessage(QtWarningMsg, "QAbstractSocket::writeFile: invalid offset -1");
+    QCOMPARE(socket->writeFile(&file, -1), qint64(-1));
+    QCOMPARE(socket->writeFile(&file, contents.size()), qint64(0));
+
+    // Data written before and after a file must stay in order around it.
+    const QByteArray expected = "head" + contents.mid(3, 100000) + "middle" + contents + "tail";
+    QCOMPARE(socket->write("head"), qint64(4));
+    QCOMPARE(socket->writeFile(&file, 3, 100000), qint64(100000));
+    QCOMPARE(socket->write("middle"), qint64(6));
+    QCOMPARE(socket->writeFile(&file, 0, contents.size() + 1), qint64(contents.size()));
+    QCOMPARE(socket->write("tail"), qint64(4));
+    QCOMPARE(socket->bytesToWrite(), qint64(expected.size()));
+
+    qint64 bytesWritten = 0;
+    connect(socket.get(), &QIODevice::bytesWritten, this, [&](qint64 bytes) { bytesWritten += bytes; });
+    QByteArray received;
+    connect(peer.get(), &QIODevice::readyRead, this, [&]() { received += peer->readAll(); });
+
+    QTRY_COMPARE_WITH_TIMEOUT(received.size(), expected.size(), 10000);
+    QVERIFY(received == expected);
+    QCOMPARE(bytesWritten, qint64(expected.size()));
+    QCOMPARE(socket->bytesToWrite(), qint64(0));
+}
+
 QTEST_MAIN(tst_QTcpSocket)
 #include "tst_qtcpsocket.moc"
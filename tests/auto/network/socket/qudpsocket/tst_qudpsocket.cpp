@@ -126,6 +126,8 @@ private slots:
     void readyReadForEmptyDatagram();
     void asyncReadDatagram();
     void writeInHostLookupState();
+    void batchedDatagrams_data();
+    void batchedDatagrams();
 
 protected slots:
     void empty_readyReadSlot();
@@ -1933,5 +1935,70 @@ void tst_QUdpSocket::writeInHostLookupState()
     QVERIFY(!socket.putChar('0'));
 }
 
+void tst_QUdpSocket::batchedDatagrams_data()
+{
+    QTest::addColumn<QList<int>>("sizes");
+    QTest::addColumn<bool>("connected");
+
+    QList<int> equal(200, 100);
+    QTest::newRow("equal") << equal << false;
+    QList<int> shorterLast = equal;
+    shorterLast[99] = 10;
+    QTest::newRow("shorter-in-the-middle") << shorterLast << false;
+    QList<int> mixed;
+    for (int i = 0; i < 200; ++i)
+        mixed << (i * 37) % 1500;
+    QTest::newRow("mixed") << mixed << false;
+    QTest::newRow("large") << QList<int>(8, 8000) << false;
+    // segments are limited to 1452 bytes unless the path MTU is known
+    QTest::newRow("above-default-segment-size") << QList<int>(64, 1472) << false;
+    // the path MTU of loopback allows larger segments
+    QTest::newRow("connected-large") << QList<int>(64, 4000) << true;
+}
+
+void tst_QUdpSocket::batchedDatagrams()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+    QFETCH(QList<int>, sizes);
+    QFETCH(bool, connected);
+
+    QUdpSocket sender, receiver;
+    QVERIFY2(receiver.bind(QHostAddress(QHostAddress::LocalHost), 0), qPrintable(receiver.errorString()));
+    if (connected) {
+        sender.connectToHost(receiver.localAddress(), receiver.localPort());
+        QVERIFY(sender.waitForConnected(5000));
+    }
+
+    QList<QNetworkDatagram> datagrams;
+    for (int i = 0; i < sizes.size(); ++i) {
+        QByteArray data(sizes.at(i), char('a' + i % 26));
+        if (!data.isEmpty())
+            data[0] = char(i);
+        // connected sockets can only send to their peer
+        datagrams << (connected ? QNetworkDatagram(data)
+                                : QNetworkDatagram(data, receiver.localAddress(), receiver.localPort()));
+    }
+
+    // in batches that fit into the receive buffer
+    for (qsizetype first = 0; first < datagrams.size(); first += 32) {
+        const QList<QNetworkDatagram> batch = datagrams.mid(first, 32);
+        QCOMPARE(sender.writeDatagrams(batch), qint64(batch.size()));
+
+        QList<QNetworkDatagram> received;
+        while (received.size() < batch.size() && receiver.waitForReadyRead(5000))
+            received += receiver.receiveDatagrams(batch.size() - received.size(), 8192);
+        QCOMPARE(received.size(), batch.size());
+
+        for (qsizetype i = 0; i < batch.size(); ++i) {
+            QCOMPARE(received.at(i).data(), batch.at(i).data());
+            QCOMPARE(received.at(i).senderPort(), int(sender.localPort()));
+            QCOMPARE(received.at(i).destinationPort(), int(receiver.localPort()));
+        }
+    }
+    QVERIFY(receiver.receiveDatagrams(64, 8192).isEmpty());
+}
+
 QTEST_MAIN(tst_QUdpSocket)
 #include "tst_qudpsocket.moc"
@@ -0,0 +1,336 @@
+/****************************************************************************
+**
+** Copyright (C) 2022 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QTest>
+#include <QtSql/QtSql>
+#include <QtSql/QSqlConnectionPool>
+#include <QtCore/QSemaphore>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtCore/QTimer>
+
+class tst_QSqlConnectionPool : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void sameThread();
+    void otherThread();
+    void maximumSize();
+    void idleTimeout();
+    void minimumSize();
+    void healthCheck();
+    void closedConnection();
+    void destroyedInUse();
+    void timerParent();
+    void openError();
+    void concurrentUse();
+
+private:
+    QTemporaryDir dir;
+    QSqlDatabase templateDb;
+};
+
+static int queryCount(const QSqlDatabase &db)
+{
+    QSqlQuery q(db);
+    if (!q.exec(QLatin1String("SELECT COUNT(*) FROM items")) || !q.next())
+        return -1;
+    return q.value(0).toInt();
+}
+
+void tst_QSqlConnectionPool::initTestCase()
+{
+    if (!QSqlDatabase::isDriverAvailable(QLatin1String("QSQLITE")))
+        QSKIP("The SQLite driver is not available");
+    QVERIFY(dir.isValid());
+}
+
+void tst_QSqlConnectionPool::init()
+{
+    templateDb = QSqlDatabase::addDatabase(QLatin1String("QSQLITE"), QLatin1String("template"));
+    templateDb.setDatabaseName(dir.filePath(QLatin1String("pool.db")));
+    QVERIFY(templateDb.open());
+    QSqlQuery q(templateDb);
+    QVERIFY(q.exec(QLatin1String("DROP TABLE IF EXISTS items")));
+    QVERIFY(q.exec(QLatin1String("CREATE TABLE items (id INTEGER)")));
+}
+
+void tst_QSqlConnectionPool::cleanup()
+{
+    templateDb = QSqlDatabase();
+    QSqlDatabase::removeDatabase(QLatin1String("template"));
+    // all pooled connections must have been removed again
+    QCOMPARE(QSqlDatabase::connectionNames(), QStringList());
+}
+
+void tst_QSqlConnectionPool::sameThread()
+{
+    QSqlConnectionPool pool(templateDb);
+    QCOMPARE(pool.size(), 0);
+
+    QSqlDatabase db = pool.acquire();
+    QVERIFY(db.isValid());
+    QVERIFY(db.isOpen());
+    QCOMPARE(db.databaseName(), templateDb.databaseName());
+    QCOMPARE(queryCount(db), 0);
+    QCOMPARE(pool.size(), 1);
+    QCOMPARE(pool.idleCount(), 0);
+
+    // nested checkouts get the same connection
+    QSqlDatabase nested = pool.acquire();
+    QCOMPARE(nested.connectionName(), db.connectionName());
+    pool.release(nested);
+    QCOMPARE(pool.idleCount(), 0);
+    pool.release(db);
+    QCOMPARE(pool.idleCount(), 1);
+
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("was not acquired from this pool"));
+    pool.release(db);
+    QCOMPARE(pool.idleCount(), 1);
+
+    QSqlDatabase again = pool.acquire();
+    QCOMPARE(again.connectionName(), db.connectionName());
+    QCOMPARE(pool.size(), 1);
+    pool.release(again);
+}
+
+void tst_QSqlConnectionPool::otherThread()
+{
+    QSqlConnectionPool pool(templateDb);
+    QString name;
+    QScopedPointer<QThread> thread(QThread::create([&] {
+        QSqlDatabase db = pool.acquire();
+        QVERIFY(db.isOpen());
+        QCOMPARE(db.driver()->thread(), QThread::currentThread());
+        QSqlQuery q(db);
+        QVERIFY(q.exec(QLatin1String("INSERT INTO items VALUES (1)")));
+        q.finish();
+        name = db.connectionName();
+        pool.release(db);
+    }));
+    thread->start();
+    QVERIFY(thread->wait());
+    QCOMPARE(pool.idleCount(), 1);
+
+    // the connection opened by the other thread is reused by this one
+    QSqlDatabase db = pool.acquire();
+    QCOMPARE(db.connectionName(), name);
+    QCOMPARE(db.driver()->thread(), QThread::currentThread());
+    QCOMPARE(queryCount(db), 1);
+    pool.release(db);
+}
+
+void tst_QSqlConnectionPool::maximumSize()
+{
+    QSqlConnectionPool pool(templateDb);
+    pool.setMaximumSize(1);
+    QCOMPARE(pool.maximumSize(), 1);
+
+    QSqlDatabase db = pool.acquire();
+    QVERIFY(db.isValid());
+
+    QSemaphore timedOut;
+    QString acquiredName;
+    QScopedPointer<QThread> thread(QThread::create([&] {
+        QVERIFY(!pool.acquire(QDeadlineTimer(10)).isValid());
+        timedOut.release();
+        QSqlDatabase other = pool.acquire();
+        acquiredName = other.connectionName();
+        pool.release(other);
+    }));
+    thread->start();
+    QVERIFY(timedOut.tryAcquire(1, 5000));
+    QCOMPARE(pool.size(), 1);
+    pool.release(db);
+    QVERIFY(thread->wait());
+    QCOMPARE(acquiredName, db.connectionName());
+    QCOMPARE(pool.size(), 1);
+}
+
+void tst_QSqlConnectionPool::idleTimeout()
+{
+    QSqlConnectionPool pool(templateDb);
+    QCOMPARE(pool.idleTimeout(), 30000);
+    pool.setIdleTimeout(50);
+
+    QSqlDatabase db = pool.acquire();
+    QVERIFY(db.isValid());
+    QTest::qWait(200);
+    // connections in use are never closed
+    QCOMPARE(pool.size(), 1);
+    pool.release(db);
+    db = QSqlDatabase();
+    QTRY_COMPARE(pool.size(), 0);
+}
+
+void tst_QSqlConnectionPool::minimumSize()
+{
+    QSqlConnectionPool pool(templateDb);
+    pool.setIdleTimeout(10);
+    pool.setMinimumSize(2);
+    QCOMPARE(pool.minimumSize(), 2);
+    QCOMPARE(pool.size(), 2);
+    QCOMPARE(pool.idleCount(), 2);
+
+    QSqlDatabase db = pool.acquire();
+    QVERIFY(db.isOpen());
+    QCOMPARE(pool.size(), 2);
+    pool.release(db);
+    db = QSqlDatabase();
+    QTest::qWait(100);
+    QCOMPARE(pool.size(), 2);
+
+    pool.setMinimumSize(0);
+    QTRY_COMPARE(pool.size(), 0);
+}
+
+void tst_QSqlConnectionPool::healthCheck()
+{
+    QSqlConnectionPool pool(templateDb);
+    pool.setHealthCheckQuery(QLatin1String("SELECT COUNT(*) FROM items"));
+
+    QSqlDatabase db = pool.acquire();
+    const QString name = db.connectionName();
+    pool.release(db);
+    db = pool.acquire();
+    QCOMPARE(db.connectionName(), name);
+    pool.release(db);
+    db = QSqlDatabase();
+
+    // a failing check replaces the connection
+    pool.setHealthCheckQuery(QLatin1String("SELECT * FROM nonexistent"));
+    QCOMPARE(pool.healthCheckQuery(), QLatin1String("SELECT * FROM nonexistent"));
+    db = pool.acquire();
+    QVERIFY(db.isOpen());
+    QVERIFY(db.connectionName() != name);
+    QCOMPARE(pool.size(), 1);
+    pool.release(db);
+}
+
+void tst_QSqlConnectionPool::closedConnection()
+{
+    QSqlConnectionPool pool(templateDb);
+    QSqlDatabase db = pool.acquire();
+    const QString name = db.connectionName();
+    db.close();
+    pool.release(db);
+    QCOMPARE(pool.size(), 0);
+    // the connection is only removed once the handle is gone, without
+    // invalidating it before
+    QVERIFY(QSqlDatabase::contains(name));
+    QCOMPARE(db.connectionName(), name);
+    db = QSqlDatabase();
+
+    db = pool.acquire();
+    QVERIFY(db.isOpen());
+    QVERIFY(!QSqlDatabase::contains(name));
+    pool.release(db);
+}
+
+void tst_QSqlConnectionPool::destroyedInUse()
+{
+    QSqlDatabase db;
+    {
+        QSqlConnectionPool pool(templateDb);
+        db = pool.acquire();
+        QVERIFY(db.isOpen());
+        QTest::ignoreMessage(QtWarningMsg,
+                             QRegularExpression("Destroyed while 1 connection\\(s\\) are still in use"));
+        QTest::ignoreMessage(QtWarningMsg, QRegularExpression("is still in use"));
+    }
+    // the connection has been reclaimed by the pool
+    QVERIFY(!db.isOpen());
+    QCOMPARE(QSqlDatabase::connectionNames(), QStringList(QLatin1String("template")));
+}
+
+void tst_QSqlConnectionPool::timerParent()
+{
+    QSqlConnectionPool pool(templateDb);
+    const QList<QTimer *> timers = pool.findChildren<QTimer *>();
+    QCOMPARE(timers.count(), 1);
+
+    // the maintenance timer moves along with the pool
+    QThread *mainThread = QThread::currentThread();
+    QThread thread;
+    thread.start();
+    pool.moveToThread(&thread);
+    QCOMPARE(timers.first()->thread(), &thread);
+    QMetaObject::invokeMethod(&pool, [&pool, mainThread] { pool.moveToThread(mainThread); },
+                              Qt::BlockingQueuedConnection);
+    QCOMPARE(timers.first()->thread(), mainThread);
+    thread.quit();
+    thread.wait();
+}
+
+void tst_QSqlConnectionPool::openError()
+{
+    QSqlDatabase invalid = QSqlDatabase::addDatabase(QLatin1String("QSQLITE"), QLatin1String("invalid"));
+    invalid.setDatabaseName(dir.filePath(QLatin1String("nonexistent/pool.db")));
+    {
+        QSqlConnectionPool pool(invalid);
+        QVERIFY(!pool.acquire().isValid());
+        QCOMPARE(pool.lastError().type(), QSqlError::ConnectionError);
+        QCOMPARE(pool.size(), 0);
+    }
+    invalid = QSqlDatabase();
+    QSqlDatabase::removeDatabase(QLatin1String("invalid"));
+}
+
+void tst_QSqlConnectionPool::concurrentUse()
+{
+    QSqlConnectionPool pool(templateDb);
+    pool.setMaximumSize(3);
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(6);
+    QAtomicInt failures;
+    for (int i = 0; i < 6; ++i) {
+        threadPool.start([&] {
+            for (int j = 0; j < 50; ++j) {
+                QSqlDatabase db = pool.acquire();
+                if (!db.isOpen() || db.driver()->thread() != QThread::currentThread()
+                    || queryCount(db) < 0) {
+                    failures.ref();
+                }
+                pool.release(db);
+            }
+        });
+    }
+    QVERIFY(threadPool.waitForDone());
+    QCOMPARE(failures.loadRelaxed(), 0);
+    QVERIFY(pool.size() <= 3);
+    QCOMPARE(pool.idleCount(), pool.size());
+}
+
+QTEST_MAIN(tst_QSqlConnectionPool)
+#include "tst_qsqlconnectionpool.moc"
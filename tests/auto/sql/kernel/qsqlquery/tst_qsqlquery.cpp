@@ -96,6 +96,10 @@ private slots:
     // forwardOnly mode need special treatment
     void forwardOnly_data() { generic_data(); }
     void forwardOnly();
+    void fetchRows_data();
+    void fetchRows();
+    void execAsync_data() { generic_data(); }
+    void execAsync();
     void forwardOnlyMultipleResultSet_data() { generic_data(); }
     void forwardOnlyMultipleResultSet();
     void psql_forwardOnlyQueryResultsLost_data() { generic_data("QPSQL"); }
@@ -250,6 +254,10 @@ private slots:
 
     void sqlite_real_data() { generic_data("QSQLITE"); }
     void sqlite_real();
+    void sqlite_cachedValues_data() { generic_data("QSQLITE"); }
+    void sqlite_cachedValues();
+    void sqlite_statementCache_data() { generic_data("QSQLITE"); }
+    void sqlite_statementCache();
 
     void aggregateFunctionTypes_data() { generic_data(); }
     void aggregateFunctionTypes();
@@ -1525,6 +1533,141 @@ QT_WARNING_POP
     QCOMPARE( q.at(), int( QSql::AfterLastRow ) );
 }
 
+void tst_QSqlQuery::fetchRows_data()
+{
+    QTest::addColumn<QString>("dbName");
+    QTest::addColumn<bool>("forwardOnly");
+    int count = 0;
+    for (const QString &dbName : qAsConst(dbs.dbNames)) {
+        if (!QSqlDatabase::database(dbName).isValid())
+            continue;
+        QTest::newRow(qPrintable(dbName + QLatin1String(":forwardOnly"))) << dbName << true;
+        QTest::newRow(qPrintable(dbName + QLatin1String(":scrollable"))) << dbName << false;
+        ++count;
+    }
+    if (!count)
+        QSKIP("No database drivers are available in this Qt configuration");
+}
+
+void tst_QSqlQuery::fetchRows()
+{
+    QFETCH(QString, dbName);
+    QFETCH(bool, forwardOnly);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    const QString tableName(qTableName("fetchrows", __FILE__, db));
+    tst_Databases::safeDropTable(db, tableName);
+
+    QSqlQuery q(db);
+    QVERIFY_SQL(q, exec("create table " + tableName + " (id int, name varchar(20))"));
+    QVERIFY_SQL(q, prepare("insert into " + tableName + " values (?, ?)"));
+    const int rowCount = 40;
+    for (int i = 0; i < rowCount; ++i) {
+        q.addBindValue(i);
+        q.addBindValue(i % 4 ? QVariant(QString::number(i)) : QVariant(QMetaType::fromType<QString>()));
+        QVERIFY_SQL(q, exec());
+    }
+
+    q.setForwardOnly(forwardOnly);
+    QVERIFY_SQL(q, exec("select id, name from " + tableName + " order by id"));
+    // rows already read with next() are not returned again
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), 0);
+
+    QList<QVariantList> columns;
+    int expected = 1;
+    while (int n = q.fetchRows(&columns, 7)) {
+        QVERIFY(n <= 7);
+        QCOMPARE(columns.count(), 2);
+        QCOMPARE(columns.at(0).count(), n);
+        QCOMPARE(columns.at(1).count(), n);
+        for (int i = 0; i < n; ++i, ++expected) {
+            QCOMPARE(columns.at(0).at(i).toInt(), expected);
+            QCOMPARE(columns.at(1).at(i).isNull(), expected % 4 == 0);
+            if (expected % 4)
+                QCOMPARE(columns.at(1).at(i).toString(), QString::number(expected));
+        }
+        if (n == 7) {
+            // the query is positioned on the last row that was read
+            QCOMPARE(q.at(), expected - 1);
+            QCOMPARE(q.value(0).toInt(), expected - 1);
+        } else {
+            QCOMPARE(q.at(), int(QSql::AfterLastRow));
+        }
+    }
+    QCOMPARE(expected, rowCount);
+    QCOMPARE(q.at(), int(QSql::AfterLastRow));
+    QVERIFY(!q.next());
+    QCOMPARE(q.fetchRows(&columns, 7), 0);
+    QCOMPARE(columns.at(0).count(), 0);
+
+    tst_Databases::safeDropTable(db, tableName);
+}
+
+void tst_QSqlQuery::execAsync()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    const QString tableName(qTableName("execasync", __FILE__, db));
+    tst_Databases::safeDropTable(db, tableName);
+
+    QSqlQuery q(db);
+    QVERIFY_SQL(q, exec("create table " + tableName + " (id int, name varchar(20))"));
+    QVERIFY_SQL(q, prepare("insert into " + tableName + " values (?, ?)"));
+    for (int i = 0; i < 30; ++i) {
+        q.addBindValue(i);
+        q.addBindValue(QString::number(i));
+        QVERIFY_SQL(q, exec());
+    }
+
+    // several queries on the same connection finish in order
+    QSqlQuery q1(db);
+    QSqlQuery q2(db);
+    QVERIFY_SQL(q1, prepare("select id, name from " + tableName + " where id < ? order by id"));
+    q1.addBindValue(20);
+    QVERIFY_SQL(q2, prepare("select name from " + tableName + " where id = ?"));
+    q2.addBindValue(25);
+
+    QFuture<QSqlRecord> f1 = q1.execAsync();
+    QFuture<QSqlRecord> f2 = q2.execAsync();
+    QTRY_VERIFY(f2.isFinished());
+    QVERIFY(f1.isFinished());
+
+    QVERIFY(!f1.isCanceled());
+    const QList<QSqlRecord> rows = f1.results();
+    QCOMPARE(rows.count(), 20);
+    for (int i = 0; i < rows.count(); ++i) {
+        QCOMPARE(rows.at(i).count(), 2);
+        QCOMPARE(rows.at(i).value(0).toInt(), i);
+        QCOMPARE(rows.at(i).value("name").toString(), QString::number(i));
+    }
+    QCOMPARE(f2.resultCount(), 1);
+    QCOMPARE(f2.resultAt(0).value(0).toString(), QString("25"));
+
+    // a failing query cancels its future
+    QSqlQuery q3(db);
+    if (q3.prepare("select name from nonexistent_" + tableName)) {
+        // the driver only checks the statement when executing it
+        QFuture<QSqlRecord> f3 = q3.execAsync();
+        QTRY_VERIFY(f3.isFinished());
+        QVERIFY(f3.isCanceled());
+        QVERIFY(q3.lastError().isValid());
+    }
+
+    // a synchronous query waits for the asynchronous ones
+    q2.bindValue(0, 3);
+    f2 = q2.execAsync();
+    QVERIFY_SQL(q, exec("select count(*) from " + tableName));
+    QVERIFY(q.next());
+    QCOMPARE(q.value(0).toInt(), 30);
+    QTRY_VERIFY(f2.isFinished());
+    QCOMPARE(f2.resultCount(), 1);
+    QCOMPARE(f2.resultAt(0).value(0).toString(), QString("3"));
+
+    tst_Databases::safeDropTable(db, tableName);
+}
+
 void tst_QSqlQuery::forwardOnlyMultipleResultSet()
 {
     QFETCH(QString, dbName);
@@ -4395,6 +4538,143 @@ void tst_QSqlQuery::sqlite_real()
     QCOMPARE(q.value(0).toDouble(), 5.6);
 }
 
+void tst_QSqlQuery::sqlite_cachedValues()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    const QString tableName(qTableName("sqlitecachedvalues", __FILE__, db));
+    tst_Databases::safeDropTable(db, tableName);
+
+    // SQLite is dynamically typed, so a column can hold values of any type
+    QSqlQuery q(db);
+    QVERIFY_SQL(q, exec("CREATE TABLE " + tableName
+                        + " (id INTEGER, intVal INTEGER, realVal REAL, textVal TEXT, mixed)"));
+    QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " VALUES (?, ?, ?, ?, ?)"));
+    const int rowCount = 300;
+    for (int i = 0; i < rowCount; ++i) {
+        q.addBindValue(i);
+        q.addBindValue(i % 7 ? QVariant(qlonglong(i) << 32) : QVariant(QMetaType::fromType<int>()));
+        q.addBindValue(i % 5 ? QVariant(i + 0.5) : QVariant(QMetaType::fromType<double>()));
+        q.addBindValue(i % 3 ? QVariant(QString(i % 10, QLatin1Char('x'))) : QVariant(QMetaType::fromType<QString>()));
+        q.addBindValue(i < 200 ? QVariant(i) : QVariant(QByteArray::number(i)));
+        QVERIFY_SQL(q, exec());
+    }
+
+    QVERIFY_SQL(q, exec("SELECT intVal, realVal, textVal, mixed FROM " + tableName + " ORDER BY id"));
+    QVERIFY(q.last());
+    QCOMPARE(q.at(), rowCount - 1);
+    // walk backwards, so all values come from the cache
+    for (int i = rowCount - 1; i >= 0; --i) {
+        QVERIFY(q.seek(i));
+        QCOMPARE(q.isNull(0), i % 7 == 0);
+        if (i % 7)
+            QCOMPARE(q.value(0).toLongLong(), qlonglong(i) << 32);
+        QCOMPARE(q.isNull(1), i % 5 == 0);
+        if (i % 5)
+            QCOMPARE(q.value(1).toDouble(), i + 0.5);
+        QCOMPARE(q.isNull(2), i % 3 == 0);
+        if (i % 3)
+            QCOMPARE(q.value(2).toString(), QString(i % 10, QLatin1Char('x')));
+        if (i < 200) {
+            QCOMPARE(q.value(3).metaType().id(), QMetaType::LongLong);
+            QCOMPARE(q.value(3).toInt(), i);
+        } else {
+            QCOMPARE(q.value(3).toByteArray(), QByteArray::number(i));
+        }
+    }
+    tst_Databases::safeDropTable(db, tableName);
+}
+
+void tst_QSqlQuery::sqlite_statementCache()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    const QString tableName(qTableName("sqlitestatementcache", __FILE__, db));
+    tst_Databases::safeDropTable(db, tableName);
+
+    QSqlDriver *driver = db.driver();
+    QCOMPARE(driver->statementCacheSize(), 0);
+    {
+        QSqlQuery q(db);
+        QVERIFY_SQL(q, exec("CREATE TABLE " + tableName + " (id INTEGER, name TEXT)"));
+    }
+    // a disabled cache doesn't count anything
+    QCOMPARE(driver->statementCacheHits(), 0);
+    QCOMPARE(driver->statementCacheMisses(), 0);
+
+    driver->setStatementCacheSize(2);
+    const QString insert = "INSERT INTO " + tableName + " VALUES (?, ?)";
+    const QString select = "SELECT name FROM " + tableName + " WHERE id = ?";
+    const QString count = "SELECT COUNT(*) FROM " + tableName;
+    for (int i = 0; i < 10; ++i) {
+        QSqlQuery q(db);
+        QVERIFY_SQL(q, prepare(insert));
+        q.addBindValue(i);
+        q.addBindValue(QString::number(i));
+        QVERIFY_SQL(q, exec());
+    }
+    QCOMPARE(driver->statementCacheMisses(), 1);
+    QCOMPARE(driver->statementCacheHits(), 9);
+
+    {
+        // a statement is only used by one query at a time; the bound
+        // values of the previous use must not leak into the next one
+        QSqlQuery q1(db);
+        QSqlQuery q2(db);
+        QVERIFY_SQL(q1, prepare(select));
+        QVERIFY_SQL(q2, prepare(select));
+        QCOMPARE(driver->statementCacheMisses(), 3);
+        q1.addBindValue(3);
+        QVERIFY_SQL(q1, exec());
+        q2.addBindValue(7);
+        QVERIFY_SQL(q2, exec());
+        QVERIFY(q1.next());
+        QVERIFY(q2.next());
+        QCOMPARE(q1.value(0).toString(), QString("3"));
+        QCOMPARE(q2.value(0).toString(), QString("7"));
+    }
+    {
+        QSqlQuery q(db);
+        QVERIFY_SQL(q, prepare(select));
+        QCOMPARE(driver->statementCacheHits(), 10);
+        q.addBindValue(42);
+        QVERIFY_SQL(q, exec());
+        QVERIFY(!q.next());
+        // re-preparing returns the select to the cache
+        QVERIFY_SQL(q, exec(count));
+        QVERIFY(q.next());
+        QCOMPARE(q.value(0).toInt(), 10);
+        QCOMPARE(driver->statementCacheMisses(), 4);
+        QVERIFY_SQL(q, prepare(select));
+        QCOMPARE(driver->statementCacheHits(), 11);
+    }
+    {
+        // the cache holds the select and the count, so the insert was
+        // evicted as the least recently used statement
+        QSqlQuery q(db);
+        QVERIFY_SQL(q, prepare(insert));
+        QCOMPARE(driver->statementCacheMisses(), 5);
+        QCOMPARE(driver->statementCacheHits(), 11);
+    }
+
+    // closing the connection releases the cached statements
+    db.close();
+    QVERIFY(!db.isOpen());
+    QVERIFY_SQL(db, open());
+    {
+        QSqlQuery q(db);
+        QVERIFY_SQL(q, exec(count));
+        QVERIFY(q.next());
+        QCOMPARE(q.value(0).toInt(), 10);
+    }
+    QCOMPARE(driver->statementCacheMisses(), 6);
+
+    driver->setStatementCacheSize(0);
+    tst_Databases::safeDropTable(db, tableName);
+}
+
 void tst_QSqlQuery::aggregateFunctionTypes()
 {
     QFETCH(QString, dbName);
@@ -58,6 +58,12 @@ private slots:
     void posix_data() { data(); }
     void diriterator();
     void diriterator_data() { data(); }
+    void diriteratorParallel();
+    void diriteratorParallel_data() { data(); }
+    void diriteratorMetaData();
+    void diriteratorMetaData_data() { data(); }
+    void diriteratorMetaDataParallel();
+    void diriteratorMetaDataParallel_data() { data(); }
     void fsiterator();
     void fsiterator_data() { data(); }
     void stdRecursiveDirectoryIterator();
@@ -203,6 +209,54 @@ void tst_qdiriterator::diriterator()
     qDebug() << count;
 }
 
+static int diriteratorHelper(const QByteArray &dirpath, QDirIterator::IteratorFlags flags,
+                             bool readMetaData)
+{
+    int count = 0;
+    qint64 totalSize = 0;
+    QDirIterator dir(dirpath, QDir::Files, QDirIterator::Subdirectories | flags);
+    while (dir.hasNext()) {
+        dir.next();
+        if (readMetaData)
+            totalSize += dir.fileInfo().size() + dir.fileInfo().lastModified().isValid();
+        ++count;
+    }
+    return totalSize >= 0 ? count : -1;
+}
+
+void tst_qdiriterator::diriteratorParallel()
+{
+    QFETCH(QByteArray, dirpath);
+
+    int count = 0;
+    QBENCHMARK {
+        count = diriteratorHelper(dirpath, QDirIterator::ParallelTraversal, false);
+    }
+    qDebug() << count;
+}
+
+void tst_qdiriterator::diriteratorMetaData()
+{
+    QFETCH(QByteArray, dirpath);
+
+    int count = 0;
+    QBENCHMARK {
+        count = diriteratorHelper(dirpath, QDirIterator::NoIteratorFlags, true);
+    }
+    qDebug() << count;
+}
+
+void tst_qdiriterator::diriteratorMetaDataParallel()
+{
+    QFETCH(QByteArray, dirpath);
+
+    int count = 0;
+    QBENCHMARK {
+        count = diriteratorHelper(dirpath, QDirIterator::ParallelTraversal, true);
+    }
+    qDebug() << count;
+}
+
 void tst_qdiriterator::fsiterator()
 {
     QFETCH(QByteArray, dirpath);
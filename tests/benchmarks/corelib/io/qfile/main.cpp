@@ -30,6 +30,7 @@
 #include <QTemporaryFile>
 #include <QString>
 #include <QDirIterator>
+#include <QFuture>
 
 #include <private/qfsfileengine_p.h>
 
@@ -107,6 +108,9 @@ private slots:
     void readBigFile_posix();
     void readBigFile_Win32();
 
+    void readBigFile_async_data();
+    void readBigFile_async();
+
 private:
     void readFile_data(BenchmarkType type, QIODevice::OpenModeFlag t, QIODevice::OpenModeFlag b);
     void readBigFile();
@@ -330,6 +334,35 @@ void tst_qfile::readBigFile()
     }
 }
 
+void tst_qfile::readBigFile_async_data()
+{
+    QTest::addColumn<int>("blockSize");
+    const int kbs[] = {8, 32, 512, 4096};
+    for (int kb : kbs)
+        QTest::addRow("BS: %d", 1024 * kb) << 1024 * kb;
+}
+
+void tst_qfile::readBigFile_async()
+{
+    // compare with readBigFile_QFile, which reads the same file synchronously
+    QFETCH(int, blockSize);
+
+    QFile file(tempDir.filename);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const qint64 size = file.size();
+
+    QBENCHMARK {
+        QList<QFuture<QByteArray>> reads;
+        reads.reserve(size / blockSize + 1);
+        for (qint64 offset = 0; offset < size; offset += blockSize)
+            reads << file.readAsync(offset, blockSize);
+        qint64 total = 0;
+        for (QFuture<QByteArray> &read : reads)
+            total += read.result().size();
+        QCOMPARE(total, size);
+    }
+}
+
 void tst_qfile::seek_data()
 {
     QTest::addColumn<tst_qfile::BenchmarkType>("testType");
@@ -0,0 +1,137 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QTest>
+#include <QFile>
+#include <QResource>
+
+class tst_QResource : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void registerResource_data() { bundles(); }
+    void registerResource();
+    void lookup_data() { bundles(); }
+    void lookup();
+    void lookupMissing_data() { bundles(); }
+    void lookupMissing();
+    void openCompressed_data() { bundles(); }
+    void openCompressed();
+
+private:
+    void bundles();
+    static QStringList paths();
+};
+
+void tst_QResource::bundles()
+{
+    QTest::addColumn<QString>("bundle");
+
+    QTest::newRow("format-3") << QFINDTESTDATA("bundle_v3.rcc");
+    QTest::newRow("format-4") << QFINDTESTDATA("bundle_v4.rcc");
+}
+
+QStringList tst_QResource::paths()
+{
+    QStringList result;
+    for (int dir = 0; dir < 40; ++dir) {
+        for (int file = 0; file < 250; ++file)
+            result << QStringLiteral(":/bench/dir%1/file%2.txt").arg(dir).arg(file);
+    }
+    return result;
+}
+
+// what an application pays at startup to make a bundle available and
+// resolve its first resource
+void tst_QResource::registerResource()
+{
+    QFETCH(QString, bundle);
+    QVERIFY(!bundle.isEmpty());
+
+    QBENCHMARK {
+        QVERIFY(QResource::registerResource(bundle, "/bench"));
+        QVERIFY(QResource(":/bench/dir39/file249.txt").isValid());
+        QVERIFY(QResource::unregisterResource(bundle, "/bench"));
+    }
+}
+
+void tst_QResource::lookup()
+{
+    QFETCH(QString, bundle);
+    QVERIFY(QResource::registerResource(bundle, "/bench"));
+    const QStringList all = paths();
+
+    QBENCHMARK {
+        for (const QString &path : all) {
+            if (!QResource(path).isValid())
+                QFAIL(qPrintable(path));
+        }
+    }
+    QVERIFY(QResource::unregisterResource(bundle, "/bench"));
+}
+
+void tst_QResource::lookupMissing()
+{
+    QFETCH(QString, bundle);
+    QVERIFY(QResource::registerResource(bundle, "/bench"));
+    QStringList missing = paths();
+    for (QString &path : missing)
+        path.replace(QLatin1String(".txt"), QLatin1String(".png"));
+
+    QBENCHMARK {
+        for (const QString &path : qAsConst(missing)) {
+            if (QResource(path).isValid())
+                QFAIL(qPrintable(path));
+        }
+    }
+    QVERIFY(QResource::unregisterResource(bundle, "/bench"));
+}
+
+// repeatedly opening the same compressed resources, as a style sheet or
+// icon loader would
+void tst_QResource::openCompressed()
+{
+    QFETCH(QString, bundle);
+    QVERIFY(QResource::registerResource(bundle, "/bench"));
+    const QStringList some = paths().mid(0, 100);
+    QVERIFY(QResource(some.first()).compressionAlgorithm() != QResource::NoCompression);
+
+    QBENCHMARK {
+        for (const QString &path : some) {
+            QFile file(path);
+            if (!file.open(QIODevice::ReadOnly) || file.readAll().isEmpty())
+                QFAIL(qPrintable(path));
+        }
+    }
+    QVERIFY(QResource::unregisterResource(bundle, "/bench"));
+}
+
+QTEST_MAIN(tst_QResource)
+
+#include "tst_bench_qresource.moc"
@@ -29,6 +29,9 @@
 #include <QTest>
 #include <qjsondocument.h>
 #include <qjsonobject.h>
+#include <qjsonarray.h>
+#include <qjsonstreamreader.h>
+#include <qjsonstreamwriter.h>
 
 class BenchmarkQtJson: public QObject
 {
@@ -45,9 +48,18 @@ private Q_SLOTS:
     void parseNumbers();
     void parseJson();
     void parseJsonToVariant();
+    void parseLargeDocument_data();
+    void parseLargeDocument();
+    void lookupMember_data();
+    void lookupMember();
+    void streamReadLargeDocument();
+    void streamWriteLargeDocument();
 
     void jsonObjectInsert();
     void variantMapInsert();
+
+private:
+    QByteArray largeDocument(QJsonDocument::JsonFormat format);
 };
 
 BenchmarkQtJson::BenchmarkQtJson(QObject *parent) : QObject(parent)
@@ -117,6 +129,102 @@ void BenchmarkQtJson::parseJsonToVariant()
     }
 }
 
+// a multi-megabyte object of records mixing ASCII, UTF-8 and escaped strings
+QByteArray BenchmarkQtJson::largeDocument(QJsonDocument::JsonFormat format)
+{
+    QJsonObject root;
+    for (int i = 0; i < 10000; ++i) {
+        QJsonObject record;
+        record.insert(QLatin1String("id"), i);
+        record.insert(QLatin1String("name"), QString(QLatin1String("record number ") + QString::number(i)));
+        record.insert(QLatin1String("description"),
+                      QLatin1String("A fairly long plain ASCII description of the record, "
+                                    "as commonly found in API payloads"));
+        record.insert(QLatin1String("city"), QString::fromUtf8("S\xc3\xa3o Paulo / M\xc3\xbcnchen"));
+        record.insert(QLatin1String("path"), QLatin1String("C:\\data\\\"quoted\"\n"));
+        record.insert(QLatin1String("score"), i * 0.25);
+        record.insert(QLatin1String("tags"), QJsonArray { QLatin1String("alpha"), QLatin1String("beta"), true, QJsonValue() });
+        root.insert(QLatin1String("record") + QString::number(i), record);
+    }
+    return QJsonDocument(root).toJson(format);
+}
+
+void BenchmarkQtJson::parseLargeDocument_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<bool>("onDemand");
+
+    const QByteArray compact = largeDocument(QJsonDocument::Compact);
+    const QByteArray indented = largeDocument(QJsonDocument::Indented);
+    QTest::newRow("compact-eager") << compact << false;
+    QTest::newRow("compact-ondemand") << compact << true;
+    QTest::newRow("indented-eager") << indented << false;
+    QTest::newRow("indented-ondemand") << indented << true;
+}
+
+void BenchmarkQtJson::parseLargeDocument()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(bool, onDemand);
+    const auto mode = onDemand ? QJsonDocument::ParseOnDemand : QJsonDocument::ParseEagerly;
+
+    QBENCHMARK {
+        QJsonDocument doc = QJsonDocument::fromJson(json, nullptr, mode);
+        QVERIFY(doc.isObject());
+    }
+}
+
+void BenchmarkQtJson::lookupMember_data()
+{
+    parseLargeDocument_data();
+}
+
+void BenchmarkQtJson::lookupMember()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(bool, onDemand);
+    const auto mode = onDemand ? QJsonDocument::ParseOnDemand : QJsonDocument::ParseEagerly;
+
+    QBENCHMARK {
+        QJsonDocument doc = QJsonDocument::fromJson(json, nullptr, mode);
+        QJsonValue value = doc[QLatin1String("record5000")];
+        QCOMPARE(value[QLatin1String("id")].toInt(), 5000);
+    }
+}
+
+void BenchmarkQtJson::streamReadLargeDocument()
+{
+    const QByteArray json = largeDocument(QJsonDocument::Compact);
+
+    QBENCHMARK {
+        QJsonStreamReader reader(json);
+        QVERIFY(reader.enterContainer());
+        int records = 0;
+        while (reader.hasNext()) {
+            reader.readString();
+            records += reader.readValue().isObject();
+        }
+        QVERIFY(reader.leaveContainer());
+        QCOMPARE(records, 10000);
+    }
+}
+
+void BenchmarkQtJson::streamWriteLargeDocument()
+{
+    const QJsonObject root = QJsonDocument::fromJson(largeDocument(QJsonDocument::Compact)).object();
+
+    QBENCHMARK {
+        QByteArray json;
+        QJsonStreamWriter writer(&json, QJsonDocument::Compact);
+        writer.startObject();
+        for (auto it = root.begin(); it != root.end(); ++it) {
+            writer.append(it.key());
+            writer.append(it.value());
+        }
+        writer.endObject();
+    }
+}
+
 void BenchmarkQtJson::jsonObjectInsert()
 {
     QJsonObject object;
@@ -30,6 +30,14 @@
 #include <qtest.h>
 #include <qtesteventloop.h>
 
+#include <memory>
+#include <vector>
+
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
 class PingPong : public QObject
 {
 public:
@@ -83,6 +91,30 @@ int EventTester::foo(int bar)
     return bar + 1;
 }
 
+class EventCounter : public QObject
+{
+public:
+    void reset(int expected) { m_received = 0; m_expected = expected; }
+    void increment()
+    {
+        if (++m_received == m_expected)
+            QTestEventLoop::instance().exitLoop();
+    }
+
+protected:
+    bool event(QEvent *e) override
+    {
+        if (e->type() != QEvent::User)
+            return QObject::event(e);
+        increment();
+        return true;
+    }
+
+private:
+    int m_received = 0;
+    int m_expected = 0;
+};
+
 class EventsBench : public QObject
 {
     Q_OBJECT
@@ -96,6 +128,10 @@ private slots:
     void sendEvent();
     void postEvent_data();
     void postEvent();
+    void crossThreadPostEvent_data();
+    void crossThreadPostEvent();
+    void socketNotifiers_data();
+    void socketNotifiers();
 };
 
 void EventsBench::initTestCase()
@@ -169,6 +205,118 @@ void EventsBench::postEvent()
     }
 }
 
+void EventsBench::crossThreadPostEvent_data()
+{
+    QTest::addColumn<int>("producerCount");
+    QTest::addColumn<bool>("queuedCall");
+    for (int count : { 1, 2, 4, 8 }) {
+        QTest::addRow("queued call, %d producers", count) << count << true;
+        QTest::addRow("custom event, %d producers", count) << count << false;
+    }
+}
+
+void EventsBench::crossThreadPostEvent()
+{
+    QFETCH(int, producerCount);
+    QFETCH(bool, queuedCall);
+    constexpr int EventsPerProducer = 10000;
+
+    // queued calls (QEvent::MetaCall) take the lock-free posting path, custom
+    // events lock the receiving thread's post event list
+    EventCounter counter;
+    QBENCHMARK {
+        counter.reset(producerCount * EventsPerProducer);
+        std::vector<std::unique_ptr<QThread>> producers;
+        for (int i = 0; i < producerCount; ++i) {
+            producers.emplace_back(QThread::create([&counter, queuedCall] {
+                for (int j = 0; j < EventsPerProducer; ++j) {
+                    if (queuedCall) {
+                        QMetaObject::invokeMethod(&counter, &EventCounter::increment,
+                                                  Qt::QueuedConnection);
+                    } else {
+                        QCoreApplication::postEvent(&counter, new QEvent(QEvent::User));
+                    }
+                }
+            }));
+            producers.back()->start();
+        }
+        QTestEventLoop::instance().enterLoop(60);
+        for (const auto &producer : producers)
+            producer->wait();
+        QVERIFY(!QTestEventLoop::instance().timeout());
+    }
+}
+
+void EventsBench::socketNotifiers_data()
+{
+    QTest::addColumn<int>("notifierCount");
+    for (int count : { 1, 10, 100, 1000, 5000 })
+        QTest::addRow("%d", count) << count;
+}
+
+void EventsBench::socketNotifiers()
+{
+#ifdef Q_OS_UNIX
+    QFETCH(int, notifierCount);
+
+    // every idle notifier watches its own duplicate of the read end of a
+    // pipe that never becomes readable, so they only add dispatch overhead
+    rlimit limit;
+    if (::getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        ::setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    int idlePipe[2];
+    int activePipe[2];
+    QVERIFY(::pipe(idlePipe) == 0);
+    QVERIFY(::pipe(activePipe) == 0);
+
+    QList<QSocketNotifier *> idleNotifiers;
+    for (int i = 1; i < notifierCount; ++i) {
+        const int fd = ::dup(idlePipe[0]);
+        if (fd == -1)
+            break;
+        idleNotifiers << new QSocketNotifier(fd, QSocketNotifier::Read);
+    }
+
+    auto cleanup = qScopeGuard([&] {
+        for (QSocketNotifier *notifier : qAsConst(idleNotifiers)) {
+            ::close(notifier->socket());
+            delete notifier;
+        }
+        ::close(idlePipe[0]);
+        ::close(idlePipe[1]);
+        ::close(activePipe[0]);
+        ::close(activePipe[1]);
+    });
+
+    if (idleNotifiers.size() != notifierCount - 1)
+        QSKIP("Not enough file descriptors available");
+
+    int received = 0;
+    QSocketNotifier activeNotifier(activePipe[0], QSocketNotifier::Read);
+    connect(&activeNotifier, &QSocketNotifier::activated, this, [&](QSocketDescriptor socket) {
+        char c;
+        if (::read(socket, &c, 1) == 1)
+            ++received;
+    });
+
+    QBENCHMARK {
+        // one wakeup per round trip, so the cost is dominated by how the
+        // dispatcher handles the notifiers that did not fire
+        received = 0;
+        for (int i = 0; i < 100; ++i) {
+            QVERIFY(::write(activePipe[1], "x", 1) == 1);
+            while (received <= i)
+                QCoreApplication::processEvents(QEventLoop::WaitForMoreEvents);
+        }
+    }
+#else
+    QSKIP("This benchmark requires pipe(2)");
+#endif
+}
+
 QTEST_MAIN(EventsBench)
 
 #include "main.moc"
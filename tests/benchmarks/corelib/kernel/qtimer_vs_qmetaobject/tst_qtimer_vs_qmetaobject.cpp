@@ -41,6 +41,8 @@ private slots:
     void bench_data();
     void benchBackgroundThread();
     void benchBackgroundThread_data() { bench_data(); }
+    void benchManyTimers();
+    void benchManyTimers_data();
 };
 
 class InvokeCounter : public QObject {
@@ -135,6 +137,41 @@ void qtimer_vs_qmetaobject::benchBackgroundThread()
 #endif
 }
 
+void qtimer_vs_qmetaobject::benchManyTimers()
+{
+    QFETCH(int, timerCount);
+    QFETCH(bool, restart);
+
+    // Long-running timers with distinct timeouts, like per-connection idle
+    // timers; none of them fire during the benchmark.
+    QObject receiver;
+    QList<int> timerIds(timerCount);
+
+    QBENCHMARK {
+        for (int i = 0; i < timerCount; ++i)
+            timerIds[i] = receiver.startTimer(3600 * 1000 + i, Qt::PreciseTimer);
+        if (restart) {
+            for (int i = 0; i < timerCount; ++i) {
+                receiver.killTimer(timerIds.at(i));
+                timerIds[i] = receiver.startTimer(3600 * 1000 + timerCount - i, Qt::PreciseTimer);
+            }
+        }
+        QCoreApplication::processEvents();
+        for (int i = 0; i < timerCount; ++i)
+            receiver.killTimer(timerIds.at(i));
+    }
+}
+
+void qtimer_vs_qmetaobject::benchManyTimers_data()
+{
+    QTest::addColumn<int>("timerCount");
+    QTest::addColumn<bool>("restart");
+    for (int count : { 1000, 10000, 100000 }) {
+        QTest::addRow("register-%d", count) << count << false;
+        QTest::addRow("restart-%d", count) << count << true;
+    }
+}
+
 QTEST_MAIN(qtimer_vs_qmetaobject)
 
 #include "tst_qtimer_vs_qmetaobject.moc"
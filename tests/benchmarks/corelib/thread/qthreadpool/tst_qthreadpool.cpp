@@ -40,6 +40,10 @@ public:
 private slots:
     void startRunnables();
     void activeThreadCount();
+    void startRunnablesFromProducers_data();
+    void startRunnablesFromProducers();
+    void startRunnablesFromWorkers_data();
+    void startRunnablesFromWorkers();
 };
 
 tst_QThreadPool::tst_QThreadPool()
@@ -75,5 +79,75 @@ void tst_QThreadPool::activeThreadCount()
     }
 }
 
+static void addThreadCountRows()
+{
+    QTest::addColumn<int>("threadCount");
+    const int idealThreadCount = QThread::idealThreadCount();
+    for (int threadCount = 1; threadCount < idealThreadCount; threadCount *= 2)
+        QTest::addRow("%d", threadCount) << threadCount;
+    QTest::addRow("%d", idealThreadCount) << idealThreadCount;
+}
+
+void tst_QThreadPool::startRunnablesFromProducers_data()
+{
+    addThreadCountRows();
+}
+
+void tst_QThreadPool::startRunnablesFromProducers()
+{
+    // many threads outside of the pool feeding it small tasks; these
+    // always go through the pool's mutex, this is the reference for
+    // startRunnablesFromWorkers()
+    QFETCH(int, threadCount);
+    const int tasksPerProducer = 100000;
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(threadCount);
+    QAtomicInt counter;
+
+    QBENCHMARK {
+        QList<QThread *> producers;
+        for (int i = 0; i < threadCount; ++i) {
+            producers << QThread::create([&] {
+                for (int j = 0; j < tasksPerProducer; ++j)
+                    threadPool.start([&counter] { counter.ref(); });
+            });
+            producers.last()->start();
+        }
+        for (QThread *producer : qAsConst(producers)) {
+            producer->wait();
+            delete producer;
+        }
+        threadPool.waitForDone();
+    }
+}
+
+void tst_QThreadPool::startRunnablesFromWorkers_data()
+{
+    addThreadCountRows();
+}
+
+void tst_QThreadPool::startRunnablesFromWorkers()
+{
+    // tasks running in the pool splitting their work into small tasks
+    QFETCH(int, threadCount);
+    const int tasksPerWorker = 100000;
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(threadCount);
+    QAtomicInt counter;
+
+    QBENCHMARK {
+        for (int i = 0; i < threadCount; ++i) {
+            threadPool.start([&] {
+                for (int j = 0; j < tasksPerWorker; ++j)
+                    threadPool.start([&counter] { counter.ref(); });
+            });
+        }
+        threadPool.waitForDone();
+    }
+    QCOMPARE(counter.loadRelaxed() % (threadCount * tasksPerWorker), 0);
+}
+
 QTEST_MAIN(tst_QThreadPool)
 #include "tst_qthreadpool.moc"
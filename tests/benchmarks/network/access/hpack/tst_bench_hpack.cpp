@@ -0,0 +1,153 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QTest>
+
+#include <QtNetwork/private/bitstreams_p.h>
+#include <QtNetwork/private/hpack_p.h>
+
+#include <vector>
+
+using namespace HPack;
+
+class tst_Hpack : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void decodeHeaderBlock_data();
+    void decodeHeaderBlock();
+    void decodeHuffmanString_data();
+    void decodeHuffmanString();
+    void staticTableLookup();
+
+private:
+    static HttpHeader requestHeader();
+};
+
+// what a browser sends for a typical page sub-resource
+HttpHeader tst_Hpack::requestHeader()
+{
+    return {
+        {":method", "GET"},
+        {":scheme", "https"},
+        {":authority", "www.example.com"},
+        {":path", "/static/js/vendor.bundle.8c3f1a2e.js?v=20211203"},
+        {"user-agent", "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) "
+                       "Chrome/96.0.4664.93 Safari/537.36"},
+        {"accept", "*/*"},
+        {"accept-encoding", "gzip, deflate, br"},
+        {"accept-language", "en-US,en;q=0.9,de;q=0.8"},
+        {"cookie", "session=8f14e45fceea167a5a36dedd4bea2543; theme=dark; _ga=GA1.2.1234567890.1638540000"},
+        {"referer", "https://www.example.com/products/index.html"},
+        {"sec-fetch-dest", "script"},
+        {"sec-fetch-mode", "no-cors"},
+        {"sec-fetch-site", "same-origin"},
+        {"cache-control", "no-cache"}
+    };
+}
+
+// a whole header block, as the protocol handler decodes it for each
+// HEADERS frame; the decoder starts with an empty dynamic table, so
+// the block is made of literals and static table references
+void tst_Hpack::decodeHeaderBlock_data()
+{
+    QTest::addColumn<bool>("huffman");
+
+    QTest::newRow("plain") << false;
+    QTest::newRow("huffman") << true;
+}
+
+void tst_Hpack::decodeHeaderBlock()
+{
+    QFETCH(bool, huffman);
+
+    const HttpHeader header = requestHeader();
+    std::vector<uchar> buffer;
+    BitOStream out(buffer);
+    Encoder encoder(HPack::FieldLookupTable::DefaultSize, huffman);
+    QVERIFY(encoder.encodeRequest(out, header));
+
+    QBENCHMARK {
+        Decoder decoder(HPack::FieldLookupTable::DefaultSize);
+        BitIStream in(out.begin(), out.end());
+        if (!decoder.decodeHeaderFields(in) || decoder.decodedHeader().size() != header.size())
+            QFAIL("failed to decode the header block");
+    }
+}
+
+void tst_Hpack::decodeHuffmanString_data()
+{
+    QTest::addColumn<QByteArray>("data");
+
+    QTest::newRow("path") << QByteArray("/static/js/vendor.bundle.8c3f1a2e.js?v=20211203");
+    QTest::newRow("user-agent") << QByteArray("Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 "
+                                              "(KHTML, like Gecko) Chrome/96.0.4664.93 Safari/537.36");
+    QByteArray binary;
+    for (int i = 0; i < 256; ++i)
+        binary.append(char(i));
+    QTest::newRow("all-bytes") << binary;
+}
+
+void tst_Hpack::decodeHuffmanString()
+{
+    QFETCH(QByteArray, data);
+
+    std::vector<uchar> buffer;
+    BitOStream out(buffer);
+    for (int i = 0; i < 100; ++i)
+        out.write(data, true);
+
+    QBENCHMARK {
+        BitIStream in(out.begin(), out.end());
+        for (int i = 0; i < 100; ++i) {
+            QByteArray decoded;
+            if (!in.read(&decoded) || decoded.size() != data.size())
+                QFAIL("failed to decode a string");
+        }
+    }
+}
+
+// the encoder looks up every field it sends in the static table first
+void tst_Hpack::staticTableLookup()
+{
+    const FieldLookupTable table(FieldLookupTable::DefaultSize, true);
+    const HttpHeader header = requestHeader();
+
+    QBENCHMARK {
+        for (const HeaderField &field : header) {
+            if (!table.indexOf(field.name, field.value))
+                table.indexOf(field.name);
+        }
+    }
+}
+
+QTEST_MAIN(tst_Hpack)
+
+#include "tst_bench_hpack.moc"
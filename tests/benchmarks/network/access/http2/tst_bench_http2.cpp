@@ -0,0 +1,160 @@
+/****************************************************************************
+**
+** Copyright (C) 2021 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#include <QTest>
+#include <QSignalSpy>
+
+#include "http2srv.h"
+
+#include <QtNetwork/private/http2protocol_p.h>
+#include <QtNetwork/qnetworkaccessmanager.h>
+#include <QtNetwork/qhttp2configuration.h>
+#include <QtNetwork/qnetworkrequest.h>
+#include <QtNetwork/qnetworkreply.h>
+
+#include <QtCore/qthread.h>
+#include <QtCore/qurl.h>
+
+Q_DECLARE_METATYPE(QHttp2Configuration)
+
+namespace {
+
+struct ServerDeleter
+{
+    static void cleanup(Http2Server *srv)
+    {
+        if (srv) {
+            srv->stopSendingDATAFrames();
+            QMetaObject::invokeMethod(srv, "deleteLater", Qt::QueuedConnection);
+        }
+    }
+};
+
+using ServerPtr = QScopedPointer<Http2Server, ServerDeleter>;
+
+const qint64 responseSize = 8 * 1024 * 1024;
+
+RawSettings toSettings(const QHttp2Configuration &config)
+{
+    RawSettings settings;
+    settings[Http2::Settings::ENABLE_PUSH_ID] = config.serverPushEnabled();
+    settings[Http2::Settings::INITIAL_WINDOW_SIZE_ID] = config.streamReceiveWindowSize();
+    return settings;
+}
+
+} // unnamed namespace
+
+class tst_bench_Http2 : public QObject
+{
+    Q_OBJECT
+public:
+    tst_bench_Http2();
+    ~tst_bench_Http2();
+
+private slots:
+    void download_data();
+    void download();
+
+private:
+    QThread workerThread;
+};
+
+tst_bench_Http2::tst_bench_Http2()
+{
+    workerThread.start();
+}
+
+tst_bench_Http2::~tst_bench_Http2()
+{
+    workerThread.quit();
+    workerThread.wait();
+}
+
+void tst_bench_Http2::download_data()
+{
+    QTest::addColumn<QHttp2Configuration>("configuration");
+
+    QHttp2Configuration config;
+    config.setServerPushEnabled(false);
+    config.setSessionReceiveWindowSize(Http2::maxSessionReceiveWindowSize);
+    config.setStreamReceiveWindowSize(Http2::defaultSessionWindowSize);
+    QTest::newRow("64K-window") << config;
+
+    config.setReceiveWindowAutoTuningEnabled(true);
+    QTest::newRow("64K-window-auto-tuned") << config;
+
+    config.setReceiveWindowAutoTuningEnabled(false);
+    config.setStreamReceiveWindowSize(16 * 1024 * 1024);
+    QTest::newRow("16M-window") << config;
+}
+
+void tst_bench_Http2::download()
+{
+    // A single, large response over a cleartext HTTP/2 connection to a
+    // local server: the server can only send as much as the client's
+    // stream window allows before it waits for a WINDOW_UPDATE.
+    QFETCH(const QHttp2Configuration, configuration);
+
+    ServerPtr srv(new Http2Server(H2Type::h2cDirect,
+                                  {{Http2::Settings::MAX_CONCURRENT_STREAMS_ID, 100}},
+                                  toSettings(configuration)));
+    srv->setResponseBody(QByteArray(responseSize, 'x'));
+    srv->moveToThread(&workerThread);
+    Http2Server *server = srv.data();
+    quint16 port = 0;
+    connect(server, &Http2Server::serverStarted, this, [&port](quint16 serverPort) {
+        port = serverPort;
+    });
+    connect(server, &Http2Server::receivedRequest, server, [server](quint32 streamID) {
+        server->sendResponse(streamID, false);
+    }, Qt::QueuedConnection);
+    QMetaObject::invokeMethod(srv.data(), "startServer", Qt::QueuedConnection);
+    QTRY_VERIFY(port != 0);
+
+    QUrl url(QStringLiteral("http://127.0.0.1/index.html"));
+    url.setPort(port);
+
+    QNetworkRequest request(url);
+    request.setAttribute(QNetworkRequest::Http2DirectAttribute, true);
+    request.setHttp2Configuration(configuration);
+
+    QNetworkAccessManager manager;
+    QBENCHMARK {
+        QNetworkReply *reply = manager.get(request);
+        QSignalSpy finished(reply, &QNetworkReply::finished);
+        QVERIFY(finished.wait(60000));
+        QCOMPARE(reply->error(), QNetworkReply::NoError);
+        QCOMPARE(reply->bytesAvailable(), responseSize);
+        delete reply;
+    }
+}
+
+QTEST_MAIN(tst_bench_Http2)
+
+#include "tst_bench_http2.moc"
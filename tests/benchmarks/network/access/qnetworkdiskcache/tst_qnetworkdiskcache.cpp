@@ -78,6 +78,9 @@ private slots:
 
     void timeExpiration_data();
     void timeExpiration();
+
+    void timeReopen_data();
+    void timeReopen();
 };
 
 
@@ -157,9 +160,12 @@ void tst_qnetworkdiskcache::timeInsertion()
 void tst_qnetworkdiskcache::timeRead_data()
 {
     QTest::addColumn<QString>("cacheRootDirectory");
+    QTest::addColumn<qint64>("memoryCacheSize");
 
     QString cacheLoc = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
-    QTest::newRow("QStandardPaths Cache Location") << cacheLoc;
+    QTest::newRow("QStandardPaths Cache Location") << cacheLoc << qint64(0);
+    QTest::newRow("QStandardPaths Cache Location, in memory") << cacheLoc
+                                                              << qint64(HugeCacheLimit);
 }
 
 //Times metadata as well payload lookup
@@ -168,6 +174,7 @@ void tst_qnetworkdiskcache::timeRead()
 {
 
     QFETCH(QString, cacheRootDirectory);
+    QFETCH(qint64, memoryCacheSize);
 
     cacheDir = QString( cacheRootDirectory + QDir::separator() + "man_qndc");
     QDir d;
@@ -178,6 +185,7 @@ void tst_qnetworkdiskcache::timeRead()
     initCacheObject();
     cache->setCacheDirectory(cacheDir);
     cache->setMaximumCacheSize(qint64(HugeCacheLimit));
+    cache->setMaximumMemoryCacheSize(memoryCacheSize);
     cache->clear();
 
     //populate some fake data to simulate partially full cache
@@ -186,6 +194,10 @@ void tst_qnetworkdiskcache::timeRead()
     //Entries in the cache should be > what we try to remove
     QVERIFY(NumFakeCacheObjects > NumReadContent);
 
+    //read the entries once, so that the ones kept in memory are hot
+    for (quint32 i = 0; i < NumReadContent; i++)
+        QVERIFY(isUrlCached(i));
+
     //time metadata lookup of previously inserted URL.
     QBENCHMARK_ONCE {
         for (quint32 i = 0; i < NumReadContent; i++) {
@@ -324,6 +336,48 @@ void tst_qnetworkdiskcache::timeExpiration()
     cleanRecursive(cacheDir);
 
 }
+void tst_qnetworkdiskcache::timeReopen_data()
+{
+    QTest::addColumn<QString>("cacheRootDirectory");
+
+    QString cacheLoc = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    QTest::newRow("QStandardPaths Cache Location") << cacheLoc;
+}
+
+//Times opening an already populated cache and asking for its size,
+//which is answered from the cache index rather than by reading the directory.
+void tst_qnetworkdiskcache::timeReopen()
+{
+
+    QFETCH(QString, cacheRootDirectory);
+
+    cacheDir = QString( cacheRootDirectory + QDir::separator() + "man_qndc");
+    QDir d;
+    qDebug() << "Setting cache directory to = " << d.absoluteFilePath(cacheDir);
+
+    //Housekeeping
+    initCacheObject();
+    cleanRecursive(cacheDir); // slow op.
+    cache->setCacheDirectory(cacheDir);
+    cache->setMaximumCacheSize(qint64(HugeCacheLimit));
+    cache->clear();
+
+    //populate some fake data to simulate partially full cache
+    injectFakeData();
+    const qint64 size = cache->cacheSize();
+    cleanupCacheObject();
+
+    QBENCHMARK {
+        QNetworkDiskCache reopened;
+        reopened.setCacheDirectory(cacheDir);
+        QCOMPARE(reopened.cacheSize(), size);
+    }
+
+    //Cleanup (slow)
+    cleanRecursive(cacheDir);
+
+}
+
 // This function simulates a partially or fully occupied disk cache
 // like a normal user of a cache might encounter is real-life browsing.
 // The point of this is to trigger degradation in file-system and media performance
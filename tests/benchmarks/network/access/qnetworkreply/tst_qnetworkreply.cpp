@@ -38,6 +38,7 @@
 #include <QtNetwork/qnetworkreply.h>
 #include <QtNetwork/qnetworkrequest.h>
 #include <QtNetwork/qnetworkaccessmanager.h>
+#include <QtNetwork/qhttp1configuration.h>
 #include <QtNetwork/qtcpsocket.h>
 #include <QtNetwork/qtcpserver.h>
 #include "../../../../auto/network-settings.h"
@@ -410,6 +411,43 @@ public slots:
     }
 };
 
+// Answers every request right away with a small body, and keeps the
+// connection open for the next one.
+class KeepAliveHttpServer : QObject {
+    Q_OBJECT
+    QTcpServer server;
+    QHash<QTcpSocket *, QByteArray> buffers;
+
+public:
+    KeepAliveHttpServer() {
+        server.listen(QHostAddress::LocalHost);
+        connect(&server, SIGNAL(newConnection()), this, SLOT(newConnectionSlot()));
+    }
+
+    int serverPort() {
+        return server.serverPort();
+    }
+
+public slots:
+    void newConnectionSlot() {
+        while (QTcpSocket *client = server.nextPendingConnection()) {
+            client->setParent(this);
+            connect(client, SIGNAL(readyRead()), this, SLOT(readyReadSlot()));
+        }
+    }
+
+    void readyReadSlot() {
+        QTcpSocket *client = qobject_cast<QTcpSocket *>(sender());
+        QByteArray &buffer = buffers[client];
+        buffer += client->readAll();
+        qsizetype end;
+        while ((end = buffer.indexOf("\r\n\r\n")) != -1) {
+            buffer.remove(0, end + 4);
+            client->write("HTTP/1.1 200 OK\r\nContent-Length: 4\r\n\r\npong");
+        }
+    }
+};
+
 class HttpDownloadPerformanceClient : QObject {
     Q_OBJECT;
     QIODevice *device;
@@ -461,6 +499,8 @@ private slots:
     void httpsUpload();
     void preConnect_data();
     void preConnect();
+    void http1ConnectionPool_data();
+    void http1ConnectionPool();
 
 private:
     void runHttpsUploadRequest(const QByteArray &data, const QNetworkRequest &request);
@@ -953,6 +993,58 @@ void tst_qnetworkreply::preConnect()
              << (normalElapsed - preConnectElapsed) << "ms";
 }
 
+void tst_qnetworkreply::http1ConnectionPool_data()
+{
+    QTest::addColumn<int>("connectionsPerHost");
+    QTest::addColumn<bool>("adaptive");
+    QTest::addColumn<int>("pipelineLength");
+
+    QTest::newRow("default") << 6 << false << 0;
+    QTest::newRow("24-connections") << 24 << false << 0;
+    QTest::newRow("adaptive-24-connections") << 24 << true << 0;
+    QTest::newRow("pipelined-3") << 6 << false << 3;
+    QTest::newRow("pipelined-8") << 6 << false << 8;
+}
+
+void tst_qnetworkreply::http1ConnectionPool()
+{
+    QFETCH(int, connectionsPerHost);
+    QFETCH(bool, adaptive);
+    QFETCH(int, pipelineLength);
+
+    enum { RequestCount = 200 };
+
+    KeepAliveHttpServer server;
+    QHttp1Configuration config;
+    QVERIFY(config.setNumberOfConnectionsPerHost(connectionsPerHost));
+    config.setAdaptiveConnectionCountEnabled(adaptive);
+    if (pipelineLength)
+        QVERIFY(config.setMaximumPipelineLength(pipelineLength));
+
+    QNetworkRequest request(QUrl("http://127.0.0.1:" + QString::number(server.serverPort()) + "/"));
+    request.setHttp1Configuration(config);
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, false);
+    request.setAttribute(QNetworkRequest::HttpPipeliningAllowedAttribute, pipelineLength > 0);
+
+    // every row starts from an empty connection pool
+    QNetworkAccessManager manager;
+    QBENCHMARK {
+        QList<QNetworkReplyPtr> replies;
+        int finished = 0;
+        for (int i = 0; i < RequestCount; ++i) {
+            replies << QNetworkReplyPtr(manager.get(request));
+            QObject::connect(replies.last().data(), &QNetworkReply::finished, [&finished]() {
+                if (++finished == RequestCount)
+                    QTestEventLoop::instance().exitLoop();
+            });
+        }
+        QTestEventLoop::instance().enterLoop(20);
+        QVERIFY(!QTestEventLoop::instance().timeout());
+        for (const QNetworkReplyPtr &reply : qAsConst(replies))
+            QCOMPARE(reply->error(), QNetworkReply::NoError);
+    }
+}
+
 QTEST_MAIN(tst_qnetworkreply)
 
 #include "tst_qnetworkreply.moc"
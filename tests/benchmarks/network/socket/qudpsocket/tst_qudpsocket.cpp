@@ -41,6 +41,8 @@ public:
 private slots:
     void pendingDatagramSize_data();
     void pendingDatagramSize();
+    void throughput_data();
+    void throughput();
 };
 
 tst_QUdpSocket::tst_QUdpSocket()
@@ -76,5 +78,52 @@ void tst_QUdpSocket::pendingDatagramSize()
     }
 }
 
+void tst_QUdpSocket::throughput_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::addColumn<bool>("batched");
+    for (int size : {64, 512, 1400}) {
+        QTest::addRow("%d-single", size) << size << false;
+        QTest::addRow("%d-batched", size) << size << true;
+    }
+}
+
+void tst_QUdpSocket::throughput()
+{
+    QFETCH(int, size);
+    QFETCH(bool, batched);
+
+    QUdpSocket sender, receiver;
+    QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+
+    // what fits into the default receive buffer
+    constexpr int Count = 32;
+    QList<QNetworkDatagram> datagrams;
+    for (int i = 0; i < Count; ++i)
+        datagrams << QNetworkDatagram(QByteArray(size, 'a'), receiver.localAddress(), receiver.localPort());
+
+    QBENCHMARK {
+        if (batched) {
+            QCOMPARE(sender.writeDatagrams(datagrams), qint64(Count));
+        } else {
+            for (const QNetworkDatagram &datagram : qAsConst(datagrams))
+                QCOMPARE(sender.writeDatagram(datagram), qint64(size));
+        }
+
+        int received = 0;
+        while (received < Count && receiver.waitForReadyRead(5000)) {
+            if (batched) {
+                received += receiver.receiveDatagrams(Count - received, size).size();
+            } else {
+                while (received < Count && receiver.hasPendingDatagrams()) {
+                    receiver.receiveDatagram(size);
+                    ++received;
+                }
+            }
+        }
+        QCOMPARE(received, Count);
+    }
+}
+
 QTEST_MAIN(tst_QUdpSocket)
 #include "tst_qudpsocket.moc"
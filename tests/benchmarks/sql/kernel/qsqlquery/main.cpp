@@ -52,6 +52,12 @@ private slots:
     void benchmark();
     void benchmarkSelectPrepared_data() { generic_data(); }
     void benchmarkSelectPrepared();
+    void benchmarkSelectScrollable_data() { generic_data(); }
+    void benchmarkSelectScrollable();
+    void benchmarkFetchRows_data();
+    void benchmarkFetchRows();
+    void benchmarkStatementCache_data();
+    void benchmarkStatementCache();
 
 private:
     // returns all database connections
@@ -293,4 +299,151 @@ void tst_QSqlQuery::benchmarkSelectPrepared()
     tst_Databases::safeDropTable(db, tableName);
 }
 
+void tst_QSqlQuery::benchmarkSelectScrollable()
+{
+    QFETCH(QString, dbName);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    QSqlQuery q(db);
+    const QString tableName(qTableName("benchmark", __FILE__, db));
+
+    tst_Databases::safeDropTable(db, tableName);
+
+    QVERIFY_SQL(q, exec("CREATE TABLE " + tableName
+                        + "(id INT NOT NULL, val DOUBLE PRECISION, txt VARCHAR(20))"));
+
+    const int NUM_ROWS = 10000;
+    QVERIFY(db.transaction());
+    QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " VALUES (?, ?, ?)"));
+    for (int i = 0; i < NUM_ROWS; ++i) {
+        q.addBindValue(i);
+        q.addBindValue(i * 0.5);
+        q.addBindValue(QString::number(i));
+        QVERIFY_SQL(q, exec());
+    }
+    QVERIFY(db.commit());
+
+    // reading the rows backwards makes drivers without scrollable cursors
+    // serve them from the cached result
+    QVERIFY_SQL(q, prepare("SELECT id, val, txt FROM " + tableName));
+    QBENCHMARK {
+        QVERIFY_SQL(q, exec());
+        QVERIFY(q.last());
+        qint64 sum = 0;
+        do {
+            sum += q.value(0).toInt() + q.value(2).toString().size();
+        } while (q.previous());
+        QVERIFY(sum > 0);
+    }
+
+    tst_Databases::safeDropTable(db, tableName);
+}
+
+void tst_QSqlQuery::benchmarkFetchRows_data()
+{
+    if (dbs.fillTestTable() == 0)
+        QSKIP("No database drivers are available in this Qt configuration");
+
+    QTest::addColumn<QString>("dbName");
+    QTest::addColumn<int>("blockSize");
+    for (const QString &dbName : qAsConst(dbs.dbNames)) {
+        QTest::newRow(qPrintable(dbName + QLatin1String(":next"))) << dbName << 0;
+        QTest::newRow(qPrintable(dbName + QLatin1String(":fetchRows"))) << dbName << 256;
+    }
+}
+
+void tst_QSqlQuery::benchmarkFetchRows()
+{
+    QFETCH(QString, dbName);
+    QFETCH(int, blockSize);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    QSqlQuery q(db);
+    const QString tableName(qTableName("benchmark", __FILE__, db));
+
+    tst_Databases::safeDropTable(db, tableName);
+
+    QVERIFY_SQL(q, exec("CREATE TABLE " + tableName
+                        + "(id INT NOT NULL, val DOUBLE PRECISION, txt VARCHAR(20))"));
+
+    const int NUM_ROWS = 10000;
+    QVERIFY(db.transaction());
+    QVERIFY_SQL(q, prepare("INSERT INTO " + tableName + " VALUES (?, ?, ?)"));
+    for (int i = 0; i < NUM_ROWS; ++i) {
+        q.addBindValue(i);
+        q.addBindValue(i * 0.5);
+        q.addBindValue(QString::number(i));
+        QVERIFY_SQL(q, exec());
+    }
+    QVERIFY(db.commit());
+
+    q.setForwardOnly(true);
+    QVERIFY_SQL(q, prepare("SELECT id, val, txt FROM " + tableName));
+    QList<QVariantList> columns;
+    QBENCHMARK {
+        QVERIFY_SQL(q, exec());
+        qint64 sum = 0;
+        if (blockSize) {
+            while (int n = q.fetchRows(&columns, blockSize)) {
+                for (int i = 0; i < n; ++i)
+                    sum += columns.at(0).at(i).toInt() + columns.at(2).at(i).toString().size();
+            }
+        } else {
+            while (q.next())
+                sum += q.value(0).toInt() + q.value(2).toString().size();
+        }
+        QVERIFY(sum > 0);
+    }
+
+    tst_Databases::safeDropTable(db, tableName);
+}
+
+void tst_QSqlQuery::benchmarkStatementCache_data()
+{
+    if (dbs.fillTestTable() == 0)
+        QSKIP("No database drivers are available in this Qt configuration");
+
+    QTest::addColumn<QString>("dbName");
+    QTest::addColumn<int>("cacheSize");
+    for (const QString &dbName : qAsConst(dbs.dbNames)) {
+        QTest::newRow(qPrintable(dbName + QLatin1String(":uncached"))) << dbName << 0;
+        QTest::newRow(qPrintable(dbName + QLatin1String(":cached"))) << dbName << 16;
+    }
+}
+
+void tst_QSqlQuery::benchmarkStatementCache()
+{
+    QFETCH(QString, dbName);
+    QFETCH(int, cacheSize);
+    QSqlDatabase db = QSqlDatabase::database(dbName);
+    CHECK_DATABASE(db);
+    const QString tableName(qTableName("benchmark", __FILE__, db));
+
+    tst_Databases::safeDropTable(db, tableName);
+
+    {
+        QSqlQuery q(db);
+        QVERIFY_SQL(q, exec("CREATE TABLE " + tableName
+                            + "(id INT NOT NULL, val DOUBLE PRECISION, txt VARCHAR(20))"));
+        QVERIFY_SQL(q, exec("INSERT INTO " + tableName + " VALUES (1, 0.5, 'one')"));
+    }
+
+    // every iteration prepares the statement with a fresh query, like
+    // short-lived queries in application code do
+    db.driver()->setStatementCacheSize(cacheSize);
+    const QString select = "SELECT val, txt FROM " + tableName + " WHERE id = ?";
+    QBENCHMARK {
+        for (int i = 0; i < 100; ++i) {
+            QSqlQuery q(db);
+            QVERIFY_SQL(q, prepare(select));
+            q.addBindValue(1);
+            QVERIFY_SQL(q, exec());
+            QVERIFY(q.next());
+        }
+    }
+    db.driver()->setStatementCacheSize(0);
+
+    tst_Databases::safeDropTable(db, tableName);
+}
+
 #include "main.moc"